@@ -35,11 +35,11 @@ std::vector<std::byte> Audio::gen_wav(std::span<const float> s) const {
     return ret;
 }
 
-bool Audio::init(nngn::Math *m, std::size_t rate) {
+bool Audio::init(nngn::Math *m, std::size_t rate, std::size_t max_sources) {
     NNGN_LOG_CONTEXT_CF(Audio);
     this->math = m;
     this->m_rate = rate;
-    return this->init_openal();
+    return this->init_openal(max_sources);
 }
 
 }
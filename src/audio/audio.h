@@ -11,12 +11,24 @@
 #include "math/vec3.h"
 #include "utils/def.h"
 
+#include "voice_pool.h"
+
 namespace nngn {
 
-/** Audio manager.  Generates, stores, and controls audio streams. */
+/**
+ * Audio manager.  Generates, stores, and controls audio streams.
+ *
+ * Sources are allocated from a fixed pool created during initialization, so
+ * adding and removing them does not create or destroy OpenAL objects.  A
+ * source handle remains valid until the source is removed or, when the pool is
+ * full, its slot is reused for a new source (see \ref VoicePool for the order
+ * in which sources are replaced).  Operations on invalid handles fail
+ * (returning \c false or an empty value) without affecting other sources.
+ */
 class Audio {
 public:
-    enum class source : std::size_t {};
+    using source = VoicePool::handle;
+    static constexpr std::size_t DEFAULT_MAX_SOURCES = 32;
     // Utility
     /** Multiplier to decibel conversion. */
     static constexpr float db(float x) { return std::pow(10.0f, x / 20.0f); }
@@ -42,7 +54,10 @@ public:
         std::size_t a, std::size_t d, float st, std::size_t r);
     /** Adds the samples from both buffers. */
     static void mix(std::span<float> dst, std::span<const float> src);
-    /** Generates 16-bit PCM data from floating-point data. */
+    /**
+     * Generates 16-bit PCM data from floating-point data.
+     * Samples outside of <tt>[-1, 1]</tt> are saturated.
+     */
     static void normalize(std::span<i16> dst, std::span<const float> src);
     // Constructors, destructors
     NNGN_MOVE_ONLY(Audio)
@@ -53,9 +68,15 @@ public:
      * Initializes the manager to work with a given sample rate.
      * Must be called before any other non-static member function.
      * \param m May be \c null if \ref noise is never called.
+     * \param max_sources
+     *     Size of the source pool, limited by the number of sources supported
+     *     by the device.
      */
-    bool init(Math *m, std::size_t rate);
+    bool init(
+        Math *m, std::size_t rate,
+        std::size_t max_sources = DEFAULT_MAX_SOURCES);
     std::size_t rate(void) const { return this->m_rate; }
+    std::size_t max_sources(void) const;
     std::size_t n_sources(void) const;
     // I/O
     /** Reads WAV data from a file. */
@@ -91,8 +112,12 @@ public:
     void gen_noise(std::span<float> s) const;
     // Sources
     bool set_pos(vec3 p);
-    source add_source(void);
-    source add_source(std::span<const std::byte> v);
+    /**
+     * Takes a source from the pool.
+     * \return Null handle if the pool is full and no source can be stolen.
+     */
+    source add_source(i32 priority = 0);
+    source add_source(std::span<const std::byte> v, i32 priority = 0);
     bool remove_source(source s);
     vec3 source_pos(source s) const;
     std::size_t source_sample_pos(source s) const;
@@ -103,13 +128,30 @@ public:
     bool set_source_sample_pos(source s, std::size_t p);
     bool set_source_loop(source s, bool l);
     bool set_source_gain(source s, float g);
+    bool set_source_priority(source s, i32 p);
     bool play(source s) const;
     bool stop(source s) const;
+    /**
+     * Starts all sources in a single operation.
+     * Invalid handles are skipped (and make the function return \c false).
+     */
+    bool play(std::span<const source> s) const;
+    /** \see play(std::span<const source>) const */
+    bool stop(std::span<const source> s) const;
+    /**
+     * Storage for the handles of a batch operation.
+     * Reused between calls so that building a batch does not allocate.
+     */
+    std::vector<source> *batch_buffer(void) { return &this->batch; }
 private:
-    bool init_openal(void);
+    bool init_openal(std::size_t max_sources);
+    /** Phase increment (in cycles) per sample of frequency \p f. */
+    double step(float f) const
+        { return static_cast<double>(f) / static_cast<double>(this->m_rate); }
     std::unique_ptr<void, void(*)(void*)> data = {nullptr, [](auto){}};
     Math *math = nullptr;
     std::size_t m_rate = 0;
+    std::vector<source> batch = {};
 };
 
 }
@@ -0,0 +1,271 @@
+#include "dsp.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cfloat>
+#include <cstdint>
+#include <cmath>
+
+namespace {
+
+using nngn::dsp::BLOCK;
+
+constexpr auto w = 2.0f * std::numbers::pi_v<float>;
+
+/** Index to float conversion which can be vectorized (unlike `size_t`). */
+float to_float(std::size_t i) {
+    assert(i <= static_cast<std::size_t>(INT32_MAX));
+    return static_cast<float>(static_cast<nngn::i32>(i));
+}
+
+/** Phase accumulator, kept in double precision and advanced per block. */
+class phasor {
+public:
+    phasor(double phase, double step) : p{phase - std::floor(phase)}, d{step}
+        {}
+    double phase(void) const { return this->p; }
+    /** Fills \p b with the phases of the next samples. */
+    void fill(std::span<float, BLOCK> b) const {
+        const auto p0 = static_cast<float>(this->p);
+        const auto d0 = static_cast<float>(this->d);
+        for(std::size_t i = 0; i != BLOCK; ++i)
+            b[i] = p0 + to_float(i) * d0;
+    }
+    void advance(std::size_t n) {
+        this->p += static_cast<double>(n) * this->d;
+        this->p -= std::floor(this->p);
+    }
+private:
+    double p, d;
+};
+
+/** Calls \p f for each block of \p s along with the phases of its samples. */
+double osc(std::span<float> s, double phase, double step, auto &&f) {
+    auto ph = phasor{phase, step};
+    std::array<float, BLOCK> p = {};
+    for(std::size_t i = 0, n = s.size(); i < n; i += BLOCK) {
+        const auto b = s.subspan(i, std::min(BLOCK, n - i));
+        ph.fill(p);
+        f(b, std::span<const float>{p});
+        ph.advance(b.size());
+    }
+    return ph.phase();
+}
+
+/** Fractional part of \p x, in <tt>[0, 1)</tt>. */
+float frac(float x) {
+    x -= static_cast<float>(static_cast<nngn::i32>(x));
+    return x < 0 ? x + 1 : x;
+}
+
+/** <tt>x ^ e</tt> for \p x in <tt>[0, 1]</tt>. */
+inline float pow01(float x, float e) {
+    const auto p =
+        nngn::dsp::fast_exp2(e * nngn::dsp::fast_log2(x > 0 ? x : FLT_MIN));
+    return x > 0 ? p : (e == 0 ? 1.0f : 0.0f);
+}
+
+double wrap(double p) { return p - std::floor(p); }
+
+}
+
+namespace nngn::dsp {
+
+void gain(std::span<float> s, float g) {
+    for(auto &x : s)
+        x *= g;
+}
+
+void mix(std::span<float> dst, std::span<const float> src) {
+    assert(src.size() <= dst.size());
+    for(std::size_t i = 0, n = src.size(); i != n; ++i)
+        dst[i] += src[i];
+}
+
+void normalize(std::span<i16> dst, std::span<const float> src) {
+    assert(src.size() == dst.size());
+    constexpr auto max = static_cast<float>(INT16_MAX);
+    for(std::size_t i = 0, n = src.size(); i != n; ++i) {
+        auto x = src[i];
+        x = x > -1.0f ? x : -1.0f;
+        x = x < 1.0f ? x : 1.0f;
+        dst[i] = static_cast<i16>(max * x);
+    }
+}
+
+void denormalize(std::span<float> dst, std::span<const i16> src) {
+    assert(src.size() == dst.size());
+    constexpr auto m = 1.0f / static_cast<float>(INT16_MAX);
+    for(std::size_t i = 0, n = src.size(); i != n; ++i)
+        dst[i] = m * static_cast<float>(src[i]);
+}
+
+void over(std::span<float> s, float m, float mix) {
+    constexpr auto l = std::numbers::log2e_v<float>;
+    for(auto &x : s) {
+        const auto a = x < 0 ? -x : x;
+        const auto e = 1.0f - fast_exp2(-l * m * a);
+        const auto o = x < 0 ? e : -e;
+        x += mix * (o - x);
+    }
+}
+
+void fade(std::span<float> s, std::size_t ep, float g0, float g1) {
+    const auto d = (g1 - g0) / static_cast<float>(ep);
+    for(std::size_t i = 0, n = s.size(); i != n; ++i)
+        s[i] *= g0 + d * to_float(i);
+}
+
+void exp_fade(
+    std::span<float> s, std::size_t ep, float g0, float g1, float e
+) {
+    const auto d = 1.0f / static_cast<float>(ep);
+    if(g0 <= g1)
+        for(std::size_t i = 0, n = s.size(); i != n; ++i)
+            s[i] *= g0 + (g1 - g0) * pow01(d * to_float(i), e);
+    else
+        for(std::size_t i = 0, n = s.size(); i != n; ++i)
+            s[i] *= g1
+                + (g0 - g1) * pow01(1.0f - d * to_float(i), e);
+}
+
+double sine(std::span<float> s, double phase, double step) {
+    return osc(s, phase, step, [](auto b, auto p) {
+        for(std::size_t i = 0, n = b.size(); i != n; ++i)
+            b[i] += fast_sin(p[i]);
+    });
+}
+
+void sine_fm(
+    std::span<float> s, double step,
+    float beta, double lfo_phase, double lfo_step
+) {
+    const auto k = beta / w;
+    auto lfo = phasor{lfo_phase, lfo_step};
+    std::array<float, BLOCK> m = {};
+    osc(s, 0, step, [k, &lfo, &m](auto b, auto p) {
+        lfo.fill(m);
+        for(std::size_t i = 0, n = b.size(); i != n; ++i)
+            b[i] += fast_sin(p[i] + k * fast_sin(m[i]));
+        lfo.advance(b.size());
+    });
+}
+
+double square(std::span<float> s, double phase, double step) {
+    return osc(s, phase, step, [](auto b, auto p) {
+        for(std::size_t i = 0, n = b.size(); i != n; ++i)
+            b[i] += frac(p[i]) <= 0.5f ? 1.0f : -1.0f;
+    });
+}
+
+double saw(std::span<float> s, double phase, double step) {
+    return osc(s, phase, step, [](auto b, auto p) {
+        for(std::size_t i = 0, n = b.size(); i != n; ++i)
+            b[i] += 2.0f * frac(p[i]) - 1.0f;
+    });
+}
+
+void trem(std::span<float> s, float a, double step, float mix) {
+    osc(s, 0, step, [a, mix](auto b, auto p) {
+        for(std::size_t i = 0, n = b.size(); i != n; ++i)
+            b[i] += mix * (b[i] * a * fast_sin(p[i]) - b[i]);
+    });
+}
+
+}
+
+namespace nngn::dsp::ref {
+
+void gain(std::span<float> s, float g) {
+    for(auto &x : s)
+        x *= g;
+}
+
+void mix(std::span<float> dst, std::span<const float> src) {
+    assert(src.size() <= dst.size());
+    for(std::size_t i = 0, n = src.size(); i != n; ++i)
+        dst[i] += src[i];
+}
+
+void normalize(std::span<i16> dst, std::span<const float> src) {
+    assert(src.size() == dst.size());
+    constexpr auto max = static_cast<float>(INT16_MAX);
+    for(std::size_t i = 0, n = src.size(); i != n; ++i)
+        dst[i] = static_cast<i16>(max * std::clamp(src[i], -1.0f, 1.0f));
+}
+
+void over(std::span<float> s, float m, float mix) {
+    for(auto &x : s) {
+        const auto o = -std::copysign(1.0f, x)
+            * (1.0f - std::exp(-std::abs(m * x)));
+        x = std::lerp(x, o, mix);
+    }
+}
+
+void fade(std::span<float> s, std::size_t ep, float g0, float g1) {
+    for(std::size_t i = 0, n = s.size(); i != n; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(ep);
+        s[i] *= std::lerp(g0, g1, t);
+    }
+}
+
+void exp_fade(
+    std::span<float> s, std::size_t ep, float g0, float g1, float e
+) {
+    for(std::size_t i = 0, n = s.size(); i != n; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(ep);
+        s[i] *= g0 <= g1
+            ? std::lerp(g0, g1, std::pow(t, e))
+            : std::lerp(g1, g0, std::pow(1 - t, e));
+    }
+}
+
+double sine(std::span<float> s, double phase, double step) {
+    const auto p = static_cast<float>(phase);
+    const auto d = static_cast<float>(step);
+    for(std::size_t i = 0, n = s.size(); i != n; ++i)
+        s[i] += std::sin(w * (p + static_cast<float>(i) * d));
+    return wrap(phase + static_cast<double>(s.size()) * step);
+}
+
+void sine_fm(
+    std::span<float> s, double step,
+    float beta, double lfo_phase, double lfo_step
+) {
+    const auto d = static_cast<float>(step);
+    const auto lp = static_cast<float>(lfo_phase);
+    const auto ld = static_cast<float>(lfo_step);
+    for(std::size_t i = 0, n = s.size(); i != n; ++i) {
+        const auto t = static_cast<float>(i);
+        const auto fm = beta * std::sin(w * (lp + t * ld));
+        s[i] += std::sin(w * t * d + fm);
+    }
+}
+
+double square(std::span<float> s, double phase, double step) {
+    const auto p = static_cast<float>(phase);
+    const auto d = static_cast<float>(step);
+    for(std::size_t i = 0, n = s.size(); i != n; ++i)
+        s[i] += std::copysign(
+            1.0f, 0.5f - std::fmod(p + static_cast<float>(i) * d, 1.0f));
+    return wrap(phase + static_cast<double>(s.size()) * step);
+}
+
+double saw(std::span<float> s, double phase, double step) {
+    const auto p = static_cast<float>(phase);
+    const auto d = static_cast<float>(step);
+    for(std::size_t i = 0, n = s.size(); i != n; ++i)
+        s[i] += 2.0f * std::fmod(p + static_cast<float>(i) * d, 1.0f) - 1.0f;
+    return wrap(phase + static_cast<double>(s.size()) * step);
+}
+
+void trem(std::span<float> s, float a, double step, float mix) {
+    const auto d = static_cast<float>(step);
+    for(std::size_t i = 0, n = s.size(); i != n; ++i) {
+        const auto tr = s[i] * a * std::sin(w * static_cast<float>(i) * d);
+        s[i] = std::lerp(s[i], tr, mix);
+    }
+}
+
+}
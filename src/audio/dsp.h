@@ -0,0 +1,140 @@
+#ifndef NNGN_AUDIO_DSP_H
+#define NNGN_AUDIO_DSP_H
+
+#include <bit>
+#include <cstddef>
+#include <numbers>
+#include <span>
+
+#include "utils/def.h"
+
+/**
+ * Sample processing kernels.
+ *
+ * These are the implementations of the generation functions in \ref Audio.
+ * Loops are written so that they can be vectorized by the compiler: they
+ * contain no function calls, branches, or dependencies between iterations.
+ * Transcendental functions are replaced by the polynomial approximations
+ * below, and oscillators keep a phase accumulator (in turns, i.e. fractions
+ * of a cycle) which is advanced in blocks of \ref BLOCK samples instead of
+ * evaluating the phase of each sample from its index.
+ *
+ * The scalar implementations these replaced are kept in \ref nngn::dsp::ref,
+ * with the same interface, as a reference for tests and benchmarks.
+ */
+namespace nngn::dsp {
+
+/** Number of samples whose phase is computed from each accumulator value. */
+inline constexpr std::size_t BLOCK = 64;
+
+/**
+ * Approximates <tt>sin(2 * pi * p)</tt>.
+ * The argument is reduced to <tt>[-1/4, 1/4]</tt>, where a degree-11
+ * polynomial is used.  \p p must be within the range of \c i32.
+ */
+inline float fast_sin(float p) {
+    p -= static_cast<float>(static_cast<i32>(p));
+    p -= p > 0.5f ? 1.0f : 0.0f;
+    p += p < -0.5f ? 1.0f : 0.0f;
+    const auto a = p < 0 ? -p : p;
+    const auto r = a > 0.25f ? 0.5f - a : a;
+    const auto x = 2 * std::numbers::pi_v<float> * (p < 0 ? -r : r);
+    const auto x2 = x * x;
+    return x * (1 + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040
+        + x2 * (1.0f / 362880 + x2 * (-1.0f / 39916800))))));
+}
+
+/**
+ * Approximates <tt>2 ^ x</tt>.
+ * \p x is clamped to <tt>[-126, 127]</tt> (so the result is never a
+ * denormal, zero, or infinity), the fractional part is evaluated with a
+ * degree-6 polynomial.
+ */
+inline float fast_exp2(float x) {
+    x = x > -126.0f ? x : -126.0f;
+    x = x < 127.0f ? x : 127.0f;
+    const auto i = static_cast<i32>(x + 128.5f) - 128;
+    const auto f = (x - static_cast<float>(i)) * std::numbers::ln2_v<float>;
+    const auto p = 1 + f * (1 + f * (1.0f / 2 + f * (1.0f / 6
+        + f * (1.0f / 24 + f * (1.0f / 120 + f * (1.0f / 720))))));
+    return std::bit_cast<float>(std::bit_cast<i32>(p) + (i << 23));
+}
+
+/**
+ * Approximates <tt>log2(x)</tt>.
+ * \p x must be positive and normal.  The mantissa is reduced to
+ * <tt>[sqrt(2)/2, sqrt(2)]</tt> and evaluated with a degree-7 series.
+ */
+inline float fast_log2(float x) {
+    const auto b = std::bit_cast<i32>(x);
+    auto e = ((b >> 23) & 0xff) - 127;
+    auto m = std::bit_cast<float>((b & 0x7fffff) | 0x3f800000);
+    const bool h = m > std::numbers::sqrt2_v<float>;
+    m = h ? m / 2 : m;
+    e += h ? 1 : 0;
+    const auto t = (m - 1) / (m + 1), t2 = t * t;
+    const auto l = 2 * t * (1 + t2 * (1.0f / 3 + t2 * (1.0f / 5 + t2 / 7)));
+    return static_cast<float>(e) + l * std::numbers::log2e_v<float>;
+}
+
+/** Multiplies each sample by \p g. */
+void gain(std::span<float> s, float g);
+/** Adds each sample in \p src to the corresponding sample in \p dst. */
+void mix(std::span<float> dst, std::span<const float> src);
+/**
+ * Converts samples to 16-bit PCM.
+ * Samples are saturated to <tt>[-1, 1]</tt>, \c NaN is converted to \c -1.
+ */
+void normalize(std::span<i16> dst, std::span<const float> src);
+/** Converts 16-bit PCM samples to floating-point, the inverse of the above. */
+void denormalize(std::span<float> dst, std::span<const i16> src);
+/** Overdrive effect, see \ref Audio::over. */
+void over(std::span<float> s, float m, float mix);
+/** Linear fade from \p g0 to \p g1 over \p ep samples. */
+void fade(std::span<float> s, std::size_t ep, float g0, float g1);
+/** Exponential fade, see \ref Audio::exp_fade. */
+void exp_fade(
+    std::span<float> s, std::size_t ep, float g0, float g1, float e);
+/**
+ * Adds a sine wave starting at \p phase and advancing \p step per sample.
+ * \return Phase of the sample following the last one, in <tt>[0, 1)</tt>.
+ */
+double sine(std::span<float> s, double phase, double step);
+/**
+ * Adds a frequency-modulated sine wave.
+ * \param beta Modulation index (i.e. peak phase deviation, in radians).
+ * \param lfo_phase, lfo_step Phase of the message signal.
+ */
+void sine_fm(
+    std::span<float> s, double step,
+    float beta, double lfo_phase, double lfo_step);
+/** Adds a square wave, see \ref sine. */
+double square(std::span<float> s, double phase, double step);
+/** Adds a saw-tooth wave, see \ref sine. */
+double saw(std::span<float> s, double phase, double step);
+/** Tremolo effect, see \ref Audio::trem. */
+void trem(std::span<float> s, float a, double step, float mix);
+
+}
+
+/** Scalar reference implementations of the kernels above. */
+namespace nngn::dsp::ref {
+
+void gain(std::span<float> s, float g);
+void mix(std::span<float> dst, std::span<const float> src);
+void normalize(std::span<i16> dst, std::span<const float> src);
+void over(std::span<float> s, float m, float mix);
+void fade(std::span<float> s, std::size_t ep, float g0, float g1);
+void exp_fade(
+    std::span<float> s, std::size_t ep, float g0, float g1, float e);
+double sine(std::span<float> s, double phase, double step);
+void sine_fm(
+    std::span<float> s, double step,
+    float beta, double lfo_phase, double lfo_step);
+double square(std::span<float> s, double phase, double step);
+double saw(std::span<float> s, double phase, double step);
+void trem(std::span<float> s, float a, double step, float mix);
+
+}
+
+#endif
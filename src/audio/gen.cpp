@@ -1,57 +1,28 @@
 #include "audio.h"
 
 #include <cfloat>
-#include <cmath>
 #include <numbers>
 
 #include "utils/span.h"
 
-namespace {
-
-constexpr auto pi = std::numbers::pi_v<float>;
-constexpr auto w = 2.0f * pi;
-
-void fade(std::span<float> s, std::size_t ep, float g0, float g1, auto &&f) {
-    for(std::size_t i = 0, n = s.size(); i != n; ++i) {
-        const auto t = static_cast<float>(i) / static_cast<float>(ep);
-        s[i] *= std::lerp(g0, g1, f(t));
-    }
-}
-
-void sine(std::span<float> s, std::size_t rate, auto &&f) {
-    const auto t = w / static_cast<float>(rate);
-    for(std::size_t i = 0, n = s.size(); i != n; ++i)
-        s[i] += std::sin(f(static_cast<float>(i) * t));
-}
-
-}
+#include "dsp.h"
 
 namespace nngn {
 
-void Audio::gain(std::span<float> s, float g) {
-    for(auto &x : s)
-        x *= g;
-}
+void Audio::gain(std::span<float> s, float g) { dsp::gain(s, g); }
 
 void Audio::over(std::span<float> s, float m, float mix) {
-    for(auto &x : s) {
-        const auto o = -std::copysign(1.0f, x)
-            * (1.0f - std::exp(-std::abs(m * x)));
-        x = std::lerp(x, o, mix);
-    }
+    dsp::over(s, m, mix);
 }
 
 void Audio::fade(std::span<float> s, float g0, float g1) {
-    ::fade(s, s.size(), g0, g1, std::identity{});
+    dsp::fade(s, s.size(), g0, g1);
 }
 
 void Audio::exp_fade(
     std::span<float> s, std::size_t ep, float g0, float g1, float e
 ) {
-    if(g0 <= g1)
-        ::fade(s, ep, g0, g1, [e](auto x) { return std::pow(x, e); });
-    else
-        ::fade(s, ep, g1, g0, [e](auto x) { return std::pow(1 - x, e); });
+    dsp::exp_fade(s, ep, g0, g1, e);
 }
 
 void Audio::env(
@@ -70,51 +41,36 @@ void Audio::env(
 }
 
 void Audio::mix(std::span<float> dst, std::span<const float> src) {
-    assert(src.size() <= dst.size());
-    for(std::size_t i = 0, n = src.size(); i != n; ++i)
-        dst[i] += src[i];
+    dsp::mix(dst, src);
 }
 
 void Audio::normalize(std::span<i16> dst, std::span<const float> src) {
-    assert(src.size() == dst.size());
-    constexpr auto max = static_cast<float>(INT16_MAX);
-    for(std::size_t i = 0, n = src.size(); i != n; ++i)
-        dst[i] = static_cast<i16>(max * src[i]);
+    dsp::normalize(dst, src);
 }
 
 void Audio::trem(std::span<float> s, float a, float freq, float mix) const {
-    const auto t = freq * w / static_cast<float>(this->m_rate);
-    for(std::size_t i = 0, n = s.size(); i != n; ++i) {
-        const auto tr = s[i] * a * std::sin(static_cast<float>(i) * t);
-        s[i] = std::lerp(s[i], tr, mix);
-    }
+    dsp::trem(s, a, this->step(freq), mix);
 }
 
 void Audio::gen_sine(std::span<float> s, float freq) const {
-    ::sine(s, this->m_rate, [freq](auto t) { return freq * t; });
+    dsp::sine(s, 0, this->step(freq));
 }
 
 void Audio::gen_sine_fm(
     std::span<float> s, float freq, float lfo_a, float lfo_freq, float lfo_d
 ) const {
-    ::sine(s, this->m_rate, [freq, lfo_a, lfo_freq, lfo_d](auto t) {
-        const auto fm = lfo_a * std::sin(lfo_freq * (t + lfo_d));
-        return freq * (t + fm);
-    });
+    constexpr auto w = 2.0 * std::numbers::pi;
+    dsp::sine_fm(
+        s, this->step(freq), freq * lfo_a,
+        static_cast<double>(lfo_freq * lfo_d) / w, this->step(lfo_freq));
 }
 
 void Audio::gen_square(std::span<float> s, float freq) const {
-    const auto r = static_cast<float>(this->m_rate);
-    const auto m = r / 2.0f;
-    for(std::size_t i = 0; i != s.size(); ++i)
-        s[i] += std::copysign(
-            1.0f, m - std::fmod(static_cast<float>(i) * freq, r));
+    dsp::square(s, 0, this->step(freq));
 }
 
 void Audio::gen_saw(std::span<float> s, float freq) const {
-    const auto r = static_cast<float>(this->m_rate);
-    for(std::size_t i = 0; i != s.size(); ++i)
-        s[i] += 2.0f * std::fmod(static_cast<float>(i) * freq, r) / r - 1.0f;
+    dsp::saw(s, 0, this->step(freq));
 }
 
 void Audio::gen_noise(std::span<float> s) const {
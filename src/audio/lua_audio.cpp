@@ -1,4 +1,5 @@
 #include "lua/function.h"
+#include "lua/iter.h"
 #include "lua/register.h"
 #include "lua/table.h"
 #include "math/lua_vector.h"
@@ -99,14 +100,25 @@ bool read_wav(const Audio &a, std::string_view path, bvec *v) {
     return a.read_wav(path, v);
 }
 
-bool init(Audio &a, nngn::Math *m, lua_Integer rate) {
-    return a.init(m, nngn::narrow<std::size_t>(rate));
+bool init(
+    Audio &a, nngn::Math *m, lua_Integer rate,
+    std::optional<lua_Integer> max_sources)
+{
+    return a.init(
+        m, nngn::narrow<std::size_t>(rate),
+        max_sources
+            ? nngn::narrow<std::size_t>(*max_sources)
+            : Audio::DEFAULT_MAX_SOURCES);
 }
 
 void wav_header(const Audio &a, bvec *v, const bvec &src) {
     a.gen_wav_header(*v, src);
 }
 
+auto max_sources(const Audio &a) {
+    return nngn::narrow<lua_Integer>(a.max_sources());
+}
+
 auto n_sources(const Audio &a) {
     return nngn::narrow<lua_Integer>(a.n_sources());
 }
@@ -115,10 +127,13 @@ bool set_pos(Audio &a, float x, float y, float z) {
     return a.set_pos({x, y, z});
 }
 
-std::optional<lua_Integer> add_source(Audio &a, std::optional<const bvec*> v) {
-    const auto s = v ? a.add_source(**v) : a.add_source();
-    if(const auto ret = static_cast<std::size_t>(s))
-        return ret;
+std::optional<lua_Integer> add_source(
+    Audio &a, std::optional<const bvec*> v, std::optional<lua_Integer> p)
+{
+    const auto priority = nngn::narrow<nngn::i32>(p.value_or(0));
+    const auto s = v ? a.add_source(**v, priority) : a.add_source(priority);
+    if(const auto ret = static_cast<nngn::u64>(s))
+        return nngn::narrow<lua_Integer>(ret);
     return {};
 }
 
@@ -137,6 +152,36 @@ bool set_source_pos(Audio &a, lua_Integer source, float x, float y, float z) {
     return a.set_source_pos(nngn::narrow<Audio::source>(source), {x, y, z});
 }
 
+bool set_source_priority(Audio &a, lua_Integer source, lua_Integer p) {
+    return a.set_source_priority(
+        nngn::narrow<Audio::source>(source), nngn::narrow<nngn::i32>(p));
+}
+
+/** Reads an array of source handles into \ref Audio::batch_buffer. */
+std::span<const Audio::source> sources(Audio *a, nngn::lua::table_view t) {
+    auto &ret = *a->batch_buffer();
+    ret.clear();
+    for(auto [_, x] : ipairs(t))
+        ret.push_back(nngn::narrow<Audio::source>(x.get<lua_Integer>()));
+    return ret;
+}
+
+bool play(const Audio &a, lua_Integer s) {
+    return a.play(nngn::narrow<Audio::source>(s));
+}
+
+bool stop(const Audio &a, lua_Integer s) {
+    return a.stop(nngn::narrow<Audio::source>(s));
+}
+
+bool play_batch(Audio &a, nngn::lua::table_view t) {
+    return a.play(sources(&a, t));
+}
+
+bool stop_batch(Audio &a, nngn::lua::table_view t) {
+    return a.stop(sources(&a, t));
+}
+
 int write(lua_State *L) {
     const nngn::lua::state_view lua = {L};
     return lua.get<const Audio&>(1).write_wav(
@@ -162,6 +207,7 @@ void register_audio(nngn::lua::table_view t) {
     t["read_wav"] = read_wav;
     t["init"] = init;
     t["wav_header"] = wav_header;
+    t["max_sources"] = max_sources;
     t["n_sources"] = n_sources;
     t["set_pos"] = set_pos;
     t["add_source"] = add_source;
@@ -172,8 +218,11 @@ void register_audio(nngn::lua::table_view t) {
         wrap<&Audio::set_source_sample_pos, lua_Integer>;
     t["set_source_loop"] = wrap<&Audio::set_source_loop, bool>;
     t["set_source_gain"] = wrap<&Audio::set_source_gain, float>;
-    t["play"] = wrap<&Audio::play>;
-    t["stop"] = wrap<&Audio::stop>;
+    t["set_source_priority"] = set_source_priority;
+    t["play"] = play;
+    t["stop"] = stop;
+    t["play_batch"] = play_batch;
+    t["stop_batch"] = stop_batch;
     t["source_sample_pos"] = wrap<&Audio::source_sample_pos>;
     t["write"] = write;
 }
@@ -0,0 +1,124 @@
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/table.h"
+#include "math/lua_vector.h"
+#include "utils/log.h"
+
+#include "mixer.h"
+#include "wav_stream.h"
+
+using nngn::Mixer;
+
+using bvec = nngn::lua_vector<std::byte>;
+
+NNGN_LUA_DECLARE_USER_TYPE(FILE)
+
+namespace {
+
+auto voice(lua_Integer i) { return nngn::narrow<Mixer::voice>(i); }
+
+bool init(Mixer &m, lua_Integer rate, lua_Integer period, lua_Integer n) {
+    return m.init(
+        nngn::narrow<std::size_t>(rate),
+        nngn::narrow<std::size_t>(period),
+        nngn::narrow<std::size_t>(n));
+}
+
+bool set_sink_null(Mixer &m, bool realtime) {
+    return m.set_sink(std::make_unique<nngn::NullSink>(realtime));
+}
+
+/** The file must remain open until the sink is replaced. */
+int set_sink_wav(lua_State *L) {
+    const nngn::lua::state_view lua = {L};
+    auto *const f = *nngn::chain_cast<FILE**, void*>(lua.get(2));
+    lua.push(lua.get<Mixer&>(1).set_sink(std::make_unique<nngn::WAVSink>(f)));
+    return 1;
+}
+
+bool set_sink_openal(Mixer &m, lua_Integer n) {
+    return m.set_sink(
+        std::make_unique<nngn::OpenALSink>(nngn::narrow<std::size_t>(n)));
+}
+
+void set_listener(Mixer &m, float x, float y, float z) {
+    m.set_listener({x, y, z});
+}
+
+auto add_voice(Mixer &m, const bvec &v) {
+    return static_cast<lua_Integer>(
+        m.add_voice(nngn::byte_cast<const float>(std::span{v})));
+}
+
+std::optional<lua_Integer> add_voice_wav(
+    Mixer &m, std::string_view path, std::optional<lua_Integer> read_ahead
+) {
+    NNGN_LOG_CONTEXT_F();
+    auto s = read_ahead
+        ? std::make_unique<nngn::WAVStream>(
+            nngn::narrow<std::size_t>(*read_ahead))
+        : std::make_unique<nngn::WAVStream>();
+    if(!s->open(path))
+        return {};
+    if(const auto r = s->rate(); r != m.rate()) {
+        nngn::Log::l()
+            << "file sample rate (" << r << ") does not match mixer rate ("
+            << m.rate() << ")\n";
+        return {};
+    }
+    return static_cast<lua_Integer>(m.add_voice(std::move(s)));
+}
+
+bool remove_voice(Mixer &m, lua_Integer v) {
+    return m.remove_voice(voice(v));
+}
+
+bool set_voice_gain(Mixer &m, lua_Integer v, float g) {
+    return m.set_voice_gain(voice(v), g);
+}
+
+bool set_voice_pos(Mixer &m, lua_Integer v, float x, float y, float z) {
+    return m.set_voice_pos(voice(v), {x, y, z});
+}
+
+bool set_voice_loop(Mixer &m, lua_Integer v, bool l) {
+    return m.set_voice_loop(voice(v), l);
+}
+
+bool play(Mixer &m, lua_Integer v) { return m.play(voice(v)); }
+bool stop(Mixer &m, lua_Integer v) { return m.stop(voice(v)); }
+bool playing(const Mixer &m, lua_Integer v) { return m.playing(voice(v)); }
+
+void register_mixer(nngn::lua::table_view t) {
+    static constexpr nngn::to<lua_Integer> cast = {};
+    t["CHANNELS"] = cast(Mixer::CHANNELS);
+    t["rate"] = [](const Mixer &m) { return cast(m.rate()); };
+    t["period"] = [](const Mixer &m) { return cast(m.period()); };
+    t["n_periods"] = [](const Mixer &m) { return cast(m.n_periods()); };
+    t["n_voices"] = [](const Mixer &m) { return cast(m.n_voices()); };
+    t["n_written"] = [](const Mixer &m) { return cast(m.n_written()); };
+    t["running"] = &Mixer::running;
+    t["init"] = init;
+    t["set_sink_null"] = set_sink_null;
+    t["set_sink_wav"] = set_sink_wav;
+    t["set_sink_openal"] = set_sink_openal;
+    t["set_listener"] = set_listener;
+    t["set_gain"] = &Mixer::set_gain;
+    t["add_voice"] = add_voice;
+    t["add_voice_wav"] = add_voice_wav;
+    t["remove_voice"] = remove_voice;
+    t["set_voice_gain"] = set_voice_gain;
+    t["set_voice_pos"] = set_voice_pos;
+    t["set_voice_loop"] = set_voice_loop;
+    t["play"] = play;
+    t["stop"] = stop;
+    t["playing"] = playing;
+    t["update"] = &Mixer::update;
+    t["start_thread"] = &Mixer::start_thread;
+    t["stop_thread"] = &Mixer::stop_thread;
+}
+
+}
+
+NNGN_LUA_DECLARE_USER_TYPE(Mixer)
+NNGN_LUA_PROXY(Mixer, register_mixer)
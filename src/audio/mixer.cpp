@@ -0,0 +1,383 @@
+#include "mixer.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+
+#include "math/math.h"
+#include "os/platform.h"
+#include "timing/trace.h"
+#include "utils/log.h"
+
+#include "dsp.h"
+#include "wav.h"
+
+namespace {
+
+/** Same range as \ref nngn::VoicePool generations. */
+constexpr nngn::u32 MAX_GEN = INT32_MAX;
+
+}
+
+namespace nngn {
+
+bool Mixer::Sink::init(std::size_t, std::size_t) { return true; }
+
+Mixer::~Mixer(void) { this->stop_thread(); }
+
+void Mixer::to_i16(std::span<i16> dst, std::span<const float> src) {
+    dsp::normalize(dst, src);
+}
+
+bool Mixer::init(std::size_t rate, std::size_t period, std::size_t n_periods) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    assert(!this->running());
+    if(!rate || !period || !n_periods) {
+        Log::l()
+            << "invalid configuration: " << rate << ' ' << period << ' '
+            << n_periods << '\n';
+        return false;
+    }
+    this->m_rate = rate;
+    this->m_period = period;
+    this->m_n_periods = n_periods;
+    this->tmp.resize(period);
+    this->ring.resize(n_periods * period * Mixer::CHANNELS);
+    this->ring_w = this->ring_r = 0;
+    if(this->voices.empty())
+        this->voices.emplace_back();
+    return !this->sink || this->sink->init(rate, period);
+}
+
+std::size_t Mixer::n_voices(void) const {
+    const auto lock = std::lock_guard{this->m};
+    return static_cast<std::size_t>(std::ranges::count_if(
+        this->voices, [](const auto &x) { return x.active; }));
+}
+
+bool Mixer::set_sink(std::unique_ptr<Sink> s) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    assert(!this->running());
+    this->sink = std::move(s);
+    this->ring_w = this->ring_r;
+    return !this->sink || !this->m_rate
+        || this->sink->init(this->m_rate, this->m_period);
+}
+
+void Mixer::set_listener(vec3 p) {
+    const auto lock = std::lock_guard{this->m};
+    this->listener = p;
+}
+
+void Mixer::set_gain(float g) {
+    const auto lock = std::lock_guard{this->m};
+    this->gain = g;
+}
+
+auto Mixer::get(voice v) -> voice_data* {
+    const auto u = static_cast<u64>(v);
+    const auto i = static_cast<std::size_t>(u & UINT32_MAX);
+    if(!i || this->voices.size() <= i
+            || !this->voices[i].active || this->voices[i].gen != u >> 32) {
+        Log::l() << "invalid voice: " << u << '\n';
+        return nullptr;
+    }
+    return &this->voices[i];
+}
+
+auto Mixer::get(voice v) const -> const voice_data* {
+    return const_cast<Mixer*>(this)->get(v);
+}
+
+auto Mixer::add_voice(Fn f, void *p) -> voice {
+    const auto lock = std::lock_guard{this->m};
+    auto &v = this->voices;
+    const auto it = std::find_if(
+        begin(v) + 1, end(v), [](const auto &x) { return !x.active; });
+    const auto i = static_cast<std::size_t>(it - begin(v));
+    assert(i <= UINT32_MAX);
+    if(it == end(v))
+        v.emplace_back();
+    const auto gen = v[i].gen;
+    v[i] = {.f = f, .p = p, .gen = gen, .active = true};
+    return static_cast<voice>(u64{gen} << 32 | i);
+}
+
+auto Mixer::add_voice(std::span<const float> s) -> voice {
+    auto buffer = std::vector<float>(begin(s), end(s));
+    const auto ret = this->add_voice(nullptr, nullptr);
+    const auto lock = std::lock_guard{this->m};
+    this->get(ret)->buffer = std::move(buffer);
+    return ret;
+}
+
+auto Mixer::add_voice(std::unique_ptr<Stream> s) -> voice {
+    const auto ret = this->add_voice(nullptr, nullptr);
+    const auto lock = std::lock_guard{this->m};
+    this->get(ret)->stream = std::move(s);
+    return ret;
+}
+
+bool Mixer::remove_voice(voice v) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    const auto lock = std::lock_guard{this->m};
+    auto *const d = this->get(v);
+    if(!d)
+        return false;
+    // Slots are kept so that their generation is not lost.
+    const auto gen = d->gen;
+    *d = {};
+    d->gen = gen == MAX_GEN ? 1 : gen + 1;
+    return true;
+}
+
+bool Mixer::set_voice_gain(voice v, float g) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    const auto lock = std::lock_guard{this->m};
+    auto *const d = this->get(v);
+    return d && (d->gain = g, true);
+}
+
+bool Mixer::set_voice_pos(voice v, vec3 p) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    const auto lock = std::lock_guard{this->m};
+    auto *const d = this->get(v);
+    return d && (d->pos3 = p, true);
+}
+
+bool Mixer::set_voice_loop(voice v, bool l) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    const auto lock = std::lock_guard{this->m};
+    auto *const d = this->get(v);
+    return d && (d->loop = l, true);
+}
+
+bool Mixer::play(voice v) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    const auto lock = std::lock_guard{this->m};
+    auto *const d = this->get(v);
+    return d && (d->playing = true);
+}
+
+bool Mixer::stop(voice v) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    const auto lock = std::lock_guard{this->m};
+    auto *const d = this->get(v);
+    return d && (d->playing = false, Mixer::rewind(d), true);
+}
+
+bool Mixer::playing(voice v) const {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    const auto lock = std::lock_guard{this->m};
+    const auto *const d = this->get(v);
+    return d && d->playing;
+}
+
+void Mixer::rewind(voice_data *v) {
+    v->pos = 0;
+    if(v->stream)
+        v->stream->seek(0);
+}
+
+std::size_t Mixer::fill(voice_data *v, std::span<float> s) {
+    if(v->f)
+        return v->f(v->p, s);
+    if(const auto &st = v->stream) {
+        auto ret = st->read(s);
+        while(ret != s.size() && v->loop && st->seek(0)) {
+            const auto n = st->read(s.subspan(ret));
+            if(!n)
+                break;
+            ret += n;
+        }
+        return ret;
+    }
+    const auto &b = v->buffer;
+    std::size_t ret = 0;
+    while(ret != s.size()) {
+        if(v->pos == b.size()) {
+            if(!v->loop || b.empty())
+                break;
+            v->pos = 0;
+        }
+        const auto n = std::min(s.size() - ret, b.size() - v->pos);
+        std::copy_n(b.data() + v->pos, n, s.data() + ret);
+        v->pos += n;
+        ret += n;
+    }
+    return ret;
+}
+
+void Mixer::mix(std::span<float> s) {
+    constexpr auto quarter_pi = std::numbers::pi_v<float> / 4;
+    assert(s.size() == this->m_period * Mixer::CHANNELS);
+    std::ranges::fill(s, 0.0f);
+    const auto lock = std::lock_guard{this->m};
+    const auto t = std::span{this->tmp};
+    for(auto &v : this->voices) {
+        if(!v.playing)
+            continue;
+        const auto n = this->fill(&v, t);
+        const bool end =
+            !v.f && !v.stream && !v.loop && v.pos == v.buffer.size();
+        if(n < t.size() || end)
+            v.playing = false, Mixer::rewind(&v);
+        // Inverse distance attenuation (as OpenAL's default model) and
+        // equal-power panning on the horizontal axis.
+        const auto d = v.pos3 - this->listener;
+        const auto dist = Math::length(d);
+        const auto g = this->gain * v.gain
+            * Mixer::REF_DISTANCE / std::max(Mixer::REF_DISTANCE, dist);
+        const auto a = quarter_pi * (1.0f + (dist > 0 ? d.x / dist : 0.0f));
+        const auto gl = g * std::cos(a), gr = g * std::sin(a);
+        for(std::size_t i = 0; i != n; ++i) {
+            s[Mixer::CHANNELS * i] += gl * t[i];
+            s[Mixer::CHANNELS * i + 1] += gr * t[i];
+        }
+    }
+}
+
+std::span<float> Mixer::ring_entry(u64 i) {
+    const auto n = this->m_period * Mixer::CHANNELS;
+    const auto o = static_cast<std::size_t>(i % this->m_n_periods) * n;
+    return std::span{this->ring}.subspan(o, n);
+}
+
+bool Mixer::update(void) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    const auto produce = [this] {
+        while(this->ring_w - this->ring_r < this->m_n_periods)
+            this->mix(this->ring_entry(this->ring_w++));
+    };
+    produce();
+    if(!this->sink)
+        return true;
+    for(auto n = this->sink->available(); n && this->ring_r != this->ring_w;) {
+        if(!this->sink->write(this->ring_entry(this->ring_r++)))
+            return false;
+        ++this->written;
+        --n;
+    }
+    produce();
+    return true;
+}
+
+bool Mixer::start_thread(void) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    if constexpr(Platform::emscripten)
+        return Log::l() << "threads are not supported\n", false;
+    if(this->running())
+        return true;
+    if(!this->m_rate)
+        return Log::l() << "not initialized\n", false;
+    this->exit = false;
+    this->thread = std::thread{&Mixer::run, this};
+    return true;
+}
+
+void Mixer::stop_thread(void) {
+    if(!this->running())
+        return;
+    {
+        const auto lock = std::lock_guard{this->thread_m};
+        this->exit = true;
+    }
+    this->cv.notify_all();
+    this->thread.join();
+}
+
+void Mixer::run(void) {
+    NNGN_LOG_CONTEXT_CF(Mixer);
+    Trace::set_thread_name("audio");
+    // Wake up twice per period so that the sink is never starved.
+    const auto wait = std::chrono::duration<double>{
+        static_cast<double>(this->m_period)
+            / static_cast<double>(2 * this->m_rate)};
+    auto lock = std::unique_lock{this->thread_m};
+    while(!this->exit) {
+        lock.unlock();
+        const bool ok = this->update();
+        lock.lock();
+        if(!ok) {
+            Log::l() << "update failed, stopping audio thread\n";
+            break;
+        }
+        this->cv.wait_for(lock, wait, [this] { return this->exit; });
+    }
+}
+
+bool NullSink::init(std::size_t rate, std::size_t p) {
+    this->start = clock::now();
+    this->period = std::chrono::duration_cast<clock::duration>(
+        std::chrono::duration<double>{
+            static_cast<double>(p) / static_cast<double>(rate)});
+    this->n = 0;
+    return true;
+}
+
+std::size_t NullSink::available(void) {
+    if(!this->realtime)
+        return std::numeric_limits<std::size_t>::max();
+    // Accept one period ahead of the simulated device.
+    const auto dt = clock::now() - this->start;
+    const auto t = static_cast<u64>(dt / this->period);
+    return static_cast<std::size_t>(std::max(t + 1, this->n) - this->n);
+}
+
+bool NullSink::write(std::span<const float>) {
+    ++this->n;
+    return true;
+}
+
+WAVSink::~WAVSink(void) { this->finish(); }
+
+bool WAVSink::init(std::size_t rate, std::size_t period) {
+    NNGN_LOG_CONTEXT_CF(WAVSink);
+    assert(this->f);
+    this->tmp.resize(period * Mixer::CHANNELS);
+    this->r = rate;
+    this->size = 0;
+    if((this->offset = std::ftell(this->f)) == -1)
+        return Log::perror("ftell"), false;
+    std::array<std::byte, WAV::HEADER_SIZE> h = {};
+    if(std::fwrite(h.data(), 1, h.size(), this->f) != h.size())
+        return Log::perror("fwrite"), false;
+    return true;
+}
+
+bool WAVSink::write(std::span<const float> s) {
+    NNGN_LOG_CONTEXT_CF(WAVSink);
+    assert(s.size() == this->tmp.size());
+    Mixer::to_i16(this->tmp, s);
+    if(std::fwrite(this->tmp.data(), sizeof(i16), s.size(), this->f)
+            != s.size())
+        return Log::perror("fwrite"), false;
+    this->size += s.size() * sizeof(i16);
+    return true;
+}
+
+bool WAVSink::finish(void) {
+    NNGN_LOG_CONTEXT_CF(WAVSink);
+    if(!this->f || !this->r)
+        return true;
+    std::array<std::byte, WAV::HEADER_SIZE> h = {};
+    const auto wav = WAV{std::span{h}};
+    wav.set_size(narrow<u32>(this->size));
+    wav.set_channels(static_cast<u16>(Mixer::CHANNELS));
+    wav.set_rate(narrow<u32>(this->r));
+    wav.fill();
+    this->r = 0;
+    if(std::fseek(this->f, this->offset, SEEK_SET) == -1)
+        return Log::perror("fseek"), false;
+    if(std::fwrite(h.data(), 1, h.size(), this->f) != h.size())
+        return Log::perror("fwrite"), false;
+    if(std::fseek(this->f, 0, SEEK_END) == -1)
+        return Log::perror("fseek"), false;
+    return true;
+}
+
+}
@@ -0,0 +1,226 @@
+#ifndef NNGN_AUDIO_MIXER_H
+#define NNGN_AUDIO_MIXER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "math/vec3.h"
+#include "utils/def.h"
+#include "utils/utils.h"
+
+namespace nngn {
+
+/**
+ * Block-based streaming software mixer.
+ *
+ * Audio is produced in fixed-size periods of \ref period frames.  Each period
+ * is the sum of all playing voices, attenuated by their gain and by the
+ * distance to the listener and panned according to their position relative
+ * to it, stored as interleaved stereo samples.  Voices either play a buffer
+ * owned by the mixer or call a function which generates (or decodes) their
+ * samples on demand, so that long tracks do not have to be materialized in
+ * memory.
+ *
+ * Mixed periods are stored in a ring of \ref n_periods entries and handed to
+ * the current \ref Sink as it becomes ready to accept them.  \ref update
+ * performs one iteration of this process on the calling thread, \ref start
+ * executes it continuously on a dedicated audio thread.  Voices can be
+ * manipulated from any thread while the mixer is running.
+ *
+ * Voices are referred to by generation-checked handles, in the same format as
+ * those of \ref VoicePool, so that handles to removed voices are rejected even
+ * after their slot is reused.
+ */
+class Mixer {
+public:
+    enum class voice : u64 {};
+    /**
+     * Generates the next samples of a voice.
+     * Called on the audio thread with the opaque pointer given on creation
+     * and a span which should be filled with mono samples.  Returning less
+     * than `s.size()` samples stops the voice.  Called with the mixer locked,
+     * so it must not call any of its member functions.
+     */
+    using Fn = std::size_t(*)(void *p, std::span<float> s);
+    /**
+     * Source of samples owned by a voice (e.g. a file being decoded).
+     * Called on the audio thread with the mixer locked, like \ref Fn.
+     */
+    class Stream {
+    public:
+        NNGN_VIRTUAL(Stream)
+        /** Reads the next samples, fewer than `s.size()` at the end. */
+        virtual std::size_t read(std::span<float> s) = 0;
+        /** Moves to the sample at position \p i. */
+        virtual bool seek(std::size_t i) = 0;
+    };
+    /** Output device for mixed periods. */
+    class Sink {
+    public:
+        NNGN_VIRTUAL(Sink)
+        /** Called when the sink is attached to a mixer. */
+        virtual bool init(std::size_t rate, std::size_t period);
+        /** Number of periods which can be written without blocking. */
+        virtual std::size_t available(void) = 0;
+        /** Consumes one period of interleaved samples. */
+        virtual bool write(std::span<const float> s) = 0;
+    };
+    static constexpr std::size_t CHANNELS = 2;
+    /** Distance at which voices are played at their full gain. */
+    static constexpr float REF_DISTANCE = 1;
+    /** Converts samples to 16-bit PCM, clamping them to `[-1, 1]`. */
+    static void to_i16(std::span<i16> dst, std::span<const float> src);
+    Mixer(void) = default;
+    NNGN_NO_MOVE(Mixer)
+    ~Mixer(void);
+    /**
+     * Initializes the mixer.
+     * Must be called before any other member function, while the mixer is
+     * not running.
+     */
+    bool init(std::size_t rate, std::size_t period, std::size_t n_periods);
+    std::size_t rate(void) const { return this->m_rate; }
+    std::size_t period(void) const { return this->m_period; }
+    std::size_t n_periods(void) const { return this->m_n_periods; }
+    /** Number of active (created and not removed) voices. */
+    std::size_t n_voices(void) const;
+    /** Total number of periods written to the sink. */
+    u64 n_written(void) const { return this->written.load(); }
+    /** Replaces the sink, must be called while the mixer is not running. */
+    bool set_sink(std::unique_ptr<Sink> s);
+    void set_listener(vec3 p);
+    void set_gain(float g);
+    /** Adds a voice which streams samples from \p f. */
+    voice add_voice(Fn f, void *p);
+    /** Adds a voice which plays a copy of the samples in \p s. */
+    voice add_voice(std::span<const float> s);
+    /** Adds a voice which plays samples read from \p s. */
+    voice add_voice(std::unique_ptr<Stream> s);
+    bool remove_voice(voice v);
+    bool set_voice_gain(voice v, float g);
+    bool set_voice_pos(voice v, vec3 p);
+    /** Whether a buffer/stream voice restarts once it reaches its end. */
+    bool set_voice_loop(voice v, bool l);
+    bool play(voice v);
+    bool stop(voice v);
+    bool playing(voice v) const;
+    /** Mixes the next period of all playing voices into \p s. */
+    void mix(std::span<float> s);
+    /**
+     * Fills free entries in the ring and writes them to the sink.
+     * Must not be called while the audio thread is running.
+     */
+    bool update(void);
+    bool running(void) const { return this->thread.joinable(); }
+    /** Starts the audio thread, which calls \ref update until stopped. */
+    bool start_thread(void);
+    /** Stops and joins the audio thread. */
+    void stop_thread(void);
+private:
+    struct voice_data {
+        Fn f = {};
+        void *p = {};
+        std::vector<float> buffer = {};
+        std::unique_ptr<Stream> stream = {};
+        std::size_t pos = 0;
+        vec3 pos3 = {};
+        float gain = 1;
+        /** Incremented when the voice is removed, see \ref voice. */
+        u32 gen = 1;
+        bool active = false, playing = false, loop = false;
+    };
+    voice_data *get(voice v);
+    const voice_data *get(voice v) const;
+    std::size_t fill(voice_data *v, std::span<float> s);
+    static void rewind(voice_data *v);
+    std::span<float> ring_entry(u64 i);
+    void run(void);
+    std::size_t m_rate = 0, m_period = 0, m_n_periods = 0;
+    std::unique_ptr<Sink> sink = {};
+    /** Guards voices and the listener, which are accessed by \ref mix. */
+    mutable std::mutex m = {};
+    std::vector<voice_data> voices = {};
+    /** Mono samples of the voice being mixed. */
+    std::vector<float> tmp = {};
+    std::vector<float> ring = {};
+    /** Number of periods mixed into and written from \ref ring. */
+    u64 ring_w = 0, ring_r = 0;
+    std::atomic<u64> written = 0;
+    vec3 listener = {};
+    float gain = 1;
+    std::thread thread = {};
+    std::mutex thread_m = {};
+    std::condition_variable cv = {};
+    bool exit = false;
+};
+
+/** Sink which discards all samples. */
+class NullSink final : public Mixer::Sink {
+public:
+    /**
+     * \param rt
+     *     Accept periods at the rate they would be played by a real device,
+     *     otherwise accept them as fast as they are produced.
+     */
+    explicit NullSink(bool rt) : realtime{rt} {}
+    bool init(std::size_t rate, std::size_t period) final;
+    std::size_t available(void) final;
+    bool write(std::span<const float> s) final;
+private:
+    using clock = std::chrono::steady_clock;
+    clock::time_point start = {};
+    clock::duration period = {};
+    u64 n = 0;
+    bool realtime;
+};
+
+/**
+ * Sink which writes 16-bit PCM samples to a WAV file.
+ * The header is completed once the sink is destroyed or \ref finish is
+ * called.  The file must be seekable and remain open until then.
+ */
+class WAVSink final : public Mixer::Sink {
+public:
+    explicit WAVSink(FILE *file) : f{file} {}
+    NNGN_NO_MOVE(WAVSink)
+    ~WAVSink(void) final;
+    bool init(std::size_t rate, std::size_t period) final;
+    std::size_t available(void) final { return 1; }
+    bool write(std::span<const float> s) final;
+    /** Writes the final header, the sink can no longer be used. */
+    bool finish(void);
+private:
+    FILE *f = nullptr;
+    std::vector<i16> tmp = {};
+    std::size_t r = 0;
+    u64 size = 0;
+    long offset = 0;
+};
+
+/** Sink which plays samples using the OpenAL source queue. */
+class OpenALSink final : public Mixer::Sink {
+public:
+    /** \param n_buffers Number of buffers queued in the source. */
+    explicit OpenALSink(std::size_t n_buffers) : n{n_buffers} {}
+    NNGN_NO_MOVE(OpenALSink)
+    ~OpenALSink(void) final;
+    bool init(std::size_t rate, std::size_t period) final;
+    std::size_t available(void) final;
+    bool write(std::span<const float> s) final;
+private:
+    std::vector<i16> tmp = {};
+    std::vector<unsigned> buffers = {};
+    std::size_t n, queued = 0, r = 0;
+    unsigned source = 0;
+};
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "audio.h"
+#include "mixer.h"
 
 #include "os/platform.h"
 #include "utils/log.h"
@@ -6,7 +7,7 @@
 #ifndef NNGN_PLATFORM_HAS_OPENAL
 namespace nngn {
 
-bool Audio::init_openal(void) {
+bool Audio::init_openal(std::size_t) {
     NNGN_LOG_CONTEXT_CF(Audio);
     Log::l() << "compiled without audio support\n";
     return true;
@@ -19,10 +20,12 @@ bool Audio::read_wav(std::string_view, std::vector<std::byte>*) const {
 }
 
 Audio::~Audio(void) {}
+std::size_t Audio::max_sources(void) const { return 0; }
 std::size_t Audio::n_sources(void) const { return 0; }
 bool Audio::set_pos(vec3) { return true; }
-auto Audio::add_source(void) -> source { return {}; }
-auto Audio::add_source(std::span<const std::byte>) -> source { return {}; }
+auto Audio::add_source(i32) -> source { return {}; }
+auto Audio::add_source(std::span<const std::byte>, i32) -> source
+    { return {}; }
 bool Audio::remove_source(source) { return true; }
 vec3 Audio::source_pos(source) const { return {}; }
 std::size_t Audio::source_sample_pos(source) const { return 0; }
@@ -30,8 +33,11 @@ bool Audio::set_source_pos(source, vec3) { return true; }
 bool Audio::set_source_sample_pos(source, std::size_t) { return true; }
 bool Audio::set_source_loop(source, bool) { return true; }
 bool Audio::set_source_gain(source, float) { return true; }
+bool Audio::set_source_priority(source, i32) { return true; }
 bool Audio::play(source) const { return true; }
 bool Audio::stop(source) const { return true; }
+bool Audio::play(std::span<const source>) const { return true; }
+bool Audio::stop(std::span<const source>) const { return true; }
 
 bool Audio::set_source_data(
     source, std::size_t, std::size_t, std::span<const std::byte>)
@@ -39,6 +45,17 @@ bool Audio::set_source_data(
     return true;
 }
 
+OpenALSink::~OpenALSink(void) {}
+
+bool OpenALSink::init(std::size_t, std::size_t) {
+    NNGN_LOG_CONTEXT_CF(OpenALSink);
+    Log::l() << "compiled without audio support\n";
+    return false;
+}
+
+std::size_t OpenALSink::available(void) { return 0; }
+bool OpenALSink::write(std::span<const float>) { return false; }
+
 }
 #else
 #include <climits>
@@ -62,19 +79,14 @@ static_assert(AL_FORMAT_STEREO8 + 1 == AL_FORMAT_STEREO16);
 
 namespace {
 
-struct Source {
-    static_assert(sizeof(ALuint) <= sizeof(std::uintptr_t));
-    std::uintptr_t id;
-    std::size_t n;
-    ALuint buffer;
-    constexpr ALuint al_id(void) const { return static_cast<ALuint>(this->id); }
-};
-
 struct Data {
     ALCdevice *dev = nullptr;
     ALCcontext *ctx = nullptr;
-    std::vector<ALuint> buffers = {};
-    std::vector<Source> sources = {};
+    nngn::VoicePool pool = {};
+    /** OpenAL source and buffer names of each slot in \ref pool. */
+    std::vector<ALuint> sources = {}, buffers = {};
+    /** Temporary storage for batch operations. */
+    std::vector<ALuint> tmp = {};
 };
 
 bool check_openal(const char *msg) {
@@ -111,13 +123,54 @@ bool check_openal_ctx(ALCdevice *dev, const char *msg) {
     return false;
 }
 
-ALuint source_id(const auto &d, nngn::Audio::source i) {
-    return static_cast<Data*>(d.get())
-        ->sources[static_cast<std::size_t>(i)].al_id();
+Data *get_data(const auto &p) { return static_cast<Data*>(p.get()); }
+
+std::optional<std::size_t> slot(const Data &d, nngn::Audio::source s) {
+    const auto ret = d.pool.index(s);
+    if(!ret)
+        nngn::Log::l()
+            << "invalid source: " << static_cast<nngn::u64>(s) << '\n';
+    return ret;
+}
+
+ALuint source_id(const auto &d, nngn::Audio::source s) {
+    const auto *const p = get_data(d);
+    const auto i = slot(*p, s);
+    return i ? p->sources[*i] : 0;
+}
+
+/** Collects the names of all valid sources in \c Data::tmp. */
+bool source_ids(Data *d, std::span<const nngn::Audio::source> s) {
+    bool ret = true;
+    d->tmp.clear();
+    for(const auto x : s) {
+        if(const auto i = slot(*d, x))
+            d->tmp.push_back(d->sources[*i]);
+        else
+            ret = false;
+    }
+    return ret;
+}
+
+bool is_playing(ALuint id) {
+    ALint state = 0;
+    if(!LOG_RESULT(alGetSourcei, id, AL_SOURCE_STATE, &state))
+        return true;
+    return state == AL_PLAYING || state == AL_PAUSED;
 }
 
-bool delete_source(const Source &s) {
-    const auto id = s.al_id();
+/** Restores the initial state of a source when it is returned to the pool. */
+bool reset_source(ALuint id) {
+    bool ret = true;
+    ret = LOG_RESULT(alSourceStop, id) && ret;
+    ret = LOG_RESULT(alSourcei, id, AL_BUFFER, 0) && ret;
+    ret = LOG_RESULT(alSourcei, id, AL_LOOPING, AL_FALSE) && ret;
+    ret = LOG_RESULT(alSourcef, id, AL_GAIN, 1.0f) && ret;
+    ret = LOG_RESULT(alSource3f, id, AL_POSITION, 0.0f, 0.0f, 0.0f) && ret;
+    return ret;
+}
+
+bool delete_source(ALuint id) {
     bool ret = true;
     ret = LOG_RESULT(alSourceStop, id) && ret;
     ret = LOG_RESULT(alDeleteSources, 1, &id) && ret;
@@ -132,10 +185,12 @@ Audio::~Audio(void) {
     NNGN_LOG_CONTEXT_CF(Audio);
     if(!this->data)
         return;
-    auto *const d = static_cast<Data*>(this->data.get());
-    for(const auto &x : d->sources)
-        if(const auto id = x.al_id())
-            delete_source(x);
+    auto *const d = get_data(this->data);
+    for(const auto id : d->sources)
+        LOG_RESULT(alSourceStop, id);
+    if(!d->sources.empty())
+        LOG_RESULT(alDeleteSources,
+            static_cast<int>(d->sources.size()), d->sources.data());
     if(!d->buffers.empty())
         LOG_RESULT(alDeleteBuffers,
             static_cast<int>(d->buffers.size()), d->buffers.data());
@@ -144,22 +199,44 @@ Audio::~Audio(void) {
     LOG_CTX_RESULT(alcCloseDevice, d->dev, d->dev);
 }
 
+std::size_t Audio::max_sources(void) const {
+    return get_data(this->data)->pool.capacity();
+}
+
 std::size_t Audio::n_sources(void) const {
-    return static_cast<Data*>(this->data.get())->sources.size();
+    return get_data(this->data)->pool.size();
 }
 
-bool Audio::init_openal(void) {
+bool Audio::init_openal(std::size_t max_sources) {
     ALCdevice *const dev = alcOpenDevice(nullptr);
     if(!dev)
         return false;
     ALCcontext *const ctx = alcCreateContext(dev, NULL);
     if(!ctx)
         return check_openal_ctx(dev, "alcCreateContext"), false;
-    CHECK_CTX_RESULT(alcMakeContextCurrent, dev, ctx);
-    CHECK_RESULT(alListenerf, AL_GAIN, 10.0f / 6.0f);
     auto *const d = new Data{.dev = dev, .ctx = ctx};
     this->data = {d, [](void *p) { delete static_cast<Data*>(p); }};
-    d->sources.emplace_back();
+    CHECK_CTX_RESULT(alcMakeContextCurrent, dev, ctx);
+    CHECK_RESULT(alListenerf, AL_GAIN, 10.0f / 6.0f);
+    ALCint dev_max = 0;
+    CHECK_CTX_RESULT(alcGetIntegerv, dev, dev, ALC_MONO_SOURCES, 1, &dev_max);
+    // Zero if the implementation does not report a limit.
+    if(const auto m = static_cast<std::size_t>(dev_max))
+        if(m < max_sources) {
+            Log::l()
+                << "device supports " << m << " sources, requested "
+                << max_sources << '\n';
+            max_sources = m;
+        }
+    const auto n = narrow<ALsizei>(max_sources);
+    d->sources.resize(max_sources);
+    if(!LOG_RESULT(alGenSources, n, d->sources.data()))
+        return d->sources.clear(), false;
+    d->buffers.resize(max_sources);
+    if(!LOG_RESULT(alGenBuffers, n, d->buffers.data()))
+        return d->buffers.clear(), false;
+    d->tmp.reserve(max_sources);
+    d->pool.set_capacity(max_sources);
     return true;
 }
 
@@ -186,49 +263,56 @@ bool Audio::set_pos(vec3 p) {
     return LOG_RESULT(alListenerfv, AL_POSITION, &p.x);
 }
 
-auto Audio::add_source(void) -> source {
+auto Audio::add_source(i32 priority) -> source {
     NNGN_LOG_CONTEXT_CF(Audio);
-    auto *const d = static_cast<Data*>(this->data.get());
-    ALuint id = 0;
-    CHECK_RESULT(alGenSources, 1, &id);
-    auto &sources = d->sources;
-    return narrow<source>(
-        &sources.emplace_back(Source{.id = id}) - &sources.front());
+    auto *const d = get_data(this->data);
+    std::optional<std::size_t> stolen = {};
+    const auto ret = d->pool.acquire(
+        priority,
+        [d](std::size_t i) { return is_playing(d->sources[i]); },
+        &stolen);
+    if(!static_cast<bool>(ret)) {
+        Log::l() << "no source available (priority " << priority << ")\n";
+        return {};
+    }
+    if(stolen)
+        reset_source(d->sources[*stolen]);
+    return ret;
 }
 
-auto Audio::add_source(std::span<const std::byte> v) -> source {
+auto Audio::add_source(std::span<const std::byte> v, i32 priority)
+    -> source
+{
     NNGN_LOG_CONTEXT_CF(Audio);
-    const auto ret = this->add_source();
+    const auto ret = this->add_source(priority);
     if(static_cast<bool>(ret))
         this->set_source_data(ret, 1, 16, v);
     return ret;
 }
 
-bool Audio::remove_source(source i) {
+bool Audio::remove_source(source s) {
     NNGN_LOG_CONTEXT_CF(Audio);
-    auto *const d = static_cast<Data*>(this->data.get());
-    auto it = d->sources.begin() + static_cast<std::ptrdiff_t>(i);
-    bool ret = true;
-    ret = delete_source(*it);
-    ret = LOG_RESULT(alDeleteBuffers, 1, &it->buffer) && ret;
-    d->sources.erase(it);
-    d->buffers[static_cast<std::size_t>(i)] = 0;
-    return ret;
+    auto *const d = get_data(this->data);
+    const auto i = slot(*d, s);
+    if(!i)
+        return false;
+    const bool ret = reset_source(d->sources[*i]);
+    return d->pool.release(s) && ret;
 }
 
-vec3 Audio::source_pos(source i) const {
+vec3 Audio::source_pos(source s) const {
     NNGN_LOG_CONTEXT_CF(Audio);
     vec3 ret = {};
-    CHECK_RESULT(alGetSourcefv,
-        source_id(this->data, i), AL_POSITION, ret.data());
+    if(const auto id = source_id(this->data, s))
+        CHECK_RESULT(alGetSourcefv, id, AL_POSITION, ret.data());
     return ret;
 }
 
-std::size_t Audio::source_sample_pos(source i) const {
+std::size_t Audio::source_sample_pos(source s) const {
     NNGN_LOG_CONTEXT_CF(Audio);
     ALint ret = 0;
-    CHECK_RESULT(alGetSourcei,
-        source_id(this->data, i), AL_SAMPLE_OFFSET, &ret);
+    if(const auto id = source_id(this->data, s))
+        CHECK_RESULT(alGetSourcei, id, AL_SAMPLE_OFFSET, &ret);
     return static_cast<std::size_t>(ret);
 }
 
@@ -237,9 +321,10 @@ bool Audio::set_source_data(
     std::span<const std::byte> v)
 {
     NNGN_LOG_CONTEXT_CF(Audio);
-    auto *const d = static_cast<Data*>(this->data.get());
-    ALuint buffer = 0;
-    CHECK_RESULT(alGenBuffers, 1, &buffer);
+    auto *const d = get_data(this->data);
+    const auto i = slot(*d, s);
+    if(!i)
+        return false;
     ALenum format = AL_INVALID_ENUM;
     switch(channels) {
     case 1: format = AL_FORMAT_MONO8; break;
@@ -255,50 +340,130 @@ bool Audio::set_source_data(
         Log::l() << "invalid bit depth: " << bit_depth << '\n';
         return false;
     }
+    // The slot's buffer is reused, it has to be detached before it can be
+    // modified.
+    const auto id = d->sources[*i], buffer = d->buffers[*i];
+    CHECK_RESULT(alSourceStop, id);
+    CHECK_RESULT(alSourcei, id, AL_BUFFER, 0);
     CHECK_RESULT(alBufferData,
         buffer, format, v.data(), static_cast<int>(v.size()),
         static_cast<int>(this->m_rate));
-    const auto i = static_cast<std::size_t>(s);
-    auto &sources = d->sources;
-    auto &buffers = d->buffers;
-    if(buffers.size() <= i)
-        buffers.resize(sources.size());
-    buffers[i] = buffer;
-    CHECK_RESULT(alSourcei,
-        sources[i].al_id(), AL_BUFFER, static_cast<ALint>(buffer));
+    CHECK_RESULT(alSourcei, id, AL_BUFFER, static_cast<ALint>(buffer));
     return true;
 }
 
-bool Audio::set_source_pos(source i, vec3 p) {
+bool Audio::set_source_pos(source s, vec3 p) {
+    NNGN_LOG_CONTEXT_CF(Audio);
+    const auto id = source_id(this->data, s);
+    return id && LOG_RESULT(alSourcefv, id, AL_POSITION, p.data());
+}
+
+bool Audio::set_source_sample_pos(source s, std::size_t p) {
+    NNGN_LOG_CONTEXT_CF(Audio);
+    const auto id = source_id(this->data, s);
+    return id
+        && LOG_RESULT(alSourcei, id, AL_SAMPLE_OFFSET, narrow<int>(p));
+}
+
+bool Audio::set_source_loop(source s, bool l) {
+    NNGN_LOG_CONTEXT_CF(Audio);
+    const auto id = source_id(this->data, s);
+    return id && LOG_RESULT(alSourcei, id, AL_LOOPING, l);
+}
+
+bool Audio::set_source_gain(source s, float g) {
     NNGN_LOG_CONTEXT_CF(Audio);
-    return LOG_RESULT(alSourcefv,
-        source_id(this->data, i), AL_POSITION, p.data());
+    const auto id = source_id(this->data, s);
+    return id && LOG_RESULT(alSourcef, id, AL_GAIN, g);
 }
 
-bool Audio::set_source_sample_pos(source i, std::size_t p) {
+bool Audio::set_source_priority(source s, i32 p) {
     NNGN_LOG_CONTEXT_CF(Audio);
-    return LOG_RESULT(alSourcei,
-        source_id(this->data, i), AL_SAMPLE_OFFSET, narrow<int>(p));
+    auto *const d = get_data(this->data);
+    return slot(*d, s) && d->pool.set_priority(s, p);
 }
 
-bool Audio::set_source_loop(source i, bool l) {
+bool Audio::play(source s) const {
     NNGN_LOG_CONTEXT_CF(Audio);
-    return LOG_RESULT(alSourcei, source_id(this->data, i), AL_LOOPING, l);
+    const auto id = source_id(this->data, s);
+    return id && LOG_RESULT(alSourcePlay, id);
 }
 
-bool Audio::set_source_gain(source i, float g) {
+bool Audio::stop(source s) const {
     NNGN_LOG_CONTEXT_CF(Audio);
-    return LOG_RESULT(alSourcef, source_id(this->data, i), AL_GAIN, g);
+    const auto id = source_id(this->data, s);
+    return id && LOG_RESULT(alSourceStop, id);
 }
 
-bool Audio::play(source i) const {
+bool Audio::play(std::span<const source> s) const {
     NNGN_LOG_CONTEXT_CF(Audio);
-    return LOG_RESULT(alSourcePlay, source_id(this->data, i));
+    auto *const d = get_data(this->data);
+    const bool ret = source_ids(d, s);
+    const auto &v = d->tmp;
+    return (v.empty() || LOG_RESULT(alSourcePlayv,
+        narrow<ALsizei>(v.size()), v.data())) && ret;
 }
 
-bool Audio::stop(source i) const {
+bool Audio::stop(std::span<const source> s) const {
     NNGN_LOG_CONTEXT_CF(Audio);
-    return LOG_RESULT(alSourceStop, source_id(this->data, i));
+    auto *const d = get_data(this->data);
+    const bool ret = source_ids(d, s);
+    const auto &v = d->tmp;
+    return (v.empty() || LOG_RESULT(alSourceStopv,
+        narrow<ALsizei>(v.size()), v.data())) && ret;
+}
+
+OpenALSink::~OpenALSink(void) {
+    NNGN_LOG_CONTEXT_CF(OpenALSink);
+    if(this->source)
+        delete_source(this->source);
+    if(!this->buffers.empty())
+        LOG_RESULT(alDeleteBuffers,
+            static_cast<int>(this->buffers.size()), this->buffers.data());
+}
+
+bool OpenALSink::init(std::size_t rate, std::size_t period) {
+    NNGN_LOG_CONTEXT_CF(OpenALSink);
+    static_assert(std::is_same_v<ALuint, unsigned>);
+    assert(!this->source);
+    this->tmp.resize(period * Mixer::CHANNELS);
+    this->buffers.resize(this->n);
+    this->r = rate;
+    CHECK_RESULT(alGenSources, 1, &this->source);
+    CHECK_RESULT(alGenBuffers,
+        static_cast<int>(this->buffers.size()), this->buffers.data());
+    return true;
+}
+
+std::size_t OpenALSink::available(void) {
+    NNGN_LOG_CONTEXT_CF(OpenALSink);
+    if(this->queued < this->n)
+        return this->n - this->queued;
+    ALint ret = 0;
+    CHECK_RESULT(alGetSourcei, this->source, AL_BUFFERS_PROCESSED, &ret);
+    return static_cast<std::size_t>(ret);
+}
+
+bool OpenALSink::write(std::span<const float> s) {
+    NNGN_LOG_CONTEXT_CF(OpenALSink);
+    assert(s.size() == this->tmp.size());
+    Mixer::to_i16(this->tmp, s);
+    ALuint b = 0;
+    if(this->queued < this->n)
+        b = this->buffers[this->queued++];
+    else
+        CHECK_RESULT(alSourceUnqueueBuffers, this->source, 1, &b);
+    CHECK_RESULT(alBufferData,
+        b, AL_FORMAT_STEREO16, this->tmp.data(),
+        narrow<ALsizei>(this->tmp.size() * sizeof(i16)),
+        narrow<ALsizei>(this->r));
+    CHECK_RESULT(alSourceQueueBuffers, this->source, 1, &b);
+    // Also restarts the source if it stopped after running out of buffers.
+    ALint state = 0;
+    CHECK_RESULT(alGetSourcei, this->source, AL_SOURCE_STATE, &state);
+    if(state != AL_PLAYING)
+        CHECK_RESULT(alSourcePlay, this->source);
+    return true;
 }
 
 }
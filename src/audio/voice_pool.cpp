@@ -0,0 +1,74 @@
+#include "voice_pool.h"
+
+#include <cstdint>
+
+namespace {
+
+constexpr nngn::u32 MAX_GEN = INT32_MAX;
+
+}
+
+namespace nngn {
+
+void VoicePool::set_capacity(std::size_t n) {
+    assert(!this->size());
+    assert(n <= UINT32_MAX);
+    this->slots.assign(n, {.seq = 0, .priority = 0, .gen = 1, .active = false});
+    this->free.clear();
+    this->free.reserve(n);
+    for(std::size_t i = n; i--;)
+        this->free.push_back(i);
+}
+
+std::optional<std::size_t> VoicePool::index(handle h) const {
+    const auto u = static_cast<u64>(h);
+    const auto i = static_cast<std::size_t>(u & UINT32_MAX);
+    if(i >= this->slots.size())
+        return {};
+    const auto &s = this->slots[i];
+    if(!s.active || s.gen != u >> 32)
+        return {};
+    return i;
+}
+
+std::optional<i32> VoicePool::priority(handle h) const {
+    if(const auto i = this->index(h))
+        return this->slots[*i].priority;
+    return {};
+}
+
+bool VoicePool::set_priority(handle h, i32 p) {
+    const auto i = this->index(h);
+    if(!i)
+        return false;
+    this->slots[*i].priority = p;
+    return true;
+}
+
+bool VoicePool::release(handle h) {
+    const auto i = this->index(h);
+    if(!i)
+        return false;
+    this->reset(*i);
+    this->free.push_back(*i);
+    return true;
+}
+
+auto VoicePool::take(std::size_t i, i32 p) -> handle {
+    auto &s = this->slots[i];
+    assert(!s.active);
+    s.seq = this->seq++;
+    s.priority = p;
+    s.active = true;
+    return static_cast<handle>(static_cast<u64>(s.gen) << 32 | i);
+}
+
+void VoicePool::reset(std::size_t i) {
+    auto &s = this->slots[i];
+    assert(s.active);
+    s.active = false;
+    // Kept within the range of a signed 64-bit handle (e.g. `lua_Integer`).
+    s.gen = s.gen == MAX_GEN ? 1 : s.gen + 1;
+}
+
+}
@@ -0,0 +1,112 @@
+#ifndef NNGN_AUDIO_VOICE_POOL_H
+#define NNGN_AUDIO_VOICE_POOL_H
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "utils/def.h"
+
+namespace nngn {
+
+/**
+ * Fixed set of voice slots addressed by generation-checked handles.
+ *
+ * A handle contains the index of its slot in the low 32 bits and the
+ * generation of the slot in the high bits.  The generation is incremented
+ * every time a slot is released, so handles to voices which have been removed
+ * (or stolen, see below) are rejected in constant time instead of referring
+ * to whichever voice now occupies the slot.  Zero is never a valid handle.
+ *
+ * When every slot is in use, \ref acquire steals one from an existing voice:
+ * voices which are not playing are taken first, then those with the lowest
+ * priority, the oldest first.  A playing voice is never stolen for one with a
+ * lower priority.
+ */
+class VoicePool {
+public:
+    enum class handle : u64 {};
+    VoicePool(void) = default;
+    explicit VoicePool(std::size_t n) { this->set_capacity(n); }
+    std::size_t capacity(void) const { return this->slots.size(); }
+    std::size_t size(void) const
+        { return this->slots.size() - this->free.size(); }
+    bool full(void) const { return this->free.empty(); }
+    /**
+     * Resizes the pool to \p n free slots.
+     * Must be called before any handle is acquired.
+     */
+    void set_capacity(std::size_t n);
+    /** Index of the slot referred to by \p h, empty if it is not valid. */
+    std::optional<std::size_t> index(handle h) const;
+    std::optional<i32> priority(handle h) const;
+    bool set_priority(handle h, i32 p);
+    /**
+     * Reserves a slot for a new voice.
+     * \param playing
+     *     Called with slot indices to determine which voices are still
+     *     playing.  Only used when the pool is full.
+     * \param stolen
+     *     Set to the index of the slot whose voice was replaced, if any.
+     *     That voice's handle is no longer valid.
+     * \return
+     *     Handle to the new voice, or zero if the pool is full and no voice
+     *     can be stolen.
+     */
+    template<std::predicate<std::size_t> F>
+    handle acquire(
+        i32 priority, F &&playing,
+        std::optional<std::size_t> *stolen = nullptr);
+    /** Same as above, considering every voice to be playing. */
+    handle acquire(i32 priority)
+        { return this->acquire(priority, [](std::size_t) { return true; }); }
+    /** Returns the slot to the pool, invalidating \p h. */
+    bool release(handle h);
+private:
+    struct slot {
+        u64 seq;
+        i32 priority;
+        u32 gen;
+        bool active;
+    };
+    handle take(std::size_t i, i32 priority);
+    void reset(std::size_t i);
+    std::vector<slot> slots = {};
+    /** Indices of inactive slots, used as a stack. */
+    std::vector<std::size_t> free = {};
+    u64 seq = 0;
+};
+
+template<std::predicate<std::size_t> F>
+auto VoicePool::acquire(
+    i32 p, F &&playing, std::optional<std::size_t> *stolen
+) -> handle {
+    if(!this->free.empty()) {
+        const auto i = this->free.back();
+        this->free.pop_back();
+        return this->take(i, p);
+    }
+    using key = std::tuple<bool, i32, u64>;
+    std::optional<key> min = {};
+    std::size_t victim = 0;
+    for(std::size_t i = 0, n = this->slots.size(); i != n; ++i) {
+        const auto &s = this->slots[i];
+        assert(s.active);
+        const auto k = key{playing(i), s.priority, s.seq};
+        if(!min || k < *min)
+            min = k, victim = i;
+    }
+    if(!min || (std::get<0>(*min) && p < std::get<1>(*min)))
+        return {};
+    this->reset(victim);
+    if(stolen)
+        *stolen = victim;
+    return this->take(victim, p);
+}
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#include "wav_stream.h"
+
+#include <algorithm>
+
+#include "utils/log.h"
+
+#include "dsp.h"
+#include "wav.h"
+
+namespace nngn {
+
+bool WAVStream::open(std::string_view path) {
+    NNGN_LOG_CONTEXT_CF(WAVStream);
+    NNGN_LOG_CONTEXT(path.data());
+    return this->file.open(path) && this->init();
+}
+
+bool WAVStream::open(FILE *f) {
+    NNGN_LOG_CONTEXT_CF(WAVStream);
+    return this->file.open(f) && this->init();
+}
+
+bool WAVStream::init(void) {
+    const auto d = this->file.data();
+    if(d.size() < WAV::HEADER_SIZE)
+        return Log::l() << "file too short: " << d.size() << '\n', false;
+    const auto wav = WAV{d};
+    if(!wav.check())
+        return false;
+    if(const auto n = d.size() - WAV::HEADER_SIZE,
+                e = wav.n_samples() * sizeof(i16); n < e)
+        return Log::l()
+            << "data size larger than file: " << n << " < " << e << '\n',
+            false;
+    this->samples = byte_cast<const i16>(
+        d.subspan(WAV::HEADER_SIZE, wav.n_samples() * sizeof(i16)));
+    this->m_rate = wav.rate();
+    this->m_pos = 0;
+    this->prefetched = this->released = 0;
+    this->advise();
+    return true;
+}
+
+std::size_t WAVStream::read(std::span<float> s) {
+    const auto n = std::min(s.size(), this->samples.size() - this->m_pos);
+    dsp::denormalize(s.subspan(0, n), this->samples.subspan(this->m_pos, n));
+    this->m_pos += n;
+    this->advise();
+    return n;
+}
+
+bool WAVStream::seek(std::size_t i) {
+    NNGN_LOG_CONTEXT_CF(WAVStream);
+    if(this->samples.size() < i) {
+        Log::l()
+            << "invalid position: " << i
+            << " > " << this->samples.size() << '\n';
+        return false;
+    }
+    const auto r = this->released;
+    this->file.release(r, this->prefetched - r);
+    this->m_pos = i;
+    this->prefetched = this->released = 0;
+    this->advise();
+    return true;
+}
+
+void WAVStream::advise(void) {
+    const auto page = MappedFile::page_size();
+    const auto n = this->m_read_ahead;
+    const auto o = WAV::HEADER_SIZE + this->m_pos * sizeof(i16);
+    const auto o_page = o / page * page;
+    if(!this->prefetched)
+        this->prefetched = this->released = o_page;
+    // Both are done in steps of half/all of the window to limit the number of
+    // system calls.
+    if(this->prefetched < o + n / 2) {
+        const auto e = std::min(o + n, this->file.size());
+        if(this->prefetched < e)
+            this->file.prefetch(this->prefetched, e - this->prefetched);
+        this->prefetched = std::max(this->prefetched, e);
+    }
+    if(o_page - this->released >= n) {
+        this->file.release(this->released, o_page - this->released);
+        this->released = o_page;
+    }
+}
+
+}
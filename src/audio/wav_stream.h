@@ -0,0 +1,53 @@
+#ifndef NNGN_AUDIO_WAV_STREAM_H
+#define NNGN_AUDIO_WAV_STREAM_H
+
+#include <cstdio>
+#include <span>
+#include <string_view>
+
+#include "os/mapped_file.h"
+#include "utils/def.h"
+
+#include "mixer.h"
+
+namespace nngn {
+
+/**
+ * Mixer stream which plays a memory-mapped WAV file.
+ *
+ * Samples are converted directly from the mapping as they are read, so the
+ * time it takes to open a file does not depend on its size and the file is
+ * never copied to private memory.  To keep the resident portion of the file
+ * bounded, the next \ref read_ahead bytes are prefetched as playback advances
+ * and pages which have been played are released (in steps of the same size).
+ * The file has to satisfy \ref WAV::check and its sample rate should match
+ * the mixer's.
+ */
+class WAVStream final : public Mixer::Stream {
+public:
+    static constexpr std::size_t DEFAULT_READ_AHEAD = 256 * 1024;
+    WAVStream(void) = default;
+    explicit WAVStream(std::size_t read_ahead) : m_read_ahead{read_ahead} {}
+    bool open(std::string_view path);
+    /** Maps the file currently open in \p f, which can be closed later. */
+    bool open(FILE *f);
+    std::size_t rate(void) const { return this->m_rate; }
+    std::size_t read_ahead(void) const { return this->m_read_ahead; }
+    std::size_t n_samples(void) const { return this->samples.size(); }
+    std::size_t pos(void) const { return this->m_pos; }
+    std::size_t read(std::span<float> s) final;
+    bool seek(std::size_t i) final;
+private:
+    bool init(void);
+    /** Issues prefetch/release hints for the current position. */
+    void advise(void);
+    MappedFile file = {};
+    std::span<const i16> samples = {};
+    std::size_t m_rate = 0, m_read_ahead = DEFAULT_READ_AHEAD, m_pos = 0;
+    /** File offsets up to which pages have been prefetched/released. */
+    std::size_t prefetched = 0, released = 0;
+};
+
+}
+
+#endif
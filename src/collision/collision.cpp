@@ -48,8 +48,8 @@ bool Colliders::set_backend(std::unique_ptr<Backend> p) {
 }
 
 void Colliders::remove(Collider *p) {
-    const auto remove = [p]<typename T>(std::vector<T> *v) {
-        const_time_erase(v, static_cast<T*>(p));
+    const auto remove = [p]<typename V>(V *v) {
+        const_time_erase(v, static_cast<typename V::value_type*>(p));
         if(p != &*v->end())
             p->entity->collider = p;
     };
@@ -104,9 +104,9 @@ void Colliders::resolve_collisions(void) const {
             continue;
         const auto denom = c.mass0 + c.mass1;
         if(const auto f = div(c.mass1, denom); f != 0)
-            c.entity0->set_pos(c.entity0->p + f * c.force);
+            c.entity0->move(c.entity0->p + f * c.force);
         if(const auto f = div(c.mass0, denom); f != 0)
-            c.entity1->set_pos(c.entity1->p - f * c.force);
+            c.entity1->move(c.entity1->p - f * c.force);
     }
 }
 
@@ -17,6 +17,7 @@
 
 #include "lua/table.h"
 #include "timing/stats.h"
+#include "utils/alloc/accounting.h"
 #include "utils/utils.h"
 
 #include "colliders.h"
@@ -27,6 +28,7 @@ struct Entity;
 namespace nngn {
 
 struct Compute;
+class Jobs;
 struct Timing;
 
 struct Collision {
@@ -71,16 +73,18 @@ struct CollisionStats : StatsBase<CollisionStats, 4> {
 
 struct Colliders {
     struct Backend {
+        template<typename T>
+        using vector = accounted_vector<T, memory_tag::collision>;
         struct Input {
-            std::vector<AABBCollider> aabb = {};
-            std::vector<BBCollider> bb = {};
-            std::vector<SphereCollider> sphere = {};
-            std::vector<PlaneCollider> plane = {};
-            std::vector<GravityCollider> gravity = {};
+            vector<AABBCollider> aabb = {};
+            vector<BBCollider> bb = {};
+            vector<SphereCollider> sphere = {};
+            vector<PlaneCollider> plane = {};
+            vector<GravityCollider> gravity = {};
         };
         struct Output {
             CollisionStats stats = {};
-            std::vector<Collision> collisions = {};
+            vector<Collision> collisions = {};
         };
         NNGN_VIRTUAL(Backend)
         virtual bool init(void) { return true; }
@@ -102,7 +106,8 @@ private:
 public:
     using Stats = CollisionStats;
     static constexpr std::size_t STATS_IDX = 1;
-    static std::unique_ptr<Backend> native_backend();
+    /** \param jobs Used to parallelize checks, may be null. */
+    static std::unique_ptr<Backend> native_backend(Jobs *jobs = nullptr);
     static std::unique_ptr<Backend> compute_backend(Compute *c);
     NNGN_MOVE_ONLY(Colliders)
     Colliders(void);
@@ -161,7 +161,7 @@ class ComputeBackend final : public nngn::Colliders::Backend {
         nngn::Compute::Buffer b, std::size_t counter_idx,
         std::span<T> s0, std::span<U> s1,
         const nngn::Compute::Event *wait,
-        std::vector<nngn::Collision> *out);
+        nngn::Colliders::Backend::vector<nngn::Collision> *out);
     bool write_stats(const Events &events);
 public:
     NNGN_MOVE_ONLY(ComputeBackend)
@@ -605,7 +605,7 @@ bool ComputeBackend::read_collision_buffer(
     nngn::Compute::Buffer b, std::size_t counter_idx,
     std::span<T> s0, std::span<U> s1,
     const nngn::Compute::Event *wait,
-    std::vector<nngn::Collision> *out)
+    nngn::Colliders::Backend::vector<nngn::Collision> *out)
 {
     NNGN_LOG_CONTEXT_CF(ComputeBackend);
     if(s0.empty() || s1.empty())
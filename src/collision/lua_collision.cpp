@@ -1,11 +1,15 @@
+#include <cstdio>
+
 #include "entity.h"
 
 #include "compute/compute.h"
+#include "jobs/jobs.h"
 #include "lua/function.h"
 #include "lua/register.h"
 #include "lua/table.h"
 #include "lua/utils.h"
 #include "timing/stats.h"
+#include "timing/stats_stream.h"
 
 #include "collision.h"
 
@@ -15,10 +19,11 @@ using CollisionBackend = nngn::Colliders::Backend;
 NNGN_LUA_DECLARE_USER_TYPE(Entity)
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Collider, "Collider")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Compute, "Compute")
+NNGN_LUA_DECLARE_USER_TYPE(nngn::Jobs, "Jobs")
 
 namespace {
-auto native(void) {
-    return nngn::Colliders::native_backend().release();
+auto native(nngn::Jobs *jobs) {
+    return nngn::Colliders::native_backend(jobs).release();
 }
 
 auto compute(nngn::Compute *c) {
@@ -82,6 +87,13 @@ auto stats(nngn::lua::state_view lua) {
     return ret.release();
 }
 
+bool write_stats(nngn::lua::state_view lua) {
+    return nngn::StatsStream::write(
+        *nngn::chain_cast<FILE**, void*>(lua.get(1)),
+        *nngn::Stats::u64_data<Colliders>(),
+        Colliders::Stats::N_EVENTS);
+}
+
 void set_backend(Colliders &c, Colliders::Backend *p) {
     c.set_backend(std::unique_ptr<Colliders::Backend>{p});
 }
@@ -96,6 +108,7 @@ void register_colliders(nngn::lua::table_view t) {
     t["STATS_N_EVENTS"] = nngn::narrow<lua_Integer>(Colliders::Stats::N_EVENTS);
     t["stats_names"] = stats_names;
     t["stats"] = stats;
+    t["write_stats"] = write_stats;
     t["check"] = &Colliders::check;
     t["resolve"] = &Colliders::resolve;
     t["n_aabbs"] = size<&Colliders::aabb>;
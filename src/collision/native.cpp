@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <atomic>
 
 #include "collision/collision.h"
+#include "jobs/jobs.h"
 #include "math/math.h"
 #include "timing/profile.h"
 #include "utils/log.h"
@@ -16,21 +18,56 @@ using nngn::GravityCollider;
 
 namespace {
 
-void check_aabb(std::span<AABBCollider> aabb, Output *output);
-void check_bb(std::span<BBCollider> s, Output *output);
-void check_sphere(std::span<SphereCollider> s, Output *output);
+/** Collision found by a job, added to the output after all jobs finish. */
+struct pending {
+    nngn::Collider *c0, *c1;
+    nngn::vec3 v;
+};
+
+/**
+ * Distributes the outer loop of a collision check among jobs.
+ * Collisions found by each job are recorded separately and added to the
+ * output in order once all jobs finish, so results (including flags and the
+ * behavior when the maximum number of collisions is reached) are the same as
+ * those of a serial execution.  The number of recorded collisions is limited
+ * to the remaining capacity of the output: if it is exceeded, the jobs stop
+ * and the rows are processed again serially.
+ */
+class Rows {
+public:
+    /** Number of rows processed by each job. */
+    static constexpr std::size_t GRAIN = 64;
+    explicit Rows(nngn::Jobs *j) : jobs{j} {}
+    NNGN_NO_MOVE(Rows)
+    ~Rows(void) = default;
+    /**
+     * Calls `f(i, add)` for each row `i` in <tt>[0, n)</tt>.
+     * `add(c0, c1, v)` reports a collision and returns `false` if no more can
+     * be added, in which case `f` should return immediately.
+     */
+    template<typename F> void run(std::size_t n, Output *output, F &&f);
+private:
+    template<typename F>
+    static void run_serial(std::size_t n, Output *output, F &&f);
+    nngn::Jobs *jobs;
+    std::vector<Colliders::Backend::vector<pending>> chunks = {};
+};
+
+void check_aabb(Rows *rows, std::span<AABBCollider> aabb, Output *output);
+void check_bb(Rows *rows, std::span<BBCollider> s, Output *output);
+void check_sphere(Rows *rows, std::span<SphereCollider> s, Output *output);
 void check_plane(std::span<PlaneCollider> s, Output *output);
 template<typename T> void check_gravity(
     std::span<T> s, std::span<nngn::GravityCollider> gravity,
     Output *output);
 void check_aabb_bb(
-    std::span<AABBCollider> aabb, std::span<BBCollider> bb,
+    Rows *rows, std::span<AABBCollider> aabb, std::span<BBCollider> bb,
     Output *output);
 void check_aabb_sphere(
-    std::span<AABBCollider> aabb, std::span<SphereCollider> sphere,
-    Output *output);
+    Rows *rows, std::span<AABBCollider> aabb,
+    std::span<SphereCollider> sphere, Output *output);
 void check_bb_sphere(
-    std::span<BBCollider> bb, std::span<SphereCollider> sphere,
+    Rows *rows, std::span<BBCollider> bb, std::span<SphereCollider> sphere,
     Output *output);
 void check_sphere_plane(
     std::span<SphereCollider> sphere, std::span<PlaneCollider> plane,
@@ -50,24 +87,28 @@ inline bool check_bb_sphere_common(
 template<typename T, typename U>
 bool add_collision(
     T *c0, U *c1, const nngn::vec3 &v,
-    std::vector<nngn::Collision> *output);
+    Colliders::Backend::vector<nngn::Collision> *output);
 
 class NativeBackend final : public Colliders::Backend {
+public:
+    explicit NativeBackend(nngn::Jobs *j) : rows{j} {}
+private:
     bool check(const nngn::Timing &t, Input *input, Output *output) final;
+    Rows rows;
 };
 
 bool NativeBackend::check(
     const nngn::Timing&, Input *input, Output *output
 ) {
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.counters); }
-    check_aabb(input->aabb, output);
-    check_bb(input->bb, output);
-    check_sphere(input->sphere, output);
+    check_aabb(&this->rows, input->aabb, output);
+    check_bb(&this->rows, input->bb, output);
+    check_sphere(&this->rows, input->sphere, output);
     check_plane(input->plane, output);
     check_gravity(std::span{input->gravity}, input->gravity, output);
-    check_aabb_bb(input->aabb, input->bb, output);
-    check_aabb_sphere(input->aabb, input->sphere, output);
-    check_bb_sphere(input->bb, input->sphere, output);
+    check_aabb_bb(&this->rows, input->aabb, input->bb, output);
+    check_aabb_sphere(&this->rows, input->aabb, input->sphere, output);
+    check_bb_sphere(&this->rows, input->bb, input->sphere, output);
     check_sphere_plane(input->sphere, input->plane, output);
     check_gravity(std::span{input->aabb}, input->gravity, output);
     check_gravity(std::span{input->bb}, input->gravity, output);
@@ -78,13 +119,57 @@ bool NativeBackend::check(
     return true;
 }
 
-void check_aabb(std::span<AABBCollider> aabb, Output *output) {
+template<typename F>
+void Rows::run_serial(std::size_t n, Output *output, F &&f) {
+    auto *const out = &output->collisions;
+    const auto add = [out](auto *c0, auto *c1, const nngn::vec3 &v)
+        { return add_collision(c0, c1, v, out); };
+    for(std::size_t i = 0; i != n; ++i)
+        if(!f(i, add))
+            return;
+}
+
+template<typename F>
+void Rows::run(std::size_t n, Output *output, F &&f) {
+    if(!this->jobs || !this->jobs->threads() || n <= Rows::GRAIN)
+        return Rows::run_serial(n, output, FWD(f));
+    auto *const out = &output->collisions;
+    const auto n_chunks = (n + Rows::GRAIN - 1) / Rows::GRAIN;
+    if(this->chunks.size() < n_chunks)
+        this->chunks.resize(n_chunks);
+    const auto max = out->capacity() - out->size();
+    std::atomic<std::size_t> count = 0;
+    this->jobs->parallel_for("collision", n, Rows::GRAIN,
+        [this, &f, &count, max](std::size_t b, std::size_t e) {
+            auto &chunk = this->chunks[b / Rows::GRAIN];
+            chunk.clear();
+            const auto add = [&chunk, &count, max](
+                auto *c0, auto *c1, const nngn::vec3 &v
+            ) {
+                if(count.fetch_add(1, std::memory_order_relaxed) >= max)
+                    return false;
+                return chunk.push_back({c0, c1, v}), true;
+            };
+            for(auto i = b; i != e; ++i)
+                if(!f(i, add))
+                    return;
+        });
+    if(count.load(std::memory_order_relaxed) > max)
+        return Rows::run_serial(n, output, FWD(f));
+    for(std::size_t i = 0; i != n_chunks; ++i)
+        for(const auto &x : this->chunks[i])
+            if(!add_collision(x.c0, x.c1, x.v, out))
+                return;
+}
+
+void check_aabb(Rows *rows, std::span<AABBCollider> aabb, Output *output) {
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.aabb_copy); }
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.aabb_exec_barrier); }
     NNGN_STATS_CONTEXT(Colliders, &output->stats.aabb_exec);
-    for(auto i0 = begin(aabb), e = end(aabb); i0 != e; ++i0) {
+    rows->run(aabb.size(), output, [aabb](std::size_t i, auto &&add) {
+        const auto i0 = begin(aabb) + static_cast<std::ptrdiff_t>(i);
         auto &c0 = *i0;
-        for(auto i1 = i0 + 1; i1 != e; ++i1) {
+        for(auto i1 = i0 + 1, e = end(aabb); i1 != e; ++i1) {
             auto &c1 = *i1;
             if(!check_bb_fast(c0, c1))
                 continue;
@@ -97,20 +182,22 @@ void check_aabb(std::span<AABBCollider> aabb, Output *output) {
             const auto v = std::fabs(xoverlap) <= std::fabs(yoverlap)
                 ? nngn::vec3(-xoverlap, 0, 0)
                 : nngn::vec3(0, -yoverlap, 0);
-            if(!add_collision(&c0, &c1, v, &output->collisions))
-                return;
+            if(!add(&c0, &c1, v))
+                return false;
         }
-    }
+        return true;
+    });
 }
 
-void check_bb(std::span<BBCollider> bb, Output *output) {
+void check_bb(Rows *rows, std::span<BBCollider> bb, Output *output) {
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.bb_copy); }
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.bb_exec_barrier); }
     NNGN_STATS_CONTEXT(Colliders, &output->stats.bb_exec);
-    for(auto i0 = begin(bb), e = end(bb); i0 != e; ++i0) {
+    rows->run(bb.size(), output, [bb](std::size_t i, auto &&add) {
+        const auto i0 = begin(bb) + static_cast<std::ptrdiff_t>(i);
         auto &c0 = *i0;
         const auto rel_bl0 = c0.bl - c0.center, rel_tr0 = c0.tr - c0.center;
-        for(auto i1 = i0 + 1; i1 != e; ++i1) {
+        for(auto i1 = i0 + 1, e = end(bb); i1 != e; ++i1) {
             auto &c1 = *i1;
             if(!check_bb_fast(c0, c1))
                 continue;
@@ -135,13 +222,16 @@ void check_bb(std::span<BBCollider> bb, Output *output) {
             v0 = nngn::Math::length2(v0) <= nngn::Math::length2(v1)
                 ? -rotate(v0, c1.cos, c1.sin)
                 : rotate(v1, c0.cos, c0.sin);
-            if(!add_collision(&c0, &c1, {v0, 0}, &output->collisions))
-                return;
+            if(!add(&c0, &c1, {v0, 0}))
+                return false;
         }
-    }
+        return true;
+    });
 }
 
-void check_sphere(std::span<SphereCollider> sphere, Output *output) {
+void check_sphere(
+    Rows *rows, std::span<SphereCollider> sphere, Output *output
+) {
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.sphere_pos); }
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.sphere_vel); }
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.sphere_mass); }
@@ -151,9 +241,10 @@ void check_sphere(std::span<SphereCollider> sphere, Output *output) {
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.sphere_exec_grid); }
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.sphere_exec_barrier); }
     NNGN_STATS_CONTEXT(Colliders, &output->stats.sphere_exec);
-    for(auto i0 = begin(sphere), e = end(sphere); i0 != e; ++i0) {
+    rows->run(sphere.size(), output, [sphere](std::size_t i, auto &&add) {
+        const auto i0 = begin(sphere) + static_cast<std::ptrdiff_t>(i);
         auto &c0 = *i0;
-        for(auto i1 = i0 + 1; i1 != e; ++i1) {
+        for(auto i1 = i0 + 1, e = end(sphere); i1 != e; ++i1) {
             auto &c1 = *i1;
             const auto d = c0.pos - c1.pos;
             const auto r = c0.r + c1.r;
@@ -162,10 +253,11 @@ void check_sphere(std::span<SphereCollider> sphere, Output *output) {
                 continue;
             const auto l = std::sqrt(l2);
             const auto v = (r - l) / l * d;
-            if(!add_collision(&c0, &c1, v, &output->collisions))
-                return;
+            if(!add(&c0, &c1, v))
+                return false;
         }
-    }
+        return true;
+    });
 }
 
 void check_plane(std::span<PlaneCollider>, Output *output) {
@@ -207,14 +299,15 @@ void check_plane(std::span<PlaneCollider>, Output *output) {
 }
 
 void check_aabb_bb(
-    std::span<AABBCollider> aabb, std::span<BBCollider> bb,
+    Rows *rows, std::span<AABBCollider> aabb, std::span<BBCollider> bb,
     Output *output
 ) {
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.aabb_bb_exec_barrier); }
     NNGN_STATS_CONTEXT(Colliders, &output->stats.aabb_bb_exec);
     if(aabb.empty())
         return;
-    for(auto &c0 : bb) {
+    rows->run(bb.size(), output, [aabb, bb](std::size_t i, auto &&add) {
+        auto &c0 = bb[i];
         const auto rel_bl0 = c0.bl - c0.center, rel_tr0 = c0.tr - c0.center;
         for(auto &c1 : aabb) {
             if(!check_bb_fast(c0, c1))
@@ -235,40 +328,45 @@ void check_aabb_bb(
                 continue;
             v0 = nngn::Math::length2(v0) <= nngn::Math::length2(v1)
                 ? -v0 : rotate(v1, c0.cos, c0.sin);
-            if(!add_collision(&c0, &c1, {v0, 0}, &output->collisions))
-                return;
+            if(!add(&c0, &c1, {v0, 0}))
+                return false;
         }
-    }
+        return true;
+    });
 }
 
 void check_aabb_sphere(
-    std::span<AABBCollider> aabb, std::span<SphereCollider> sphere,
-    Output *output
+    Rows *rows, std::span<AABBCollider> aabb,
+    std::span<SphereCollider> sphere, Output *output
 ) {
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.aabb_sphere_exec_barrier); }
     NNGN_STATS_CONTEXT(Colliders, &output->stats.aabb_sphere_exec);
     if(sphere.empty())
         return;
-    for(auto &c0 : aabb)
+    rows->run(aabb.size(), output, [aabb, sphere](std::size_t i, auto &&add) {
+        auto &c0 = aabb[i];
         for(auto &c1 : sphere) {
             nngn::vec2 v = {};
             if(!check_bb_sphere_common(
                     c0.pos.xy(), c0.bl, c0.tr, c1.pos.xy(), c1.r, &v))
                 continue;
-            if(!add_collision(&c0, &c1, {v, 0}, &output->collisions))
-                return;
+            if(!add(&c0, &c1, {v, 0}))
+                return false;
         }
+        return true;
+    });
 }
 
 void check_bb_sphere(
-    std::span<BBCollider> bb, std::span<SphereCollider> sphere,
+    Rows *rows, std::span<BBCollider> bb, std::span<SphereCollider> sphere,
     Output *output
 ) {
     { NNGN_STATS_CONTEXT(Colliders, &output->stats.bb_sphere_exec_barrier); }
     NNGN_STATS_CONTEXT(Colliders, &output->stats.bb_sphere_exec);
     if(sphere.empty())
         return;
-    for(auto &c0 : bb) {
+    rows->run(bb.size(), output, [bb, sphere](std::size_t i, auto &&add) {
+        auto &c0 = bb[i];
         const auto pos0 = c0.pos.xy();
         const auto center0 = c0.center.xy();
         for(auto &c1 : sphere) {
@@ -279,10 +377,11 @@ void check_bb_sphere(
                     c1.r, &v))
                 continue;
             v = rotate(v, c0.cos, c0.sin);
-            if(!add_collision(&c0, &c1, {v, 0}, &output->collisions))
-                return;
+            if(!add(&c0, &c1, {v, 0}))
+                return false;
         }
-    }
+        return true;
+    });
 }
 
 void check_sphere_plane(
@@ -411,7 +510,7 @@ inline bool check_bb_sphere_common(
 template<typename T, typename U>
 bool add_collision(
     T *c0, U *c1, const nngn::vec3 &v,
-    std::vector<nngn::Collision> *out)
+    Colliders::Backend::vector<nngn::Collision> *out)
 {
     c0->flags.set(nngn::Collider::Flag::COLLIDING);
     c1->flags.set(nngn::Collider::Flag::COLLIDING);
@@ -437,7 +536,7 @@ bool add_collision(
 
 namespace nngn {
 
-auto Colliders::native_backend() -> std::unique_ptr<Backend>
-    { return std::make_unique<NativeBackend>(); }
+auto Colliders::native_backend(Jobs *jobs) -> std::unique_ptr<Backend>
+    { return std::make_unique<NativeBackend>(jobs); }
 
 }
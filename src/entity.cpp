@@ -1,10 +1,12 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <utility>
 
 #include "entity.h"
 
 #include "collision/colliders.h"
+#include "jobs/jobs.h"
 #include "math/camera.h"
 #include "math/math.h"
 #include "render/animation.h"
@@ -16,6 +18,7 @@
 #include "utils/utils.h"
 
 using nngn::vec3;
+using Component = Entities::Component;
 
 namespace {
 
@@ -62,9 +65,112 @@ void set_pos(Entity *e, vec3 oldp, vec3 p) {
         e->light->set_pos(p);
 }
 
+template<typename T>
+void store(const T &x, float *p) {
+    static_assert(sizeof(T) % sizeof(float) == 0);
+    std::memcpy(p, &x, sizeof(T));
+}
+
+template<typename T>
+T load(const float *p) {
+    T ret = {};
+    std::memcpy(&ret, p, sizeof(T));
+    return ret;
+}
+
+template<Component c>
+void read_one(const Entity &e, float *p) {
+    if constexpr(c == Component::POS)
+        store(e.p, p);
+    else if constexpr(c == Component::VEL)
+        store(e.v, p);
+    else if constexpr(c == Component::ACC)
+        store(e.a, p);
+    else if constexpr(c == Component::MAX_VEL)
+        *p = e.max_v;
+    else if constexpr(c == Component::RENDERER_Z_OFF)
+        *p = e.renderer ? e.renderer->z_off : 0;
+    else if constexpr(c == Component::LIGHT_COLOR)
+        store(e.light ? e.light->color : nngn::vec4{}, p);
+}
+
+template<Component c>
+void write_one(Entity *e, const float *p) {
+    if constexpr(c == Component::POS)
+        e->set_pos(load<vec3>(p));
+    else if constexpr(c == Component::VEL)
+        e->set_vel(load<vec3>(p));
+    else if constexpr(c == Component::ACC)
+        e->a = load<vec3>(p);
+    else if constexpr(c == Component::MAX_VEL)
+        e->max_v = *p;
+    else if constexpr(c == Component::RENDERER_Z_OFF) {
+        if(auto *const r = e->renderer) {
+            r->z_off = *p;
+            r->flags.set(nngn::Renderer::Flag::UPDATED);
+        }
+    } else if constexpr(c == Component::LIGHT_COLOR)
+        if(e->light)
+            e->light->set_color(load<nngn::vec4>(p));
+}
+
+/** Calls \p f with the component as a template argument. */
+decltype(auto) map_component(Component c, auto &&f) {
+    switch(c) {
+#define C(x) case Component::x: return FWD(f).template operator()<Component::x>();
+    C(POS) C(VEL) C(ACC) C(MAX_VEL) C(RENDERER_Z_OFF) C(LIGHT_COLOR)
+#undef C
+    case Component::N:
+    default: assert(!"invalid component"); return false;
+    }
+}
+
+bool check_bulk(
+    Component c, std::size_t n, std::size_t stride, std::size_t size
+) {
+    if(c >= Component::N)
+        return nngn::Log::l()
+            << "invalid component: " << static_cast<unsigned>(c) << '\n',
+            false;
+    const auto cs = Entities::component_size(c);
+    if(stride < cs)
+        return nngn::Log::l()
+            << "invalid stride: " << stride << " < " << cs << '\n',
+            false;
+    if(const auto req = n ? (n - 1) * stride + cs : 0; size < req)
+        return nngn::Log::l()
+            << "insufficient size: " << size << " < " << req << '\n',
+            false;
+    return true;
+}
+
+bool check_range(std::size_t first, std::size_t n, std::size_t max) {
+    if(max < first || max - first < n)
+        return nngn::Log::l()
+            << "invalid range: [" << first << ", " << first + n
+            << ") > " << max << '\n',
+            false;
+    return true;
+}
+
+bool check_idx(std::span<const std::uint32_t> idx, std::size_t max) {
+    const auto it = std::ranges::find_if(
+        idx, [max](auto i) { return max <= i; });
+    if(it != end(idx))
+        return nngn::Log::l()
+            << "invalid index: " << *it << " >= " << max << '\n',
+            false;
+    return true;
+}
+
 }
 
 void Entity::set_pos(vec3 pos) {
+    this->move(pos);
+    this->prev_p = pos;
+}
+
+void Entity::move(vec3 pos) {
     ::set_pos(this, this->p, pos);
     this->p = pos;
     this->flags.set(Flag::POS_UPDATED);
@@ -159,19 +265,132 @@ void Entities::set_tag(Entity *e, std::string_view s) {
     copy(::tag(this, e), &::tag_hash(this, e), s);
 }
 
+std::size_t Entities::component_size(Component c) {
+    switch(c) {
+    case Component::POS:
+    case Component::VEL:
+    case Component::ACC: return vec3::n_dim;
+    case Component::MAX_VEL:
+    case Component::RENDERER_Z_OFF: return 1;
+    case Component::LIGHT_COLOR: return nngn::vec4::n_dim;
+    case Component::N:
+    default: return 0;
+    }
+}
+
+bool Entities::read(
+    Component c, std::size_t first, std::size_t n, std::size_t stride,
+    std::span<float> dst
+) const {
+    NNGN_LOG_CONTEXT_CF(Entities);
+    const auto max = static_cast<std::size_t>(this->v.end() - this->v.begin());
+    if(!check_bulk(c, n, stride, dst.size()) || !check_range(first, n, max))
+        return false;
+    const auto cs = Entities::component_size(c);
+    return map_component(c, [this, first, n, stride, cs, dst]<Component C>() {
+        const auto *e = this->v.data() + first;
+        for(auto *p = dst.data(), *pe = p + n * stride; p != pe; p += stride)
+            if(const auto &x = *e++; x.alive())
+                read_one<C>(x, p);
+            else
+                std::fill(p, p + cs, 0.0f);
+        return true;
+    });
+}
+
+bool Entities::read(
+    Component c, std::span<const std::uint32_t> idx, std::size_t stride,
+    std::span<float> dst
+) const {
+    NNGN_LOG_CONTEXT_CF(Entities);
+    const auto max = static_cast<std::size_t>(this->v.end() - this->v.begin());
+    if(!check_bulk(c, idx.size(), stride, dst.size()) || !check_idx(idx, max))
+        return false;
+    const auto cs = Entities::component_size(c);
+    return map_component(c, [this, idx, stride, cs, dst]<Component C>() {
+        auto *p = dst.data();
+        for(const auto i : idx) {
+            if(const auto &x = this->v[i]; x.alive())
+                read_one<C>(x, p);
+            else
+                std::fill(p, p + cs, 0.0f);
+            p += stride;
+        }
+        return true;
+    });
+}
+
+bool Entities::write(
+    Component c, std::size_t first, std::size_t n, std::size_t stride,
+    std::span<const float> src
+) {
+    NNGN_LOG_CONTEXT_CF(Entities);
+    const auto max = static_cast<std::size_t>(this->v.end() - this->v.begin());
+    if(!check_bulk(c, n, stride, src.size()) || !check_range(first, n, max))
+        return false;
+    return map_component(c, [this, first, n, stride, src]<Component C>() {
+        auto *e = this->v.data() + first;
+        for(auto *p = src.data(), *pe = p + n * stride; p != pe; p += stride)
+            if(auto &x = *e++; x.alive())
+                write_one<C>(&x, p);
+        return true;
+    });
+}
+
+bool Entities::write(
+    Component c, std::span<const std::uint32_t> idx, std::size_t stride,
+    std::span<const float> src
+) {
+    NNGN_LOG_CONTEXT_CF(Entities);
+    const auto max = static_cast<std::size_t>(this->v.end() - this->v.begin());
+    if(!check_bulk(c, idx.size(), stride, src.size()) || !check_idx(idx, max))
+        return false;
+    return map_component(c, [this, idx, stride, src]<Component C>() {
+        auto *p = src.data();
+        for(const auto i : idx) {
+            if(auto &x = this->v[i]; x.alive())
+                write_one<C>(&x, p);
+            p += stride;
+        }
+        return true;
+    });
+}
+
+namespace {
+
+void update(Entity *e, float dt) {
+    if(e->a != vec3{}) {
+        e->set_vel(e->v + e->a * dt);
+        e->a = {};
+    }
+    if(e->max_v > 0)
+        e->v = nngn::Math::clamp_len(e->v, e->max_v);
+    if(e->v != vec3{})
+        e->move(e->p + e->v * dt);
+}
+
+}
+
 void Entities::update(const nngn::Timing &t) {
     NNGN_PROFILE_CONTEXT(entities);
     const auto dt = t.fdt_s();
-    for(auto &x : this->v) {
-        if(x.a != vec3{}) {
-            x.set_vel(x.v + x.a * dt);
-            x.a = {};
-        }
-        if(x.max_v > 0)
-            x.v = nngn::Math::clamp_len(x.v, x.max_v);
-        if(x.v != vec3{})
-            x.set_pos(x.p + x.v * dt);
+    if(!this->jobs || !this->jobs->threads()) {
+        for(auto &x : this->v)
+            ::update(&x, dt);
+        return;
     }
+    // Children read the position of their parents, which may be updated
+    // concurrently, so they are processed afterwards.
+    const auto n = static_cast<std::size_t>(this->v.end() - this->v.begin());
+    this->jobs->parallel_for("entities", n, UPDATE_GRAIN,
+        [this, dt](std::size_t b, std::size_t e) {
+            for(auto i = b; i != e; ++i)
+                if(auto &x = this->v[i]; !x.parent)
+                    ::update(&x, dt);
+        });
+    for(auto &x : this->v)
+        if(x.parent)
+            ::update(&x, dt);
 }
 
 void Entities::update_children() {
@@ -181,6 +400,57 @@ void Entities::update_children() {
             set_pos(&x, x.p, x.p);
 }
 
+namespace {
+
+bool moved(const Entity &e) {
+    return e.flags.is_set(Entity::Flag::INTERPOLATE) && e.prev_p != e.p;
+}
+
+bool moved_world(const Entity &e) {
+    return moved(e) || (e.parent && moved(*e.parent));
+}
+
+vec3 lerp(const Entity &e, float a) {
+    if(!e.flags.is_set(Entity::Flag::INTERPOLATE))
+        return e.p;
+    return e.prev_p + (e.p - e.prev_p) * a;
+}
+
+}
+
+void Entities::save_positions() {
+    for(auto &x : this->v)
+        if(x.renderer && moved_world(x))
+            x.renderer->set_pos(x.parent ? x.parent->p + x.p : x.p);
+    for(auto &x : this->v) {
+        x.prev_p = x.p;
+        x.flags.set(Entity::Flag::INTERPOLATE);
+    }
+}
+
+void Entities::interpolate(float alpha) {
+    NNGN_PROFILE_CONTEXT(interpolate);
+    this->interpolated = true;
+    for(auto &x : this->v) {
+        if(!x.renderer || !moved_world(x))
+            continue;
+        auto p = lerp(x, alpha);
+        if(x.parent)
+            p += lerp(*x.parent, alpha);
+        x.renderer->set_pos(p);
+    }
+}
+
+void Entities::stop_interpolation() {
+    if(!std::exchange(this->interpolated, false))
+        return;
+    for(auto &x : this->v) {
+        x.flags.clear(Entity::Flag::INTERPOLATE);
+        if(x.renderer)
+            x.renderer->set_pos(x.parent ? x.parent->p + x.p : x.p);
+    }
+}
+
 void Entities::clear_flags() {
     for(auto &x : this->v)
         x.flags.clear(Entity::Flag::POS_UPDATED);
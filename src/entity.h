@@ -8,6 +8,7 @@
 
 #include "math/hash.h"
 #include "math/vec3.h"
+#include "utils/alloc/accounting.h"
 #include "utils/flags.h"
 #include "utils/static_vector.h"
 #include "utils/utils.h"
@@ -16,6 +17,7 @@ namespace nngn {
     struct Camera;
     struct Animation;
     struct Collider;
+    class Jobs;
     struct Light;
     struct Renderer;
     struct Timing;
@@ -24,9 +26,13 @@ namespace nngn {
 struct Entity {
     enum Flag : std::uintptr_t {
         ALIVE = 1u << 0, POS_UPDATED = 1u << 1,
+        /** \ref prev_p is valid, set by \ref Entities::save_positions. */
+        INTERPOLATE = 1u << 2,
     };
     nngn::Flags<Flag> flags = {};
     nngn::vec3 p = {0, 0, 0};
+    /** Position at the start of the last fixed simulation step. */
+    nngn::vec3 prev_p = {0, 0, 0};
     nngn::vec3 v = {0, 0, 0};
     float max_v = {};
     nngn::vec3 a = {0, 0, 0};
@@ -38,7 +44,13 @@ struct Entity {
     Entity *parent = nullptr;
     bool alive() const { return this->flags.is_set(Flag::ALIVE); }
     bool pos_updated() const { return this->flags.is_set(Flag::POS_UPDATED); }
+    /** Moves the entity to \p p without interpolating the change. */
     void set_pos(nngn::vec3 p);
+    /**
+     * Moves the entity to \p p as part of a simulation step.
+     * The change is interpolated by \ref Entities::interpolate.
+     */
+    void move(nngn::vec3 p);
     void set_vel(nngn::vec3 v);
     void set_renderer(nngn::Renderer *p);
     void set_collider(nngn::Collider *p);
@@ -49,13 +61,49 @@ struct Entity {
 };
 
 class Entities {
-    nngn::static_vector<Entity> v = {};
-    std::vector<std::array<char, 32>> names = {}, tags = {};
-    std::vector<nngn::Hash> name_hashes = {}, tag_hashes = {};
+    template<typename T>
+    using allocator = nngn::accounted_allocator<T, nngn::memory_tag::entities>;
+    template<typename T>
+    using vector = nngn::accounted_vector<T, nngn::memory_tag::entities>;
+    nngn::static_vector<Entity, allocator<Entity>> v = {};
+    nngn::Jobs *jobs = nullptr;
+    vector<std::array<char, 32>> names = {}, tags = {};
+    vector<nngn::Hash> name_hashes = {}, tag_hashes = {};
+    bool interpolated = false;
 public:
+    /**
+     * Entity properties which can be transferred in bulk.
+     * \see read
+     * \see write
+     */
+    enum class Component : std::uint8_t {
+        /** \ref Entity::p, `vec3`. */
+        POS,
+        /** \ref Entity::v, `vec3`. */
+        VEL,
+        /** \ref Entity::a, `vec3`. */
+        ACC,
+        /** \ref Entity::max_v, `float`. */
+        MAX_VEL,
+        /** `nngn::Renderer::z_off`, `float`. */
+        RENDERER_Z_OFF,
+        /** `nngn::Light::color`, `vec4`. */
+        LIGHT_COLOR,
+        N,
+    };
+    /** Number of `float`s used to represent a component. */
+    static std::size_t component_size(Component c);
+    /** Number of entities processed by each job in \ref update. */
+    static constexpr std::size_t UPDATE_GRAIN = 4096;
     size_t max() const { return this->v.capacity(); }
     size_t n() const { return this->v.size(); }
     void set_max(std::size_t n);
+    /**
+     * Job system used to parallelize \ref update, may be null.
+     * Entities are updated concurrently, so distinct entities must not share
+     * associated objects (e.g. a camera).
+     */
+    void set_jobs(nngn::Jobs *j) { this->jobs = j; }
     Entity *add();
     void remove(Entity *e) { this->v.erase(e); }
     NNGN_EXPOSE_ITERATOR(, v)
@@ -69,8 +117,51 @@ public:
     nngn::Hash tag_hash(const Entity &e) const;
     void set_name(Entity *e, std::string_view s);
     void set_tag(Entity *e, std::string_view s);
+    /**
+     * Copies a component of the entities in <tt>[first, first + n)</tt>.
+     * Positions refer to the underlying storage (including removed entities,
+     * which are skipped).  The value for entity `i` is written at
+     * <tt>dst[i * stride]</tt>, `stride` must be at least
+     * <tt>component_size(c)</tt>.  Values for entities which do not have the
+     * associated object (e.g. a renderer) are zeroed.
+     */
+    bool read(
+        Component c, std::size_t first, std::size_t n, std::size_t stride,
+        std::span<float> dst) const;
+    /** Similar to \ref read, for an arbitrary list of positions. */
+    bool read(
+        Component c, std::span<const std::uint32_t> idx, std::size_t stride,
+        std::span<float> dst) const;
+    /**
+     * Inverse of \ref read.
+     * Components are set using the same functions used for individual
+     * entities, so that associated objects are updated.
+     */
+    bool write(
+        Component c, std::size_t first, std::size_t n, std::size_t stride,
+        std::span<const float> src);
+    /** Similar to \ref write, for an arbitrary list of positions. */
+    bool write(
+        Component c, std::span<const std::uint32_t> idx, std::size_t stride,
+        std::span<const float> src);
     void update(const nngn::Timing &t);
     void update_children();
+    /**
+     * Saves current positions before a fixed simulation step.
+     * Renderers of entities which were interpolated are moved to their
+     * actual position.
+     */
+    void save_positions();
+    /**
+     * Moves renderers to a position between the previous and current step.
+     * \param alpha `[0, 1]`, fraction of a step elapsed since the last one.
+     */
+    void interpolate(float alpha);
+    /**
+     * Moves renderers back to their actual position after fixed steps are
+     * disabled.  Does nothing unless \ref interpolate was called before.
+     */
+    void stop_interpolation();
     void clear_flags();
 };
 
@@ -0,0 +1,126 @@
+#include "atlas.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "utils/utils.h"
+
+namespace nngn {
+
+void GlyphAtlas::init(u32 extent) {
+    this->m_extent = extent;
+    this->image.assign(std::size_t{extent} * extent, {});
+    this->packer.init(extent, ROUND);
+    this->entries.assign(1, {});
+    this->free_entries.clear();
+    this->m_dirty.clear();
+}
+
+float GlyphAtlas::occupancy(void) const {
+    if(!this->m_extent)
+        return 0;
+    u64 n = 0;
+    for(const auto &x : this->entries)
+        if(x.active)
+            n += u64{x.r.size.x} * x.r.size.y;
+    const auto e = static_cast<double>(this->m_extent);
+    return static_cast<float>(static_cast<double>(n) / (e * e));
+}
+
+u32 GlyphAtlas::insert(
+    char32_t key, uvec2 size, std::vector<char32_t> *evicted
+) {
+    if(!this->fits(size))
+        return 0;
+    const auto s = size + PADDING;
+    u32 sh = 0, x = 0;
+    while(!this->packer.alloc(s, &sh, &x)) {
+        const auto v = this->victim(s);
+        if(!v)
+            return 0;
+        if(evicted)
+            evicted->push_back(this->entries[v].key);
+        this->remove(v);
+        ++this->m_evicted;
+    }
+    u32 ret = 0;
+    if(this->free_entries.empty()) {
+        ret = narrow<u32>(this->entries.size());
+        this->entries.emplace_back();
+    } else {
+        ret = this->free_entries.back();
+        this->free_entries.pop_back();
+    }
+    const auto &shelf = this->packer.shelves()[sh];
+    const Rect r = {{x, shelf.y}, size};
+    this->entries[ret] = {
+        .r = r,
+        .last_used = this->m_frame,
+        .key = key,
+        .shelf = sh,
+        .active = true,
+    };
+    const auto e = std::size_t{this->m_extent};
+    for(std::size_t y = r.pos.y, ye = y + s.y; y != ye; ++y)
+        std::memset(&this->image[y * e + r.pos.x], 0, s.x);
+    // The whole height of the shelf is uploaded so that adjacent regions can
+    // be merged regardless of the height of each glyph.
+    this->mark_dirty({r.pos, {s.x, shelf.h}});
+    return ret;
+}
+
+void GlyphAtlas::remove(u32 i) {
+    auto &s = this->entries[i];
+    assert(s.active);
+    s.active = false;
+    this->packer.release(s.shelf, s.r.pos.x, s.r.size.x + PADDING);
+    this->free_entries.push_back(i);
+}
+
+uvec2 GlyphAtlas::pos(u32 i) const {
+    assert(this->entries[i].active);
+    return this->entries[i].r.pos;
+}
+
+void GlyphAtlas::touch(u32 i) {
+    assert(this->entries[i].active);
+    this->entries[i].last_used = this->m_frame;
+}
+
+void GlyphAtlas::write(u32 i, const std::byte *src, std::ptrdiff_t pitch) {
+    const auto &r = this->entries[i].r;
+    const auto e = std::size_t{this->m_extent};
+    auto *dst = &this->image[r.pos.y * e + r.pos.x];
+    for(u32 y = 0; y != r.size.y; ++y, src += pitch, dst += e)
+        std::memcpy(dst, src, r.size.x);
+}
+
+u32 GlyphAtlas::victim(uvec2 s) const {
+    const auto shelves = this->packer.shelves();
+    const auto last = shelves.size() - 1;
+    u32 ret = 0;
+    for(u32 i = 1, n = narrow<u32>(this->entries.size()); i != n; ++i) {
+        const auto &x = this->entries[i];
+        if(!x.active || x.last_used == this->m_frame)
+            continue;
+        if(shelves[x.shelf].h < s.y && x.shelf != last)
+            continue;
+        if(!ret || x.last_used < this->entries[ret].last_used)
+            ret = i;
+    }
+    return ret;
+}
+
+void GlyphAtlas::mark_dirty(Rect r) {
+    if(!this->m_dirty.empty()) {
+        auto &b = this->m_dirty.back();
+        if(b.pos.y == r.pos.y && b.size.y == r.size.y
+                && b.pos.x + b.size.x == r.pos.x) {
+            b.size.x += r.size.x;
+            return;
+        }
+    }
+    this->m_dirty.push_back(r);
+}
+
+}
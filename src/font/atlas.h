@@ -0,0 +1,99 @@
+#ifndef NNGN_FONT_ATLAS_H
+#define NNGN_FONT_ATLAS_H
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "math/packer.h"
+#include "math/vec2.h"
+#include "utils/def.h"
+
+namespace nngn {
+
+/**
+ * Packs glyph bitmaps into a single square texture.
+ *
+ * Space is allocated by a \ref ShelfPacker, with shelf heights rounded up
+ * to a multiple of \ref ROUND.
+ *
+ * When the texture is full, least-recently-used glyphs are evicted to make
+ * space.  Glyphs used in the current frame (see \ref touch and \ref
+ * next_frame) are never evicted, since their coordinates may already have
+ * been written to vertex buffers.
+ *
+ * The atlas keeps a copy of the image (a single coverage channel) and a
+ * list of the rectangles modified since the last call to \ref clear_dirty, so
+ * that only those have to be uploaded.
+ */
+class GlyphAtlas {
+public:
+    /** Empty space left on the right and bottom of each glyph. */
+    static constexpr u32 PADDING = 1;
+    /** Granularity of shelf heights. */
+    static constexpr u32 ROUND = 4;
+    struct Rect { uvec2 pos, size; };
+    GlyphAtlas(void) = default;
+    explicit GlyphAtlas(u32 extent) { this->init(extent); }
+    /** Discards all glyphs and resizes the texture. */
+    void init(u32 extent);
+    u32 extent(void) const { return this->m_extent; }
+    u64 frame(void) const { return this->m_frame; }
+    /** Number of glyphs currently in the atlas. */
+    std::size_t size(void) const
+        { return this->entries.size() - 1 - this->free_entries.size(); }
+    /** Total number of glyphs evicted so far. */
+    u64 n_evicted(void) const { return this->m_evicted; }
+    /** Fraction of the texture area occupied by glyphs. */
+    float occupancy(void) const;
+    /** Coverage values, \ref extent squared, row-major, top row first. */
+    std::span<const std::byte> data(void) const { return this->image; }
+    std::span<const Rect> dirty(void) const { return this->m_dirty; }
+    void clear_dirty(void) { this->m_dirty.clear(); }
+    /** Whether a bitmap of size \p s can ever be inserted. */
+    bool fits(uvec2 s) const
+        { return s.x + PADDING <= this->m_extent
+            && s.y + PADDING <= this->m_extent; }
+    /** Starts a new frame, after which all glyphs can be evicted again. */
+    void next_frame(void) { ++this->m_frame; }
+    /**
+     * Allocates space for a bitmap owned by \p key.
+     * The region is cleared and marked as used in the current frame.
+     * \param evicted Keys of glyphs which had to be evicted are added here.
+     * \return Non-zero slot index, or zero if there is not enough space.
+     */
+    u32 insert(char32_t key, uvec2 size, std::vector<char32_t> *evicted);
+    void remove(u32 slot);
+    /** Position of the bitmap in the texture. */
+    uvec2 pos(u32 slot) const;
+    /** Marks the glyph as used in the current frame. */
+    void touch(u32 slot);
+    /**
+     * Copies the bitmap of a glyph into its region.
+     * \param pitch Distance in bytes between consecutive rows in \p src.
+     */
+    void write(u32 slot, const std::byte *src, std::ptrdiff_t pitch);
+private:
+    struct entry {
+        Rect r;
+        u64 last_used;
+        char32_t key;
+        u32 shelf;
+        bool active;
+    };
+    /** Least-recently-used glyph whose removal can make space for \p s. */
+    u32 victim(uvec2 s) const;
+    void mark_dirty(Rect r);
+    u32 m_extent = 0;
+    u64 m_frame = 0, m_evicted = 0;
+    std::vector<std::byte> image = {};
+    ShelfPacker packer = {};
+    /** The first entry is unused so that zero can represent no slot. */
+    std::vector<entry> entries = {{}};
+    std::vector<u32> free_entries = {};
+    std::vector<Rect> m_dirty = {};
+};
+
+}
+
+#endif
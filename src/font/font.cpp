@@ -1,5 +1,10 @@
 #include "font.h"
 
+#include <algorithm>
+#include <bit>
+
+#include "graphics/graphics.h"
+#include "math/vec4.h"
 #include "os/platform.h"
 #include "utils/log.h"
 
@@ -11,11 +16,17 @@ bool init(void**) { return true; }
 
 void destroy(void*) {}
 
-bool load(void*, const char*, nngn::Graphics*, nngn::Font*) {
+void destroy_face(void*) {}
+
+bool load(void*, const char*, nngn::Font*) {
     nngn::Log::l() << "compiled without freetype3 support\n";
     return false;
 }
 
+bool rasterize(nngn::Font*, char32_t, bool, nngn::Font::Character*) {
+    return false;
+}
+
 }
 
 #else
@@ -24,10 +35,6 @@ bool load(void*, const char*, nngn::Graphics*, nngn::Font*) {
 
 #include FT_FREETYPE_H
 
-#include "graphics/graphics.h"
-#include "math/vec4.h"
-#include "utils/scoped.h"
-
 namespace {
 
 const char *freetype_strerror(FT_Error err) {
@@ -62,86 +69,95 @@ void destroy(void *p) {
     FT_Done_FreeType(static_cast<FT_Library>(p));
 }
 
-void gen_tex(
-    std::size_t width, std::size_t height,
-    const std::byte *in, nngn::vec4_base<std::byte> *out
-) {
-    constexpr auto w = std::byte{255};
-    for(std::size_t y = 0; y != height; ++y)
-        for(std::size_t x = 0; x != width; ++x)
-            *out++ = {w, w, w, *in++};
+void destroy_face(void *p) {
+    if(p)
+        FT_Done_Face(static_cast<FT_Face>(p));
+}
+
+/** Large enough for all ASCII glyphs plus a few hundred others. */
+nngn::u32 atlas_extent(unsigned int size) {
+    constexpr nngn::u32 min = 64, max = 2048;
+    return std::clamp(std::bit_ceil(16 * size), min, max);
 }
 
-bool load(
-        void *p_ft, const char *filename,
-        nngn::Graphics *graphics, nngn::Font *f) {
+bool load(void *p_ft, const char *filename, nngn::Font *f) {
     auto *ft = static_cast<FT_Library>(p_ft);
-    FT_Error err = FT_Err_Ok;
     FT_Face face = {};
-    if((err = FT_New_Face(ft, filename, 0, &face)) != FT_Err_Ok) {
+    if(const auto err = FT_New_Face(ft, filename, 0, &face); err) {
         nngn::Log::l()
             << "FT_New_Face(" << filename << "): "
             << freetype_strerror(err) << std::endl;
         return false;
     }
-    auto done_face = nngn::make_scoped([face] { FT_Done_Face(face); });
     FT_Set_Pixel_Sizes(face, 0, f->size);
-    if(graphics)
-        graphics->resize_font(f->size);
-    const auto size = static_cast<std::size_t>(f->size);
-    using bvec4 = nngn::vec4_base<std::byte>;
-    std::vector<bvec4> bitmap(size * size);
-    bool ret = true;
-    for(unsigned char c = 0; c < nngn::Font::N; ++c) {
-        if((err = FT_Load_Char(face, c, FT_LOAD_RENDER)) != FT_Err_Ok) {
-            nngn::Log::l()
-                << "FT_Load_Char(" << c << "): "
-                << freetype_strerror(err) << std::endl;
-            ret = false;
-            if(graphics) {
-                bitmap.clear();
-                graphics->load_font(
-                    c, 1, nngn::rptr(nngn::uvec2{}), &bitmap[0][0]);
-            }
-            continue;
-        }
+    f->face = face;
+    f->atlas.init(atlas_extent(f->size));
+    return true;
+}
+
+bool load_char(FT_Face face, char32_t c) {
+    NNGN_LOG_CONTEXT_CF(Font);
+    const auto err = FT_Load_Char(face, c, FT_LOAD_RENDER);
+    if(!err)
+        return true;
+    nngn::Log::l()
+        << "FT_Load_Char(" << static_cast<unsigned>(c) << "): "
+        << freetype_strerror(err) << std::endl;
+    return false;
+}
+
+bool rasterize(
+    nngn::Font *f, char32_t c, bool loaded, nngn::Font::Character *ch
+) {
+    NNGN_LOG_CONTEXT_CF(Font);
+    auto *const face = static_cast<FT_Face>(f->face);
+    // Metrics are read on the first call.  Afterwards, the glyph is only
+    // loaded again once space has been allocated for its bitmap.
+    if(!loaded) {
+        if(!load_char(face, c))
+            return *ch = {}, false;
         const auto &g = *face->glyph;
-        nngn::uvec2 bsize = {g.bitmap.width, g.bitmap.rows};
-        if(f->size < bsize.x || f->size < bsize.y) {
+        ch->size = {g.bitmap.width, g.bitmap.rows};
+        ch->bearing = {
+            g.bitmap_left,
+            g.bitmap_top - static_cast<int>(g.bitmap.rows)};
+        ch->advance = static_cast<float>(g.advance.x) / 64.0f;
+        if(!ch->size.x || !ch->size.y)
+            return true;
+        if(!f->atlas.fits(ch->size)) {
+            const auto e = f->atlas.extent();
             nngn::Log::l()
                 << "character " << static_cast<unsigned>(c)
-                << "('" << c << "')"
-                << " larger than font size ("
-                << bsize.x << "x" << bsize.y
-                << " > " << f->size << "x" << f->size
-                << ")\n";
-            if(graphics)
-                bitmap.clear();
-            bsize = {f->size, f->size};
+                << " larger than font atlas ("
+                << ch->size.x << "x" << ch->size.y
+                << " > " << e << "x" << e << ")\n";
+            ch->size = {};
+            return false;
         }
-        if(graphics) {
-            if(bsize.x && bsize.y) {
-                assert(bsize.x <= size && bsize.y <= size);
-                gen_tex(
-                    bsize.x, bsize.y,
-                    static_cast<const std::byte*>(
-                        static_cast<const void*>(g.bitmap.buffer)),
-                    bitmap.data());
-            } else
-                std::fill(begin(bitmap), end(bitmap), bvec4{});
-            if(!graphics->load_font(c, 1, &bsize, &bitmap[0][0])) {
-                ret = false;
-                continue;
-            }
-        }
-        auto &r = f->chars[c];
-        r.size = bsize;
-        r.bearing = {
-            g.bitmap_left,
-            g.bitmap_top - static_cast<int>(g.bitmap.rows)};
-        r.advance = static_cast<float>(g.advance.x) / 64.0f;
     }
-    return ret;
+    std::vector<char32_t> evicted = {};
+    const auto slot = f->atlas.insert(c, ch->size, &evicted);
+    for(const auto k : evicted)
+        f->chars.find(k)->second.slot = 0;
+    // All glyphs are in use in this frame, try again in the next one.
+    if(!slot)
+        return false;
+    if(loaded && !load_char(face, c)) {
+        f->atlas.remove(slot);
+        return *ch = {}, false;
+    }
+    ++f->n_rasterized;
+    const auto &g = *face->glyph;
+    const auto pitch = static_cast<std::ptrdiff_t>(g.bitmap.pitch);
+    const auto *src = static_cast<const std::byte*>(
+        static_cast<const void*>(g.bitmap.buffer));
+    // Rows are stored bottom-up when the pitch is negative.
+    if(pitch < 0)
+        src -= pitch * static_cast<std::ptrdiff_t>(ch->size.y - 1);
+    f->atlas.write(slot, src, pitch);
+    ch->pos = f->atlas.pos(slot);
+    ch->slot = slot;
+    return true;
 }
 
 }
@@ -150,11 +166,33 @@ bool load(
 
 namespace nngn {
 
-Fonts::~Fonts() { destroy(this->ft); }
+auto Font::find(char32_t c) const -> const Character* {
+    const auto it = this->chars.find(c);
+    return it == this->chars.end() ? nullptr : &it->second;
+}
+
+auto Font::glyph(char32_t c) -> const Character& {
+    const auto [it, inserted] = this->chars.try_emplace(c);
+    auto &ret = it->second;
+    if(!this->face)
+        return ret;
+    if(ret.slot)
+        this->atlas.touch(ret.slot);
+    else if(inserted || (ret.size.x && ret.size.y))
+        ::rasterize(this, c, !inserted, &ret);
+    return ret;
+}
+
+Fonts::~Fonts() {
+    for(const auto &x : this->v)
+        destroy_face(x.face);
+    destroy(this->ft);
+}
+
 bool Fonts::init() { return ::init((&this->ft)); }
 
-uint32_t Fonts::add(const Font &f) {
-    this->v.push_back(f);
+uint32_t Fonts::add(Font f) {
+    this->v.push_back(std::move(f));
     return static_cast<uint32_t>(this->v.size() - 1);
 }
 
@@ -162,9 +200,42 @@ uint32_t Fonts::load(unsigned int size, const char *filename) {
     NNGN_LOG_CONTEXT_CF(Fonts);
     Font f = {};
     f.size = size;
-    if(::load(this->ft, filename, this->graphics, &f))
-        return this->add(f);
-    return 0;
+    if(!::load(this->ft, filename, &f))
+        return 0;
+    if(this->graphics && !this->graphics->resize_font(f.atlas.extent())) {
+        destroy_face(f.face);
+        return 0;
+    }
+    return this->add(std::move(f));
+}
+
+bool Fonts::update(void) {
+    NNGN_LOG_CONTEXT_CF(Fonts);
+    bool ret = true;
+    if(auto &f = this->v.back(); this->graphics) {
+        using bvec4 = vec4_base<std::byte>;
+        constexpr auto w = std::byte{255};
+        const auto e = std::size_t{f.atlas.extent()};
+        const auto data = f.atlas.data();
+        for(const auto &r : f.atlas.dirty()) {
+            this->tmp.resize(4 * std::size_t{r.size.x} * r.size.y);
+            auto *dst = static_cast<bvec4*>(static_cast<void*>(
+                this->tmp.data()));
+            for(std::size_t y = r.pos.y, ye = y + r.size.y; y != ye; ++y)
+                for(const auto a : data.subspan(y * e + r.pos.x, r.size.x))
+                    *dst++ = {w, w, w, a};
+            if(!this->graphics->load_font(r.pos, r.size, this->tmp.data()))
+                ret = false;
+        }
+    }
+    u64 n = 0;
+    for(auto &x : this->v) {
+        n += x.n_rasterized;
+        x.atlas.clear_dirty();
+        x.atlas.next_frame();
+    }
+    this->m_rasterized_frame = n - std::exchange(this->m_rasterized, n);
+    return ret;
 }
 
 }
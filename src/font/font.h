@@ -5,41 +5,77 @@
 #ifndef NNGN_FONT_H
 #define NNGN_FONT_H
 
-#include <array>
+#include <unordered_map>
 #include <vector>
 
 #include "math/vec2.h"
 #include "utils/utils.h"
 
+#include "atlas.h"
+
 namespace nngn {
 
 struct Graphics;
 
+/**
+ * Glyph metrics and bitmaps of a font face at a given size.
+ * Glyphs are rasterized into \ref atlas on first use (see \ref glyph) and may
+ * be evicted from it later, in which case they are rasterized again when
+ * next requested.
+ */
 struct Font {
-    static constexpr size_t N = 128;
     struct Character {
-        uvec2 size;
-        ivec2 bearing;
-        float advance;
+        uvec2 size = {};
+        ivec2 bearing = {};
+        float advance = 0;
+        /** Position in the atlas, only valid if \ref slot is not zero. */
+        uvec2 pos = {};
+        /**
+         * Atlas slot, zero if the glyph has no bitmap, was evicted, or did
+         * not fit in the atlas when last requested.
+         */
+        u32 slot = 0;
     };
-    using Characters = std::array<Character, N>;
+    NNGN_MOVE_ONLY(Font)
+    Font(void) = default;
+    ~Font(void) = default;
     unsigned int size = 0;
-    Characters chars = {};
+    /** All glyphs loaded so far, including those evicted from the atlas. */
+    std::unordered_map<char32_t, Character> chars = {};
+    GlyphAtlas atlas = {};
+    /** Face used to rasterize glyphs, owned by \ref Fonts. */
+    void *face = nullptr;
+    /** Total number of glyphs rasterized. */
+    u64 n_rasterized = 0;
+    /** Glyph previously loaded with \ref glyph, if any. */
+    const Character *find(char32_t c) const;
+    /** Loads the glyph if necessary and marks it as used in this frame. */
+    const Character &glyph(char32_t c);
 };
 
 class Fonts {
     void *ft = {};
-    std::vector<Font> v = {{}};
+    std::vector<Font> v = {};
+    std::vector<std::byte> tmp = {};
+    u64 m_rasterized = 0, m_rasterized_frame = 0;
 public:
     Graphics *graphics = nullptr;
     NNGN_MOVE_ONLY(Fonts)
-    Fonts(void) = default;
+    Fonts(void) { this->v.emplace_back(); }
     ~Fonts(void);
     bool init(void);
     size_t n() const { return this->v.size(); }
     const Font *fonts(void) const { return this->v.data(); }
-    uint32_t add(const Font &f);
+    Font *fonts(void) { return this->v.data(); }
+    /** Number of glyphs rasterized in the last frame. */
+    u64 rasterized_frame(void) const { return this->m_rasterized_frame; }
+    uint32_t add(Font f);
     uint32_t load(unsigned int size, const char *filename);
+    /**
+     * Uploads the regions of the atlas of the current font modified since
+     * the last call and starts a new frame for all atlases.
+     */
+    bool update(void);
 };
 
 }
@@ -8,8 +8,27 @@ using nngn::Fonts;
 
 namespace {
 
+const nngn::Font &cur(const Fonts &f) { return f.fonts()[f.n() - 1]; }
+
 void register_fonts(nngn::lua::table_view t) {
+    static constexpr nngn::to<lua_Integer> cast = {};
     t["n"] = [](Fonts &f) { return nngn::narrow<lua_Integer>(f.n()); };
+    t["n_rasterized"] = [](const Fonts &f) {
+        nngn::u64 ret = 0;
+        for(std::size_t i = 0, n = f.n(); i != n; ++i)
+            ret += f.fonts()[i].n_rasterized;
+        return cast(ret);
+    };
+    t["rasterized_frame"] = [](const Fonts &f)
+        { return cast(f.rasterized_frame()); };
+    t["atlas_extent"] = [](const Fonts &f)
+        { return cast(cur(f).atlas.extent()); };
+    t["atlas_glyphs"] = [](const Fonts &f)
+        { return cast(cur(f).atlas.size()); };
+    t["atlas_occupancy"] = [](const Fonts &f)
+        { return nngn::narrow<lua_Number>(cur(f).atlas.occupancy()); };
+    t["atlas_evicted"] = [](const Fonts &f)
+        { return cast(cur(f).atlas.n_evicted()); };
     t["load"] = &Fonts::load;
 }
 
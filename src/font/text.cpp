@@ -1,26 +1,77 @@
 #include <algorithm>
 #include <cassert>
-#include <numeric>
+#include <utility>
+
+#include "utils/utf8.h"
 
 #include "font.h"
 #include "text.h"
+#include "textbox.h"
 
 namespace nngn {
 
+void Text::layout(Font &f) {
+    const std::string_view s = this->str;
+    this->glyphs.clear();
+    this->lines.assign(1, {});
+    float x = 0, max_width = 0;
+    u32 col = 0;
+    unsigned char cmd = 0;
+    for(std::size_t i = 0, n = 0; i != s.size(); i += n) {
+        n = 1;
+        const auto b = static_cast<unsigned char>(s[i]);
+        if(b == '\n') {
+            max_width = std::max(max_width, std::exchange(x, 0.0f));
+            col = 0;
+            this->lines.push_back({
+                .begin = narrow<u32>(i + 1),
+                .max_width = max_width,
+            });
+        } else if(Textbox::is_command(b))
+            cmd = b;
+        else if(utf8::seq_len(b)) {
+            const auto c = utf8::decode(s.substr(i), &n);
+            const auto advance = f.glyph(c).advance;
+            this->glyphs.push_back({
+                .x = x,
+                .advance = advance,
+                .line = narrow<u32>(this->lines.size() - 1),
+                .col = col++,
+                .end = narrow<u32>(i + n),
+                .c = c,
+                .cmd = cmd,
+            });
+            x += advance;
+        }
+    }
+}
+
 void Text::update_cur(const Font &f, std::size_t c) {
     assert(c <= this->str.size());
     this->cur = c;
-    this->nlines = Text::count_lines(this->str, this->cur);
+    this->nlines = static_cast<std::size_t>(
+        std::ranges::upper_bound(this->lines, c, {}, &Line::begin)
+        - this->lines.begin());
+    this->n_glyphs = static_cast<std::size_t>(
+        std::ranges::partition_point(this->glyphs,
+            [c](const auto &g) { return g.end <= c; })
+        - this->glyphs.begin());
     this->update_size(f);
 }
 
 void Text::update_size(const Font &f) {
     const auto flines = static_cast<float>(this->nlines);
     const auto fsize = static_cast<float>(f.size);
-    this->size = {
-        Text::max_width(f.chars, this->str, this->cur),
-        flines * (fsize + this->spacing) - this->spacing,
-    };
+    float width = 0;
+    if(this->nlines) {
+        const auto line = this->nlines - 1;
+        width = this->lines[line].max_width;
+        if(this->n_glyphs)
+            if(const auto &g = this->glyphs[this->n_glyphs - 1];
+                    g.line == line)
+                width = std::max(width, g.x + g.advance);
+    }
+    this->size = {width, flines * (fsize + this->spacing) - this->spacing};
 }
 
 std::size_t Text::count_lines(std::string_view s, std::size_t cur) {
@@ -30,23 +81,18 @@ std::size_t Text::count_lines(std::string_view s, std::size_t cur) {
         std::count(b, b + static_cast<std::ptrdiff_t>(cur), '\n'));
 }
 
-float Text::max_width(
-        const Font::Characters &font,
-        std::string_view str, std::size_t cur) {
-    assert(!cur || font.size() >= 128);
-    const auto *const end = str.cbegin() + static_cast<std::ptrdiff_t>(cur);
-    assert(end <= str.cend());
-    const auto acc = [&font](float a, char c) {
-        return static_cast<signed char>(c) < 0
-            ? 0 : a + font[static_cast<std::size_t>(c)].advance;
-    };
-    float ret = 0.0f;
-    for(const auto *it = str.cbegin(); it <= end;) {
-        const auto *const e = std::find(it, end, '\n');
-        ret = std::max(ret, std::accumulate(it, e, 0.0f, acc));
-        it = e + 1;
+float Text::max_width(Font &font, std::string_view str, std::size_t cur) {
+    assert(cur <= str.size());
+    str = str.substr(0, cur);
+    float ret = 0.0f, w = 0.0f;
+    for(std::size_t n = 0; !str.empty(); str.remove_prefix(n)) {
+        n = 1;
+        if(const auto c = static_cast<unsigned char>(str[0]); c == '\n')
+            ret = std::max(ret, std::exchange(w, 0.0f));
+        else if(utf8::seq_len(c))
+            w += font.glyph(utf8::decode(str, &n)).advance;
     }
-    return ret;
+    return std::max(ret, w);
 }
 
 }
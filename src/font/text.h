@@ -2,6 +2,7 @@
 #define NNGN_TEXT_H
 
 #include <string>
+#include <vector>
 
 #include "math/vec2.h"
 
@@ -9,26 +10,62 @@
 
 namespace nngn {
 
+/**
+ * UTF-8 string revealed progressively up to a cursor.
+ * The position of every character is computed once when the text is
+ * constructed (see \ref layout), so that moving the cursor does not require
+ * traversing the string again.
+ */
 struct Text {
+    /** Laid out character. */
+    struct Glyph {
+        /** Pen position relative to the start of the line. */
+        float x;
+        float advance;
+        u32 line;
+        /** Number of characters before this one in the line. */
+        u32 col;
+        /** Offset of the byte following the character in \ref str. */
+        u32 end;
+        char32_t c;
+        /** Last text box command before the character, or zero. */
+        unsigned char cmd;
+    };
+    struct Line {
+        /** Offset of the first byte of the line in \ref str. */
+        u32 begin;
+        /** Width of the widest of the previous lines. */
+        float max_width;
+    };
     std::string str = {};
+    std::vector<Glyph> glyphs = {};
+    std::vector<Line> lines = {};
     size_t cur = 0, nlines = 0;
+    /** Number of elements of \ref glyphs before \ref cur. */
+    size_t n_glyphs = 0;
     float spacing = 0;
     vec2 size = {0, 0};
     constexpr Text() = default;
-    Text(const Font &f, std::string_view s);
-    Text(const Font &f, std::string_view s, size_t cur);
+    Text(Font &f, std::string_view s);
+    Text(Font &f, std::string_view s, size_t cur);
+    /** Computes \ref glyphs and \ref lines for the entire string. */
+    void layout(Font &f);
     void update_cur(const Font &f, size_t cur);
     void update_size(const Font &f);
     static size_t count_lines(std::string_view s, size_t cur);
-    static float max_width(
-        const Font::Characters &font, std::string_view s, size_t cur);
+    /**
+     * Width of the longest of the first \p cur bytes of \p s, in UTF-8.
+     * Bytes which cannot start a sequence (e.g. text box commands) are
+     * ignored.
+     */
+    static float max_width(Font &font, std::string_view s, size_t cur);
 };
 
-inline Text::Text(const Font &f, std::string_view s)
+inline Text::Text(Font &f, std::string_view s)
     : Text(f, s, s.size()) {}
-inline Text::Text(const Font &f, std::string_view s, size_t c)
+inline Text::Text(Font &f, std::string_view s, size_t c)
     : str(s), spacing(static_cast<float>(f.size) / 4.0f)
-    { this->update_cur(f, c); }
+    { this->layout(f); this->update_cur(f, c); }
 
 }
 
@@ -7,20 +7,14 @@
 
 namespace {
 
-auto font(const nngn::Fonts *f) { assert(f); return f->fonts() + f->n() - 1; }
+auto font(nngn::Fonts *f) { assert(f); return f->fonts() + f->n() - 1; }
 
 }
 
 namespace nngn {
 
 std::size_t Textbox::text_length(void) const {
-    constexpr auto f = [](const auto &t) {
-        const auto b = t.str.begin();
-        return static_cast<u32>(std::count_if(
-            b, b + static_cast<std::ptrdiff_t>(t.cur),
-            static_cast<bool(*)(char)>(&Textbox::is_character)));
-    };
-    return f(this->title) + f(this->str);
+    return this->title.n_glyphs + this->str.n_glyphs;
 }
 
 void Textbox::set_title(const char *s) {
@@ -36,24 +30,27 @@ void Textbox::set_text(const char *s) {
 
 void Textbox::set_cur(std::size_t cur) {
     this->str.update_cur(*font(this->fonts), cur);
+    this->flags.set(Flag::UPDATED);
 }
 
 bool Textbox::update(const nngn::Timing &t) {
     this->timer += std::chrono::duration_cast<std::chrono::microseconds>(t.dt);
-    const auto size = this->str.str.size();
-    auto cur = this->str.cur;
-    if(cur == size)
-        return this->flags.is_set(Flag::SCREEN_UPDATED);
+    auto &s = this->str;
+    const auto size = s.str.size();
+    const auto n_glyphs = s.glyphs.size();
     const auto n = this->speed.count()
         ? static_cast<std::size_t>(this->timer / this->speed)
-        : size;
-    std::size_t c = 0;
-    for(; cur != size && c != n; ++cur)
-        if(Textbox::is_character(this->str.str[cur]))
-            c++;
-    this->timer -= this->speed * c;
-    this->str.update_cur(*font(this->fonts), cur);
-    this->flags.set(Flag::UPDATED);
+        : n_glyphs;
+    if(s.cur == size || !n)
+        return this->flags.is_set(Flag::SCREEN_UPDATED);
+    const auto end = std::min(s.n_glyphs + n, n_glyphs);
+    this->timer -= this->speed * (end - s.n_glyphs);
+    const auto nlines = s.nlines;
+    // Anything after the last character (e.g. commands) is revealed with it.
+    s.update_cur(
+        *font(this->fonts),
+        end == n_glyphs ? size : std::size_t{s.glyphs[end - 1].end});
+    this->flags.set(s.nlines == nlines ? Flag::APPENDED : Flag::UPDATED);
     return true;
 }
 
@@ -61,7 +58,7 @@ void Textbox::update_size(void) {
     const auto *const f = font(this->fonts);
     const auto pad = static_cast<float>(f->size) / 2;
     const auto title_width = this->monospaced()
-        ? static_cast<float>(f->size * this->title.str.size())
+        ? static_cast<float>(f->size * this->title.n_glyphs)
         : this->title.size.x;
     const auto title_sz = 2 * pad + vec2{title_width, this->title.size.y};
     this->title_bl = this->str_bl + pad + vec2{0, this->str.size.y};
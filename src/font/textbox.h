@@ -21,6 +21,8 @@ public:
         UPDATED = 1u << 0,
         SCREEN_UPDATED = 1u << 1,
         MONOSPACED = 1u << 2,
+        /** Characters were revealed without moving the previous ones. */
+        APPENDED = 1u << 3,
     };
     struct Command {
         enum : unsigned char {
@@ -35,15 +37,15 @@ public:
     std::chrono::milliseconds speed = DEFAULT_SPEED;
     vec2 title_bl = {0, 0}, title_tr = {0, 0};
     vec2 str_bl = {0, 0}, str_tr = {0, 0};
-    static bool is_character(unsigned char c);
-    static bool is_character(char c);
     static bool is_command(unsigned char c);
     static bool is_command(char c);
-    void init(const Fonts *f) { this->fonts = f; }
+    void init(Fonts *f) { this->fonts = f; }
     bool empty(void) const;
     std::size_t text_length(void) const;
     bool monospaced(void) const { return this->flags.is_set(Flag::MONOSPACED); }
     bool updated(void) const;
+    /** Whether the only change since \ref clear_updated is \c APPENDED. */
+    bool appended(void) const;
     bool finished(void) const { return this->str.cur == this->str.str.size(); }
     void set_monospaced(bool m);
     void set_screen_updated(void) { this->flags.set(Flag::SCREEN_UPDATED); }
@@ -57,17 +59,9 @@ public:
     void clear_updated(void);
 private:
     Flags<Flag> flags = {};
-    const Fonts *fonts = nullptr;
+    Fonts *fonts = nullptr;
 };
 
-inline bool Textbox::is_character(unsigned char c) {
-    return c < Command::MIN && c != '\n';
-}
-
-inline bool Textbox::is_character(char c) {
-    return Textbox::is_character(static_cast<unsigned char>(c));
-}
-
 inline bool Textbox::is_command(unsigned char c) {
     return Command::MIN <= c && c < Command::MAX;
 }
@@ -87,11 +81,18 @@ inline void Textbox::set_monospaced(bool m) {
 }
 
 inline bool Textbox::updated(void) const {
-    return this->flags.is_set(Flag::UPDATED | Flag::SCREEN_UPDATED);
+    return this->flags.is_set(
+        Flag::UPDATED | Flag::SCREEN_UPDATED | Flag::APPENDED);
+}
+
+inline bool Textbox::appended(void) const {
+    return this->flags.is_set(Flag::APPENDED)
+        && !this->flags.is_set(Flag::UPDATED | Flag::SCREEN_UPDATED);
 }
 
 inline void Textbox::clear_updated(void) {
-    this->flags.clear(Flag::UPDATED | Flag::SCREEN_UPDATED);
+    this->flags.clear(
+        Flag::UPDATED | Flag::SCREEN_UPDATED | Flag::APPENDED);
 }
 
 }
@@ -373,10 +373,11 @@ struct Graphics {
     virtual bool load_textures(
         std::uint32_t i, std::uint32_t n, const std::byte *v) = 0;
     // Fonts
+    /** Recreates the font atlas texture with \p s × \p s texels. */
     virtual bool resize_font(std::uint32_t s) = 0;
+    /** Updates a region of the font atlas with RGBA data, top row first. */
     virtual bool load_font(
-        unsigned char c, std::uint32_t n,
-        const nngn::uvec2 *size, const std::byte *v) = 0;
+        nngn::uvec2 pos, nngn::uvec2 size, const std::byte *v) = 0;
     // Rendering
     virtual bool set_render_list(const RenderList &l) = 0;
     virtual void poll_events() const = 0;
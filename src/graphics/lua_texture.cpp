@@ -4,6 +4,7 @@
 
 #include "const.h"
 #include "math/lua_vector.h"
+#include "utils/log.h"
 
 #include "texture.h"
 
@@ -30,6 +31,65 @@ auto load_data(Textures &t, const char *name, const bvec *p) {
     return t.load_data(name, p ? p->data() : nullptr);
 }
 
+auto decode_threads(const Textures &t) {
+    return nngn::narrow<lua_Integer>(t.decode_threads());
+}
+
+auto n_pending(const Textures &t) {
+    return nngn::narrow<lua_Integer>(t.n_pending());
+}
+
+bool set_decode_threads(Textures &t, lua_Integer n) {
+    return t.set_decode_threads(nngn::narrow<std::size_t>(n));
+}
+
+auto cache_dir(const Textures &t) { return t.cache().dir().string(); }
+
+auto cache_hits(const Textures &t) {
+    return nngn::narrow<lua_Integer>(t.cache().hits());
+}
+
+auto cache_misses(const Textures &t) {
+    return nngn::narrow<lua_Integer>(t.cache().misses());
+}
+
+bool set_cache_dir(Textures &t, const char *dir) {
+    return t.set_cache_dir(dir);
+}
+
+void set_upload_budget(Textures &t, lua_Integer n) {
+    t.set_upload_budget(nngn::narrow<u32>(n));
+}
+
+/**
+ * Starts an asynchronous load.
+ * The optional third argument is a function, called with the index of the
+ * texture (or zero on failure) once the data are available.
+ */
+auto load_async(
+    Textures &t, const char *filename, nngn::lua::state_view lua
+) {
+    if(lua_type(lua, 3) != LUA_TFUNCTION)
+        return t.load_async(filename);
+    // The caller may be a coroutine which no longer exists when the load
+    // finishes, so the callback is executed in the main thread.
+    lua_rawgeti(lua, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+    auto *const L = lua_tothread(lua, -1);
+    lua_pop(lua, 1);
+    lua_pushvalue(lua, 3);
+    const int ref = luaL_ref(lua, LUA_REGISTRYINDEX);
+    return t.load_async(filename, [L, ref](u32 i) {
+        NNGN_LOG_CONTEXT("texture load callback");
+        lua_pushcfunction(L, nngn::lua::msgh);
+        lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+        luaL_unref(L, LUA_REGISTRYINDEX, ref);
+        lua_pushinteger(L, i);
+        const bool ok = lua_pcall(L, 1, 0, -3) == LUA_OK;
+        lua_pop(L, ok ? 1 : 2);
+        return ok;
+    });
+}
+
 auto update_data(Textures &t, lua_Integer id, const bvec &p) {
     return t.update_data(nngn::narrow<u32>(id), p.data());
 }
@@ -59,9 +119,19 @@ void register_textures(nngn::lua::table_view t) {
     t["max"] = &Textures::max;
     t["n"] = &Textures::n;
     t["generation"] = generation;
+    t["decode_threads"] = decode_threads;
+    t["upload_budget"] = &Textures::upload_budget;
+    t["n_pending"] = n_pending;
+    t["cache_dir"] = cache_dir;
+    t["cache_hits"] = cache_hits;
+    t["cache_misses"] = cache_misses;
     t["set_max"] = &Textures::set_max;
+    t["set_decode_threads"] = set_decode_threads;
+    t["set_upload_budget"] = set_upload_budget;
+    t["set_cache_dir"] = set_cache_dir;
     t["load_data"] = load_data;
     t["load"] = &Textures::load;
+    t["load_async"] = load_async;
     t["reload"] = &Textures::reload;
     t["reload_all"] = &Textures::reload_all;
     t["update_data"] = update_data;
@@ -0,0 +1,55 @@
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/table.h"
+
+#include "math/lua_vector.h"
+#include "utils/log.h"
+
+#include "texture_atlas.h"
+
+using nngn::u32;
+using nngn::TextureAtlas;
+
+namespace {
+
+auto load_data(
+    TextureAtlas &a, const char *name, lua_Integer w, lua_Integer h,
+    const nngn::lua_vector<std::byte> &v
+) {
+    NNGN_LOG_CONTEXT_CF(TextureAtlas);
+    const nngn::uvec2 size = {nngn::narrow<u32>(w), nngn::narrow<u32>(h)};
+    if(v.size() < std::size_t{4} * size.x * size.y)
+        return nngn::Log::l() << "buffer too small\n", u32{};
+    return a.load_data(name, size, v.data());
+}
+
+/** Texture coordinates in the format of the `uv` sprite property. */
+auto uv(const TextureAtlas &a, lua_Integer i, nngn::lua::state_view lua) {
+    const auto [uv0, uv1] = a.uv(nngn::narrow<u32>(i));
+    constexpr auto f = [](float x) { return nngn::narrow<lua_Number>(x); };
+    return nngn::lua::table_array(
+        lua, f(uv0.x), f(uv0.y), f(uv1.x), f(uv1.y)).release();
+}
+
+void register_texture_atlas(nngn::lua::table_view t) {
+    static constexpr nngn::to<lua_Integer> cast = {};
+    t["PADDING"] = TextureAtlas::PADDING;
+    t["n"] = [](const TextureAtlas &a) { return cast(a.n()); };
+    t["n_layers"] = [](const TextureAtlas &a) { return cast(a.n_layers()); };
+    t["generation"] = [](const TextureAtlas &a)
+        { return cast(a.generation()); };
+    t["occupancy"] = [](const TextureAtlas &a)
+        { return nngn::narrow<lua_Number>(a.occupancy()); };
+    t["tex"] = [](const TextureAtlas &a, lua_Integer i)
+        { return a.tex(nngn::narrow<u32>(i)); };
+    t["uv"] = uv;
+    t["load_data"] = load_data;
+    t["load"] = &TextureAtlas::load;
+    t["remove"] = &TextureAtlas::remove;
+    t["repack"] = &TextureAtlas::repack;
+}
+
+}
+
+NNGN_LUA_DECLARE_USER_TYPE(TextureAtlas)
+NNGN_LUA_PROXY(TextureAtlas, register_texture_atlas)
@@ -39,7 +39,6 @@ std::unique_ptr<Graphics> graphics_create_backend<backend_es>(const void*) {
 #include <string_view>
 #include <vector>
 
-#include "font/font.h"
 #include "graphics/glfw.h"
 #include "graphics/shaders.h"
 #include "math/camera.h"
@@ -200,8 +199,7 @@ public:
     bool load_textures(u32 i, u32 n, const std::byte *v) final;
     bool resize_font(u32 s) final;
     bool load_font(
-        unsigned char c, u32 n,
-        const nngn::uvec2 *size, const std::byte *v) final;
+        nngn::uvec2 pos, nngn::uvec2 size, const std::byte *v) final;
     bool set_render_list(const RenderList&) final;
     bool render() final;
     bool vsync() final;
@@ -689,23 +687,21 @@ bool OpenGLBackend::resize_font(u32 s) {
         && LOG_RESULT(glGenTextures, 1, &this->font_tex.id())
         && this->font_tex.create(
             GL_TEXTURE_2D_ARRAY, GL_RGBA8, GL_NEAREST, GL_NEAREST, GL_REPEAT,
-            {si, si, nngn::Font::N},
-            static_cast<GLsizei>(nngn::Math::mip_levels(s)))
+            {si, si, 1}, 1)
         && nngn::gl_set_obj_name(GL_TEXTURE, this->font_tex.id(), "font_tex"sv);
 }
 
 bool OpenGLBackend::load_font(
-    unsigned char c, u32 n, const nngn::uvec2 *size, const std::byte *v
+    nngn::uvec2 pos, nngn::uvec2 size, const std::byte *v
 ) {
     NNGN_LOG_CONTEXT_CF(OpenGLBackend);
     constexpr auto type = GL_TEXTURE_2D_ARRAY;
     CHECK_RESULT(glBindTexture, type, this->font_tex.id());
-    for(size_t i = 0; i < n; ++i, ++c, v += 4_z * size->x * size->y, ++size)
-        CHECK_RESULT(
-            glTexSubImage3D, type, 0, 0, 0, static_cast<GLint>(c),
-            static_cast<GLsizei>(size->x), static_cast<GLsizei>(size->y),
-            1, GL_RGBA, GL_UNSIGNED_BYTE, v);
-    CHECK_RESULT(glGenerateMipmap, type);
+    CHECK_RESULT(
+        glTexSubImage3D, type, 0,
+        static_cast<GLint>(pos.x), static_cast<GLint>(pos.y), 0,
+        static_cast<GLsizei>(size.x), static_cast<GLsizei>(size.y),
+        1, GL_RGBA, GL_UNSIGNED_BYTE, v);
     return true;
 }
 
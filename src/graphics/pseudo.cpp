@@ -22,7 +22,8 @@ bool Pseudograph::write_to_buffer(
 
 bool Pseudograph::vsync() {
     constexpr auto t = std::chrono::milliseconds(1000) / 60.0f;
-    std::this_thread::sleep_for(t);
+    if(const auto i = this->m_swap_interval; i > 0)
+        std::this_thread::sleep_for(t * static_cast<float>(i));
     return true;
 }
 
@@ -32,14 +32,14 @@ struct Pseudograph : Graphics {
     void memory_types(std::size_t, std::size_t, MemoryType*) const override {}
     bool error() override { return false; }
     bool window_closed() const override { return false; }
-    int swap_interval() const override { return 1; }
+    int swap_interval() const override { return this->m_swap_interval; }
     uvec2 window_size() const override { return {}; }
     GraphicsStats stats() override { return {}; }
     void get_keys(size_t, int32_t*) const override {}
     ivec2 mouse_pos(void) const override { return {}; }
     bool set_n_frames(std::size_t) override { return true; }
     bool set_n_swap_chain_images(std::size_t) override { return true; }
-    void set_swap_interval(int) override {}
+    void set_swap_interval(int i) override { this->m_swap_interval = i; }
     void set_window_title(const char*) override {}
     void set_cursor_mode(CursorMode) override {}
     void set_size_callback(void*, size_callback_f) override {}
@@ -74,13 +74,15 @@ struct Pseudograph : Graphics {
     bool resize_textures(u32) override { return true; }
     bool load_textures(u32, u32, const std::byte*) override { return true; }
     bool resize_font(u32) override { return true; }
-    bool load_font(
-            unsigned char, u32, const nngn::uvec2*, const std::byte*) override
+    bool load_font(nngn::uvec2, nngn::uvec2, const std::byte*) override
         { return true; }
     void poll_events() const override {}
     bool set_render_list(const RenderList&) override { return true; }
     bool render() override { return true; }
+    /** Sleeps for \ref swap_interval 60Hz periods (none if `0`). */
     bool vsync() override;
+private:
+    int m_swap_interval = 1;
 };
 
 }
@@ -23,7 +23,7 @@ void write_suffix(std::span<char> s, nngn::Flags<Flag> f) {
 }
 
 void resize_and_fill(
-    nngn::term::FrameBuffer *f, std::vector<char> *v,
+    nngn::term::FrameBuffer *f, auto *v,
     std::size_t n, auto fill)
 {
     constexpr auto size = sizeof(fill);
@@ -3,6 +3,7 @@
 
 #include "graphics/graphics.h"
 #include "os/os.h"
+#include "utils/alloc/accounting.h"
 #include "utils/ranges.h"
 
 #include "texture.h"
@@ -57,7 +58,7 @@ private:
     std::size_t pixel_size(void) const;
     Flags<Flag> flags;
     Mode mode;
-    std::vector<char> v = {}, flip_tmp = {};
+    accounted_vector<char, memory_tag::terminal> v = {}, flip_tmp = {};
     std::size_t prefix_size, suffix_size;
     uvec2 m_size = {};
 };
@@ -19,7 +19,6 @@ std::unique_ptr<Graphics> graphics_create_backend<backend>(const void*) {
 
 #else
 
-#include "font/font.h"
 #include "graphics/pseudo.h"
 #include "os/terminal.h"
 #include "timing/limit.h"
@@ -87,8 +86,7 @@ private:
     bool load_textures(u32 i, u32 n, const std::byte *v) final;
     bool resize_font(u32 n) final;
     bool load_font(
-        unsigned char c, u32 n, const nngn::uvec2 *size,
-        const std::byte *v) final;
+        nngn::uvec2 pos, nngn::uvec2 size, const std::byte *v) final;
     bool set_render_list(const Graphics::RenderList &l) final;
     bool render(void) final;
     // Buffer/texture helpers
@@ -208,20 +206,15 @@ bool TerminalBackend::load_textures(u32 i, u32 n, const std::byte *v) {
 }
 
 bool TerminalBackend::resize_font(u32 n) {
-    if(this->fonts.empty())
-        this->fonts.resize(nngn::Font::N);
-    for(auto &x : this->fonts)
-        x.resize({n, n});
+    this->fonts.resize(1);
+    this->fonts[0].resize({n, n});
     return true;
 }
 
 bool TerminalBackend::load_font(
-    unsigned char c, u32 n, const nngn::uvec2 *size, const std::byte *v)
+    nngn::uvec2 pos, nngn::uvec2 size, const std::byte *v)
 {
-    for(const auto e = c + n; c < e; ++c) {
-        this->fonts[c].copy(*size, nngn::byte_cast<const u8*>(v));
-        v += nngn::Math::product(*size++);
-    }
+    this->fonts[0].copy(pos, size, nngn::byte_cast<const u8*>(v));
     return true;
 }
 
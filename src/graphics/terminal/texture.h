@@ -24,7 +24,7 @@ public:
     std::span<const texel4> data(void) const { return this->m_data; }
     void resize(uvec2 size);
     void copy(const u8 *p);
-    void copy(uvec2 size, const u8 *p);
+    void copy(uvec2 off, uvec2 size, const u8 *p);
     texel4 sample(vec2 uv) const;
 private:
     uvec2 m_size;
@@ -44,8 +44,8 @@ inline void Texture::copy(const u8 *p) {
     std::copy(p, p + this->m_data.size(), this->m_data.front().data());
 }
 
-inline void Texture::copy(uvec2 size, const u8 *p) {
-    auto *dst = this->m_data.front().data();
+inline void Texture::copy(uvec2 off, uvec2 size, const u8 *p) {
+    auto *dst = this->m_data[this->m_size.x * off.y + off.x].data();
     for(auto y = 0u; y != size.y; ++y) {
         std::copy(p, p + 4_z * size.x, dst);
         p += 4_z * size.x;
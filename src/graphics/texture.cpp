@@ -2,6 +2,10 @@
 #include <cassert>
 #include <cstring>
 #include <fstream>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include "os/platform.h"
@@ -13,6 +17,7 @@ using namespace std::string_view_literals;
 #endif
 
 #include "math/math.h"
+#include "timing/trace.h"
 #include "utils/log.h"
 
 #include "graphics.h"
@@ -25,16 +30,6 @@ namespace {
 constexpr auto SIZE = nngn::Graphics::TEXTURE_SIZE;
 constexpr auto EXTENT = nngn::Graphics::TEXTURE_EXTENT;
 
-u32 find(const std::vector<nngn::Hash> &v, std::string_view name) {
-    return static_cast<u32>(
-        std::distance(begin(v), std::find(begin(v), end(v), nngn::hash(name))));
-}
-
-u32 find_empty(const std::vector<u32> &v) {
-    return static_cast<u32>(
-        std::distance(begin(v), std::find(begin(v), end(v), 0)));
-}
-
 bool check_max(std::size_t n, u32 i) {
     if(static_cast<std::size_t>(i) < n)
         return true;
@@ -53,6 +48,22 @@ bool write_png(const char*, std::span<const std::byte>) {
 
 #else
 
+std::vector<std::byte> read_png(const char *filename, nngn::uvec2 *size) {
+    std::vector<std::byte> ret;
+    png_image img;
+    std::memset(&img, 0, sizeof(img));
+    img.version = PNG_IMAGE_VERSION;
+    if(!png_image_begin_read_from_file(&img, filename)) {
+        nngn::Log::l() << img.message << std::endl;
+        return ret;
+    }
+    *size = {img.width, img.height};
+    img.format = PNG_FORMAT_RGBA;
+    ret.resize(static_cast<std::size_t>(PNG_IMAGE_SIZE(img)));
+    png_image_finish_read(&img, nullptr, ret.data(), 0, nullptr);
+    return ret;
+}
+
 bool write_png(const char *filename, std::span<const std::byte> s) {
     png_image img = {
         .version = PNG_IMAGE_VERSION,
@@ -86,27 +97,40 @@ std::vector<std::byte> Textures::read(const char*) {
     return {};
 }
 
+std::vector<std::byte> Textures::read(const char*, uvec2*) {
+    Log::l() << "compiled without libpng support\n";
+    return {};
+}
+
 #else
 
 std::vector<std::byte> Textures::read(const char *filename) {
     NNGN_LOG_CONTEXT_CF(Textures);
     NNGN_LOG_CONTEXT(filename);
-    std::vector<std::byte> ret;
-    png_image img;
-    std::memset(&img, 0, sizeof(img));
-    img.version = PNG_IMAGE_VERSION;
-    if(!png_image_begin_read_from_file(&img, filename))
-        Log::l() << img.message << std::endl;
-    else if(img.width != EXTENT && img.height != EXTENT)
+    uvec2 size = {};
+    auto ret = read_png(filename, &size);
+    if(!ret.empty() && size != uvec2{EXTENT}) {
         Log::l()
             << "only " << EXTENT << "x" << EXTENT
             << " images are supported, got "
-            << img.width << "x" << img.height
+            << size.x << "x" << size.y
             << std::endl;
-    else {
-        img.format = PNG_FORMAT_RGBA;
-        ret.resize(static_cast<std::size_t>(PNG_IMAGE_SIZE(img)));
-        png_image_finish_read(&img, nullptr, ret.data(), 0, nullptr);
+        ret = {};
+    }
+    return ret;
+}
+
+std::vector<std::byte> Textures::read(const char *filename, uvec2 *size) {
+    NNGN_LOG_CONTEXT_CF(Textures);
+    NNGN_LOG_CONTEXT(filename);
+    auto ret = read_png(filename, size);
+    if(!ret.empty() && (EXTENT < size->x || EXTENT < size->y)) {
+        Log::l()
+            << "images larger than " << EXTENT << "x" << EXTENT
+            << " are not supported, got "
+            << size->x << "x" << size->y
+            << std::endl;
+        ret = {};
     }
     return ret;
 }
@@ -139,17 +163,70 @@ bool Textures::write(
     }
 }
 
+u32 Textures::find(std::string_view name) const {
+    const auto [b, e] = this->index.equal_range(this->m_hash(name));
+    for(auto it = b; it != e; ++it)
+        if(this->names[it->second] == name)
+            return it->second;
+    return 0;
+}
+
+u32 Textures::find_empty(void) const {
+    return this->free_slots.empty()
+        ? static_cast<u32>(this->counts.size())
+        : this->free_slots.back();
+}
+
 u32 Textures::insert(u32 i, std::string_view name, const std::byte *p) {
     assert(i < this->counts.size());
+    assert(!this->counts[i]);
+    this->unindex(i);
     if(p && !this->update_data(static_cast<u32>(i), p))
         return 0;
-    this->hashes[i] = hash(name);
+    const auto h = this->m_hash(name);
+    this->hashes[i] = h;
     this->counts[i] = 1;
     this->names[i] = name;
+    this->index.emplace(h, i);
+    this->mark_used(i);
     ++this->gen;
     return i;
 }
 
+void Textures::add_count(u32 i, std::size_t n) {
+    const bool was_free = !this->counts[i];
+    this->counts[i] = static_cast<u32>(this->counts[i] + n);
+    if(was_free && this->counts[i])
+        this->mark_used(i);
+}
+
+void Textures::mark_free(u32 i) {
+    if(this->free_pos[i] != USED)
+        return;
+    this->free_pos[i] = static_cast<u32>(this->free_slots.size());
+    this->free_slots.push_back(i);
+}
+
+void Textures::mark_used(u32 i) {
+    const auto pos = std::exchange(this->free_pos[i], USED);
+    if(pos == USED)
+        return;
+    const auto last = this->free_slots.back();
+    this->free_slots[pos] = last;
+    this->free_pos[last] = last == i ? USED : pos;
+    this->free_slots.pop_back();
+}
+
+void Textures::unindex(u32 i) {
+    const auto [b, e] = this->index.equal_range(this->hashes[i]);
+    const auto it = std::find_if(b, e, [i](const auto &x)
+        { return x.second == i; });
+    if(it != e)
+        this->index.erase(it);
+    this->hashes[i] = {};
+    this->names[i].clear();
+}
+
 void Textures::red_to_rgba(
     std::span<std::byte> dst, std::span<const std::byte> src)
 {
@@ -174,26 +251,93 @@ void Textures::flip_y(std::span<std::byte> s) {
     }
 }
 
+auto Textures::find_pending(u32 i) -> pending_load* {
+    const auto it = std::ranges::find(this->pending, i, &pending_load::i);
+    return it == end(this->pending) ? nullptr : &*it;
+}
+
+auto Textures::read_cached(u32 i, const char *filename) -> decoded {
+    decoded ret = {.i = i};
+    // Read before decoding, so that a concurrent change invalidates the entry.
+    std::optional<i64> t = {};
+    if(this->m_cache.enabled() && (t = TextureCache::mtime(filename))) {
+        auto f = std::make_unique<MappedFile>();
+        if(const auto s = this->m_cache.read(filename, *t, f.get());
+                !s.empty()) {
+            const auto off = static_cast<std::size_t>(
+                s.data() - f->data().data());
+            f->prefetch(off, s.size());
+            ret.file = std::move(f);
+            ret.mapped = s;
+            return ret;
+        }
+    }
+    ret.data = Textures::read(filename);
+    if(t && !ret.data.empty())
+        this->m_cache.write(filename, *t, ret.data);
+    return ret;
+}
+
 u32 Textures::n(void) const {
-    return static_cast<u32>(
-        std::count_if(begin(this->counts), end(this->counts), std::identity{}));
+    return static_cast<u32>(this->counts.size() - this->free_slots.size());
 }
 
 void Textures::set_max(u32 n) {
     this->hashes.resize(n);
     this->counts.resize(n);
     this->names.resize(n);
+    this->free_pos.resize(n);
+    this->index.clear();
+    this->free_slots.clear();
+    for(u32 i = n; i--;) {
+        if(!this->names[i].empty())
+            this->index.emplace(this->hashes[i], i);
+        this->free_pos[i] = USED;
+        if(!this->counts[i])
+            this->mark_free(i);
+    }
+}
+
+bool Textures::set_decode_threads(std::size_t n) {
+    NNGN_LOG_CONTEXT_CF(Textures);
+    if(n == this->decode_threads())
+        return true;
+    if constexpr(Platform::emscripten)
+        if(n)
+            return Log::l() << "threads are not supported\n", false;
+    {
+        const std::lock_guard lock = std::lock_guard{this->m};
+        this->exit = true;
+    }
+    this->cv.notify_all();
+    for(auto &x : this->workers)
+        x.join();
+    this->workers.clear();
+    this->exit = false;
+    this->workers.reserve(n);
+    for(std::size_t i = 0; i != n; ++i)
+        this->workers.emplace_back(&Textures::decode, this);
+    return true;
+}
+
+bool Textures::set_cache_dir(std::filesystem::path p) {
+    NNGN_LOG_CONTEXT_CF(Textures);
+    if(!this->pending.empty())
+        return Log::l()
+            << "cannot change the cache directory while loads are pending\n",
+            false;
+    return this->m_cache.set_dir(std::move(p));
 }
 
 u32 Textures::load_data(const char *name, const std::byte *p) {
     NNGN_LOG_CONTEXT_CF(Textures);
     NNGN_LOG_CONTEXT(name);
-    if(const auto i = find(this->hashes, name); i < this->counts.size()) {
+    if(const auto i = this->find(name)) {
         Log::l() << "already loaded, ignoring data" << std::endl;
-        ++this->counts[i];
+        this->add_count(i, 1);
         return i;
     }
-    const auto i = find_empty(this->counts);
+    const auto i = this->find_empty();
     if(!check_max(this->counts.size(), i))
         return 0;
     return this->insert(i, name, p);
@@ -202,32 +346,170 @@ u32 Textures::load_data(const char *name, const std::byte *p) {
 u32 Textures::load(const char *filename) {
     NNGN_LOG_CONTEXT_CF(Textures);
     NNGN_LOG_CONTEXT(filename);
-    if(const auto i = find(this->hashes, filename); i < this->counts.size()) {
-        ++this->counts[i];
+    if(const auto i = this->find(filename)) {
+        this->add_count(i, 1);
         return i;
     }
-    const auto i = find_empty(this->counts);
+    const auto i = this->find_empty();
     if(!check_max(this->counts.size(), i))
         return 0;
-    const auto data = Textures::read(filename);
-    if(data.empty())
+    const auto d = this->read_cached(i, filename);
+    if(d.empty())
         return 0;
-    return this->insert(i, filename, data.data());
+    return this->insert(i, filename, d.bytes());
+}
+
+u32 Textures::load_async(const char *filename, load_fn f) {
+    NNGN_LOG_CONTEXT_CF(Textures);
+    NNGN_LOG_CONTEXT(filename);
+    if(const auto i = this->find(filename)) {
+        this->add_count(i, 1);
+        if(auto *const p = this->find_pending(i)) {
+            if(f)
+                p->callbacks.push_back(std::move(f));
+            return 0;
+        }
+        if(f)
+            this->ready.emplace_back(std::move(f), i);
+        return i;
+    }
+    const auto i = this->find_empty();
+    if(!check_max(this->counts.size(), i)) {
+        if(f)
+            this->ready.emplace_back(std::move(f), 0);
+        return 0;
+    }
+    this->insert(i, filename, nullptr);
+    auto &p = this->pending.emplace_back(
+        pending_load{.i = i, .name = filename, .callbacks = {}});
+    if(f)
+        p.callbacks.push_back(std::move(f));
+    {
+        const std::lock_guard lock = std::lock_guard{this->m};
+        this->requests.push_back({.i = i, .reload = false, .name = filename});
+    }
+    this->cv.notify_all();
+    return 0;
+}
+
+bool Textures::update(void) {
+    NNGN_LOG_CONTEXT_CF(Textures);
+    bool ok = true;
+    if(!this->pending.empty()) {
+        const auto budget = static_cast<std::size_t>(this->m_upload_budget);
+        std::vector<decoded> v = {};
+        std::vector<request> sync = {};
+        {
+            const std::lock_guard lock = std::lock_guard{this->m};
+            auto &r = this->results;
+            const auto n = static_cast<std::ptrdiff_t>(
+                std::min(budget, r.size()));
+            v.assign(
+                std::make_move_iterator(begin(r)),
+                std::make_move_iterator(begin(r) + n));
+            r.erase(begin(r), begin(r) + n);
+            if(this->workers.empty())
+                for(auto &q = this->requests;
+                        !q.empty() && v.size() + sync.size() < budget;
+                        q.pop_front())
+                    sync.push_back(std::move(q.front()));
+        }
+        for(auto &x : sync)
+            v.push_back(this->read_cached(x.i, x.name.c_str()));
+        for(auto &x : v)
+            ok = this->finish(std::move(x)) && ok;
+    }
+    for(auto &[f, i] : std::exchange(this->ready, {}))
+        ok = f(i) && ok;
+    return ok;
+}
+
+bool Textures::finish(decoded d) {
+    const auto i = d.i;
+    auto *const p = this->find_pending(i);
+    assert(p);
+    NNGN_LOG_CONTEXT(p->name.c_str());
+    // Decoding errors have already been logged and are reported only to the
+    // callbacks, while a failed upload is an error in the back end.
+    const bool owned = this->names[i] == p->name;
+    const bool has_data = owned && !d.empty();
+    const bool ok = has_data && this->update_data(i, d.bytes());
+    if(!owned)
+        Log::l() << "slot reused by " << this->names[i] << ", ignoring data\n";
+    else if(!ok) {
+        this->unindex(i);
+        this->counts[i] = 0;
+        this->mark_free(i);
+        ++this->gen;
+    } else if(!this->counts[i])
+        this->mark_free(i);
+    for(auto &f : p->callbacks)
+        this->ready.emplace_back(std::move(f), ok ? i : 0);
+    *p = std::move(this->pending.back());
+    this->pending.pop_back();
+    return ok || !has_data;
+}
+
+void Textures::decode(void) {
+    Trace::set_thread_name("textures");
+    std::unique_lock lock = std::unique_lock{this->m};
+    for(;;) {
+        this->cv.wait(lock, [this]
+            { return this->exit || !this->requests.empty(); });
+        if(this->exit)
+            return;
+        auto r = std::move(this->requests.front());
+        this->requests.pop_front();
+        lock.unlock();
+        auto d = this->read_cached(r.i, r.name.c_str());
+        lock.lock();
+        (r.reload ? this->reloaded : this->results).push_back(std::move(d));
+        if(r.reload)
+            this->cv.notify_all();
+    }
 }
 
 bool Textures::reload(u32 i) {
     NNGN_LOG_CONTEXT_CF(Textures);
     if(!this->graphics)
         return true;
-    const auto data = Textures::read(this->names[i].c_str());
-    return !data.empty() && this->update_data(i, data.data());
+    const auto d = this->read_cached(i, this->names[i].c_str());
+    return !d.empty() && this->update_data(i, d.bytes());
 }
 
 bool Textures::reload_all(void) {
-    for(std::size_t i = 1, n = this->counts.size(); i < n; ++i)
-        if(this->counts[i] && !this->reload(static_cast<u32>(i)))
-            return false;
-    return true;
+    NNGN_LOG_CONTEXT_CF(Textures);
+    if(this->workers.empty()) {
+        for(std::size_t i = 1, n = this->counts.size(); i < n; ++i)
+            if(this->counts[i] && !this->reload(static_cast<u32>(i)))
+                return false;
+        return true;
+    }
+    if(!this->graphics)
+        return true;
+    std::size_t n = 0;
+    {
+        const std::lock_guard lock = std::lock_guard{this->m};
+        for(u32 i = 1, e = narrow<u32>(this->counts.size()); i < e; ++i) {
+            // Pending textures are uploaded when their load finishes.
+            if(!this->counts[i] || this->find_pending(i))
+                continue;
+            this->requests.push_back(
+                {.i = i, .reload = true, .name = this->names[i]});
+            ++n;
+        }
+    }
+    this->cv.notify_all();
+    std::vector<decoded> v = {};
+    {
+        std::unique_lock lock = std::unique_lock{this->m};
+        this->cv.wait(lock, [this, n] { return this->reloaded.size() == n; });
+        v = std::exchange(this->reloaded, {});
+    }
+    bool ok = true;
+    for(const auto &x : v)
+        ok = !x.empty() && this->update_data(x.i, x.bytes()) && ok;
+    return ok;
 }
 
 bool Textures::update_data(u32 i, const std::byte *p) const {
@@ -240,22 +522,23 @@ void Textures::remove(u32 i) {
         return;
     assert(i);
     assert(this->counts[i]);
-    --this->counts[i];
+    if(!--this->counts[i] && !this->find_pending(i))
+        this->mark_free(i);
     ++this->gen;
 }
 
 void Textures::add_ref(u32 i, std::size_t n) {
     NNGN_LOG_CONTEXT_CF(Textures);
-    this->counts[i] = static_cast<u32>(this->counts[i] + n);
+    this->add_count(i, n);
     ++this->gen;
 }
 
 void Textures::add_ref(const char *filename, std::size_t n) {
     NNGN_LOG_CONTEXT_CF(Textures);
     NNGN_LOG_CONTEXT(filename);
-    const auto i = find(this->hashes, filename);
-    assert(i < this->counts.size());
-    this->counts[i] = static_cast<u32>(this->counts[i] + n);
+    const auto i = this->find(filename);
+    assert(i);
+    this->add_count(i, n);
     ++this->gen;
 }
 
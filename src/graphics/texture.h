@@ -2,12 +2,27 @@
 #define NNGN_GRAPHICS_TEXTURE_H
 
 #include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "math/hash.h"
+#include "math/vec2.h"
+#include "os/mapped_file.h"
+#include "utils/alloc/accounting.h"
 #include "utils/def.h"
+#include "utils/utils.h"
+
+#include "texture_cache.h"
 
 namespace nngn {
 
@@ -26,10 +41,22 @@ struct Graphics;
  * reference count (image data, if provided, is ignored).  When a texture is
  * removed, the reference count is decremented.  No special action is taken when
  * it reaches zero, but the slot is then considered unused and the ID will be
- * reused in future loads.
+ * reused in future loads.  Until then, loading the same ID again revives the
+ * slot without reading the image data.  Slots are found by ID through a hash
+ * table and unused slots are kept in a list, so neither operation depends on
+ * the number of textures.
  *
  * The index \c 0 is special: it is pre-allocated when the object is initialized
  * and returned in case of errors.  It is a texture with no associated data.
+ *
+ * Files can also be loaded asynchronously (see \ref load_async): image data
+ * are decoded by a pool of threads (see \ref set_decode_threads) and uploaded
+ * by \ref update, at most \ref upload_budget textures per call, so that
+ * loading many images does not stall the main thread.  Without decoding
+ * threads, images are decoded in \ref update, subject to the same budget.
+ *
+ * Files loaded by name can be stored in a \ref TextureCache (see \ref
+ * cache), which is checked before decoding them.
  */
 class Textures {
 public:
@@ -37,8 +64,22 @@ public:
         PNG = 1,
         PPM,
     };
+    /**
+     * Called by \ref update when an asynchronous load finishes.
+     * The argument is the index of the texture, or zero if the load failed.
+     * Returning \c false causes \ref update to fail.
+     */
+    using load_fn = std::function<bool(u32)>;
+    /** Default value for \ref set_upload_budget. */
+    static constexpr u32 DEFAULT_UPLOAD_BUDGET = 2;
     /** Reads raw RGBA image data from a file. */
     static std::vector<std::byte> read(const char *filename);
+    /**
+     * Reads raw RGBA image data of any size from a file.
+     * Images up to \ref Graphics::TEXTURE_EXTENT in each dimension are
+     * accepted, their size is written to \p size.
+     */
+    static std::vector<std::byte> read(const char *filename, uvec2 *size);
     /** Writes raw RGBA image data to a file. */
     static bool write(
         const char *filename, std::span<const std::byte> s, Format fmt);
@@ -54,6 +95,9 @@ public:
         std::span<std::byte> dst, std::span<const std::byte> src);
     /** Reverses the rows of a buffer containing raw RGBA image data. */
     static void flip_y(std::span<std::byte> s);
+    Textures(void) = default;
+    NNGN_NO_MOVE(Textures)
+    ~Textures(void) { this->set_decode_threads(0); }
     /** Maximum number of textures that can be loaded, see \ref set_max. */
     u32 max(void) const { return static_cast<u32>(this->counts.capacity()); }
     /** Number of active images in the cache. */
@@ -64,6 +108,13 @@ public:
      * tool to know when to call \ref dump.
      */
     u64 generation(void) const { return this->gen; }
+    /** Number of threads which decode image data for \ref load_async. */
+    std::size_t decode_threads(void) const { return this->workers.size(); }
+    const TextureCache &cache(void) const { return this->m_cache; }
+    /** Maximum number of textures uploaded in each call to \ref update. */
+    u32 upload_budget(void) const { return this->m_upload_budget; }
+    /** Number of asynchronous loads which have not yet finished. */
+    std::size_t n_pending(void) const { return this->pending.size(); }
     /**
      * Sets the graphics back end where textures will be uploaded.
      * This method does not load any data, any pre-existing textures have to be
@@ -77,13 +128,44 @@ public:
      * end has been configured to hold at least \c n textures.
      */
     void set_max(u32 n);
+    /**
+     * Stops current decoding threads and starts \p n new ones.
+     * Requests which have not been started are kept and processed by the new
+     * threads (or by \ref update if \p n is zero).
+     */
+    bool set_decode_threads(std::size_t n);
+    void set_upload_budget(u32 n) { this->m_upload_budget = n; }
+    /**
+     * Sets the directory of the texture cache, see \ref TextureCache::set_dir.
+     * Fails while asynchronous loads are pending, since decoding threads read
+     * the cache without synchronization.
+     */
+    bool set_cache_dir(std::filesystem::path p);
     /** Loads RGBA texture data from a buffer. */
     u32 load_data(const char *name, const std::byte *p);
     /** Loads texture data from a file. */
     u32 load(const char *filename);
+    /**
+     * Starts loading texture data from a file in the background.
+     * If the file is already loaded, its index is returned (and the reference
+     * count incremented) as in \ref load.  Otherwise, a slot is reserved for
+     * it and zero is returned: that texture can be used as a placeholder
+     * until \p f is called with the final index.  \p f is always called from
+     * \ref update, even if the texture is already available.
+     */
+    u32 load_async(const char *filename, load_fn f = {});
+    /**
+     * Finishes asynchronous loads.
+     * At most \ref upload_budget textures are uploaded, then callbacks of all
+     * loads which finished are called.
+     */
+    bool update(void);
     /** Reloads data for a single texture. */
     bool reload(u32 i);
-    /** Reloads all texture data. */
+    /**
+     * Reloads all texture data.
+     * Images are decoded in parallel if decoding threads have been started.
+     */
     bool reload_all(void);
     /** Updates a previously loaded texture. */
     bool update_data(u32 i, const std::byte *p) const;
@@ -95,13 +177,98 @@ public:
     void add_ref(const char *filename, std::size_t n = 1);
     /** Dumps name/ref_count pairs for all loaded textures. */
     std::vector<std::tuple<std::string_view, u32>> dump(void) const;
+protected:
+    using hash_fn = Hash(*)(std::span<const char>);
+    /**
+     * Replaces the function used to index names, e.g. to cause collisions.
+     * Must be called before any texture is loaded.
+     */
+    void set_hash(hash_fn f) { this->m_hash = f; }
 private:
+    template<typename T>
+    using vector = accounted_vector<T, memory_tag::textures>;
+    /** Slots indexed by the hash of their name, which can collide. */
+    using index_map = std::unordered_multimap<
+        Hash, u32, std::hash<Hash>, std::equal_to<Hash>,
+        accounted_allocator<std::pair<const Hash, u32>, memory_tag::textures>>;
+    /** Value of \ref free_pos for slots which are in use. */
+    static constexpr u32 USED = static_cast<u32>(-1);
+    struct request {
+        u32 i;
+        /** Whether the result is waited for by \ref reload_all. */
+        bool reload;
+        std::string name;
+    };
+    /** Image data, either decoded or mapped from the cache. */
+    struct decoded {
+        u32 i = 0;
+        std::vector<std::byte> data = {};
+        std::unique_ptr<MappedFile> file = {};
+        std::span<const std::byte> mapped = {};
+        bool empty(void) const
+            { return this->data.empty() && this->mapped.empty(); }
+        const std::byte *bytes(void) const {
+            return this->mapped.empty()
+                ? this->data.data() : this->mapped.data();
+        }
+    };
+    /**
+     * Texture being loaded by \ref load_async.
+     * The slot is not reused until the load finishes, even if its reference
+     * count reaches zero.
+     */
+    struct pending_load {
+        u32 i;
+        std::string name;
+        std::vector<load_fn> callbacks;
+    };
+    /** Slot with a given name, or zero if there is none. */
+    u32 find(std::string_view name) const;
+    /** An unused slot, or the number of slots if all are in use. */
+    u32 find_empty(void) const;
+    u32 insert(u32 i, std::string_view name, const std::byte *p);
+    /** Increments a reference count, reviving the slot if it was unused. */
+    void add_count(u32 i, std::size_t n);
+    void mark_free(u32 i);
+    void mark_used(u32 i);
+    /** Removes the name of a slot from \ref index. */
+    void unindex(u32 i);
+    pending_load *find_pending(u32 i);
+    /**
+     * Reads image data from the cache or, if not present, from the file,
+     * which is then added to the cache.  Can be called from any thread.
+     */
+    decoded read_cached(u32 i, const char *filename);
+    /** Decoding thread main loop. */
+    void decode(void);
+    /** Uploads the data and moves the callbacks to \ref ready. */
+    bool finish(decoded d);
     Graphics *graphics = nullptr;
-    std::vector<Hash> hashes = {{}};
-    std::vector<u32> counts = {1};
-    std::vector<std::string> names = {{}};
+    hash_fn m_hash = hash;
+    vector<Hash> hashes = {{}};
+    vector<u32> counts = {1};
+    vector<std::string> names = {{}};
+    index_map index = {};
+    /** Unused slots, the last one is reused first. */
+    vector<u32> free_slots = {};
+    /** Position of each slot in \ref free_slots, or \ref USED. */
+    vector<u32> free_pos = {USED};
     u64 gen = 0;
-    u32 insert(u32 i, std::string_view name, const std::byte *p);
+    TextureCache m_cache = {};
+    u32 m_upload_budget = DEFAULT_UPLOAD_BUDGET;
+    std::vector<pending_load> pending = {};
+    /** Callbacks to be called by the next \ref update, with their argument. */
+    std::vector<std::pair<load_fn, u32>> ready = {};
+    std::vector<std::thread> workers = {};
+    /**
+     * Protects \ref requests, \ref results, \ref reloaded, \ref exit, and
+     * \ref cv waits.
+     */
+    std::mutex m = {};
+    std::condition_variable cv = {};
+    std::deque<request> requests = {};
+    std::vector<decoded> results = {}, reloaded = {};
+    bool exit = false;
 };
 
 }
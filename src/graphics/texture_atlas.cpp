@@ -0,0 +1,292 @@
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+
+#include "utils/log.h"
+#include "utils/utils.h"
+
+#include "graphics.h"
+#include "texture.h"
+
+namespace {
+
+constexpr auto EXTENT = nngn::Graphics::TEXTURE_EXTENT;
+constexpr auto SIZE = nngn::Graphics::TEXTURE_SIZE;
+constexpr nngn::u32 NO_LAYER = static_cast<nngn::u32>(-1);
+
+/** Size of the region reserved for an image, including padding. */
+nngn::uvec2 padded(nngn::uvec2 s) {
+    constexpr auto p = nngn::TextureAtlas::PADDING;
+    return {std::min(s.x + p, EXTENT), std::min(s.y + p, EXTENT)};
+}
+
+}
+
+namespace nngn {
+
+std::size_t TextureAtlas::n_layers(void) const {
+    return static_cast<std::size_t>(
+        std::ranges::count_if(this->layers, &layer::tex));
+}
+
+float TextureAtlas::occupancy(void) const {
+    const auto n = this->n_layers();
+    if(!n)
+        return 0;
+    u64 used = 0;
+    for(const auto &x : this->entries)
+        if(x.count)
+            used += u64{x.r.size.x} * x.r.size.y;
+    const auto e = static_cast<double>(EXTENT);
+    return static_cast<float>(
+        static_cast<double>(used) / (static_cast<double>(n) * e * e));
+}
+
+u32 TextureAtlas::tex(u32 i) const {
+    assert(this->entries[i].count);
+    return this->layers[this->entries[i].layer].tex;
+}
+
+auto TextureAtlas::rect(u32 i) const -> Rect {
+    assert(this->entries[i].count);
+    return this->entries[i].r;
+}
+
+std::array<vec2, 2> TextureAtlas::uv(u32 i) const {
+    const auto r = this->rect(i);
+    const auto e = static_cast<float>(EXTENT);
+    const auto p0 = static_cast<vec2>(r.pos) / e;
+    const auto p1 = static_cast<vec2>(r.pos + r.size) / e;
+    return {{{p0.x, 1 - p0.y}, {p1.x, 1 - p1.y}}};
+}
+
+u32 TextureAtlas::load_data(const char *name, uvec2 size, const std::byte *p) {
+    NNGN_LOG_CONTEXT_CF(TextureAtlas);
+    NNGN_LOG_CONTEXT(name);
+    if(const auto i = this->find(name)) {
+        Log::l() << "already loaded, ignoring data" << std::endl;
+        ++this->entries[i].count;
+        return i;
+    }
+    if(!size.x || !size.y || EXTENT < size.x || EXTENT < size.y) {
+        Log::l() << "invalid size: " << size.x << "x" << size.y << std::endl;
+        return 0;
+    }
+    u32 l = 0, sh = 0;
+    uvec2 pos = {};
+    if(!this->alloc(size, &l, &sh, &pos))
+        return 0;
+    u32 ret = 0;
+    if(this->free_entries.empty()) {
+        ret = narrow<u32>(this->entries.size());
+        this->entries.emplace_back();
+    } else {
+        ret = this->free_entries.back();
+        this->free_entries.pop_back();
+    }
+    const Rect r = {pos, size};
+    const auto h = hash(std::string_view{name});
+    this->index.emplace(h, ret);
+    this->entries[ret] = {
+        .hash = h,
+        .name = name,
+        .count = 1,
+        .layer = l,
+        .shelf = sh,
+        .r = r,
+    };
+    ++this->layers[l].n;
+    this->write(l, r, p, std::size_t{4} * size.x);
+    return ret;
+}
+
+u32 TextureAtlas::load(const char *filename) {
+    NNGN_LOG_CONTEXT_CF(TextureAtlas);
+    NNGN_LOG_CONTEXT(filename);
+    if(const auto i = this->find(filename)) {
+        ++this->entries[i].count;
+        return i;
+    }
+    uvec2 size = {};
+    const auto data = Textures::read(filename, &size);
+    if(data.empty())
+        return 0;
+    return this->load_data(filename, size, data.data());
+}
+
+void TextureAtlas::remove(u32 i) {
+    if(!i)
+        return;
+    auto &e = this->entries[i];
+    assert(e.count);
+    if(--e.count)
+        return;
+    auto &l = this->layers[e.layer];
+    l.packer.release(e.shelf, e.r.pos.x, padded(e.r.size).x);
+    if(!--l.n)
+        this->remove_layer(e.layer);
+    const auto [first, last] = this->index.equal_range(e.hash);
+    const auto it = std::find_if(first, last, [i](const auto &x)
+        { return x.second == i; });
+    assert(it != last);
+    this->index.erase(it);
+    e.name.clear();
+    e.hash = {};
+    this->free_entries.push_back(i);
+}
+
+bool TextureAtlas::repack(void) {
+    NNGN_LOG_CONTEXT_CF(TextureAtlas);
+    std::vector<u32> v = {};
+    v.reserve(this->n());
+    for(u32 i = 1, n = narrow<u32>(this->entries.size()); i != n; ++i)
+        if(this->entries[i].count)
+            v.push_back(i);
+    std::ranges::sort(v, [&e = this->entries](auto i0, auto i1) {
+        const auto s0 = e[i0].r.size, s1 = e[i1].r.size;
+        return s0.y != s1.y ? s1.y < s0.y : s1.x < s0.x;
+    });
+    struct placement { u32 layer, shelf; uvec2 pos; };
+    std::vector<ShelfPacker> packers = {};
+    std::vector<placement> placements = {};
+    placements.reserve(v.size());
+    for(const auto i : v) {
+        const auto s = padded(this->entries[i].r.size);
+        placement p = {};
+        for(;; ++p.layer) {
+            if(p.layer == packers.size())
+                packers.emplace_back(EXTENT);
+            auto &packer = packers[p.layer];
+            if(packer.alloc(s, &p.shelf, &p.pos.x)) {
+                p.pos.y = packer.shelves()[p.shelf].y;
+                break;
+            }
+        }
+        placements.push_back(p);
+    }
+    std::vector<u32> texs = {};
+    for(const auto &x : this->layers)
+        if(x.tex)
+            texs.push_back(x.tex);
+    const auto n_old = texs.size();
+    while(texs.size() < packers.size()) {
+        const auto name = "atlas/" + std::to_string(this->layer_id++);
+        if(const auto t = this->textures->load_data(name.c_str(), nullptr))
+            texs.push_back(t);
+        else {
+            for(std::size_t i = n_old; i != texs.size(); ++i)
+                this->textures->remove(texs[i]);
+            return false;
+        }
+    }
+    for(std::size_t i = packers.size(); i < texs.size(); ++i)
+        this->textures->remove(texs[i]);
+    std::vector<layer> new_layers = {};
+    new_layers.reserve(packers.size());
+    for(std::size_t i = 0; i != packers.size(); ++i)
+        new_layers.push_back({
+            .tex = texs[i],
+            .n = 0,
+            .dirty = true,
+            .packer = std::move(packers[i]),
+            .data = std::vector<std::byte>(SIZE),
+        });
+    const auto old_layers = std::exchange(this->layers, std::move(new_layers));
+    for(std::size_t j = 0; j != v.size(); ++j) {
+        auto &e = this->entries[v[j]];
+        const auto &p = placements[j];
+        const auto &src = old_layers[e.layer].data;
+        const auto off = 4 * (std::size_t{e.r.pos.y} * EXTENT + e.r.pos.x);
+        e.layer = p.layer;
+        e.shelf = p.shelf;
+        e.r.pos = p.pos;
+        ++this->layers[p.layer].n;
+        this->write(p.layer, e.r, &src[off], std::size_t{4} * EXTENT);
+    }
+    ++this->gen;
+    return true;
+}
+
+bool TextureAtlas::update(void) {
+    NNGN_LOG_CONTEXT_CF(TextureAtlas);
+    for(auto &x : this->layers) {
+        if(!x.tex || !x.dirty)
+            continue;
+        if(!this->textures->update_data(x.tex, x.data.data()))
+            return false;
+        x.dirty = false;
+    }
+    return true;
+}
+
+u32 TextureAtlas::find(std::string_view name) const {
+    const auto [b, e] = this->index.equal_range(hash(name));
+    for(auto it = b; it != e; ++it)
+        if(this->entries[it->second].name == name)
+            return it->second;
+    return 0;
+}
+
+bool TextureAtlas::alloc(uvec2 size, u32 *l, u32 *sh, uvec2 *pos) {
+    const auto s = padded(size);
+    const auto n = narrow<u32>(this->layers.size());
+    u32 i = 0;
+    for(; i != n; ++i)
+        if(this->layers[i].tex && this->layers[i].packer.alloc(s, sh, &pos->x))
+            break;
+    if(i == n) {
+        if((i = this->add_layer()) == NO_LAYER)
+            return false;
+        [[maybe_unused]] const bool ok =
+            this->layers[i].packer.alloc(s, sh, &pos->x);
+        assert(ok);
+    }
+    *l = i;
+    pos->y = this->layers[i].packer.shelves()[*sh].y;
+    return true;
+}
+
+u32 TextureAtlas::add_layer(void) {
+    assert(this->textures);
+    const auto name = "atlas/" + std::to_string(this->layer_id++);
+    const auto t = this->textures->load_data(name.c_str(), nullptr);
+    if(!t)
+        return NO_LAYER;
+    const auto it = std::ranges::find(this->layers, 0u, &layer::tex);
+    const auto ret = static_cast<u32>(it - this->layers.begin());
+    if(it == this->layers.end())
+        this->layers.emplace_back();
+    this->layers[ret] = {
+        .tex = t,
+        .n = 0,
+        .dirty = true,
+        .packer = ShelfPacker{EXTENT},
+        .data = std::vector<std::byte>(SIZE),
+    };
+    return ret;
+}
+
+void TextureAtlas::remove_layer(u32 i) {
+    auto &l = this->layers[i];
+    this->textures->remove(l.tex);
+    l = {};
+}
+
+void TextureAtlas::write(
+    u32 l, Rect r, const std::byte *src, std::size_t pitch
+) {
+    auto &x = this->layers[l];
+    const auto s = padded(r.size);
+    const auto row = [&x](u32 y, u32 px)
+        { return &x.data[4 * (std::size_t{y} * EXTENT + px)]; };
+    for(u32 y = 0; y != s.y; ++y)
+        std::memset(row(r.pos.y + y, r.pos.x), 0, std::size_t{4} * s.x);
+    for(u32 y = 0; y != r.size.y; ++y, src += pitch)
+        std::memcpy(row(r.pos.y + y, r.pos.x), src, std::size_t{4} * r.size.x);
+    x.dirty = true;
+}
+
+}
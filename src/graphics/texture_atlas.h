@@ -0,0 +1,119 @@
+#ifndef NNGN_GRAPHICS_TEXTURE_ATLAS_H
+#define NNGN_GRAPHICS_TEXTURE_ATLAS_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "math/hash.h"
+#include "math/packer.h"
+#include "math/vec2.h"
+#include "utils/def.h"
+
+namespace nngn {
+
+class Textures;
+
+/**
+ * Packs images of arbitrary size into shared texture layers.
+ *
+ * Each layer is a regular texture of \ref Graphics::TEXTURE_EXTENT size,
+ * allocated from \ref Textures when an image does not fit in any of the
+ * existing ones and removed when its last image is removed, so that many
+ * small images occupy a single texture and the total is bounded by \ref
+ * Textures::max.  Space in each layer is allocated by a \ref ShelfPacker.
+ *
+ * Images are identified and reference-counted by name, like in \ref
+ * Textures, and their position is given as a texture index (see \ref tex)
+ * and a pair of texture coordinates in the format of \ref
+ * SpriteRenderer::uv (see \ref uv).  The index \c 0 is never used and is
+ * returned in case of errors.
+ *
+ * The contents of each layer are kept in memory so that images can be moved
+ * by \ref repack without reading them again.  Modified layers are uploaded in
+ * \ref update.
+ */
+class TextureAtlas {
+public:
+    /** Empty space left on the right and bottom of each image. */
+    static constexpr u32 PADDING = 1;
+    struct Rect { uvec2 pos, size; };
+    void set_textures(Textures *t) { this->textures = t; }
+    /** Number of active images. */
+    std::size_t n(void) const
+        { return this->entries.size() - 1 - this->free_entries.size(); }
+    /** Number of textures currently used as layers. */
+    std::size_t n_layers(void) const;
+    /**
+     * Counter incremented every time images are moved.
+     * Coordinates obtained from \ref tex and \ref uv before the change are no
+     * longer valid.
+     */
+    u64 generation(void) const { return this->gen; }
+    /** Fraction of the area of all layers occupied by images. */
+    float occupancy(void) const;
+    /** Texture index of the layer which contains an image. */
+    u32 tex(u32 i) const;
+    /** Region of the layer occupied by an image, in pixels. */
+    Rect rect(u32 i) const;
+    /** Texture coordinates of an image, see \ref SpriteRenderer::uv. */
+    std::array<vec2, 2> uv(u32 i) const;
+    /** Adds an RGBA image of size \p size. */
+    u32 load_data(const char *name, uvec2 size, const std::byte *p);
+    /** Adds an image read from a file, see \ref Textures::read. */
+    u32 load(const char *filename);
+    /**
+     * Decrements an image's reference count.
+     * When it reaches zero, its space is released and the layer is removed
+     * if it becomes empty.
+     */
+    void remove(u32 i);
+    /**
+     * Moves all images to as few layers as possible.
+     * Images are reinserted in order of decreasing height, which leaves less
+     * unused space than the arbitrary order in which they were loaded.
+     * Unused layers are removed.
+     */
+    bool repack(void);
+    /** Uploads the layers which were modified. */
+    bool update(void);
+private:
+    struct layer {
+        u32 tex = 0;
+        /** Number of images in the layer. */
+        u32 n = 0;
+        bool dirty = false;
+        ShelfPacker packer = {};
+        std::vector<std::byte> data = {};
+    };
+    struct entry {
+        Hash hash = {};
+        std::string name = {};
+        u32 count = 0, layer = 0, shelf = 0;
+        Rect r = {};
+    };
+    u32 find(std::string_view name) const;
+    /** Reserves space for an image, creating a layer if necessary. */
+    bool alloc(uvec2 size, u32 *layer, u32 *shelf, uvec2 *pos);
+    /** Creates a layer, returns its index or \c -1. */
+    u32 add_layer(void);
+    void remove_layer(u32 i);
+    /** Copies image data into a layer. */
+    void write(
+        u32 layer, Rect r, const std::byte *src, std::size_t pitch);
+    Textures *textures = nullptr;
+    u64 gen = 0, layer_id = 0;
+    std::vector<layer> layers = {};
+    /** The first entry is unused so that zero can represent no image. */
+    std::vector<entry> entries = {{}};
+    std::vector<u32> free_entries = {};
+    /** Active entries indexed by the hash of their name, which can collide. */
+    std::unordered_multimap<Hash, u32> index = {};
+};
+
+}
+
+#endif
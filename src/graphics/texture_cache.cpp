@@ -0,0 +1,170 @@
+#include "texture_cache.h"
+
+#include <cassert>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "math/hash.h"
+#include "os/mapped_file.h"
+#include "utils/log.h"
+
+#include "graphics.h"
+
+namespace {
+
+constexpr auto EXTENT = nngn::Graphics::TEXTURE_EXTENT;
+constexpr auto SIZE = nngn::Graphics::TEXTURE_SIZE;
+
+bool write_all(std::FILE *f, const void *p, std::size_t n) {
+    return std::fwrite(p, 1, n, f) == n;
+}
+
+}
+
+namespace nngn {
+
+std::optional<i64> TextureCache::mtime(const char *src) {
+    std::error_code ec = {};
+    const auto t = std::filesystem::last_write_time(src, ec);
+    if(ec)
+        return {};
+    return static_cast<i64>(t.time_since_epoch().count());
+}
+
+bool TextureCache::set_dir(std::filesystem::path p) {
+    NNGN_LOG_CONTEXT_CF(TextureCache);
+    if(!p.empty()) {
+        std::error_code ec = {};
+        std::filesystem::create_directories(p, ec);
+        if(ec)
+            return Log::l() << p.string() << ": " << ec.message() << '\n',
+                false;
+    }
+    // The mask can only be read by setting it.
+    const auto mask = umask(0);
+    umask(mask);
+    this->m_mode = 0666u & ~static_cast<u32>(mask);
+    this->m_dir = std::move(p);
+    return true;
+}
+
+std::filesystem::path TextureCache::path(std::string_view src) const {
+    std::array<char, 2 * sizeof(Hash)> b = {};
+    const auto r = std::to_chars(b.data(), b.data() + b.size(), hash(src), 16);
+    assert(r.ec == std::errc{});
+    return this->m_dir / (std::string{b.data(), r.ptr} + ".bin");
+}
+
+std::span<const std::byte> TextureCache::read(
+    const char *src, i64 mtime, MappedFile *f
+) {
+    NNGN_LOG_CONTEXT_CF(TextureCache);
+    if(!this->enabled())
+        return {};
+    const auto miss = [this, f] {
+        f->close();
+        ++this->m_misses;
+        return std::span<const std::byte>{};
+    };
+    const auto p = this->path(src);
+    std::error_code ec = {};
+    if(!std::filesystem::exists(p, ec) || !f->open(p.c_str()))
+        return miss();
+    const auto d = f->data();
+    if(d.size() < sizeof(Header))
+        return miss();
+    Header h = {};
+    std::memcpy(&h, d.data(), sizeof(h));
+    const std::string_view s = src;
+    if(h.magic != MAGIC || h.version != VERSION
+            || h.format != Format::RGBA8
+            || h.path_hash != hash(s) || h.mtime != mtime
+            || h.width != EXTENT || h.height != EXTENT || h.size != SIZE
+            || h.path_size != s.size()
+            || h.offset < sizeof(h) + h.path_size || d.size() < h.offset
+            || d.size() - h.offset < h.size)
+        return miss();
+    const auto *const path_p =
+        byte_cast<const char*>(d.data() + sizeof(h));
+    if(std::string_view{path_p, s.size()} != s)
+        return miss();
+    ++this->m_hits;
+    return d.subspan(h.offset, h.size);
+}
+
+bool TextureCache::write(
+    const char *src, i64 mtime, std::span<const std::byte> s
+) const {
+    NNGN_LOG_CONTEXT_CF(TextureCache);
+    NNGN_LOG_CONTEXT(src);
+    if(!this->enabled())
+        return true;
+    assert(s.size() == SIZE);
+    const std::string_view src_v = src;
+    const auto page = MappedFile::page_size();
+    const auto offset =
+        (sizeof(Header) + src_v.size() + page - 1) / page * page;
+    const Header h = {
+        .magic = MAGIC,
+        .version = VERSION,
+        .format = Format::RGBA8,
+        .path_hash = hash(src_v),
+        .mtime = mtime,
+        .width = EXTENT,
+        .height = EXTENT,
+        .offset = offset,
+        .size = s.size(),
+        .path_size = src_v.size(),
+    };
+    const std::vector<std::byte> pad(offset - sizeof(h) - src_v.size());
+    const auto p = this->path(src_v);
+    // Unique, so that concurrent writers of the same entry do not interfere.
+    auto tmp = p.string() + ".XXXXXX";
+    const int fd = mkstemp(tmp.data());
+    if(fd == -1)
+        return Log::perror("mkstemp"), false;
+    const auto fail = [&tmp](const char *msg, int fd_) {
+        Log::perror(msg);
+        close(fd_);
+        std::error_code ec = {};
+        std::filesystem::remove(tmp, ec);
+        return false;
+    };
+    // Created as 0600, use the mode any other new file would have.
+    if(fchmod(fd, static_cast<mode_t>(this->m_mode)) == -1)
+        return fail("fchmod", fd);
+    auto *const f = fdopen(fd, "wb");
+    if(!f)
+        return fail("fdopen", fd);
+    const bool ok = write_all(f, &h, sizeof(h))
+        && write_all(f, src_v.data(), src_v.size())
+        && write_all(f, pad.data(), pad.size())
+        && write_all(f, s.data(), s.size());
+    if(!ok)
+        Log::perror("fwrite");
+    if(std::fclose(f) == EOF || !ok) {
+        if(ok)
+            Log::perror("fclose");
+        std::error_code ec = {};
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    std::error_code ec = {};
+    std::filesystem::rename(tmp, p, ec);
+    if(ec) {
+        Log::l() << "rename: " << ec.message() << '\n';
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+}
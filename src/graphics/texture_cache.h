@@ -0,0 +1,107 @@
+#ifndef NNGN_GRAPHICS_TEXTURE_CACHE_H
+#define NNGN_GRAPHICS_TEXTURE_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "utils/def.h"
+#include "utils/utils.h"
+
+namespace nngn {
+
+class MappedFile;
+
+/**
+ * On-disk cache of decoded texture data.
+ *
+ * Each source image is stored in a separate file in the cache directory,
+ * named after the hash of its path.  The file starts with a \ref Header
+ * (followed by the source path), which is used to verify that the entry
+ * corresponds to the current version of the source (by path and modification
+ * time).  Image data follow, starting at a multiple of the page size, so that
+ * the file can be mapped (see \ref MappedFile) and passed directly to \ref
+ * Graphics::load_textures.
+ *
+ * Files are written to a temporary name and then renamed, so that partial
+ * entries are never read.  Reads and writes can be performed concurrently
+ * from any thread, but not concurrently with \ref set_dir.  An empty directory
+ * (the default) disables the cache.
+ */
+class TextureCache {
+public:
+    static constexpr std::array<char, 8> MAGIC = {"nngntex"};
+    static constexpr u32 VERSION = 1;
+    /** Layout of the image data. */
+    enum class Format : u32 {
+        /** Uncompressed, 8 bits per channel. */
+        RGBA8 = 1,
+    };
+    struct Header {
+        std::array<char, 8> magic;
+        u32 version;
+        Format format;
+        u64 path_hash;
+        /** Modification time of the source, in file clock ticks. */
+        i64 mtime;
+        u32 width, height;
+        /** Offset of the image data from the start of the file. */
+        u64 offset;
+        u64 size;
+        /** Length of the source path which follows the header. */
+        u64 path_size;
+    };
+    static_assert(sizeof(Header) == 64);
+    static_assert(std::is_trivially_copyable_v<Header>);
+    TextureCache(void) = default;
+    NNGN_NO_MOVE(TextureCache)
+    ~TextureCache(void) = default;
+    const std::filesystem::path &dir(void) const { return this->m_dir; }
+    bool enabled(void) const { return !this->m_dir.empty(); }
+    /** Number of successful \ref read calls. */
+    u64 hits(void) const { return this->m_hits.load(); }
+    /** Number of \ref read calls which did not find a valid entry. */
+    u64 misses(void) const { return this->m_misses.load(); }
+    /**
+     * Modification time of a source file, as stored in \ref Header::mtime.
+     * Should be read before the source is decoded, so that a concurrent
+     * modification invalidates the entry.
+     */
+    static std::optional<i64> mtime(const char *src);
+    /**
+     * Sets and creates the cache directory.
+     * Also records the process umask, from which the mode of new entries is
+     * derived.
+     */
+    bool set_dir(std::filesystem::path p);
+    /** Path of the cache file for a source path. */
+    std::filesystem::path path(std::string_view src) const;
+    /**
+     * Maps the cached image data of a source file.
+     * \param mtime Current value of \ref mtime for the source.
+     * \return
+     *     View of the RGBA data inside \p f, or an empty span if there is no
+     *     valid entry.
+     */
+    std::span<const std::byte> read(
+        const char *src, i64 mtime, MappedFile *f);
+    /**
+     * Stores decoded RGBA image data for a source file.
+     * \param mtime Value of \ref mtime before the source was decoded.
+     */
+    bool write(
+        const char *src, i64 mtime, std::span<const std::byte> s) const;
+private:
+    std::filesystem::path m_dir = {};
+    /** Permissions of new entries. */
+    u32 m_mode = 0644;
+    std::atomic<u64> m_hits = 0, m_misses = 0;
+};
+
+}
+
+#endif
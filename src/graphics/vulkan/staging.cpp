@@ -5,10 +5,23 @@
 
 #include <cassert>
 
+#include "utils/alloc/accounting.h"
 #include "utils/literals.h"
 
 using namespace std::string_view_literals;
 
+namespace {
+
+void destroy_block(
+    nngn::DedicatedBuffer *b, VkDevice dev, nngn::DeviceMemory *dev_mem)
+{
+    if(const auto n = b->capacity())
+        nngn::memory_accounting::deallocate(nngn::memory_tag::vulkan, n);
+    b->destroy(dev, dev_mem);
+}
+
+}
+
 namespace nngn {
 
 void StagingBuffer::Frame::release(
@@ -27,7 +40,7 @@ void StagingBuffer::Frame::destroy(VkDevice dev_, DeviceMemory *dev_mem_) {
     if(this->mapped)
         vkUnmapMemory(dev_, this->blocks.back().mem());
     for(auto &x : this->blocks)
-        x.destroy(dev_, dev_mem_);
+        destroy_block(&x, dev_, dev_mem_);
     *this = {};
 }
 
@@ -36,7 +49,7 @@ StagingBuffer::~StagingBuffer() {
     for(auto &x : this->frames)
         x.destroy(this->dev, this->dev_mem);
     for(auto &x : this->free)
-        x.destroy(this->dev, this->dev_mem);
+        destroy_block(&x, this->dev, this->dev_mem);
 }
 
 void StagingBuffer::destroy(std::size_t i) {
@@ -54,8 +67,9 @@ void StagingBuffer::retire_free() {
         return;
     const auto i = std::find_if_not(
         b, e, [n](const auto &x) { return x.age == n; });
-    std::for_each(
-        b, i, [this](auto &x) { x.destroy(this->dev, this->dev_mem); });
+    std::for_each(b, i, [this](auto &x) {
+        destroy_block(&x, this->dev, this->dev_mem);
+    });
     std::for_each(i, e, [](auto &x) { ++x.age; });
     this->free.erase(b, i);
 }
@@ -118,6 +132,7 @@ auto StagingBuffer::alloc(
             && this->inst->set_obj_name(this->dev, b.mem(), "staging_mem"sv);
         if(!ok)
             return {};
+        memory_accounting::allocate(memory_tag::vulkan, b.capacity());
     }
     auto &b = f.blocks.back();
     const auto cap = std::min(n, (b.capacity() - b.size()) / size);
@@ -34,7 +34,6 @@ std::unique_ptr<Graphics> graphics_create_backend<Backend>(const void*) {
 #include <GLFW/glfw3.h>
 
 #include "const.h"
-#include "font/font.h"
 #include "graphics/glfw.h"
 #include "graphics/shaders.h"
 #include "math/camera.h"
@@ -324,7 +323,6 @@ class VulkanBackend final : public nngn::GLFWBackend {
     TexArray tex = {}, font_tex = {};
     ShadowMap shadow_map = {};
     ShadowCube shadow_cube = {};
-    u32 font_size = {};
     static void error_callback(void *p)
         { static_cast<VulkanBackend*>(p)->flags.set(Flag::ERROR); };
     static bool begin_cmd(VkCommandBuffer cmd);
@@ -408,8 +406,7 @@ public:
         std::uint32_t i, std::uint32_t n, const std::byte *v) final;
     bool resize_font(std::uint32_t s) final;
     bool load_font(
-        unsigned char c, std::uint32_t n,
-        const nngn::uvec2 *size, const std::byte *v) final;
+        nngn::uvec2 pos, nngn::uvec2 size, const std::byte *v) final;
     void set_camera(const Camera &c) final;
     void set_lighting(const Lighting &l) final;
     bool set_render_list(const RenderList &l) final;
@@ -2123,14 +2120,14 @@ bool VulkanBackend::resize_font(std::uint32_t s) {
     this->font_tex.destroy(this->dev.id(), &this->dev_mem);
     const bool ok = this->font_tex.init(
             this->dev.id(), &this->dev_mem, this->cur_cmd_buffer(),
-            {}, VK_FORMAT_R8G8B8A8_UNORM, {s, s, 1},
-            nngn::Math::mip_levels(s), nngn::Font::N,
+            {}, VK_FORMAT_R8G8B8A8_UNORM, {s, s, 1}, 1, 1,
             VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-            VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
             VK_IMAGE_VIEW_TYPE_2D_ARRAY,
             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            0, VK_ACCESS_TRANSFER_WRITE_BIT)
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0, VK_ACCESS_SHADER_READ_BIT)
         && this->name_tex_array("font_tex"sv, this->font_tex);
     if(!ok)
         return false;
@@ -2138,59 +2135,48 @@ bool VulkanBackend::resize_font(std::uint32_t s) {
         this->sampler, this->shadow_sampler,
         this->tex.view(), this->font_tex.view(),
         this->shadow_map.view(), this->shadow_cube.cube_2d_view());
-    this->font_size = s;
     return true;
 }
 
 bool VulkanBackend::load_font(
-    unsigned char c, std::uint32_t n,
-    const nngn::uvec2 *size, const std::byte *v
+    nngn::uvec2 pos, nngn::uvec2 size, const std::byte *v
 ) {
     NNGN_LOG_CONTEXT_CF(VulkanBackend);
-    if(!n)
+    if(!size.x || !size.y)
         return true;
-    const auto mip_levels = nngn::Math::mip_levels(this->font_size);
+    constexpr VkImageSubresourceRange range = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .levelCount = 1,
+        .layerCount = 1,
+    };
     auto cmd = this->cur_cmd_buffer();
     this->font_tex.transition_layout(
         cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
         VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .levelCount = mip_levels,
-            .baseArrayLayer = c,
-            .layerCount = n,
-        });
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, range);
     const auto id = this->font_tex.id();
-    const auto e = c + n;
-    for(auto i = c; i < e; ++i) {
-        const auto s = *size++;
-        const auto write = [i, &v, cmd, id, s](
-            auto src, void *p, auto off, auto iw, auto nw
-        ) {
-            const auto y = static_cast<std::int32_t>(iw);
-            const auto h = static_cast<std::uint32_t>(nw);
-            auto *b = std::exchange(v, v + 4 * iw * s.x);
-            std::memcpy(p, b, static_cast<std::size_t>(4 * nw * s.x));
-            VulkanBackend::copy_buffer(
-                cmd, id, src, {s.x, h, 1}, i, 1, {0, y, 0}, off);
-            return true;
-        };
-        if(!this->stg_buffer.write(this->cur_frame, s.y, 4_z * s.x, write))
-            return false;
-    }
+    const auto write = [v, cmd, id, pos, size](
+        auto src, void *p, auto off, auto iw, auto nw
+    ) {
+        const auto y = static_cast<std::int32_t>(pos.y + iw);
+        const auto h = static_cast<std::uint32_t>(nw);
+        const auto row = 4_z * size.x;
+        std::memcpy(p, v + iw * row, static_cast<std::size_t>(nw * row));
+        VulkanBackend::copy_buffer(
+            cmd, id, src, {size.x, h, 1}, 0, 1,
+            {static_cast<std::int32_t>(pos.x), y, 0}, off);
+        return true;
+    };
+    if(!this->stg_buffer.write(this->cur_frame, size.y, 4_z * size.x, write))
+        return false;
     this->font_tex.transition_layout(
         cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
         VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
         VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, {
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .levelCount = mip_levels,
-            .baseArrayLayer = c,
-            .layerCount = n,
-        });
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range);
     return true;
 }
 
@@ -10,6 +10,7 @@
 #include "utils/log.h"
 
 #include "group.h"
+#include "recorder.h"
 
 namespace nngn {
 
@@ -20,11 +21,17 @@ void Input::Source::get_keys(std::span<i32> keys) const {
 }
 
 void Input::get_keys(std::span<i32> keys) const {
+    const auto *const r = this->recorder;
+    const bool replay = r && r->mode() == Recorder::Mode::REPLAY;
     for(auto &k : keys) {
         if(this->overrides[static_cast<std::size_t>(k)]) {
             k = 1;
             continue;
         }
+        if(replay) {
+            r->get_keys({&k, 1});
+            continue;
+        }
         if(std::any_of(
             begin(this->sources), end(this->sources),
                 [&k, k0 = k](auto &s) {
@@ -111,6 +118,8 @@ bool Input::key_callback(int key, Action action, Modifier mods) const {
     const bool press = action == Input::KEY_PRESS;
     if(!press && action != Input::KEY_RELEASE)
         return true;
+    if(this->recorder && !this->recorder->key(key, action, mods))
+        return true;
     const auto call = [L_ = this->L, key, press, mods](int ref) {
         lua_pushcfunction(L_, nngn::lua::msgh);
         lua_rawgeti(L_, LUA_REGISTRYINDEX, ref);
@@ -23,6 +23,7 @@ namespace nngn {
 using nngn::i32;
 
 class BindingGroup;
+class Recorder;
 struct Graphics;
 
 /** Dispatches keyboard input events to pre-registered Lua functions. */
@@ -63,6 +64,8 @@ public:
     void has_override(std::size_t n, i32 *keys) const;
     BindingGroup *binding_group() const { return this->m_binding_group; }
     void set_binding_group(BindingGroup *g) { this->m_binding_group = g; }
+    /** Records or replays events and key state (see \ref Recorder). */
+    void set_recorder(Recorder *r) { this->recorder = r; }
     void add_source(std::unique_ptr<Source> p);
     bool remove_source(Source *p);
     bool override_keys(bool pressed, std::span<const i32> keys);
@@ -74,6 +77,7 @@ private:
     lua_State *L = {};
     int callback_ref = {};
     BindingGroup *m_binding_group = {};
+    Recorder *recorder = {};
     std::bitset<KEY_MAX + 1> overrides = {};
     std::vector<std::unique_ptr<Source>> sources = {};
 };
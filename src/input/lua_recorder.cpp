@@ -0,0 +1,27 @@
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/table.h"
+
+#include "recorder.h"
+
+using nngn::Recorder;
+
+namespace {
+
+bool record(Recorder &r, const char *path) { return r.record(path); }
+bool replay(Recorder &r, const char *path) { return r.replay(path); }
+
+void register_recorder(nngn::lua::table_view t) {
+    t["NONE"] = Recorder::Mode::NONE;
+    t["RECORD"] = Recorder::Mode::RECORD;
+    t["REPLAY"] = Recorder::Mode::REPLAY;
+    t["mode"] = &Recorder::mode;
+    t["record"] = record;
+    t["replay"] = replay;
+    t["stop"] = &Recorder::stop;
+}
+
+}
+
+NNGN_LUA_DECLARE_USER_TYPE(Recorder)
+NNGN_LUA_PROXY(Recorder, register_recorder)
@@ -6,6 +6,8 @@
 #include "lua/utils.h"
 #include "utils/log.h"
 
+#include "recorder.h"
+
 namespace {
 
 void register_cb(lua_State *L, int *p) {
@@ -31,6 +33,8 @@ bool MouseInput::button_callback(int button, int action, int mods) {
     const bool press = action == static_cast<int>(Action::PRESS);
     if(!press && action != static_cast<int>(Action::RELEASE))
         return true;
+    if(this->recorder && !this->recorder->button(button, action, mods))
+        return true;
     lua_pushcfunction(L, nngn::lua::msgh);
     lua_rawgeti(L, LUA_REGISTRYINDEX, this->button_cb);
     lua_pushinteger(L, button);
@@ -43,6 +47,8 @@ bool MouseInput::button_callback(int button, int action, int mods) {
 bool MouseInput::move_callback(dvec2 pos) {
     if(!this->move_cb)
         return true;
+    if(this->recorder && !this->recorder->move(pos))
+        return true;
     NNGN_LOG_CONTEXT_CF(MouseInput);
     lua_pushcfunction(L, nngn::lua::msgh);
     lua_rawgeti(L, LUA_REGISTRYINDEX, this->move_cb);
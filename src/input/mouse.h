@@ -7,6 +7,8 @@ struct lua_State;
 
 namespace nngn {
 
+class Recorder;
+
 /**
  * Mouse event manager.
  * Registered Lua callback functions are later called when events happen.
@@ -16,6 +18,8 @@ class MouseInput {
 public:
     enum class Action : std::uint8_t { PRESS = 1, RELEASE = 0 };
     void init(lua_State *L_) { this->L = L_; }
+    /** Records or replays events (see \ref Recorder). */
+    void set_recorder(Recorder *r) { this->recorder = r; }
     /**
      * Registers a Lua function called when a button is pressed.
      * The Lua stack is expected to contain the function object at the top.
@@ -32,6 +36,7 @@ public:
     bool move_callback(dvec2 pos);
 private:
     lua_State *L = {};
+    Recorder *recorder = {};
     int button_cb = {}, move_cb = {};
 };
 
@@ -0,0 +1,231 @@
+#include <cassert>
+#include <fstream>
+
+#include "utils/log.h"
+#include "utils/utils.h"
+
+#include "recorder.h"
+
+namespace {
+
+using Type = nngn::Recorder::Type;
+
+struct frame_rec { std::int64_t now, dt; };
+struct event_rec { nngn::i32 i0, i1, i2; };
+
+}
+
+namespace nngn {
+
+template<typename T>
+void Recorder::write(const T &t) {
+    this->out->write(byte_cast<const char*>(&t), sizeof(t));
+}
+
+template<typename T>
+bool Recorder::read(T *t) {
+    return static_cast<bool>(
+        this->in->read(byte_cast<char*>(t), sizeof(*t)));
+}
+
+bool Recorder::fail(void) {
+    this->stop();
+    return false;
+}
+
+bool Recorder::record(const char *path) {
+    NNGN_LOG_CONTEXT_CF(Recorder);
+    auto f = std::make_unique<std::ofstream>(path, std::ios::binary);
+    if(!*f)
+        return Log::perror(path), false;
+    return this->record(std::move(f));
+}
+
+bool Recorder::record(std::unique_ptr<std::ostream> s) {
+    this->stop();
+    this->out = std::move(s);
+    this->m_mode = Mode::RECORD;
+    return this->write_header() && this->write_frame();
+}
+
+bool Recorder::replay(const char *path) {
+    NNGN_LOG_CONTEXT_CF(Recorder);
+    auto f = std::make_unique<std::ifstream>(path, std::ios::binary);
+    if(!*f)
+        return Log::perror(path), false;
+    return this->replay(std::move(f));
+}
+
+bool Recorder::replay(std::unique_ptr<std::istream> s) {
+    this->stop();
+    this->in = std::move(s);
+    this->m_mode = Mode::REPLAY;
+    return this->read_header();
+}
+
+void Recorder::stop(void) {
+    if(this->out)
+        this->out->flush();
+    this->out.reset();
+    this->in.reset();
+    this->m_events.clear();
+    this->keys.reset();
+    this->next_frame = false;
+    this->m_mode = Mode::NONE;
+}
+
+bool Recorder::write_header(void) {
+    NNGN_LOG_CONTEXT_CF(Recorder);
+    this->out->write(MAGIC.data(), static_cast<std::streamsize>(MAGIC.size()));
+    this->write(VERSION);
+    if(!*this->out)
+        return Log::l() << "failed to write header\n", this->fail();
+    return true;
+}
+
+bool Recorder::read_header(void) {
+    NNGN_LOG_CONTEXT_CF(Recorder);
+    std::string magic(MAGIC.size(), 0);
+    this->in->read(magic.data(), static_cast<std::streamsize>(magic.size()));
+    if(!*this->in || magic != MAGIC)
+        return Log::l() << "invalid header\n", this->fail();
+    u8 version = {};
+    if(!this->read(&version) || version != VERSION)
+        return Log::l() << "unsupported version\n", this->fail();
+    return true;
+}
+
+bool Recorder::write_frame(void) {
+    NNGN_LOG_CONTEXT_CF(Recorder);
+    assert(this->timing);
+    const auto &t = *this->timing;
+    this->write(Type::FRAME);
+    this->write(frame_rec{t.now.time_since_epoch().count(), t.dt.count()});
+    if(!*this->out)
+        return Log::l() << "failed to write frame\n", this->fail();
+    return true;
+}
+
+bool Recorder::frame(void) {
+    NNGN_LOG_CONTEXT_CF(Recorder);
+    switch(this->m_mode) {
+    case Mode::NONE: return true;
+    case Mode::RECORD: return this->write_frame();
+    case Mode::REPLAY: break;
+    }
+    this->m_events.clear();
+    Type type = {};
+    if(!std::exchange(this->next_frame, false)) {
+        if(!this->read(&type))
+            return Log::l() << "replay finished\n", this->stop(), true;
+        if(type != Type::FRAME)
+            return Log::l() << "expected frame record\n", this->fail();
+    }
+    frame_rec f = {};
+    if(!this->read(&f))
+        return Log::l() << "truncated frame record\n", this->fail();
+    assert(this->timing);
+    this->timing->now = Timing::time_point{Timing::duration{f.now}};
+    this->timing->dt = Timing::duration{f.dt};
+    while(this->read(&type)) {
+        if(type == Type::FRAME)
+            return this->next_frame = true;
+        if(!this->read_event(type))
+            return this->fail();
+    }
+    return true;
+}
+
+bool Recorder::read_event(Type t) {
+    Event e = {t, 0, 0, 0, {}, {}};
+    switch(t) {
+    case Type::KEY:
+    case Type::BUTTON: {
+        event_rec r = {};
+        if(!this->read(&r))
+            return Log::l() << "truncated event\n", false;
+        e.i0 = r.i0, e.i1 = r.i1, e.i2 = r.i2;
+        if(t == Type::KEY && 0 <= r.i0 && r.i0 <= Input::KEY_MAX)
+            this->keys[static_cast<std::size_t>(r.i0)] =
+                r.i1 == Input::KEY_PRESS;
+        break;
+    }
+    case Type::MOVE:
+        if(!this->read(&e.pos))
+            return Log::l() << "truncated event\n", false;
+        break;
+    case Type::SOCKET: {
+        u32 n = {};
+        if(!this->read(&n))
+            return Log::l() << "truncated event\n", false;
+        if(n > MAX_COMMAND)
+            return Log::l()
+                << "command too large: " << n << " > " << MAX_COMMAND << '\n',
+                false;
+        e.data.resize(n);
+        if(!this->in->read(e.data.data(), static_cast<std::streamsize>(n)))
+            return Log::l() << "truncated event\n", false;
+        break;
+    }
+    case Type::FRAME:
+    default: return Log::l() << "invalid record type\n", false;
+    }
+    this->m_events.push_back(std::move(e));
+    return true;
+}
+
+bool Recorder::key(int key, int action, int mods) {
+    switch(this->m_mode) {
+    case Mode::NONE: return true;
+    case Mode::REPLAY: return this->dispatching;
+    case Mode::RECORD: break;
+    }
+    this->write(Type::KEY);
+    this->write(event_rec{key, action, mods});
+    return true;
+}
+
+bool Recorder::button(int button, int action, int mods) {
+    switch(this->m_mode) {
+    case Mode::NONE: return true;
+    case Mode::REPLAY: return this->dispatching;
+    case Mode::RECORD: break;
+    }
+    this->write(Type::BUTTON);
+    this->write(event_rec{button, action, mods});
+    return true;
+}
+
+bool Recorder::move(dvec2 pos) {
+    switch(this->m_mode) {
+    case Mode::NONE: return true;
+    case Mode::REPLAY: return this->dispatching;
+    case Mode::RECORD: break;
+    }
+    this->write(Type::MOVE);
+    this->write(pos);
+    return true;
+}
+
+bool Recorder::socket(std::string_view s) {
+    NNGN_LOG_CONTEXT_CF(Recorder);
+    switch(this->m_mode) {
+    case Mode::NONE: return true;
+    case Mode::REPLAY: return this->dispatching;
+    case Mode::RECORD: break;
+    }
+    if(s.size() > MAX_COMMAND)
+        return Log::l() << "command too large to record\n", true;
+    this->write(Type::SOCKET);
+    this->write(static_cast<u32>(s.size()));
+    this->out->write(s.data(), static_cast<std::streamsize>(s.size()));
+    return true;
+}
+
+void Recorder::get_keys(std::span<i32> keys_) const {
+    for(auto &k : keys_)
+        k = 0 <= k && k <= Input::KEY_MAX
+            && this->keys[static_cast<std::size_t>(k)];
+}
+
+}
@@ -0,0 +1,139 @@
+#ifndef NNGN_INPUT_RECORDER_H
+#define NNGN_INPUT_RECORDER_H
+
+#include <bitset>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "math/vec2.h"
+#include "timing/timing.h"
+#include "utils/def.h"
+
+#include "input.h"
+#include "mouse.h"
+
+namespace nngn {
+
+/**
+ * Records external input to a binary stream and later replays it.
+ *
+ * While recording, the clock values of each frame (see \ref frame), every key
+ * and mouse event, and every command received through the socket are written
+ * to the stream.  While replaying, the same sequence is read back: the clock
+ * is set to the recorded values, live events are discarded, and the recorded
+ * events of each frame are dispatched by \ref dispatch.  The state of the keys
+ * polled via \ref Input::get_keys is reconstructed from the key events.
+ *
+ * The stream starts with a header (\ref MAGIC, \ref VERSION), followed by a
+ * sequence of records, each a \ref Type byte followed by its fixed-size
+ * fields (socket commands are prefixed by their size).  Values are written in
+ * host byte order.  Recording starts with a frame record for the current
+ * frame, so that events from the rest of the frame are replayed.  When the end
+ * of the stream is reached, replaying stops and the live input is used again.
+ */
+class Recorder {
+public:
+    enum class Mode : u8 { NONE, RECORD, REPLAY };
+    enum class Type : u8 { FRAME, KEY, BUTTON, MOVE, SOCKET };
+    static constexpr std::string_view MAGIC = "nngnrec";
+    static constexpr u8 VERSION = 1;
+    /** Maximum size of a socket command, see \ref Socket. */
+    static constexpr u32 MAX_COMMAND = 1024u * 1024u;
+    /** Event read from the stream while replaying. */
+    struct Event {
+        Type type;
+        int i0, i1, i2;
+        dvec2 pos;
+        std::string data;
+    };
+    void init(Timing *t) { this->timing = t; }
+    Mode mode(void) const { return this->m_mode; }
+    /** Events of the current frame, only valid while replaying. */
+    std::span<const Event> events(void) const { return this->m_events; }
+    bool record(const char *path);
+    bool record(std::unique_ptr<std::ostream> s);
+    bool replay(const char *path);
+    bool replay(std::unique_ptr<std::istream> s);
+    void stop(void);
+    /**
+     * Records or replays the clock values for the current frame.
+     * Must be called once per frame, after \ref Timing::update.  While
+     * replaying, also reads the events of the frame.
+     */
+    bool frame(void);
+    /**
+     * Filters live events.
+     * While recording, the event is written to the stream.  Returns `false`
+     * if it should be discarded, i.e. while replaying.
+     */
+    bool key(int key, int action, int mods);
+    bool button(int button, int action, int mods);
+    bool move(dvec2 pos);
+    bool socket(std::string_view s);
+    /** Key state reconstructed from the replayed events. */
+    void get_keys(std::span<i32> keys) const;
+    /**
+     * Dispatches the replayed input events of the current frame.
+     * As with live input, failures in the callbacks are ignored.
+     */
+    void dispatch(Input *input, MouseInput *mouse);
+    /**
+     * Dispatches the replayed socket commands of the current frame.
+     * Should be called where live commands are processed.
+     */
+    template<typename F>
+    void dispatch_socket(F &&f);
+private:
+    template<typename T> void write(const T &t);
+    template<typename T> bool read(T *t);
+    bool write_header(void);
+    bool write_frame(void);
+    bool read_header(void);
+    bool read_event(Type t);
+    bool fail(void);
+    Timing *timing = nullptr;
+    Mode m_mode = Mode::NONE;
+    bool dispatching = false, next_frame = false;
+    std::unique_ptr<std::ostream> out = {};
+    std::unique_ptr<std::istream> in = {};
+    std::vector<Event> m_events = {};
+    std::bitset<Input::KEY_MAX + 1> keys = {};
+};
+
+inline void Recorder::dispatch(Input *input, MouseInput *mouse) {
+    if(this->m_mode != Mode::REPLAY)
+        return;
+    this->dispatching = true;
+    for(const auto &x : this->m_events)
+        switch(x.type) {
+        case Type::KEY:
+            input->key_callback(
+                x.i0, static_cast<Input::Action>(x.i1),
+                static_cast<Input::Modifier>(x.i2));
+            break;
+        case Type::BUTTON: mouse->button_callback(x.i0, x.i1, x.i2); break;
+        case Type::MOVE: mouse->move_callback(x.pos); break;
+        case Type::SOCKET: case Type::FRAME: break;
+        }
+    this->dispatching = false;
+}
+
+template<typename F>
+void Recorder::dispatch_socket(F &&f) {
+    if(this->m_mode != Mode::REPLAY)
+        return;
+    this->dispatching = true;
+    for(const auto &x : this->m_events)
+        if(x.type == Type::SOCKET)
+            f(std::string_view{x.data});
+    this->dispatching = false;
+}
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef NNGN_JOBS_DEQUE_H
+#define NNGN_JOBS_DEQUE_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+#include "utils/def.h"
+#include "utils/utils.h"
+
+namespace nngn {
+
+/**
+ * Bounded double-ended queue with a single owner and multiple thieves.
+ * The owner thread pushes and pops items at the bottom, other threads remove
+ * items from the top.  Based on the Chase-Lev deque, following "Correct and
+ * Efficient Work-Stealing for Weak Memory Models" (Lê et al., 2013), with
+ * sequentially-consistent operations in place of fences and without the
+ * resizing step: \ref push fails when the queue is full.
+ */
+template<typename T, std::size_t N>
+class work_stealing_deque {
+    static_assert(std::has_single_bit(N));
+    static_assert(std::is_trivially_copyable_v<T>);
+public:
+    work_stealing_deque(void) = default;
+    NNGN_NO_MOVE(work_stealing_deque)
+    ~work_stealing_deque(void) = default;
+    /** Approximate number of items, exact only for the owner. */
+    std::size_t size(void) const;
+    /** Adds an item at the bottom, owner only. */
+    bool push(T x);
+    /** Removes an item from the bottom, owner only. */
+    bool pop(T *x);
+    /** Removes an item from the top, any thread. */
+    bool steal(T *x);
+private:
+    static constexpr auto mask = static_cast<i64>(N - 1);
+    alignas(64) std::atomic<i64> top = 0;
+    alignas(64) std::atomic<i64> bottom = 0;
+    std::array<std::atomic<T>, N> v = {};
+};
+
+template<typename T, std::size_t N>
+std::size_t work_stealing_deque<T, N>::size(void) const {
+    const auto b = this->bottom.load(std::memory_order_relaxed);
+    const auto t = this->top.load(std::memory_order_relaxed);
+    return b <= t ? 0 : static_cast<std::size_t>(b - t);
+}
+
+template<typename T, std::size_t N>
+bool work_stealing_deque<T, N>::push(T x) {
+    const auto b = this->bottom.load(std::memory_order_relaxed);
+    const auto t = this->top.load(std::memory_order_acquire);
+    if(b - t >= static_cast<i64>(N))
+        return false;
+    this->v[static_cast<std::size_t>(b & mask)]
+        .store(x, std::memory_order_relaxed);
+    this->bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T, std::size_t N>
+bool work_stealing_deque<T, N>::pop(T *x) {
+    const auto b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_seq_cst);
+    auto t = this->top.load(std::memory_order_seq_cst);
+    if(b < t) {
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return false;
+    }
+    *x = this->v[static_cast<std::size_t>(b & mask)]
+        .load(std::memory_order_relaxed);
+    if(t < b)
+        return true;
+    const bool ret = this->top.compare_exchange_strong(
+        t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    this->bottom.store(b + 1, std::memory_order_relaxed);
+    return ret;
+}
+
+template<typename T, std::size_t N>
+bool work_stealing_deque<T, N>::steal(T *x) {
+    auto t = this->top.load(std::memory_order_seq_cst);
+    const auto b = this->bottom.load(std::memory_order_seq_cst);
+    if(b <= t)
+        return false;
+    const auto ret = this->v[static_cast<std::size_t>(t & mask)]
+        .load(std::memory_order_relaxed);
+    if(!this->top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return false;
+    *x = ret;
+    return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,256 @@
+#include <cassert>
+#include <string>
+
+#include "os/platform.h"
+#include "utils/log.h"
+
+#include "jobs.h"
+
+namespace {
+
+struct thread_info {
+    const nngn::Jobs *owner;
+    std::size_t i;
+};
+
+thread_local thread_info current = {};
+
+/** Number of unsuccessful searches before a worker goes to sleep. */
+constexpr std::size_t SPIN = 64;
+
+}
+
+namespace nngn {
+
+Jobs::Job::Job(
+    Graph *g, const char *n, std::function<void(void)> f_, bool main_
+) : graph{g}, name{n}, f{std::move(f_)}, main{main_} {}
+
+Jobs::Job::Job(
+    Graph *g, const char *n, range_fn *f_, void *p,
+    std::size_t begin_, std::size_t end_
+) : graph{g}, name{n}, range_f{f_}, data{p}, begin{begin_}, end{end_} {}
+
+auto Jobs::Graph::add(
+    const char *name, std::function<void(void)> f,
+    std::span<Job *const> deps
+) -> Job* {
+    return this->submit(
+        &this->v.emplace_back(this, name, std::move(f), false), deps);
+}
+
+auto Jobs::Graph::add_main(
+    const char *name, std::function<void(void)> f,
+    std::span<Job *const> deps
+) -> Job* {
+    return this->submit(
+        &this->v.emplace_back(this, name, std::move(f), true), deps);
+}
+
+auto Jobs::Graph::add_range(
+    const char *name, Job::range_fn *f, void *p,
+    std::size_t begin, std::size_t end
+) -> Job* {
+    return this->submit(
+        &this->v.emplace_back(this, name, f, p, begin, end), {});
+}
+
+auto Jobs::Graph::submit(Job *j, std::span<Job *const> deps) -> Job* {
+    this->remaining.fetch_add(1, std::memory_order_relaxed);
+    for(auto *const d : deps) {
+        assert(d->graph == this);
+        const std::lock_guard lock = std::lock_guard{d->m};
+        if(d->done)
+            continue;
+        d->next.push_back(j);
+        j->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    if(j->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        this->jobs->schedule(j);
+    return j;
+}
+
+void Jobs::Graph::wait(void) {
+    if(!this->done())
+        this->jobs->wait(*this);
+}
+
+std::size_t Jobs::default_threads(void) {
+    const auto n = std::thread::hardware_concurrency();
+    return n ? n - 1 : 0;
+}
+
+Jobs::Jobs(void) {
+    this->queues.emplace_back(std::make_unique<queue>());
+}
+
+std::size_t Jobs::queue_index(void) const {
+    if(current.owner == this)
+        return current.i;
+    if(std::this_thread::get_id() == this->main_thread)
+        return 0;
+    return NO_QUEUE;
+}
+
+bool Jobs::set_threads(std::size_t n) {
+    NNGN_LOG_CONTEXT_CF(Jobs);
+    if(n == this->threads())
+        return true;
+    if constexpr(Platform::emscripten)
+        if(n)
+            return Log::l() << "threads are not supported\n", false;
+    {
+        const std::lock_guard lock = std::lock_guard{this->m};
+        this->exit = true;
+    }
+    this->cv.notify_all();
+    for(auto &x : this->workers)
+        x.join();
+    this->workers.clear();
+    this->exit = false;
+    this->queues.resize(1);
+    this->queues.reserve(n + 1);
+    for(std::size_t i = 1; i <= n; ++i)
+        this->queues.emplace_back(std::make_unique<queue>());
+    this->workers.reserve(n);
+    for(std::size_t i = 1; i <= n; ++i)
+        this->workers.emplace_back(&Jobs::run, this, i);
+    return true;
+}
+
+void Jobs::run_main(void) {
+    assert(this->queue_index() == 0);
+    while(auto *const j = this->pop_main())
+        this->execute(j);
+}
+
+void Jobs::run(std::size_t i) {
+    current = {this, i};
+    Trace::set_thread_name("jobs " + std::to_string(i));
+    for(std::size_t spin = 0;;) {
+        if(auto *const j = this->find(i)) {
+            this->execute(j);
+            spin = 0;
+            continue;
+        }
+        if(++spin < SPIN) {
+            std::this_thread::yield();
+            continue;
+        }
+        spin = 0;
+        std::unique_lock lock = std::unique_lock{this->m};
+        this->sleeping.fetch_add(1);
+        this->cv.wait(lock, [this] { return this->exit || this->queued > 0; });
+        this->sleeping.fetch_sub(1);
+        if(this->exit)
+            return;
+    }
+}
+
+void Jobs::schedule(Job *j) {
+    if(j->main) {
+        {
+            const std::lock_guard lock = std::lock_guard{this->m};
+            this->main_queue.push_back(j);
+        }
+        return this->notify(true);
+    }
+    this->queued.fetch_add(1);
+    const auto i = this->queue_index();
+    if(i == NO_QUEUE || !this->queues[i]->push(j)) {
+        const std::lock_guard lock = std::lock_guard{this->m};
+        this->shared.push_back(j);
+    }
+    this->notify(false);
+}
+
+auto Jobs::find(std::size_t i) -> Job* {
+    Job *ret = nullptr;
+    const auto took = [this, &ret] {
+        this->queued.fetch_sub(1);
+        return ret;
+    };
+    if(i != NO_QUEUE && this->queues[i]->pop(&ret))
+        return took();
+    const auto n = this->queues.size();
+    const auto first = i == NO_QUEUE ? 0 : i + 1;
+    for(std::size_t k = 0; k != n; ++k)
+        if(const auto qi = (first + k) % n; qi != i)
+            if(this->queues[qi]->steal(&ret))
+                return took();
+    const std::lock_guard lock = std::lock_guard{this->m};
+    if(this->shared.empty())
+        return nullptr;
+    ret = this->shared.front();
+    this->shared.pop_front();
+    return took();
+}
+
+auto Jobs::pop_main(void) -> Job* {
+    const std::lock_guard lock = std::lock_guard{this->m};
+    if(this->main_queue.empty())
+        return nullptr;
+    auto *const ret = this->main_queue.back();
+    this->main_queue.pop_back();
+    return ret;
+}
+
+void Jobs::execute(Job *j) {
+    {
+        const auto zone = Trace::zone{j->name};
+        if(j->range_f)
+            j->range_f(j->data, j->begin, j->end);
+        else
+            j->f();
+    }
+    std::vector<Job*> next = {};
+    {
+        const std::lock_guard lock = std::lock_guard{j->m};
+        j->done = true;
+        next.swap(j->next);
+    }
+    for(auto *const x : next)
+        if(x->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            this->schedule(x);
+    // The graph may be destroyed as soon as this reaches zero.
+    if(j->graph->remaining.fetch_sub(1) == 1)
+        this->notify(true);
+}
+
+void Jobs::wait(const Graph &g) {
+    const auto i = this->queue_index();
+    const bool main = !i;
+    for(;;) {
+        if(g.done())
+            return;
+        if(auto *const j = main ? this->pop_main() : nullptr) {
+            this->execute(j);
+            continue;
+        }
+        if(auto *const j = this->find(i)) {
+            this->execute(j);
+            continue;
+        }
+        std::unique_lock lock = std::unique_lock{this->m};
+        this->sleeping.fetch_add(1);
+        this->cv.wait(lock, [this, &g, main] {
+            return g.done() || this->queued > 0
+                || (main && !this->main_queue.empty());
+        });
+        this->sleeping.fetch_sub(1);
+    }
+}
+
+void Jobs::notify(bool all) {
+    // Waiters increment `sleeping` and then check the counters updated before
+    // this call, the opposite order: all four operations are seq_cst.
+    if(!this->sleeping.load())
+        return;
+    { const std::lock_guard lock = std::lock_guard{this->m}; }
+    if(all)
+        this->cv.notify_all();
+    else
+        this->cv.notify_one();
+}
+
+}
@@ -0,0 +1,200 @@
+/**
+ * \dir src/jobs
+ * \brief Work-stealing job system.
+ *
+ * \ref nngn::Jobs executes small units of work in a pool of threads.  It is
+ * used by subsystems to parallelize their internal loops (e.g. via \ref
+ * nngn::Jobs::parallel_for) and is not exposed directly to Lua code, which
+ * always executes in the main thread.
+ */
+#ifndef NNGN_JOBS_JOBS_H
+#define NNGN_JOBS_JOBS_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "timing/trace.h"
+#include "utils/def.h"
+#include "utils/utils.h"
+
+#include "deque.h"
+
+namespace nngn {
+
+/**
+ * Pool of worker threads which execute jobs.
+ *
+ * Each worker and the main thread (the one which created the object) have
+ * their own \ref work_stealing_deque: jobs which become ready in one of these
+ * threads are pushed to the bottom of its queue and popped in LIFO order, idle
+ * threads steal from the top of the other queues.  Jobs submitted by other
+ * threads are placed in a shared queue.  A thread waiting for jobs to finish
+ * executes other jobs in the meantime.
+ *
+ * Jobs are grouped in \ref Graph objects, which also express dependencies
+ * between them.  Jobs can be restricted to the main thread (e.g. those which
+ * use the Lua state), in which case they are only executed while the main
+ * thread waits for a graph or calls \ref run_main.
+ *
+ * With zero workers (the default), all jobs are executed by the thread which
+ * waits for them.  Each job is recorded as a \ref Trace zone.
+ */
+class Jobs {
+public:
+    class Graph;
+    /** Unit of work, owned by a \ref Graph. */
+    class Job {
+    public:
+        using range_fn = void(void*, std::size_t, std::size_t);
+        Job(Graph *g, const char *n, std::function<void(void)> f, bool main);
+        Job(Graph *g, const char *n, range_fn *f, void *p,
+            std::size_t begin, std::size_t end);
+        NNGN_NO_MOVE(Job)
+        ~Job(void) = default;
+    private:
+        friend class Jobs;
+        friend class Graph;
+        Graph *graph;
+        const char *name;
+        std::function<void(void)> f = {};
+        range_fn *range_f = nullptr;
+        void *data = nullptr;
+        std::size_t begin = 0, end = 0;
+        bool main = false, done = false;
+        /** Unfinished dependencies, plus one until the job is submitted. */
+        std::atomic<u32> pending = 1;
+        /** Protects \ref next and \ref done. */
+        std::mutex m = {};
+        /** Jobs which depend on this one. */
+        std::vector<Job*> next = {};
+    };
+    /**
+     * Set of jobs, completed by \ref wait.
+     * Jobs must be added by a single thread.  The graph must not be destroyed
+     * before all its jobs are finished, which the destructor ensures.
+     */
+    class Graph {
+    public:
+        explicit Graph(Jobs *j) : jobs{j} {}
+        NNGN_NO_MOVE(Graph)
+        ~Graph(void) { this->wait(); }
+        /** Sequentially consistent, see \ref Jobs::notify. */
+        bool done(void) const { return !this->remaining.load(); }
+        /** Adds a job which executes after all jobs in \p deps finish. */
+        Job *add(
+            const char *name, std::function<void(void)> f,
+            std::span<Job *const> deps = {});
+        Job *add(
+            const char *name, std::function<void(void)> f,
+            std::initializer_list<Job*> deps)
+        { return this->add(name, std::move(f), {deps.begin(), deps.size()}); }
+        /** Similar to \ref add, but the job only executes in the main thread. */
+        Job *add_main(
+            const char *name, std::function<void(void)> f,
+            std::span<Job *const> deps = {});
+        Job *add_main(
+            const char *name, std::function<void(void)> f,
+            std::initializer_list<Job*> deps)
+        {
+            return this->add_main(
+                name, std::move(f), {deps.begin(), deps.size()});
+        }
+        /** Adds a job which calls `f(p, begin, end)`. */
+        Job *add_range(
+            const char *name, Job::range_fn *f, void *p,
+            std::size_t begin, std::size_t end);
+        /** Executes jobs until all jobs in this graph are finished. */
+        void wait(void);
+    private:
+        friend class Jobs;
+        Job *submit(Job *j, std::span<Job *const> deps);
+        Jobs *jobs;
+        std::deque<Job> v = {};
+        std::atomic<std::size_t> remaining = 0;
+    };
+    /** Capacity of each thread's queue. */
+    static constexpr std::size_t QUEUE_SIZE = 1u << 12;
+    /** Number of workers which, with the main thread, occupy all cores. */
+    static std::size_t default_threads(void);
+    Jobs(void);
+    NNGN_NO_MOVE(Jobs)
+    ~Jobs(void) { this->set_threads(0); }
+    std::size_t threads(void) const { return this->workers.size(); }
+    /**
+     * Stops current workers and starts \p n new ones.
+     * No jobs may be pending.
+     */
+    bool set_threads(std::size_t n);
+    /** Executes all pending main-thread jobs, main thread only. */
+    void run_main(void);
+    /**
+     * Calls `f(begin, end)` for consecutive ranges covering <tt>[0, n)</tt>.
+     * Each range has at most \p grain elements (except when executed
+     * serially, when a single call is made for the entire range).  Returns
+     * once all calls are finished.
+     */
+    template<typename F>
+    void parallel_for(
+        const char *name, std::size_t n, std::size_t grain, F &&f);
+private:
+    using queue = work_stealing_deque<Job*, QUEUE_SIZE>;
+    static constexpr auto NO_QUEUE = static_cast<std::size_t>(-1);
+    /** Index of the calling thread's queue, or \ref NO_QUEUE. */
+    std::size_t queue_index(void) const;
+    void run(std::size_t i);
+    void schedule(Job *j);
+    Job *find(std::size_t i);
+    Job *pop_main(void);
+    void execute(Job *j);
+    void wait(const Graph &g);
+    void notify(bool all);
+    std::thread::id main_thread = std::this_thread::get_id();
+    std::vector<std::unique_ptr<queue>> queues = {};
+    std::vector<std::thread> workers = {};
+    /** Protects \ref shared, \ref main_queue, \ref exit, and \ref cv waits. */
+    std::mutex m = {};
+    std::condition_variable cv = {};
+    std::deque<Job*> shared = {};
+    std::vector<Job*> main_queue = {};
+    /** Jobs which are ready but not yet taken by any thread. */
+    std::atomic<i64> queued = 0;
+    /** Threads waiting on \ref cv. */
+    std::atomic<u32> sleeping = 0;
+    bool exit = false;
+};
+
+template<typename F>
+void Jobs::parallel_for(
+    const char *name, std::size_t n, std::size_t grain, F &&f)
+{
+    grain = std::max<std::size_t>(grain, 1);
+    if(!n)
+        return;
+    if(!this->threads() || n <= grain) {
+        const auto zone = Trace::zone{name};
+        return f(std::size_t{}, n);
+    }
+    using T = std::remove_reference_t<F>;
+    constexpr auto call = [](void *p, std::size_t b, std::size_t e)
+        { (*static_cast<T*>(p))(b, e); };
+    auto *const p = const_cast<void*>(
+        static_cast<const void*>(std::addressof(f)));
+    Graph g = Graph{this};
+    for(std::size_t b = 0; b < n; b += grain)
+        g.add_range(name, call, p, b, std::min(b + grain, n));
+    g.wait();
+}
+
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/table.h"
+
+#include "jobs.h"
+
+using nngn::Jobs;
+
+namespace {
+
+auto default_threads(void) {
+    return nngn::narrow<lua_Integer>(Jobs::default_threads());
+}
+
+auto threads(const Jobs &j) {
+    return nngn::narrow<lua_Integer>(j.threads());
+}
+
+bool set_threads(Jobs &j, lua_Integer n) {
+    return j.set_threads(nngn::narrow<std::size_t>(n));
+}
+
+void register_jobs(nngn::lua::table_view t) {
+    t["default_threads"] = default_threads;
+    t["threads"] = threads;
+    t["set_threads"] = set_threads;
+}
+
+}
+
+NNGN_LUA_DECLARE_USER_TYPE(Jobs)
+NNGN_LUA_PROXY(Jobs, register_jobs)
@@ -1,6 +1,7 @@
 #include "alloc.h"
 
 #include "utils/alloc/block.h"
+#include "utils/alloc/pool.h"
 #include "utils/alloc/realloc.h"
 #include "utils/alloc/tagging.h"
 #include "utils/alloc/tracking.h"
@@ -115,4 +116,23 @@ void *alloc_info::lua_alloc(void *d, void *p, std::size_t s0, std::size_t s1) {
     return nullptr;
 }
 
+void *alloc_info::lua_alloc_pool(
+    void *d, void *p, std::size_t s0, std::size_t s1)
+{
+    using T = char;
+    using tracker = ::tracker<T>;
+    using A0 = pool_allocator<T>;
+    using A1 = tagging_allocator<tracker, A0>;
+    using A2 = tracking_allocator<tracker, A1>;
+    auto *const info = static_cast<alloc_info*>(d);
+    auto alloc = A2{tracker{info}, A1{A0{&info->pool}}};
+    if(s1)
+        return p
+            ? alloc.reallocate(static_cast<char*>(p), s0, s1)
+            : alloc.allocate(s1, static_cast<type>(s0));
+    if(p)
+        alloc.deallocate(static_cast<char*>(p), s0);
+    return nullptr;
+}
+
 }
@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <tuple>
 
+#include "utils/alloc/pool.h"
 #include "utils/ranges.h"
 #include "utils/utils.h"
 
@@ -25,10 +26,18 @@ namespace nngn::lua {
  * Its \p d parameter should be the address of an object of this type.
  * `malloc(3)`, `realloc(3)`, and `free(3)` will be used for actual memory
  * allocations.
+ *
+ * \ref lua_alloc_pool is an alternative which serves small allocations from
+ * the size-class free lists in \ref pool (see \ref nngn::size_class_pool).
+ * Tracking information is kept in the same way for both functions, but they
+ * cannot be mixed in the same state.
  */
 struct alloc_info {
     /** Function to be passed to `lua_newstate`. */
     static void *lua_alloc(void *d, void *p, std::size_t s0, std::size_t s1);
+    /** As \ref lua_alloc, but allocates from \ref pool. */
+    static void *lua_alloc_pool(
+        void *d, void *p, std::size_t s0, std::size_t s1);
     /** Each entry corresponds to the allocation information in \ref v. */
     static constexpr std::array types = {
         type::string, type::table, type::function, type::user_data,
@@ -50,6 +59,8 @@ struct alloc_info {
      * Types are in the same order as \ref types.
      */
     std::array<info, n_types> v = {};
+    /** Storage for allocations made by \ref lua_alloc_pool. */
+    size_class_pool pool = {};
 };
 
 }
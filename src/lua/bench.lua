@@ -0,0 +1,6 @@
+-- Runs a headless benchmark (see `nngn.lib.bench`).
+-- Options are read from the global table `BENCH`, e.g.:
+--
+--     nngn 'BENCH = {"demos/colliders.lua", frames = 1200}' @src/lua/bench.lua
+dofile "src/lua/path.lua"
+require("nngn.lib.bench").run(BENCH)
@@ -1 +1,35 @@
 #include "function.h"
+
+#include "table.h"
+
+namespace nngn::lua::detail {
+
+bool check_method_self(lua_State *L, std::string_view meta) {
+    NNGN_LOG_CONTEXT_F();
+    if(lua_getmetatable(L, 1)) {
+        const bool ret = lua_rawequal(L, -1, lua_upvalueindex(1));
+        lua_pop(L, 1);
+        if(ret)
+            return true;
+    }
+    Log::l()
+        << "expected a user data value of type " << std::quoted(meta)
+        << " as the first argument, found "
+        << type_str(state_view{L}.get_type(1)) << '\n';
+    return false;
+}
+
+void push_method(lua_State *L, lua_CFunction f, std::string_view meta) {
+    NNGN_LOG_CONTEXT_F();
+    const state_view lua = {L};
+    table mt = global_table{lua}[meta];
+    if constexpr(Platform::debug)
+        if(const auto t = mt.get_type(); t != type::table)
+            Log::l()
+                << "meta table " << std::quoted(meta)
+                << " not found, got a " << type_str(t) << " value\n";
+    mt.release();
+    lua_pushcclosure(L, f, 1);
+}
+
+}
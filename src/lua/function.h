@@ -60,16 +60,40 @@
  * }));
  * assert(lua.get(-1) == 85.0);
  * \endcode
+ *
+ * ## Compiled methods
+ *
+ * Member functions pushed as regular values (e.g. `t["f"] = &T::f`) are
+ * stored as a full user data up value which is read and called indirectly on
+ * every invocation, and the object argument goes through the generic \ref
+ * nngn::lua::user_data::get "user_data::get" path.  \ref nngn::lua::method
+ * "method" is an opt-in alternative for frequently-called methods of user
+ * types: the function is a template argument, so the thunk is specialized (and
+ * the call usually inlined) at compile time, and the meta table of the object
+ * type is captured as an up value when the method is registered.  In debug
+ * builds, the object argument is verified with a single comparison against
+ * that up value instead of a lookup in the global table.
+ *
+ * \code{.cpp}
+ * int g(T &t, int i) { return t.g(i); }
+ *
+ * static void register_t(nngn::lua::table_view t) {
+ *     t["f"] = nngn::lua::method<&T::f>;
+ *     t["g"] = nngn::lua::method<g>;
+ * }
+ * \endcode
  */
 #ifndef NNGN_LUA_FUNCTION_H
 #define NNGN_LUA_FUNCTION_H
 
+#include <functional>
 #include <optional>
 #include <tuple>
 #include <utility>
 
 #include <lua.hpp>
 
+#include "os/platform.h"
 #include "utils/log.h"
 
 #include "lua.h"
@@ -111,6 +135,71 @@ struct function_value : value, detail::function_base<function_value> {
 
 namespace detail {
 
+/**
+ * Decomposes a function which can be registered as a \ref method.
+ * Supported are (`const`) member functions of a user type and regular
+ * functions which take the object as a reference or pointer in the first
+ * parameter.
+ */
+template<typename F> struct method_traits;
+
+template<typename R, typename T, typename ...Args>
+struct method_traits<R(T::*)(Args...)> {
+    using type = T;
+    using args = std::tuple<Args...>;
+    static T &self(T *p) { return *p; }
+};
+
+template<typename R, typename T, typename ...Args>
+struct method_traits<R(T::*)(Args...) const> {
+    using type = T;
+    using args = std::tuple<Args...>;
+    static const T &self(T *p) { return *p; }
+};
+
+template<typename R, typename T, typename ...Args>
+struct method_traits<R(*)(T&, Args...)> {
+    using type = std::remove_const_t<T>;
+    using args = std::tuple<Args...>;
+    static T &self(type *p) { return *p; }
+};
+
+template<typename R, typename T, typename ...Args>
+struct method_traits<R(*)(T*, Args...)> {
+    using type = std::remove_const_t<T>;
+    using args = std::tuple<Args...>;
+    static T *self(type *p) { return p; }
+};
+
+/**
+ * Verifies that the first argument's meta table is the first up value.
+ * \see nngn::lua::method
+ */
+bool check_method_self(lua_State *L, std::string_view meta);
+
+/** Pushes \p f as a closure with the meta table \p meta as up value. */
+void push_method(lua_State *L, lua_CFunction f, std::string_view meta);
+
+/** Implementation of \ref method, \p f is called with the stack arguments. */
+template<auto f>
+int method_thunk(lua_State *L) {
+    using traits = method_traits<decltype(f)>;
+    using T = typename traits::type;
+    if constexpr(Platform::debug)
+        if(!check_method_self(L, metatable_name<T>))
+            return stack_push<>::push(L, error{"invalid method call"});
+    auto *const p = user_data<T>::get_unchecked(L, 1);
+    return std::apply([L, p]<typename ...Args>(Args &&...args) {
+        using R = std::invoke_result_t<
+            decltype(f), decltype(traits::self(p)), Args...>;
+        if constexpr(std::is_void_v<R>)
+            return std::invoke(f, traits::self(p), FWD(args)...), 0;
+        else
+            return stack_push<>::push(
+                L, std::invoke(f, traits::self(p), FWD(args)...));
+    }, stack_get<typename traits::args>::get(L, 2));
+}
+
 template<typename CRTP>
 void function_base<CRTP>::operator()(auto &&...args) const {
     NNGN_LOG_CONTEXT_CF(function_base);
@@ -144,6 +233,29 @@ decltype(auto) call(lua_State *L, T, int i) {
     return call(L, +T{}, i);
 }
 
+/**
+ * Tag used to register \p f as a compiled method.
+ * \see nngn::lua::method
+ */
+template<auto f> struct method_t {};
+
+/**
+ * Pushes \p f as a method specialized for its user type.
+ * The meta table of the user type must exist when the value is pushed.
+ * \see \ref src/lua/function.h "function.h"
+ */
+template<auto f> inline constexpr method_t<f> method = {};
+
+/** Pushes the thunk for \p f with the user type meta table as up value. */
+template<auto f>
+struct stack_push<method_t<f>> {
+    static int push(lua_State *L, method_t<f>) {
+        using T = typename detail::method_traits<decltype(f)>::type;
+        detail::push_method(L, detail::method_thunk<f>, metatable_name<T>);
+        return 1;
+    }
+};
+
 static_assert(detail::stack_type<function_view>);
 static_assert(detail::stack_type<function_value>);
 
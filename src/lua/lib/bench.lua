@@ -0,0 +1,134 @@
+--- Headless, deterministic whole-frame benchmarks.
+--- A scenario (any script which sets up a scene, e.g. `demos/colliders.lua`)
+--- is loaded with a fixed time step, a seeded random number generator, and the
+--- pseudo graphics back end without v-sync.  After a number of warm-up frames,
+--- frame times and the duration of each profile and collision section are
+--- recorded for a fixed number of frames and written as JSON.
+local graphics <const> = require "nngn.lib.graphics"
+local serial <const> = require "nngn.lib.serial"
+
+local DEFAULTS <const> = {
+    frames = 600,
+    warmup = 60,
+    dt_ms = 1000 / 60,
+    seed = 0,
+    parallel = false,
+    threads = 0,
+}
+
+local function setup(opts)
+    local t <const> = nngn:timing()
+    t:set_now_ns(0)
+    t:set_fixed_dt_ns(math.floor(opts.dt_ms * 1e6))
+    nngn:math():seed_rand(opts.seed)
+    graphics.init{graphics.PSEUDOGRAPH}
+    nngn:graphics():set_swap_interval(0)
+    Stats.set_active(Profile.STATS_IDX, true)
+    Stats.set_active(Colliders.STATS_IDX, true)
+    if opts.parallel then assert(nngn:set_parallel(true)) end
+    assert(nngn:jobs():set_threads(opts.threads))
+end
+
+--- Accumulates the duration of each collision section.
+--- Sections are only counted when their timestamps change, i.e. when the
+--- compute back end executed them in the previous frame.
+local function collision_stats()
+    local names <const> = Colliders.stats_names()
+    local n <const> = Colliders.STATS_N_EVENTS
+    local ret <const>, last <const> = {}, {}
+    local function reset()
+        for i = 1, #names do ret[i] = {count = 0, sum = 0, max = 0} end
+    end
+    local function update()
+        local v <const> = Colliders.stats()
+        for i, x in ipairs(ret) do
+            local b <const> = n * (i - 1)
+            local queued <const>, start <const>, end_ <const> =
+                v[b + 1], v[b + n - 1], v[b + n]
+            if queued ~= last[i] and start < end_ then
+                last[i] = queued
+                local d <const> = (end_ - start) / 1e6
+                x.count = x.count + 1
+                x.sum = x.sum + d
+                x.max = math.max(x.max, d)
+            end
+        end
+    end
+    local function dump()
+        local t <const> = {}
+        for i, x in ipairs(ret) do
+            if x.count ~= 0 then
+                t[names[i]] = {
+                    count = x.count,
+                    mean = x.sum / x.count,
+                    max = x.max,
+                }
+            end
+        end
+        return t
+    end
+    reset()
+    return {reset = reset, update = update, dump = dump}
+end
+
+local function result(opts, coll)
+    local fps <const> = nngn:fps()
+    local frame <const> = fps:percentiles()
+    local profile <const> = {}
+    local names <const> = Profile.stats_names()
+    for i, x in ipairs(fps:profile_percentiles()) do
+        if x.count ~= 0 then profile[names[i]] = x end
+    end
+    return {
+        scenario = opts[1],
+        frames = opts.frames,
+        warmup = opts.warmup,
+        dt_ms = opts.dt_ms,
+        seed = opts.seed,
+        parallel = opts.parallel,
+        threads = opts.threads,
+        total_ms = frame.mean * frame.count,
+        frame = frame,
+        profile = profile,
+        collision = coll.dump(),
+    }
+end
+
+local function write(opts, t)
+    local s <const> = serial.json(t) .. "\n"
+    if not opts.output then
+        return io.write(s)
+    end
+    local f <close> = assert(io.open(opts.output, "w"))
+    assert(f:write(s))
+end
+
+--- Loads and runs a scenario.
+--- \param opts
+---     `{scenario, frames = n, warmup = n, dt_ms = x, seed = n,
+---     parallel = bool, threads = n, output = path}`.
+---     Results are written to standard output if `output` is not set.
+local function run(opts)
+    opts = setmetatable(opts or {}, {__index = DEFAULTS})
+    local scenario <const> = assert(opts[1], "no scenario")
+    setup(opts)
+    dofile(scenario)
+    if demo_start then nngn:schedule():next(0, demo_start) end
+    local coll <const> = collision_stats()
+    local s <const> = nngn:schedule()
+    local f0 <const> = nngn:timing():frame() + opts.warmup
+    s:next(Schedule.HEARTBEAT, coll.update)
+    s:frame(0, f0, function()
+        nngn:fps():reset_hist()
+        coll.reset()
+    end)
+    s:frame(0, f0 + opts.frames, function()
+        write(opts, result(opts, coll))
+        nngn:exit()
+    end)
+end
+
+return {
+    DEFAULTS = DEFAULTS,
+    run = run,
+}
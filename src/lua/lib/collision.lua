@@ -2,7 +2,7 @@ local camera <const> = require "nngn.lib.camera"
 
 local function default_backends()
     local t = {
-        {CollisionBackend.native, {}}}
+        {CollisionBackend.native, {nngn:jobs()}}}
     if nngn:compute() then
         table.insert(t, 1, {CollisionBackend.compute, {nngn:compute()}})
     end
@@ -3,13 +3,21 @@ local tools <const> = require "nngn.lib.tools"
 
 local ps = {}
 local task
+local binary = true
 
 local function write(f, prefix, ...)
     for _, x in ipairs{...} do f:write(prefix, x, "\n") end
 end
 
 local function write_names(f, ...) write(f, "g l ", ...) end
-local function write_data(f, ...) write(f, "d l ", ...) end
+
+local function write_data(f, ...)
+    if binary then
+        Stats.write_samples(f, ...)
+    else
+        write(f, "d l ", ...)
+    end
+end
 
 local FS = {
     fps = {
@@ -22,6 +30,27 @@ local FS = {
             write_data(f, d.last_dt, d.avg, d.sec_count, d.sec_last)
         end,
     },
+    frame_time = {
+        function(f)
+            f:write("s 5\n")
+            write_names(f, "p50", "p90", "p99", "p999", "max")
+        end,
+        function(f)
+            local p <const> = nngn:fps():percentiles()
+            write_data(f, p.p50, p.p90, p.p99, p.p999, p.max)
+        end,
+    },
+    profile_p99 = {
+        function(f)
+            f:write("s 4\n")
+            write_names(f, table.unpack(Profile.stats_names()))
+        end,
+        function(f)
+            local t <const> = nngn:fps():profile_percentiles()
+            for i, x in ipairs(t) do t[i] = x.p99 end
+            write_data(f, table.unpack(t))
+        end,
+    },
     lua = {
         function(f)
             f:write("s 4\n")
@@ -51,6 +80,26 @@ local FS = {
                 table.unpack(t))
         end,
     },
+    mem = {
+        function(f)
+            f:write("s 3\n")
+            for i = 0, Memory.N_TAGS - 1 do
+                local name <const> = Memory.name(i)
+                write_names(f,
+                    name .. "_kb", name .. "_peak_kb", name .. "_frame_allocs")
+            end
+        end,
+        function(f)
+            local t <const> = {}
+            for i = 0, Memory.N_TAGS - 1 do
+                local m <const> = Memory.info(i)
+                table.insert(t, m.bytes / 0x1p10)
+                table.insert(t, m.peak / 0x1p10)
+                table.insert(t, m.frame_allocs)
+            end
+            write_data(f, table.unpack(t))
+        end,
+    },
     render = {
         function(f)
             f:write("s 4\n")
@@ -171,4 +220,6 @@ return {
     eval = eval,
     write_names = write_names,
     write_data = write_data,
+    binary = function() return binary end,
+    set_binary = function(b) binary = b end,
 }
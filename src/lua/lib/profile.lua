@@ -28,6 +28,23 @@ local function dump_text(c)
     end
 end
 
+local function write_percentiles(name, len, t)
+    io.write(name, string.rep(" ", len - string.len(name) + 1))
+    for _, k in ipairs{"p50", "p90", "p99", "p999", "max"} do
+        io.write(" ", k, ": ", utils.fmt_time(t[k] * 1e6))
+    end
+    io.write(" n: ", t.count, "\n")
+end
+
+local function dump_percentiles(c)
+    local fps <const> = nngn:fps()
+    local names, hists = c.stats_names(), fps:profile_percentiles()
+    local len = string.len("frame")
+    for _, v in ipairs(names) do len = math.max(len, string.len(v)) end
+    write_percentiles("frame", len, fps:percentiles())
+    for i = 1, #names do write_percentiles(names[i], len, hists[i]) end
+end
+
 local function dump_tui(c, max)
     local names, values, n_events = c.stats_names(), c.stats(), c.STATS_N_EVENTS
     local n = #names
@@ -42,5 +59,6 @@ return {
     active = active,
     activate = activate,
     dump_text = dump_text,
+    dump_percentiles = dump_percentiles,
     dump_tui = dump_tui,
 }
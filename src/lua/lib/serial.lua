@@ -75,6 +75,66 @@ function serialize_key(o)
     return string.format("[%s]", serialize(o))
 end
 
+local json_table
+
+--- Returns a JSON representation of \p o.
+--- Sequences (including empty tables) are written as arrays and other tables
+--- as objects with their keys sorted, so that the output is stable.
+local function json(o, indent, level)
+    local t <const> = type(o)
+    if t == "nil" then
+        return "null"
+    elseif t == "boolean" then
+        return tostring(o)
+    elseif t == "string" then
+        return '"' .. string.gsub(o, '[%c"\\]', function(c)
+            return string.format("\\u%04x", string.byte(c))
+        end) .. '"'
+    elseif t == "number" then
+        if math.type(o) == "integer" then
+            return tostring(o)
+        elseif o ~= o or o == math.huge or o == -math.huge then
+            return "null"
+        end
+        return string.format("%.14g", o)
+    elseif t == "table" then
+        return json_table(o, indent, level)
+    else
+        error("cannot serialize a " .. t)
+    end
+end
+
+function json_table(o, indent, level)
+    local n <const> = #o
+    local keys <const> = {}
+    if n == 0 then
+        for k in pairs(o) do
+            if type(k) ~= "string" then
+                error("invalid JSON key: " .. tostring(k))
+            end
+            table.insert(keys, k)
+        end
+        table.sort(keys)
+    end
+    if n == 0 and #keys == 0 then
+        return "[]"
+    end
+    local pre0 <const> = string.rep(" ", indent * level)
+    local pre1 <const> = string.rep(" ", indent * (level + 1))
+    local ret <const> = {}
+    for i = 1, n do
+        table.insert(ret, pre1 .. json(o[i], indent, level + 1))
+    end
+    for _, k in ipairs(keys) do
+        table.insert(ret, string.format(
+            "%s%s: %s", pre1, json(k), json(o[k], indent, level + 1)))
+    end
+    local open <const>, close <const> = "{", "}"
+    if n ~= 0 then open, close = "[", "]" end
+    return open .. "\n" .. table.concat(ret, ",\n") .. "\n" .. pre0 .. close
+end
+
 return {
     serialize = function(o, indent) return serialize(o, indent or 4, 0) end,
+    json = function(o, indent) return json(o, indent or 4, 0) end,
 }
@@ -2,6 +2,7 @@ local tools <const> = require "nngn.lib.tools"
 
 local ps = {}
 local task
+local binary = true
 
 local function write(p, prefix, v)
     p:write(prefix)
@@ -32,11 +33,23 @@ local FS = {
     },
     profile = {
         function(p) write(p, "g", Profile.stats_names()) end,
-        function(p) write(p, "d", Profile.stats_as_timeline()) end,
+        function(p)
+            if binary then
+                Profile.write_stats(p)
+            else
+                write(p, "d", Profile.stats_as_timeline())
+            end
+        end,
     },
     collision = {
         function(p) write(p, "g", Colliders.stats_names()) end,
-        function(p) write(p, "d", Colliders.stats()) end,
+        function(p)
+            if binary then
+                Colliders.write_stats(p)
+            else
+                write(p, "d", Colliders.stats())
+            end
+        end,
     },
 }
 
@@ -59,4 +72,6 @@ return {
     FS = FS,
     timeline = timeline,
     named = function(name) return timeline(FS[name]) end,
+    binary = function() return binary end,
+    set_binary = function(b) binary = b end,
 }
@@ -52,3 +52,19 @@ print(fmt(
 print(fmt(
     "- gravity", Collider.SIZEOF_GRAVITY,
     nngn:colliders():n_gravity(), max_colliders))
+print("accounted:")
+for i = 0, Memory.N_TAGS - 1 do
+    local m <const> = Memory.info(i)
+    print(string.format(
+        "- %s: %s (peak %s), %d allocations, %d/%s last frame",
+        Memory.name(i),
+        utils.fmt_size(m.bytes), utils.fmt_size(m.peak), m.n,
+        m.frame_allocs, utils.fmt_size(m.frame_bytes)))
+end
+if AllocCounter.ENABLED then
+    print(string.format(
+        "global: %d allocations, %d/%s last frame",
+        AllocCounter.total(),
+        AllocCounter.frame_allocs(),
+        utils.fmt_size(AllocCounter.frame_bytes())))
+end
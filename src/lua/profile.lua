@@ -13,5 +13,6 @@ end
 
 return setmetatable({
     dump_text = wrap(profile.dump_text),
+    dump_percentiles = wrap(profile.dump_percentiles),
     dump_tui = wrap(profile.dump_tui),
 }, {__index = profile})
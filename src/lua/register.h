@@ -83,6 +83,9 @@
  * - `c_fn` is a Lua function implemented as a `lua_CFunction`.  No special
  *   treatment of arguments or return values is done.
  *
+ * Methods which are called frequently can instead be registered with \ref
+ * nngn::lua::method, see \ref src/lua/function.h "function.h".
+ *
  * Note that these macros declare members of the \ref nngn::lua namespace, so
  * they should appear in the global namespace.  They do not affect the name
  * resolution of `T` itself, it will be resolved as if it had been used just
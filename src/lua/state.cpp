@@ -39,9 +39,11 @@ namespace nngn::lua {
 bool state_view::init(alloc_info *i) {
     NNGN_LOG_CONTEXT_CF(lua::state_view);
     this->destroy();
-    if constexpr(Platform::lua_use_alloc)
-        this->L = i ? lua_newstate(alloc_info::lua_alloc, i) : luaL_newstate();
-    else {
+    if constexpr(Platform::lua_use_alloc) {
+        constexpr auto f = Platform::lua_use_pool
+            ? alloc_info::lua_alloc_pool : alloc_info::lua_alloc;
+        this->L = i ? lua_newstate(f, i) : luaL_newstate();
+    } else {
         if(i)
             Log::l() << "compiled without custom Lua allocator,"
                 " ignoring `alloc_info` parameter\n";
@@ -89,6 +89,12 @@ public:
      *     by \ref push.
      */
     static get_type from_light(const void *p);
+    /**
+     * Retrieves a user data of type \p T from the stack without verifying its
+     * type.  The caller must ensure the value is a user data of type \p T.
+     * \see nngn::lua::method
+     */
+    static get_type get_unchecked(state_view lua, int i);
     /** Verifies that the value on the stack is a user data of type \p T. */
     static bool check_type(state_view lua, int i);
     /** Pushes the type's meta table onto the stack. */
@@ -155,6 +161,11 @@ auto user_data<T>::get(state_view lua, int i) -> get_type {
     return user_data::get_pointer(lua, i);
 }
 
+template<typename T>
+auto user_data<T>::get_unchecked(state_view lua, int i) -> get_type {
+    return user_data::get_pointer(lua, i);
+}
+
 template<typename T>
 auto user_data<T>::from_light(const void *p) -> get_type {
     return p ? static_cast<const user_data*>(p)->get() : nullptr;
@@ -19,6 +19,9 @@ NNGN_LUA_DECLARE_USER_TYPE(nngn::Collider, "Collider")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Light, "Light")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Renderer, "Renderer")
 
+using bvec = nngn::lua_vector<std::byte>;
+using Component = Entities::Component;
+
 namespace {
 
 template<float Entity::*p>
@@ -124,20 +127,70 @@ void entities_set_pos(Entities &es, const nngn::lua_vector<std::byte> &v) {
     }
 }
 
+auto component_size(Component c) {
+    return nngn::narrow<lua_Integer>(Entities::component_size(c));
+}
+
+auto bulk_stride(Component c, std::optional<lua_Integer> stride) {
+    return stride
+        ? nngn::narrow<std::size_t>(*stride)
+        : Entities::component_size(c);
+}
+
+auto idx_span(const bvec &idx) {
+    return nngn::byte_cast<const std::uint32_t>(std::span{idx});
+}
+
+bool entities_read(
+    const Entities &es, Component c, bvec *v,
+    lua_Integer first, lua_Integer n, std::optional<lua_Integer> stride
+) {
+    return es.read(
+        c, nngn::narrow<std::size_t>(first), nngn::narrow<std::size_t>(n),
+        bulk_stride(c, stride), nngn::byte_cast<float>(std::span{*v}));
+}
+
+bool entities_read_idx(
+    const Entities &es, Component c, bvec *v, const bvec &idx,
+    std::optional<lua_Integer> stride
+) {
+    return es.read(
+        c, idx_span(idx), bulk_stride(c, stride),
+        nngn::byte_cast<float>(std::span{*v}));
+}
+
+bool entities_write(
+    Entities &es, Component c, const bvec &v,
+    lua_Integer first, lua_Integer n, std::optional<lua_Integer> stride
+) {
+    return es.write(
+        c, nngn::narrow<std::size_t>(first), nngn::narrow<std::size_t>(n),
+        bulk_stride(c, stride), nngn::byte_cast<const float>(std::span{v}));
+}
+
+bool entities_write_idx(
+    Entities &es, Component c, const bvec &v, const bvec &idx,
+    std::optional<lua_Integer> stride
+) {
+    return es.write(
+        c, idx_span(idx), bulk_stride(c, stride),
+        nngn::byte_cast<const float>(std::span{v}));
+}
+
 void register_entity(nngn::lua::table_view t) {
     t["SIZEOF"] = nngn::narrow<lua_Integer>(sizeof(Entity));
-    t["pos"] = get<&Entity::p>;
-    t["vel"] = get<&Entity::v>;
-    t["acc"] = get<&Entity::a>;
+    t["pos"] = nngn::lua::method<get<&Entity::p>>;
+    t["vel"] = nngn::lua::method<get<&Entity::v>>;
+    t["acc"] = nngn::lua::method<get<&Entity::a>>;
     t["max_vel"] = get<&Entity::max_v>;
     t["renderer"] = [](const Entity &e) { return e.renderer; };
     t["collider"] = [](const Entity &e) { return e.collider; };
     t["animation"] = [](const Entity &e) { return e.anim; };
     t["light"] = nngn::lua::value_accessor<&Entity::light>;
     t["parent"] = nngn::lua::value_accessor<&Entity::parent>;
-    t["set_pos"] = set_pos;
-    t["set_vel"] = set_vel;
-    t["set_acc"] = set_acc;
+    t["set_pos"] = nngn::lua::method<set_pos>;
+    t["set_vel"] = nngn::lua::method<set_vel>;
+    t["set_acc"] = nngn::lua::method<set_acc>;
     t["set_max_vel"] = [](Entity &e, float v) { e.max_v = v; };
     t["set_renderer"] = &Entity::set_renderer;
     t["set_collider"] = &Entity::set_collider;
@@ -148,6 +201,13 @@ void register_entity(nngn::lua::table_view t) {
 }
 
 void register_entities(nngn::lua::table_view t) {
+    t["POS"] = Component::POS;
+    t["VEL"] = Component::VEL;
+    t["ACC"] = Component::ACC;
+    t["MAX_VEL"] = Component::MAX_VEL;
+    t["RENDERER_Z_OFF"] = Component::RENDERER_Z_OFF;
+    t["LIGHT_COLOR"] = Component::LIGHT_COLOR;
+    t["component_size"] = component_size;
     t["max"] = entities_max;
     t["n"] = entities_n;
     t["set_max"] = entities_set_max;
@@ -164,6 +224,10 @@ void register_entities(nngn::lua::table_view t) {
     t["set_pos2"] = entities_set_pos<2>;
     t["set_pos3"] = entities_set_pos<3>;
     t["set_pos4"] = entities_set_pos<4>;
+    t["read"] = entities_read;
+    t["read_idx"] = entities_read_idx;
+    t["write"] = entities_write;
+    t["write_idx"] = entities_write_idx;
 }
 
 }
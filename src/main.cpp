@@ -21,18 +21,23 @@
  *   A failure exit code is returned.
  */
 #include <algorithm>
+#include <array>
 
 #include "entity.h"
 
 #include "audio/audio.h"
+#include "audio/mixer.h"
 #include "collision/collision.h"
 #include "compute/compute.h"
 #include "font/font.h"
 #include "font/textbox.h"
 #include "graphics/graphics.h"
 #include "graphics/texture.h"
+#include "graphics/texture_atlas.h"
 #include "input/input.h"
 #include "input/mouse.h"
+#include "input/recorder.h"
+#include "jobs/jobs.h"
 #include "lua/alloc.h"
 #include "lua/function.h"
 #include "lua/iter.h"
@@ -42,15 +47,20 @@
 #include "math/math.h"
 #include "os/platform.h"
 #include "os/socket.h"
+#include "os/worker.h"
 #include "render/animation.h"
 #include "render/grid.h"
 #include "render/light.h"
 #include "render/map.h"
 #include "render/render.h"
+#include "render/snapshot.h"
 #include "timing/fps.h"
 #include "timing/profile.h"
 #include "timing/schedule.h"
+#include "timing/timestep.h"
 #include "timing/timing.h"
+#include "utils/alloc/accounting.h"
+#include "utils/alloc/counter.h"
 #include "utils/flags.h"
 #include "utils/log.h"
 #include "utils/scoped.h"
@@ -58,7 +68,9 @@
 NNGN_LUA_DECLARE_USER_TYPE(Entities, "Entities")
 NNGN_LUA_DECLARE_USER_TYPE(Entity, "Entity")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Math, "Math")
+NNGN_LUA_DECLARE_USER_TYPE(nngn::Jobs, "Jobs")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Timing, "Timing")
+NNGN_LUA_DECLARE_USER_TYPE(nngn::FixedTimestep, "FixedTimestep")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Schedule, "Schedule")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Compute, "Compute")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Graphics, "Graphics")
@@ -72,11 +84,14 @@ NNGN_LUA_DECLARE_USER_TYPE(nngn::Grid, "Grid")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Textbox, "Textbox")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Camera, "Camera")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::MouseInput, "MouseInput")
+NNGN_LUA_DECLARE_USER_TYPE(nngn::Recorder, "Recorder")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Renderers, "Renderers")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Animations, "Animations")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Colliders, "Colliders")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Audio, "Audio")
+NNGN_LUA_DECLARE_USER_TYPE(nngn::Mixer, "Mixer")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Textures, "Textures")
+NNGN_LUA_DECLARE_USER_TYPE(nngn::TextureAtlas, "TextureAtlas")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Lighting, "Lighting")
 NNGN_LUA_DECLARE_USER_TYPE(nngn::Map, "Map")
 
@@ -89,17 +104,21 @@ struct NNGN {
     struct Input {
         nngn::Input input;
         nngn::MouseInput mouse;
+        nngn::Recorder recorder;
         struct {
             nngn::Input::Source *graphics = {};
         } sources;
     };
     nngn::Flags<Flag> flags = {};
     nngn::Math math = {};
+    nngn::Jobs jobs = {};
     nngn::Timing timing = {};
+    nngn::FixedTimestep timestep = {};
     nngn::Schedule schedule = {};
     std::unique_ptr<nngn::Compute> compute = {};
     std::unique_ptr<nngn::Graphics> graphics = {};
     nngn::FPS fps = {};
+    std::array<char, 64> fps_str = {};
     nngn::Socket socket = {};
     nngn::lua::state lua = {};
     nngn::lua::alloc_info lua_alloc = {};
@@ -113,12 +132,25 @@ struct NNGN {
     nngn::Colliders colliders = {};
     Entities entities = {};
     nngn::Audio audio = {};
+    nngn::Mixer mixer = {};
     nngn::Textures textures = {};
+    nngn::TextureAtlas texture_atlas = {};
     nngn::Lighting lighting = {};
     nngn::Map map = {};
+    nngn::Worker sim_worker = {};
+    nngn::RenderSnapshot render_snapshot = {};
     bool init(int argc, const char *const *argv);
     bool set_compute(nngn::Compute::Backend b, const void *params);
     bool set_graphics(nngn::Graphics::Backend b, const void *params);
+    bool parallel(void) const { return this->sim_worker.running(); }
+    bool set_parallel(bool p);
+    void set_render_state(nngn::Graphics *g);
+    bool simulate(const nngn::Timing &t);
+    bool post_step(void);
+    bool step(const nngn::Timing &t);
+    bool update_render(void);
+    bool frame_serial(void);
+    bool frame_parallel(void);
     int loop(void);
     void remove_entity(Entity *e);
     void exit(void) { this->flags |= Flag::EXIT; }
@@ -137,6 +169,8 @@ bool NNGN::init(int argc, const char *const *argv) {
     if(!nngn::Platform::init(argc, argv))
         return false;
     nngn::Profile::init();
+    nngn::Trace::set_thread_name("main");
+    this->entities.set_jobs(&this->jobs);
     if(!this->lua.init(&this->lua_alloc))
         return false;
     nngn::lua::static_register::register_all(this->lua);
@@ -155,6 +189,9 @@ bool NNGN::init(int argc, const char *const *argv) {
     this->schedule.init(&this->timing);
     this->input.input.init(this->lua);
     this->input.mouse.init(this->lua);
+    this->input.input.set_recorder(&this->input.recorder);
+    this->input.mouse.set_recorder(&this->input.recorder);
+    this->input.recorder.init(&this->timing);
     if(!this->fonts.init())
         return false;
     this->renderers.init(
@@ -166,6 +203,7 @@ bool NNGN::init(int argc, const char *const *argv) {
         return false;
     this->lighting.init(&this->math);
     this->map.init(&this->textures);
+    this->texture_atlas.set_textures(&this->textures);
     if(!(argc < 2
         ? this->lua.dofile("src/lua/all.lua")
         : std::all_of(
@@ -180,7 +218,8 @@ bool NNGN::init(int argc, const char *const *argv) {
     if(!this->graphics)
         this->set_graphics(nngn::Graphics::Backend::PSEUDOGRAPH, {});
     if(!this->colliders.has_backend())
-        this->colliders.set_backend(nngn::Colliders::native_backend());
+        this->colliders.set_backend(
+            nngn::Colliders::native_backend(&this->jobs));
     return true;
 }
 
@@ -220,56 +259,181 @@ bool NNGN::set_graphics(nngn::Graphics::Backend b, const void *params) {
     g->set_size_callback(
         &this->camera, [](void *p, auto s)
             { static_cast<nngn::Camera*>(p)->set_screen(s); });
+    this->camera.set_screen(g->window_size());
+    this->set_render_state(g.get());
+    this->graphics = std::move(g);
+    return ret;
+}
+
+bool NNGN::set_parallel(bool p) {
+    NNGN_LOG_CONTEXT_CF(NNGN);
+    if(p == this->parallel())
+        return true;
+    if(!p)
+        this->sim_worker.stop();
+    else if(!this->sim_worker.start("simulation"))
+        return false;
+    if(auto *const g = this->graphics.get())
+        this->set_render_state(g);
+    return true;
+}
+
+void NNGN::set_render_state(nngn::Graphics *g) {
+    if(this->parallel()) {
+        auto &s = this->render_snapshot;
+        s.update(this->camera, this->lighting);
+        g->set_camera(s.camera());
+        g->set_lighting(s.lighting());
+        return;
+    }
     g->set_camera({
         &this->camera.flags.v, &this->camera.screen,
         &this->camera.proj, &this->camera.screen_proj, &this->camera.view});
-    this->camera.set_screen(g->window_size());
     g->set_lighting({
         &this->lighting.ubo(),
         &this->lighting.dir_proj(), &this->lighting.point_proj(),
         &this->lighting.dir_view(0), &this->lighting.point_view(0, 0)});
-    this->graphics = std::move(g);
-    return ret;
 }
 
-int NNGN::loop(void) {
-    if(this->flags.is_set(Flag::ERROR))
-        return 1;
-    if(this->flags.is_set(Flag::EXIT) || this->graphics->window_closed())
-        return 0;
-    this->timing.update();
-    const bool ok = this->input.input.update()
-        && this->schedule.update()
-        && this->socket.process([&l = this->lua](auto s) { l.dostring(s); });
-    if(!ok)
-        return 1;
-    this->entities.update(this->timing);
-    this->animations.update(this->timing);
-    if(!this->colliders.check_collisions(this->timing))
-        return 1;
+/** Part of a simulation step which does not require the Lua state. */
+bool NNGN::simulate(const nngn::Timing &t) {
+    this->entities.update(t);
+    this->animations.update(t);
+    if(!this->colliders.check_collisions(t))
+        return false;
     this->colliders.resolve_collisions();
+    return true;
+}
+
+bool NNGN::post_step(void) {
     if(!this->colliders.lua_on_collision(this->lua))
-        return 1;
+        return false;
     this->entities.update_children();
+    return true;
+}
+
+bool NNGN::step(const nngn::Timing &t) {
+    return this->simulate(t) && this->post_step();
+}
+
+/** Processes state changes and sends new rendering data to the back end. */
+bool NNGN::update_render(void) {
     if(this->camera.flags & nngn::Camera::Flag::SCREEN_UPDATED)
         this->textbox.set_screen_updated();
-    if(this->camera.update(this->timing)) {
-        this->graphics->set_camera_updated();
+    const bool camera_updated = this->camera.update(this->timing);
+    if(camera_updated)
         this->lighting.update_view(this->camera.p);
-    }
     if(this->textbox.update(this->timing))
         this->textbox.update_size(this->camera.screen);
-    if(!this->renderers.update())
-        return 1;
-    this->entities.clear_flags();
+    if(!this->textures.update() || !this->texture_atlas.update()
+            || !this->renderers.update() || !this->fonts.update())
+        return false;
     this->textbox.clear_updated();
-    if(this->lighting.update(this->timing))
+    const bool lighting_updated = this->lighting.update(this->timing);
+    if(this->parallel())
+        this->render_snapshot.update(this->camera, this->lighting);
+    if(camera_updated)
+        this->graphics->set_camera_updated();
+    if(lighting_updated)
         this->graphics->set_lighting_updated();
-    if(!this->graphics->render() || !this->graphics->vsync())
+    return true;
+}
+
+bool NNGN::frame_serial(void) {
+    const auto fixed = this->timestep.enabled();
+    const auto tick = this->timestep.tick(this->timing);
+    for(auto n = this->timestep.update(this->timing.dt); n; --n) {
+        if(fixed)
+            this->entities.save_positions();
+        if(!this->step(tick))
+            return false;
+    }
+    if(fixed)
+        this->entities.interpolate(this->timestep.alpha());
+    else
+        this->entities.stop_interpolation();
+    if(!this->update_render())
+        return false;
+    this->entities.clear_flags();
+    return this->graphics->render() && this->graphics->vsync();
+}
+
+/**
+ * Renders the current state while the next one is simulated.
+ * Rendering data are generated from the state left by the previous frame,
+ * after which the first simulation step is executed in the worker thread
+ * concurrently with \ref Graphics::render and \ref Graphics::vsync.  Only the
+ * graphics back end and \ref render_snapshot are accessed by the main thread
+ * during that time.  Everything which requires the Lua state (collision
+ * callbacks) and any additional steps are executed after both are finished.
+ */
+bool NNGN::frame_parallel(void) {
+    if(!this->update_render())
+        return false;
+    const auto fixed = this->timestep.enabled();
+    const auto tick = this->timestep.tick(this->timing);
+    auto n = this->timestep.update(this->timing.dt);
+    if(n)
+        this->sim_worker.submit([this, &tick] {
+            NNGN_TRACE_ZONE("simulation");
+            if(this->timestep.enabled())
+                this->entities.save_positions();
+            return this->simulate(tick);
+        });
+    const bool ok = this->graphics->render() && this->graphics->vsync();
+    {
+        NNGN_TRACE_ZONE("simulation_wait");
+        if(!this->sim_worker.wait() || !ok)
+            return false;
+    }
+    if(n) {
+        if(!this->post_step())
+            return false;
+        for(--n; n; --n) {
+            if(fixed)
+                this->entities.save_positions();
+            if(!this->step(tick))
+                return false;
+        }
+    }
+    if(fixed)
+        this->entities.interpolate(this->timestep.alpha());
+    else
+        this->entities.stop_interpolation();
+    this->entities.clear_flags();
+    return true;
+}
+
+int NNGN::loop(void) {
+    if(this->flags.is_set(Flag::ERROR))
+        return 1;
+    if(this->flags.is_set(Flag::EXIT) || this->graphics->window_closed())
+        return 0;
+    nngn::Trace::frame();
+    NNGN_TRACE_ZONE("loop");
+    this->timing.update();
+    auto &i = this->input;
+    const auto dostring = [&l = this->lua](auto s) { l.dostring(s); };
+    if(!i.recorder.frame() || !i.input.update())
+        return 1;
+    i.recorder.dispatch(&i.input, &i.mouse);
+    const bool ok = this->schedule.update()
+        && this->socket.process([&r = i.recorder, &dostring](auto s) {
+            if(r.socket(s))
+                dostring(s);
+        });
+    if(!ok)
+        return 1;
+    i.recorder.dispatch_socket(dostring);
+    if(!(this->parallel() ? this->frame_parallel() : this->frame_serial()))
         return 1;
+    this->fps.profile(nngn::Profile::stats);
     nngn::Profile::swap();
+    nngn::memory_accounting::frame();
+    nngn::alloc_counter::frame();
     this->fps.frame(nngn::Timing::clock::now());
-    this->graphics->set_window_title(this->fps.to_string().c_str());
+    if(!this->fps.sec_count)
+        this->graphics->set_window_title(this->fps.to_string(this->fps_str));
     return -1;
 }
 
@@ -289,7 +453,9 @@ void NNGN::remove_entity(Entity *e) {
 void register_nngn(nngn::lua::table &&t) {
     using nngn::lua::accessor;
     t["math"] = accessor<&NNGN::math>;
+    t["jobs"] = accessor<&NNGN::jobs>;
     t["timing"] = accessor<&NNGN::timing>;
+    t["timestep"] = accessor<&NNGN::timestep>;
     t["schedule"] = accessor<&NNGN::schedule>;
     t["compute"] = [](const NNGN &nngn) { return nngn.compute.get(); };
     t["graphics"] = [](NNGN &nngn) { return nngn.graphics.get(); };
@@ -298,6 +464,7 @@ void register_nngn(nngn::lua::table &&t) {
     t["lua"] = accessor<&NNGN::lua>;
     t["input"] = [](NNGN &nngn) { return &nngn.input.input; };
     t["mouse_input"] = [](NNGN &nngn) { return &nngn.input.mouse; };
+    t["recorder"] = [](NNGN &nngn) { return &nngn.input.recorder; };
     t["fonts"] = accessor<&NNGN::fonts>;
     t["grid"] = accessor<&NNGN::grid>;
     t["textbox"] = accessor<&NNGN::textbox>;
@@ -307,11 +474,15 @@ void register_nngn(nngn::lua::table &&t) {
     t["colliders"] = accessor<&NNGN::colliders>;
     t["entities"] = accessor<&NNGN::entities>;
     t["audio"] = accessor<&NNGN::audio>;
+    t["mixer"] = accessor<&NNGN::mixer>;
     t["textures"] = accessor<&NNGN::textures>;
+    t["texture_atlas"] = accessor<&NNGN::texture_atlas>;
     t["lighting"] = accessor<&NNGN::lighting>;
     t["map"] = accessor<&NNGN::map>;
     t["set_compute"] = &NNGN::set_compute;
     t["set_graphics"] = &NNGN::set_graphics;
+    t["parallel"] = &NNGN::parallel;
+    t["set_parallel"] = &NNGN::set_parallel;
     t["remove_entity"] = &NNGN::remove_entity;
     t["remove_entities"] = [](NNGN &nngn, nngn::lua::table_view es) {
         for(auto [_, x] : ipairs(es))
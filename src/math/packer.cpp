@@ -0,0 +1,101 @@
+#include "packer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include "utils/utils.h"
+
+namespace {
+
+nngn::u32 round_up(nngn::u32 x, nngn::u32 n) { return (x + n - 1) / n * n; }
+
+}
+
+namespace nngn {
+
+void ShelfPacker::init(u32 extent, u32 r) {
+    assert(r);
+    this->m_extent = extent;
+    this->m_round = r;
+    this->m_shelves.clear();
+    this->holes.clear();
+}
+
+bool ShelfPacker::alloc(uvec2 s, u32 *shelf_p, u32 *x_p) {
+    const auto e = this->m_extent;
+    // The number of shelves/holes indicates that none was found.
+    const auto n = narrow<u32>(this->m_shelves.size());
+    auto best = n;
+    auto best_hole = this->holes.size();
+    for(u32 i = 0; i != n; ++i) {
+        const auto &sh = this->m_shelves[i];
+        if(sh.h < s.y || (best != n && this->m_shelves[best].h <= sh.h))
+            continue;
+        const auto &v = this->holes;
+        const auto it = std::ranges::find_if(v, [i, s](const auto &h)
+            { return h.shelf == i && s.x <= h.w; });
+        if(it != v.end())
+            best = i, best_hole = static_cast<std::size_t>(it - v.begin());
+        else if(s.x <= e - sh.end)
+            best = i, best_hole = v.size();
+    }
+    if(best != n) {
+        *shelf_p = best;
+        if(best_hole != this->holes.size()) {
+            auto &h = this->holes[best_hole];
+            *x_p = h.x;
+            h.x += s.x;
+            h.w -= s.x;
+            if(!h.w)
+                this->holes.erase(
+                    this->holes.begin()
+                    + static_cast<std::ptrdiff_t>(best_hole));
+        } else {
+            auto &sh = this->m_shelves[best];
+            *x_p = std::exchange(sh.end, sh.end + s.x);
+        }
+        return true;
+    }
+    const auto y = this->m_shelves.empty()
+        ? 0 : this->m_shelves.back().y + this->m_shelves.back().h;
+    if(e - y < s.y || e < s.x)
+        return false;
+    *shelf_p = narrow<u32>(this->m_shelves.size());
+    *x_p = 0;
+    this->m_shelves.push_back({
+        .y = y,
+        .h = std::min(round_up(s.y, this->m_round), e - y),
+        .end = s.x,
+    });
+    return true;
+}
+
+void ShelfPacker::release(u32 i, u32 x, u32 w) {
+    auto &v = this->holes;
+    const auto find = [&v, i](auto &&f) {
+        return std::ranges::find_if(v, [i, &f](const auto &h)
+            { return h.shelf == i && f(h); });
+    };
+    if(const auto l = find([x](const auto &h) { return h.x + h.w == x; });
+            l != v.end()) {
+        x = l->x;
+        w += l->w;
+        v.erase(l);
+    }
+    auto &sh = this->m_shelves[i];
+    const auto e = x + w;
+    if(e == sh.end)
+        sh.end = x;
+    else if(const auto r = find([e](const auto &h) { return h.x == e; });
+            r != v.end())
+        r->x = x, r->w += w;
+    else
+        v.push_back({.shelf = i, .x = x, .w = w});
+    // Trailing empty shelves are removed so that their space can be used by
+    // shelves of a different height.
+    while(!this->m_shelves.empty() && !this->m_shelves.back().end)
+        this->m_shelves.pop_back();
+}
+
+}
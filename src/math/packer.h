@@ -0,0 +1,58 @@
+#ifndef NNGN_MATH_PACKER_H
+#define NNGN_MATH_PACKER_H
+
+#include <span>
+#include <vector>
+
+#include "utils/def.h"
+
+#include "vec2.h"
+
+namespace nngn {
+
+/**
+ * Allocates rectangles inside a square area.
+ *
+ * Space is allocated in shelves: horizontal strips whose height is that of
+ * the first rectangle placed in them, rounded up to a multiple of \ref round.
+ * Rectangles go to the lowest shelf which can hold them, a new one is opened
+ * below the last when none can.  Space released in a shelf is reused by
+ * rectangles of equal or smaller width.
+ */
+class ShelfPacker {
+public:
+    struct shelf {
+        u32 y, h;
+        /** Start of the unused space at the end of the shelf. */
+        u32 end;
+    };
+    ShelfPacker(void) = default;
+    explicit ShelfPacker(u32 extent, u32 round = 1)
+        { this->init(extent, round); }
+    /** Releases all rectangles and resizes the area. */
+    void init(u32 extent, u32 round = 1);
+    u32 extent(void) const { return this->m_extent; }
+    /** Granularity of shelf heights. */
+    u32 round(void) const { return this->m_round; }
+    std::span<const shelf> shelves(void) const { return this->m_shelves; }
+    bool empty(void) const { return this->m_shelves.empty(); }
+    /**
+     * Reserves a region of size \p s.
+     * \param shelf_idx Index of the shelf which contains the region.
+     * \param x Horizontal position of the region in the shelf.
+     * \return \c false if there is not enough space.
+     */
+    bool alloc(uvec2 s, u32 *shelf_idx, u32 *x);
+    /** Releases a region, merging it with adjacent unused ones. */
+    void release(u32 shelf_idx, u32 x, u32 w);
+private:
+    /** Unused region inside a shelf. */
+    struct hole { u32 shelf, x, w; };
+    u32 m_extent = 0, m_round = 1;
+    std::vector<shelf> m_shelves = {};
+    std::vector<hole> holes = {};
+};
+
+}
+
+#endif
@@ -0,0 +1,144 @@
+#include "mapped_file.h"
+
+#include "os/platform.h"
+#include "utils/log.h"
+
+#ifndef NNGN_PLATFORM_HAS_MMAP
+
+namespace nngn {
+
+bool MappedFile::mapped(void) { return false; }
+std::size_t MappedFile::page_size(void) { return 4096; }
+
+bool MappedFile::open(std::string_view path) {
+    NNGN_LOG_CONTEXT_CF(MappedFile);
+    this->close();
+    if(!read_file(path, &this->buffer))
+        return false;
+    this->m = this->buffer;
+    return true;
+}
+
+bool MappedFile::open(FILE *f) {
+    NNGN_LOG_CONTEXT_CF(MappedFile);
+    this->close();
+    if(std::fseek(f, 0, SEEK_END) == -1)
+        return Log::perror("fseek"), false;
+    const auto n = std::ftell(f);
+    if(n == -1)
+        return Log::perror("ftell"), false;
+    this->buffer.resize(static_cast<std::size_t>(n));
+    std::rewind(f);
+    if(std::fread(this->buffer.data(), 1, this->buffer.size(), f)
+            != this->buffer.size())
+        return Log::perror("fread"), false;
+    this->m = this->buffer;
+    return true;
+}
+
+void MappedFile::close(void) {
+    this->m = {};
+    this->buffer = {};
+}
+
+void MappedFile::prefetch(std::size_t, std::size_t) const {}
+void MappedFile::release(std::size_t, std::size_t) const {}
+
+}
+
+#else
+
+#include <algorithm>
+#include <cassert>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+void advise(std::span<std::byte> s, std::size_t b, std::size_t e, int a) {
+    if(b >= e)
+        return;
+    if(madvise(s.data() + b, e - b, a) == -1)
+        nngn::Log::perror("madvise");
+}
+
+}
+
+namespace nngn {
+
+bool MappedFile::mapped(void) { return true; }
+
+std::size_t MappedFile::page_size(void) {
+    static const auto ret = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return ret;
+}
+
+bool MappedFile::open(std::string_view path) {
+    NNGN_LOG_CONTEXT_CF(MappedFile);
+    NNGN_LOG_CONTEXT(path.data());
+    const auto fd = ::open(path.data(), O_RDONLY);
+    if(fd == -1)
+        return Log::perror("open"), false;
+    const bool ret = this->open(fd);
+    if(::close(fd) == -1)
+        return Log::perror("close"), false;
+    return ret;
+}
+
+bool MappedFile::open(FILE *f) {
+    NNGN_LOG_CONTEXT_CF(MappedFile);
+    if(std::fflush(f) == EOF)
+        return Log::perror("fflush"), false;
+    const auto fd = fileno(f);
+    if(fd == -1)
+        return Log::perror("fileno"), false;
+    return this->open(fd);
+}
+
+bool MappedFile::open(int fd) {
+    this->close();
+    struct stat st = {};
+    if(fstat(fd, &st) == -1)
+        return Log::perror("fstat"), false;
+    const auto n = static_cast<std::size_t>(st.st_size);
+    if(!n)
+        return Log::l() << "empty file\n", false;
+    void *const p =
+        mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if(p == MAP_FAILED)
+        return Log::perror("mmap"), false;
+    this->m = {static_cast<std::byte*>(p), n};
+    return true;
+}
+
+void MappedFile::close(void) {
+    NNGN_LOG_CONTEXT_CF(MappedFile);
+    if(this->m.empty())
+        return;
+    if(munmap(this->m.data(), this->m.size()) == -1)
+        Log::perror("munmap");
+    this->m = {};
+}
+
+void MappedFile::prefetch(std::size_t off, std::size_t n) const {
+    NNGN_LOG_CONTEXT_CF(MappedFile);
+    const auto p = MappedFile::page_size();
+    const auto e = std::min(off + n, this->m.size());
+    advise(this->m, off / p * p, e, MADV_WILLNEED);
+}
+
+void MappedFile::release(std::size_t off, std::size_t n) const {
+    NNGN_LOG_CONTEXT_CF(MappedFile);
+    // Only pages entirely contained in the range can be released.
+    assert(off + n <= this->m.size());
+    const auto p = MappedFile::page_size();
+    const auto e = off + n == this->m.size() ? off + n : (off + n) / p * p;
+    advise(this->m, (off + p - 1) / p * p, e, MADV_DONTNEED);
+}
+
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef NNGN_OS_MAPPED_FILE_H
+#define NNGN_OS_MAPPED_FILE_H
+
+#include <cstdio>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "utils/utils.h"
+
+namespace nngn {
+
+/**
+ * Read-only view of the contents of a file, mapped into memory.
+ *
+ * Pages are loaded on demand as they are accessed and can be evicted by the
+ * system under memory pressure, so large files can be used without reading
+ * them into (and keeping them in) private memory.  The mapping is private:
+ * the buffer can be written to, but changes are not visible in the file and
+ * are discarded by \ref release.
+ *
+ * \ref prefetch and \ref release are hints which can be used to bound the
+ * amount of the file that is resident when it is accessed sequentially.
+ *
+ * On platforms without `mmap`, the file is read into an internal buffer and
+ * the hints have no effect.
+ */
+class MappedFile {
+public:
+    MappedFile(void) = default;
+    NNGN_NO_MOVE(MappedFile)
+    ~MappedFile(void) { this->close(); }
+    /** Whether the contents are actually mapped (see fallback above). */
+    static bool mapped(void);
+    static std::size_t page_size(void);
+    std::span<std::byte> data(void) const { return this->m; }
+    std::size_t size(void) const { return this->m.size(); }
+    bool open(std::string_view path);
+    /** Maps the file currently open in \p f, which can be closed later. */
+    bool open(FILE *f);
+    void close(void);
+    /** Starts loading pages in the range in the background. */
+    void prefetch(std::size_t off, std::size_t n) const;
+    /** Pages in the range will not be needed again and can be evicted. */
+    void release(std::size_t off, std::size_t n) const;
+private:
+    bool open(int fd);
+    std::span<std::byte> m = {};
+    std::vector<std::byte> buffer = {};
+};
+
+}
+
+#endif
@@ -16,6 +16,7 @@
 #ifdef __EMSCRIPTEN__
     #define NNGN_PLATFORM_EMSCRIPTEN
     #undef HAVE_TERMIOS_H
+    #undef HAVE_EXECINFO_H
     #undef NNGN_PLATFORM_HAS_SOCKETS
 #endif
 
@@ -42,6 +43,16 @@ struct Platform {
 #else
     static constexpr bool lua_use_alloc = false;
 #endif
+#ifdef NNGN_LUA_USE_POOL
+    static constexpr bool lua_use_pool = true;
+#else
+    static constexpr bool lua_use_pool = false;
+#endif
+#ifdef NNGN_ALLOC_COUNT
+    static constexpr bool alloc_count = true;
+#else
+    static constexpr bool alloc_count = false;
+#endif
 #ifdef NNGN_PLATFORM_HAS_LIBPNG
     static constexpr bool has_libpng = true;
 #else
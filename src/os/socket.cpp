@@ -162,8 +162,6 @@ bool Socket::recv(std::string *buffer) {
     case 0: return true;
     case -1: return Log::perror("poll"), false;
     }
-    constexpr auto MAX_LEN = 1024u * 1024u - 1u;
-    buffer->resize(MAX_LEN + 1);
     auto *it = std::find_if(
         begin(v), end(v), [](const auto &x) { return x.revents; });
     assert(it != end(v));
@@ -181,6 +179,8 @@ bool Socket::recv(std::string *buffer) {
         return close(&it->fd);
     }
     assert(it->revents & POLLIN);
+    constexpr auto MAX_LEN = 1024u * 1024u - 1u;
+    buffer->resize(MAX_LEN + 1);
     size_t size = 0;
     for(;;) {
         const auto n = read(it->fd, buffer->data() + size, MAX_LEN - size);
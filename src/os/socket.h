@@ -26,6 +26,8 @@ class Socket {
     int fd = -1;
     std::vector<std::byte> poll_data = {};
     std::string path = {};
+    /** Reused between calls to \ref process to avoid reallocations. */
+    std::string m_buffer = {};
     bool accept();
     bool process(std::string *buffer);
     bool recv(std::string *buffer);
@@ -42,11 +44,11 @@ public:
 
 template<typename F> bool Socket::process(F f) {
     NNGN_PROFILE_CONTEXT(socket);
-    std::string buffer;
-    if(!this->process(&buffer))
+    this->m_buffer.clear();
+    if(!this->process(&this->m_buffer))
         return false;
-    if(!buffer.empty())
-        f(std::string_view{buffer});
+    if(!this->m_buffer.empty())
+        f(std::string_view{this->m_buffer});
     return true;
 }
 
@@ -0,0 +1,69 @@
+#include <cassert>
+#include <utility>
+
+#include "timing/trace.h"
+#include "utils/log.h"
+
+#include "platform.h"
+#include "worker.h"
+
+namespace nngn {
+
+bool Worker::start(std::string name) {
+    NNGN_LOG_CONTEXT_CF(Worker);
+    if constexpr(Platform::emscripten)
+        return Log::l() << "threads are not supported\n", false;
+    if(this->running())
+        return true;
+    this->exit = false;
+    this->thread = std::thread{&Worker::run, this, std::move(name)};
+    return true;
+}
+
+void Worker::stop(void) {
+    if(!this->running())
+        return;
+    this->wait();
+    {
+        const std::lock_guard lock = std::lock_guard{this->m};
+        this->exit = true;
+    }
+    this->cv.notify_all();
+    this->thread.join();
+}
+
+void Worker::submit(job j) {
+    assert(this->running());
+    {
+        const std::lock_guard lock = std::lock_guard{this->m};
+        assert(!this->pending);
+        this->f = std::move(j);
+        this->pending = true;
+    }
+    this->cv.notify_all();
+}
+
+bool Worker::wait(void) {
+    std::unique_lock lock = std::unique_lock{this->m};
+    this->cv.wait(lock, [this] { return !this->pending; });
+    return std::exchange(this->result, true);
+}
+
+void Worker::run(std::string name) {
+    Trace::set_thread_name(name);
+    std::unique_lock lock = std::unique_lock{this->m};
+    for(;;) {
+        this->cv.wait(lock, [this] { return this->pending || this->exit; });
+        if(!this->pending)
+            return;
+        const auto j = std::move(this->f);
+        lock.unlock();
+        const bool ret = j();
+        lock.lock();
+        this->result = ret;
+        this->pending = false;
+        this->cv.notify_all();
+    }
+}
+
+}
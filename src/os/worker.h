@@ -0,0 +1,50 @@
+#ifndef NNGN_OS_WORKER_H
+#define NNGN_OS_WORKER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "utils/utils.h"
+
+namespace nngn {
+
+/**
+ * Background thread which executes one job at a time.
+ * A job is submitted with \ref submit and its result collected with \ref wait,
+ * so that the caller can perform other work in the meantime.  Only one job can
+ * be pending at any time and both functions must be called from the same
+ * thread.
+ *
+ * Threads are not available on all platforms (e.g. WASM), in which case \ref
+ * start fails and callers are expected to execute jobs directly.
+ */
+class Worker {
+public:
+    using job = std::function<bool(void)>;
+    Worker(void) = default;
+    NNGN_NO_MOVE(Worker)
+    ~Worker(void) { this->stop(); }
+    bool running(void) const { return this->thread.joinable(); }
+    /** Starts the thread, \p name is used to identify it in traces. */
+    bool start(std::string name);
+    /** Waits for the pending job, if any, and joins the thread. */
+    void stop(void);
+    /** Starts executing \p f in the background. */
+    void submit(job f);
+    /** Waits for the pending job and returns its result (`true` if none). */
+    bool wait(void);
+private:
+    void run(std::string name);
+    std::thread thread = {};
+    std::mutex m = {};
+    std::condition_variable cv = {};
+    job f = {};
+    bool pending = false, exit = false, result = true;
+};
+
+}
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef NNGN_RENDER_GEN_H
 #define NNGN_RENDER_GEN_H
 
+#include <span>
+
 #include "collision/colliders.h"
 #include "font/font.h"
 #include "font/text.h"
@@ -45,10 +47,14 @@ struct Gen {
     static void sprite_debug(Vertex **p, SpriteRenderer *x);
     static void cube_debug(Vertex **p, CubeRenderer *x);
     static void voxel_debug(Vertex **p, VoxelRenderer *x);
+    /**
+     * Generates one quad for each of \p n glyphs of \p txt starting at \p i.
+     * Glyphs without a bitmap generate an empty quad, so that the position
+     * of each glyph in the buffer is fixed.
+     */
     static void text(
-        Vertex **p, u64 n,
-        const Font &font, const Text &txt, bool mono, float left,
-        vec2 *pos_p, float *color_p, u64 *i_p, u64 *n_visible_p);
+        Vertex **p, const Font &font, const Text &txt, bool mono, vec2 bl,
+        std::size_t i, std::size_t n);
     static void textbox(Vertex **p, const Textbox &x);
     static void selection(Vertex **p, const SpriteRenderer &x);
     static void aabb(Vertex **p, const AABBCollider &x, vec3 color);
@@ -290,41 +296,41 @@ inline void Gen::voxel_debug(Vertex **p, VoxelRenderer *x) {
 }
 
 inline void Gen::text(
-    Vertex **p, u64 n,
-    const Font &font, const Text &txt, bool mono, float left,
-    vec2 *pos_p, float *color_p, u64 *i_p, u64 *n_visible_p
+    Vertex **p, const Font &font, const Text &txt, bool mono, vec2 bl,
+    std::size_t i, std::size_t n
 ) {
-    auto pos = *pos_p;
-    auto color = *color_p;
-    auto i = static_cast<std::size_t>(*i_p);
-    auto n_visible = *n_visible_p;
+    constexpr vec3 norm = {0, 0, 1};
     const auto font_size = static_cast<float>(font.size);
-    while(n--) {
+    const auto line_height = font_size + txt.spacing;
+    const auto atlas_size = static_cast<float>(font.atlas.extent());
+    const auto top = bl + vec2(font_size / 2, txt.size.y - font_size / 2);
+    for(const auto &g : std::span{txt.glyphs}.subspan(i, n)) {
         using C = Textbox::Command;
-        const auto c = static_cast<unsigned char>(txt.str[i++]);
-        switch(c) {
-        case '\n': pos = {left, pos.y - font_size - txt.spacing}; continue;
-        case C::TEXT_WHITE: color = Gen::text_color(255, 255, 255); continue;
-        case C::TEXT_RED: color = Gen::text_color(255, 32, 32); continue;
-        case C::TEXT_GREEN: color = Gen::text_color(32, 255, 32); continue;
-        case C::TEXT_BLUE: color = Gen::text_color(32, 32, 255); continue;
+        float color = {};
+        switch(g.cmd) {
+        case C::TEXT_WHITE: color = Gen::text_color(255, 255, 255); break;
+        case C::TEXT_RED: color = Gen::text_color(255, 32, 32); break;
+        case C::TEXT_GREEN: color = Gen::text_color(32, 255, 32); break;
+        case C::TEXT_BLUE: color = Gen::text_color(32, 32, 255); break;
+        default: color = Gen::text_color(UINT32_MAX);
+        }
+        const auto x = mono ? static_cast<float>(g.col) * font_size : g.x;
+        const auto y = static_cast<float>(g.line) * line_height;
+        const auto pos = top + vec2{x, -y};
+        const auto *const fc = font.find(g.c);
+        // Blank or not in the atlas.
+        if(!fc || !fc->slot) {
+            Gen::quad_vertices(p, pos, pos, color, norm, 0, {}, {});
+            continue;
         }
-        const auto fc = font.chars[static_cast<std::size_t>(c)];
-        const auto size = static_cast<vec2>(fc.size);
-        const auto cpos = pos
-            + vec2(font_size / 2, txt.size.y - font_size / 2)
-            + static_cast<vec2>(fc.bearing);
+        const auto size = static_cast<vec2>(fc->size);
+        const auto cpos = pos + static_cast<vec2>(fc->bearing);
+        const auto uv = static_cast<vec2>(fc->pos) / atlas_size;
+        const auto uv_size = size / atlas_size;
         Gen::quad_vertices(
-            p, cpos, cpos + size, color,
-            {0, 0, 1}, static_cast<u32>(c),
-            {0, size.y / font_size}, {size.x / font_size, 0});
-        pos.x += mono ? font_size : fc.advance;
-        ++n_visible;
+            p, cpos, cpos + size, color, norm, 0,
+            {uv.x, uv.y + uv_size.y}, {uv.x + uv_size.x, uv.y});
     }
-    *pos_p = pos;
-    *color_p = color;
-    *i_p = static_cast<u64>(i);
-    *n_visible_p = n_visible;
 }
 
 inline void Gen::textbox(Vertex **p, const Textbox &x) {
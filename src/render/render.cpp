@@ -26,7 +26,7 @@ using nngn::u8, nngn::u32, nngn::u64;
 namespace {
 
 bool set_max_sprites(
-    std::size_t n, std::vector<nngn::SpriteRenderer> *v,
+    std::size_t n, auto *v,
     nngn::Graphics *g, u32 vbo, u32 ebo, u32 debug_vbo, u32 debug_ebo)
 {
     set_capacity(v, n);
@@ -129,7 +129,7 @@ bool update_with_state(
 namespace nngn {
 
 void Renderers::init(
-    Textures *t, const Fonts *f, const Textbox *tb, const Grid *g,
+    Textures *t, Fonts *f, const Textbox *tb, const Grid *g,
     const Colliders *c, const Lighting *l, const Map *m
 ) {
     this->textures = t;
@@ -680,8 +680,8 @@ Renderer *Renderers::load(nngn::lua::table_view t) {
 }
 
 void Renderers::remove(Renderer *p) {
-    const auto remove = [this, p]<typename T>(std::vector<T> *v, auto flag) {
-        auto *const dp = static_cast<T*>(p);
+    const auto remove = [this, p]<typename V>(V *v, auto flag) {
+        auto *const dp = static_cast<typename V::value_type*>(p);
         if constexpr(requires { dp->tex; })
             if(const auto t = dp->tex)
                 this->textures->remove(t);
@@ -807,50 +807,70 @@ bool Renderers::update_renderers(
     const auto update_text = [this] {
         NNGN_LOG_CONTEXT("text");
         const auto n_fonts = this->fonts->n();
-        if(!this->textbox->updated() || n_fonts < 2)
+        if(n_fonts < 2)
+            return true;
+        auto &font = this->fonts->fonts()[n_fonts - 1];
+        // Glyphs previously written to the buffer may have been evicted from
+        // the atlas since then, or may not have fit in it.
+        const auto evicted = font.atlas.n_evicted();
+        const bool regen =
+            evicted != this->text_evicted || this->text_missing;
+        if(!this->textbox->updated() && !regen)
             return true;
         const auto vbo = this->text_vbo;
         const auto ebo = this->text_ebo;
-        const auto n = this->textbox->text_length();
+        const auto &tb = *this->textbox;
+        const auto n_title = tb.title.n_glyphs;
+        const auto n = n_title + tb.str.n_glyphs;
+        const auto prev = std::exchange(this->text_n, n);
         if(!n)
             return this->graphics->set_buffer_size(ebo, 0);
-        const auto render = [this, vbo, ebo](
-            const auto &f, const auto &txt,
-            bool mono, auto pos, auto *voff, auto *eoff, auto *ei
+        // Returns whether all glyphs with a bitmap are in the atlas.
+        const auto prepare = [&font](const Text &t, std::size_t b) {
+            bool ret = true;
+            for(const auto &g
+                    : std::span{t.glyphs}.subspan(b, t.n_glyphs - b)) {
+                const auto &c = font.glyph(g.c);
+                ret &= c.slot || !c.size.x || !c.size.y;
+            }
+            return ret;
+        };
+        // When characters are only revealed at the end of the text, quads
+        // already in the buffer are kept and only the new ones are appended.
+        std::size_t b = 0;
+        if(tb.appended() && !regen && n_title <= prev && prev <= n) {
+            this->text_missing = !prepare(tb.str, prev - n_title);
+            if(font.atlas.n_evicted() == evicted)
+                b = prev;
+        }
+        if(!b) {
+            const bool title = prepare(tb.title, 0);
+            this->text_missing = !(prepare(tb.str, 0) && title);
+        }
+        this->text_evicted = font.atlas.n_evicted();
+        const auto write = [this, &font, vbo, ebo, mono = tb.monospaced()](
+            const Text &t, vec2 bl, std::size_t off, std::size_t first
         ) {
-            if(!txt.cur)
-                return true;
-            constexpr auto gen = [](auto *d, nngn::Vertex *p, u64, u64 nw) {
-                std::apply(&Gen::text, std::tuple_cat(std::tuple{&p, nw}, *d));
+            constexpr auto gen = [](auto *d, nngn::Vertex *p, u64 i, u64 nw) {
+                const auto &[f, t_, m, bl_, first_] = *d;
+                Gen::text(&p, f, t_, m, bl_, first_ + i, nw);
             };
             constexpr auto vsize = 4 * sizeof(Vertex);
             constexpr auto esize = 6 * sizeof(u32);
-            u64 n_visible = 0;
-            return write_to_buffer<gen, Vertex>(
-                    this->graphics, vbo,
-                    std::exchange(*voff, *voff + vsize * txt.cur),
-                    txt.cur, vsize,
-                    rptr(std::tuple{
-                        std::ref(f), std::ref(txt), mono, pos.x, &pos,
-                        rptr(Gen::text_color(UINT32_MAX)),
-                        rptr(u64{}), &n_visible,
-                    }))
+            const auto n_write = t.n_glyphs - first;
+            const auto q = off + first;
+            return !n_write || (write_to_buffer<gen, Vertex>(
+                    this->graphics, vbo, q * vsize, n_write, vsize,
+                    rptr(std::tuple{std::cref(font), std::cref(t), mono, bl,
+                        first}))
                 && write_to_buffer<update_quad_indices_base<6>, u32>(
-                    this->graphics, ebo,
-                    std::exchange(*eoff, *eoff + esize * n_visible),
-                    txt.cur, esize,
-                    rptr(std::tuple{std::exchange(*ei, *ei + txt.cur)}));
+                    this->graphics, ebo, q * esize, n_write, esize,
+                    rptr(std::tuple{u64{q}})));
         };
-        const auto &f = this->fonts->fonts()[n_fonts - 1];
-        u64 ei = {}, voff = {}, eoff = {};
-        return render(
-                f, this->textbox->title, this->textbox->monospaced(),
-                this->textbox->title_bl, &voff, &eoff, &ei)
-            && render(
-                f, this->textbox->str, this->textbox->monospaced(),
-                this->textbox->str_bl, &voff, &eoff, &ei)
-            && this->graphics->set_buffer_size(vbo, voff)
-            && this->graphics->set_buffer_size(ebo, eoff);
+        return (b || write(tb.title, tb.title_bl, 0, 0))
+            && write(tb.str, tb.str_bl, n_title, b ? b - n_title : 0)
+            && this->graphics->set_buffer_size(vbo, n * 4 * sizeof(Vertex))
+            && this->graphics->set_buffer_size(ebo, n * 6 * sizeof(u32));
     };
     const auto update_textbox = [this] {
         NNGN_LOG_CONTEXT("textbox");
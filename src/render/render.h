@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "lua/table.h"
+#include "utils/alloc/accounting.h"
 #include "utils/flags.h"
 
 #include "renderers.h"
@@ -48,7 +49,7 @@ public:
     // Initialization
     /** Partially initializes this system.  \see set_graphics */
     void init(
-        Textures *t, const Fonts *f, const Textbox *tb, const Grid *g,
+        Textures *t, Fonts *f, const Textbox *tb, const Grid *g,
         const Colliders *c, const Lighting *l, const Map *map);
     // Configuration
     auto debug(void) const { return *this->m_debug; }
@@ -99,6 +100,8 @@ public:
     void remove_selection(const Renderer *p);
     bool update(void);
 private:
+    template<typename T>
+    using vector = accounted_vector<T, memory_tag::renderers>;
     bool update_renderers(
         bool sprites_updated, bool screen_sprites_updated,
         bool translucent_updated, bool cubes_updated, bool voxels_updated);
@@ -120,17 +123,23 @@ private:
     Flags<Debug> m_debug = {};
     Textures *textures = nullptr;
     Graphics *graphics = nullptr;
-    const Fonts *fonts = nullptr;
+    Fonts *fonts = nullptr;
     const Textbox *textbox = nullptr;
     const Grid *grid = nullptr;
     const Colliders *colliders = nullptr;
     const Lighting *lighting = nullptr;
     const Map *map = nullptr;
-    std::vector<SpriteRenderer> sprites = {};
-    std::vector<SpriteRenderer> screen_sprites = {};
-    std::vector<SpriteRenderer> translucent = {};
-    std::vector<CubeRenderer> cubes = {};
-    std::vector<VoxelRenderer> voxels = {};
+    /** Glyph evictions from the font atlas when text was last generated. */
+    u64 text_evicted = 0;
+    /** Whether glyphs were missing from the atlas when text was generated. */
+    bool text_missing = false;
+    /** Number of glyphs currently in \ref text_vbo. */
+    std::size_t text_n = 0;
+    vector<SpriteRenderer> sprites = {};
+    vector<SpriteRenderer> screen_sprites = {};
+    vector<SpriteRenderer> translucent = {};
+    vector<CubeRenderer> cubes = {};
+    vector<VoxelRenderer> voxels = {};
     std::unordered_set<const Renderer*> selections = {};
     u32
         translucent_vbo = {}, translucent_ebo = {},
@@ -45,13 +45,21 @@ void SpriteRenderer::load(nngn::lua::table_view t) {
         this->z_off = *z;
     else
         this->z_off = this->size.y / -2.0f;
+    // Region of the texture which contains the image, e.g. from a
+    // `TextureAtlas`.  Coordinates are relative to it.
+    if(const auto u = t["uv"].get<std::optional<nngn::lua::table>>())
+        read_table(SpriteRenderer::uv_span(&this->uv), *u);
     if(const auto s = t["scale"].get<std::optional<nngn::lua::table>>()) {
         uvec2 scale = {};
         read_table(std::span{scale}, *s);
         const auto [coords0, coords1] = read_coords(t);
+        const auto r = this->uv;
         SpriteRenderer::uv_coords(
             coords0, coords1, scale,
             SpriteRenderer::uv_span(&this->uv));
+        const auto d = r[1] - r[0];
+        for(auto &x : this->uv)
+            x = {r[0].x + x.x * d.x, r[0].y + (1 - x.y) * d.y};
     }
 }
 
@@ -0,0 +1,36 @@
+#include "math/camera.h"
+
+#include "light.h"
+#include "snapshot.h"
+
+namespace nngn {
+
+void RenderSnapshot::update(const Camera &c, const Lighting &l) {
+    this->camera_flags = c.flags.v;
+    this->screen = c.screen;
+    this->proj = c.proj;
+    this->screen_proj = c.screen_proj;
+    this->view = c.view;
+    this->ubo = l.ubo();
+    this->dir_proj = l.dir_proj();
+    this->point_proj = l.point_proj();
+    for(std::size_t i = 0; i != N_LIGHTS; ++i) {
+        this->dir_views[i] = l.dir_view(i);
+        for(std::size_t f = 0; f != 6; ++f)
+            this->point_views[6 * i + f] = l.point_view(i, f);
+    }
+}
+
+Graphics::Camera RenderSnapshot::camera(void) {
+    return {
+        &this->camera_flags, &this->screen,
+        &this->proj, &this->screen_proj, &this->view};
+}
+
+Graphics::Lighting RenderSnapshot::lighting(void) const {
+    return {
+        &this->ubo, &this->dir_proj, &this->point_proj,
+        this->dir_views.data(), this->point_views.data()};
+}
+
+}
@@ -0,0 +1,45 @@
+#ifndef NNGN_RENDER_SNAPSHOT_H
+#define NNGN_RENDER_SNAPSHOT_H
+
+#include <array>
+
+#include "graphics/graphics.h"
+#include "math/mat4.h"
+#include "math/vec2.h"
+#include "utils/def.h"
+
+namespace nngn {
+
+struct Camera;
+class Lighting;
+
+/**
+ * Copy of the camera and lighting data read by the graphics back end.
+ * The back end normally reads these directly from \ref Camera and \ref
+ * Lighting during \ref Graphics::render.  When rendering is done concurrently
+ * with the simulation of the next frame, it is instead pointed to this copy,
+ * which is only updated between frames, while the originals are free to
+ * change.
+ */
+class RenderSnapshot {
+public:
+    /** Copies the current state of \p c and \p l. */
+    void update(const Camera &c, const Lighting &l);
+    /** Parameters for \ref Graphics::set_camera. */
+    Graphics::Camera camera(void);
+    /** Parameters for \ref Graphics::set_lighting. */
+    Graphics::Lighting lighting(void) const;
+private:
+    static constexpr std::size_t N_LIGHTS = NNGN_MAX_LIGHTS;
+    u8 camera_flags = 0;
+    uvec2 screen = {};
+    mat4 proj = {}, screen_proj = {}, view = {};
+    LightsUBO ubo = {};
+    mat4 dir_proj = {}, point_proj = {};
+    std::array<mat4, N_LIGHTS> dir_views = {};
+    std::array<mat4, 6 * N_LIGHTS> point_views = {};
+};
+
+}
+
+#endif
@@ -1,15 +1,13 @@
 #include <cassert>
-#include <deque>
-#include <iomanip>
+#include <cstdio>
 #include <limits>
-#include <sstream>
+#include <utility>
 
 #include "fps.h"
 
 namespace nngn {
 
-FPS::FPS(frame_queue::size_type n)
-    : avg_hist(frame_queue::container_type(n))
+FPS::FPS(frame_queue::size_type n) : avg_hist(n)
     { assert(!this->avg_hist.empty()); }
 
 void FPS::init(Timing::clock::time_point t) {
@@ -18,16 +16,21 @@ void FPS::init(Timing::clock::time_point t) {
 }
 
 void FPS::frame(Timing::clock::time_point t) {
-    const auto update_avg = [](auto s, auto *f, const auto &dt) {
-        s -= f->front();
-        f->pop();
-        return s + f->emplace(dt);
+    const auto update_avg = [](auto s, auto *f, auto *i, const auto &dt) {
+        s -= std::exchange((*f)[*i], dt);
+        *i = (*i + 1) % f->size();
+        return s + dt;
     };
     const auto dt = t - this->last_f;
     this->last_f = t;
+    if(this->hist_window && this->hist.count() >= this->hist_window)
+        this->reset_hist();
+    this->hist.record(static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count()));
     this->min_dt = std::min(this->min_dt, dt);
     this->max_dt = std::max(this->max_dt, dt);
-    this->avg_sum = update_avg(this->avg_sum, &this->avg_hist, dt);
+    this->avg_sum = update_avg(
+        this->avg_sum, &this->avg_hist, &this->avg_i, dt);
     this->avg = std::chrono::duration<float>(this->avg_hist.size())
         / std::chrono::duration<float>(this->avg_sum);
     if(const auto s = t - this->last_t;
@@ -40,24 +43,49 @@ void FPS::frame(Timing::clock::time_point t) {
     }
 }
 
+void FPS::profile(const ProfileStats &s) {
+    constexpr auto n = ProfileStats::N_EVENTS;
+    const auto &v = *s.to_u64_array();
+    for(std::size_t i = 0; i != this->prof_hist.size(); ++i) {
+        const auto begin = v[n * i], end = v[n * i + n - 1];
+        if(begin == this->prof_last[i] || end < begin)
+            continue;
+        this->prof_last[i] = begin;
+        const auto dt = Timing::duration{
+            static_cast<Timing::duration::rep>(end - begin)};
+        this->prof_hist[i].record(static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count()));
+    }
+}
+
 void FPS::reset_min_max() {
     this->min_dt = Timing::clock::duration(
         std::numeric_limits<Timing::clock::rep>::max());
     this->max_dt = {};
 }
 
-std::string FPS::to_string() const {
+void FPS::reset_hist() {
+    this->hist.reset();
+    for(auto &x : this->prof_hist)
+        x.reset();
+}
+
+auto FPS::last_dt() const -> Timing::clock::duration {
+    const auto n = this->avg_hist.size();
+    return this->avg_hist[(this->avg_i + n - 1) % n];
+}
+
+const char *FPS::to_string(std::span<char> s) const {
     const auto cast = [](const auto &d) {
-        using D = std::chrono::duration<float, std::milli>;
+        using D = std::chrono::duration<double, std::milli>;
         return std::chrono::duration_cast<D>(d).count();
     };
-    std::stringstream fmt;
-    fmt << std::fixed << std::setprecision(1)
-        << " cur: " << this->sec_last
-        << " avg: " << this->avg
-        << " min: " << cast(this->min_dt)
-        << " max: " << cast(this->max_dt);
-    return fmt.str();
+    assert(!s.empty());
+    std::snprintf(
+        s.data(), s.size(), " cur: %zu avg: %.1f min: %.1f max: %.1f",
+        this->sec_last, static_cast<double>(this->avg),
+        cast(this->min_dt), cast(this->max_dt));
+    return s.data();
 }
 
 }
@@ -1,29 +1,63 @@
 #ifndef NNGN_FPS_H
 #define NNGN_FPS_H
 
+#include <array>
 #include <chrono>
-#include <queue>
-#include <string>
+#include <span>
+#include <vector>
 
+#include "histogram.h"
+#include "profile.h"
 #include "timing.h"
 
 namespace nngn {
 
+/**
+ * Frame rate and frame time statistics.
+ *
+ * Besides the moving average and extrema, the duration of every frame is
+ * recorded in \ref hist, and that of every \ref ProfileStats section (when
+ * profiling is active) in \ref prof_hist, so that tail percentiles can be
+ * queried.  If \ref hist_window is not zero, all histograms are reset after
+ * that many frames.
+ */
 struct FPS {
-    using frame_queue = std::queue<Timing::clock::duration>;
+    /** Circular buffer of the most recent frame times, see \ref avg_i. */
+    using frame_queue = std::vector<Timing::clock::duration>;
+    using profile_hist = std::array<Histogram, ProfileStats::names.size()>;
     static constexpr frame_queue::size_type default_size = 60;
     Timing::clock::time_point last_f = {}, last_t = {};
     Timing::clock::duration min_dt = {}, max_dt = {};
     Timing::clock::duration avg_sum = {};
     frame_queue avg_hist;
+    /** Position of the oldest frame time in \ref avg_hist. */
+    std::size_t avg_i = 0;
     float avg = 0;
     size_t sec_count = 0, sec_last = 0;
+    /** Frame times, in nanoseconds. */
+    Histogram hist = {};
+    /** Duration of each profile section, in nanoseconds. */
+    profile_hist prof_hist = {};
+    std::array<u64, ProfileStats::names.size()> prof_last = {};
+    /** Number of frames after which histograms are reset, or zero. */
+    u64 hist_window = 0;
     FPS() : FPS(default_size) {}
     explicit FPS(frame_queue::size_type n);
     void init(Timing::clock::time_point t);
     void frame(Timing::clock::time_point t);
+    /** Records the sections in \p s which were updated since the last call. */
+    void profile(const ProfileStats &s);
     void reset_min_max();
-    std::string to_string() const;
+    void reset_hist();
+    /** Duration of the last frame. */
+    Timing::clock::duration last_dt() const;
+    /**
+     * Formats the current statistics into \p s.
+     * The output is truncated (and always null-terminated) if \p s is not
+     * large enough.
+     * \return \p s.data()
+     */
+    const char *to_string(std::span<char> s) const;
 };
 
 }
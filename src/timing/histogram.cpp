@@ -0,0 +1,35 @@
+#include <cmath>
+
+#include "histogram.h"
+
+namespace nngn {
+
+static_assert(Histogram::bucket(Histogram::SUB_COUNT - 1)
+    == Histogram::SUB_COUNT - 1);
+static_assert(Histogram::bucket(Histogram::SUB_COUNT)
+    == Histogram::SUB_COUNT);
+static_assert(Histogram::bucket(u64{1} << Histogram::MAX_BITS)
+    == Histogram::N_BUCKETS - 1);
+static_assert(Histogram::bucket_max(Histogram::N_BUCKETS - 1)
+    == (u64{1} << Histogram::MAX_BITS) - 1);
+
+u64 Histogram::percentile(double q) const {
+    if(!this->m_count)
+        return 0;
+    const auto n = static_cast<double>(this->m_count);
+    const auto rank = std::clamp(
+        static_cast<u64>(std::ceil(std::clamp(q, 0.0, 1.0) * n)),
+        u64{1}, this->m_count);
+    u64 acc = 0;
+    for(std::size_t i = 0; i != N_BUCKETS; ++i)
+        if((acc += this->buckets[i]) >= rank)
+            return std::clamp(
+                Histogram::bucket_max(i), this->m_min, this->m_max);
+    return this->m_max;
+}
+
+void Histogram::reset(void) {
+    *this = {};
+}
+
+}
@@ -0,0 +1,82 @@
+#ifndef NNGN_TIMING_HISTOGRAM_H
+#define NNGN_TIMING_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <limits>
+
+#include "utils/def.h"
+
+namespace nngn {
+
+/**
+ * Log-linear histogram of unsigned values with bounded relative error.
+ *
+ * Values below `2^SUB_BITS` are counted exactly.  Above that, each power of two
+ * is divided into `2^(SUB_BITS - 1)` equal buckets, so the value reported for a
+ * bucket is within `2^(1 - SUB_BITS)` (~3%) of every value counted in it.
+ * Values of `2^MAX_BITS` or more are counted in the last bucket.
+ *
+ * Memory use is constant and \ref record is O(1).  \ref percentile is linear
+ * on the (fixed) number of buckets.  Intended for nanosecond durations: the
+ * default range covers up to ~18min.
+ */
+class Histogram {
+public:
+    static constexpr unsigned SUB_BITS = 6, MAX_BITS = 40;
+    static constexpr std::size_t SUB_COUNT = std::size_t{1} << SUB_BITS;
+    static constexpr std::size_t HALF_COUNT = SUB_COUNT / 2;
+    static constexpr std::size_t N_BUCKETS =
+        (MAX_BITS - SUB_BITS) * HALF_COUNT + SUB_COUNT;
+    /** Index of the bucket where \p v is counted. */
+    static constexpr std::size_t bucket(u64 v);
+    /** Highest value counted in bucket \p i. */
+    static constexpr u64 bucket_max(std::size_t i);
+    u64 count(void) const { return this->m_count; }
+    u64 min(void) const { return this->m_count ? this->m_min : 0; }
+    u64 max(void) const { return this->m_max; }
+    /** Exact sum of all recorded values. */
+    u64 sum(void) const { return this->m_sum; }
+    void record(u64 v);
+    /**
+     * Smallest value which is greater than or equal to a fraction \p q of all
+     * recorded values (within the precision of the buckets).
+     * \param q `[0, 1]`
+     */
+    u64 percentile(double q) const;
+    void reset(void);
+private:
+    std::array<u32, N_BUCKETS> buckets = {};
+    u64 m_count = 0, m_sum = 0, m_min = std::numeric_limits<u64>::max(), m_max = 0;
+};
+
+inline constexpr std::size_t Histogram::bucket(u64 v) {
+    constexpr u64 max = (u64{1} << MAX_BITS) - 1;
+    v = std::min(v, max);
+    if(v < SUB_COUNT)
+        return static_cast<std::size_t>(v);
+    const auto shift = static_cast<unsigned>(std::bit_width(v)) - SUB_BITS;
+    return shift * HALF_COUNT + static_cast<std::size_t>(v >> shift);
+}
+
+inline constexpr u64 Histogram::bucket_max(std::size_t i) {
+    if(i < SUB_COUNT)
+        return i;
+    const auto shift = i / HALF_COUNT - 1;
+    const auto m = i - shift * HALF_COUNT;
+    return ((u64{m} + 1) << shift) - 1;
+}
+
+inline void Histogram::record(u64 v) {
+    ++this->buckets[Histogram::bucket(v)];
+    ++this->m_count;
+    this->m_sum += v;
+    this->m_min = std::min(this->m_min, v);
+    this->m_max = std::max(this->m_max, v);
+}
+
+}
+
+#endif
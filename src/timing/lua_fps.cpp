@@ -6,16 +6,37 @@
 #include "fps.h"
 
 using nngn::FPS;
+using nngn::Histogram;
 
 namespace {
 
+lua_Number to_ms(nngn::u64 ns) { return static_cast<lua_Number>(ns) / 1e6; }
+
+lua_Number mean_ms(const Histogram &h) {
+    if(!h.count())
+        return 0;
+    return to_ms(h.sum()) / static_cast<lua_Number>(h.count());
+}
+
+auto to_lua(nngn::lua::state_view lua, const Histogram &h) {
+    return nngn::lua::table_map(lua,
+        "count", static_cast<lua_Integer>(h.count()),
+        "min", to_ms(h.min()),
+        "max", to_ms(h.max()),
+        "mean", mean_ms(h),
+        "p50", to_ms(h.percentile(0.5)),
+        "p90", to_ms(h.percentile(0.9)),
+        "p99", to_ms(h.percentile(0.99)),
+        "p999", to_ms(h.percentile(0.999)));
+}
+
 auto dump(const FPS &fps, nngn::lua::state_view lua) {
     constexpr auto cast = [](auto d) {
         using D = std::chrono::duration<lua_Number, std::milli>;
         return std::chrono::duration_cast<D>(d).count();
     };
     return nngn::lua::table_map(lua,
-        "last_dt", cast(fps.avg_hist.back()),
+        "last_dt", cast(fps.last_dt()),
         "min_dt", cast(fps.min_dt),
         "max_dt", cast(fps.max_dt),
         "avg", static_cast<lua_Number>(fps.avg),
@@ -24,8 +45,38 @@ auto dump(const FPS &fps, nngn::lua::state_view lua) {
     ).release();
 }
 
+auto percentile(const FPS &fps, lua_Number q) {
+    return to_ms(fps.hist.percentile(q));
+}
+
+auto percentiles(const FPS &fps, nngn::lua::state_view lua) {
+    return to_lua(lua, fps.hist).release();
+}
+
+auto profile_percentiles(const FPS &fps, nngn::lua::state_view lua) {
+    auto ret = lua.create_table(static_cast<int>(fps.prof_hist.size()), 0);
+    lua_Integer i = 1;
+    for(const auto &x : fps.prof_hist)
+        ret.raw_set(i++, to_lua(lua, x));
+    return ret.release();
+}
+
+auto hist_window(const FPS &fps) {
+    return static_cast<lua_Integer>(fps.hist_window);
+}
+
+void set_hist_window(FPS &fps, lua_Integer n) {
+    fps.hist_window = static_cast<nngn::u64>(n);
+}
+
 void register_fps(nngn::lua::table_view t) {
     t["reset_min_max"] = &FPS::reset_min_max;
+    t["reset_hist"] = &FPS::reset_hist;
+    t["hist_window"] = hist_window;
+    t["set_hist_window"] = set_hist_window;
+    t["percentile"] = percentile;
+    t["percentiles"] = percentiles;
+    t["profile_percentiles"] = profile_percentiles;
     t["dump"] = dump;
 }
 
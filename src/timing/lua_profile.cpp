@@ -1,9 +1,12 @@
+#include <cstdio>
+
 #include "lua/function.h"
 #include "lua/register.h"
 #include "lua/table.h"
 
 #include "profile.h"
 #include "stats.h"
+#include "stats_stream.h"
 
 using nngn::Profile;
 
@@ -44,6 +47,12 @@ void register_profile(nngn::lua::table_view t) {
     t["stats_as_timeline"] = [](nngn::lua::state_view lua) {
         return to_timeline_table(lua, *nngn::Stats::u64_data<nngn::Profile>());
     };
+    t["write_stats"] = [](nngn::lua::state_view lua) {
+        return nngn::StatsStream::write(
+            *nngn::chain_cast<FILE**, void*>(lua.get(1)),
+            *nngn::Stats::u64_data<nngn::Profile>(),
+            Profile::Stats::N_EVENTS);
+    };
 }
 
 }
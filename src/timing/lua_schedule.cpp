@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <chrono>
+
 #include "lua/function.h"
 #include "lua/register.h"
 #include "lua/table.h"
@@ -18,6 +21,17 @@ struct entry {
     int ref = 0;
 };
 
+/** Lua coroutine executed as a task, see \ref task_call. */
+struct task {
+    Schedule *s = nullptr;
+    lua_State *L = nullptr;
+    lua_State *co = nullptr;
+    int ref = 0;
+};
+
+/** Values yielded by a task to indicate what it is waiting for. */
+enum class wait : lua_Integer { FRAMES, MS, SIGNAL };
+
 bool entry_call(void *p) {
     NNGN_LOG_CONTEXT("lua task");
     const auto *e = static_cast<const entry*>(p);
@@ -35,13 +49,56 @@ bool entry_destroy(void *p) {
     return true;
 }
 
+/**
+ * Resumes the coroutine until it yields or returns.
+ * A yielding coroutine is suspended according to the yielded values: a \ref
+ * wait type and its argument.  Any other value (including none, i.e. a plain
+ * `coroutine.yield()`) suspends it until the next frame.  A coroutine which
+ * cancels itself is not resumed again.
+ */
+bool task_call(void *p) {
+    NNGN_LOG_CONTEXT("lua coroutine");
+    const auto *t = static_cast<const task*>(p);
+    auto *const co = t->co;
+    if(!co)
+        return true;
+    // Cancelling releases the registry reference while the coroutine runs.
+    auto *const L = t->L;
+    lua_rawgeti(L, LUA_REGISTRYINDEX, t->ref);
+    const auto pop_co = nngn::lua::defer_pop(L);
+    int n = 0;
+    switch(lua_resume(co, L, 0, &n)) {
+    case LUA_OK: return true;
+    case LUA_YIELD: break;
+    default: return nngn::lua::msgh(co), false;
+    }
+    const auto pop = nngn::lua::defer_pop(co, n);
+    if(!t->co)
+        return true;
+    const auto arg = [co, n] { return lua_tointeger(co, 1 - n); };
+    auto &s = *t->s;
+    switch(n < 2 ? wait::FRAMES : static_cast<wait>(lua_tointeger(co, -n))) {
+    case wait::MS: return s.suspend_in(std::chrono::milliseconds{arg()});
+    case wait::SIGNAL: return s.suspend_signal(static_cast<nngn::u64>(arg()));
+    case wait::FRAMES:
+    default:
+        return s.suspend_frames(
+            n < 2 ? 1 : nngn::narrow<nngn::u64>(std::max<lua_Integer>(arg(), 1)));
+    }
+}
+
+bool task_destroy(void *p) {
+    NNGN_LOG_CONTEXT_F();
+    const auto *t = static_cast<const task*>(p);
+    luaL_unref(t->L, LUA_REGISTRYINDEX, t->ref);
+    return true;
+}
+
 Schedule::Entry gen_entry(nngn::lua::state_view lua, Schedule::Flag f, int i) {
     NNGN_LOG_CONTEXT_F();
     lua_pushvalue(lua, i);
     const int ref = luaL_ref(lua, LUA_REGISTRYINDEX);
-    std::vector<std::byte> data(sizeof(entry));
-    new (data.data()) entry{lua, ref};
-    return {entry_call, entry_destroy, data, f};
+    return {entry_call, entry_destroy, Schedule::data(entry{lua, ref}), f};
 }
 
 auto next(
@@ -67,6 +124,49 @@ auto frame(
         s.frame(nngn::narrow<nngn::u64>(frame), gen_entry(lua, f, fn.index())));
 }
 
+auto wait_(
+    Schedule &s, Schedule::Flag f, lua_Integer signal,
+    nngn::lua::function_view fn, nngn::lua::state_view lua)
+{
+    return nngn::narrow<lua_Integer>(
+        s.wait(static_cast<nngn::u64>(signal), gen_entry(lua, f, fn.index())));
+}
+
+/**
+ * Creates a coroutine from \p fn and schedules it for the next frame.
+ * The coroutine can then suspend itself using the `wait_*` functions.  The
+ * returned index refers to the task for its entire lifetime and can be passed
+ * to \ref cancel.
+ */
+auto spawn(
+    Schedule &s, Schedule::Flag f, nngn::lua::function_view fn,
+    nngn::lua::state_view lua)
+{
+    NNGN_LOG_CONTEXT_F();
+    lua_rawgeti(lua, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+    auto *const L = lua_tothread(lua, -1);
+    lua_pop(lua, 1);
+    auto *const co = lua_newthread(lua);
+    const int ref = luaL_ref(lua, LUA_REGISTRYINDEX);
+    lua_pushvalue(lua, fn.index());
+    lua_xmove(lua, co, 1);
+    return nngn::narrow<lua_Integer>(s.next({
+        task_call, task_destroy, Schedule::data(task{&s, L, co, ref}), f}));
+}
+
+/** Yields the current coroutine with a \ref wait type and its argument. */
+template<wait w>
+int yield(lua_State *L) {
+    lua_settop(L, 1);
+    lua_pushinteger(L, nngn::to_underlying(w));
+    lua_insert(L, 1);
+    return lua_yield(L, 2);
+}
+
+auto signal(Schedule &s, lua_Integer i) {
+    return nngn::narrow<lua_Integer>(s.signal(static_cast<nngn::u64>(i)));
+}
+
 auto atexit_(
     Schedule &s, nngn::lua::function_view f, nngn::lua::state_view lua)
 {
@@ -86,7 +186,13 @@ void register_schedule(nngn::lua::table_view t) {
     t["next"] = next;
     t["in_ms"] = in_ms;
     t["frame"] = frame;
+    t["wait"] = wait_;
     t["atexit"] = atexit_;
+    t["spawn"] = spawn;
+    t["wait_frames"] = yield<wait::FRAMES>;
+    t["wait_ms"] = yield<wait::MS>;
+    t["wait_signal"] = yield<wait::SIGNAL>;
+    t["signal"] = signal;
     t["cancel"] = cancel;
 }
 
@@ -1,8 +1,12 @@
+#include <cstdio>
+
 #include "lua/function.h"
 #include "lua/register.h"
 #include "lua/table.h"
+#include "utils/log.h"
 
 #include "stats.h"
+#include "stats_stream.h"
 
 using nngn::Stats;
 
@@ -16,9 +20,27 @@ void set_active(lua_Integer i, bool a) {
     Stats::set_active(nngn::narrow<std::size_t>(i), a);
 }
 
+/** Writes the arguments after the file as an `F32` record. */
+bool write_samples(nngn::lua::state_view lua) {
+    NNGN_LOG_CONTEXT_F();
+    using nngn::StatsStream;
+    auto *const f = *nngn::chain_cast<FILE**, void*>(lua.get(1));
+    const int n = lua.top();
+    const auto type = StatsStream::Type::F32;
+    if(!StatsStream::write_header(f, type, static_cast<std::size_t>(n - 1)))
+        return false;
+    for(int i = 2; i <= n; ++i) {
+        const auto x = static_cast<float>(lua.get<lua_Number>(i));
+        if(std::fwrite(&x, sizeof(x), 1, f) != 1)
+            return nngn::Log::perror("fwrite"), false;
+    }
+    return true;
+}
+
 void register_stats(nngn::lua::table_view t) {
     t["active"] = active;
     t["set_active"] = set_active;
+    t["write_samples"] = write_samples;
 }
 
 }
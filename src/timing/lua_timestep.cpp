@@ -0,0 +1,52 @@
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/table.h"
+
+#include "timestep.h"
+
+using nngn::FixedTimestep;
+
+namespace {
+
+auto step_ns(const FixedTimestep &t) {
+    return nngn::narrow<lua_Integer>(t.step().count());
+}
+
+void set_step_ns(FixedTimestep &t, FixedTimestep::duration::rep r) {
+    t.set_step(FixedTimestep::duration(r));
+}
+
+void set_rate(FixedTimestep &t, lua_Number hz) {
+    using D = std::chrono::duration<lua_Number>;
+    t.set_step(hz > 0
+        ? std::chrono::duration_cast<FixedTimestep::duration>(D{1 / hz})
+        : FixedTimestep::duration{});
+}
+
+auto max_steps(const FixedTimestep &t) {
+    return nngn::narrow<lua_Integer>(t.max_steps());
+}
+
+void set_max_steps(FixedTimestep &t, lua_Integer n) {
+    t.set_max_steps(nngn::narrow<std::size_t>(n));
+}
+
+auto dropped(const FixedTimestep &t) {
+    return nngn::narrow<lua_Integer>(t.dropped());
+}
+
+void register_timestep(nngn::lua::table_view t) {
+    t["enabled"] = &FixedTimestep::enabled;
+    t["step_ns"] = step_ns;
+    t["set_step_ns"] = set_step_ns;
+    t["set_rate"] = set_rate;
+    t["max_steps"] = max_steps;
+    t["set_max_steps"] = set_max_steps;
+    t["dropped"] = dropped;
+    t["alpha"] = &FixedTimestep::alpha;
+}
+
+}
+
+NNGN_LUA_DECLARE_USER_TYPE(FixedTimestep)
+NNGN_LUA_PROXY(FixedTimestep, register_timestep)
@@ -35,6 +35,14 @@ void set_dt_ns(Timing &t, Timing::duration::rep r) {
     t.dt = Timing::duration(r);
 }
 
+auto fixed_dt_ns(const Timing &t) {
+    return nngn::narrow<lua_Integer>(t.fixed_dt.count());
+}
+
+void set_fixed_dt_ns(Timing &t, Timing::duration::rep r) {
+    t.fixed_dt = Timing::duration(r);
+}
+
 void register_timing(nngn::lua::table_view t) {
     t["frame"] = frame;
     t["time_s"] = [](function_view f) { return time<std::ratio<1>>(f); };
@@ -59,6 +67,8 @@ void register_timing(nngn::lua::table_view t) {
     t["scale"] = scale;
     t["set_now_ns"] = set_now_ns;
     t["set_dt_ns"] = set_dt_ns;
+    t["fixed_dt_ns"] = fixed_dt_ns;
+    t["set_fixed_dt_ns"] = set_fixed_dt_ns;
     t["set_scale"] = [](Timing &ti, float s) { ti.scale = s; };
 }
 
@@ -0,0 +1,53 @@
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/table.h"
+
+#include "trace.h"
+
+using nngn::Trace;
+
+namespace {
+
+/** Zones opened from Lua on the main thread and not yet closed. */
+std::vector<std::pair<const char*, nngn::u64>> lua_zones = {};
+
+void begin_zone(std::string_view name) {
+    if(Trace::active())
+        lua_zones.emplace_back(Trace::intern(name), Trace::now());
+    else
+        lua_zones.emplace_back(nullptr, 0);
+}
+
+bool end_zone(void) {
+    if(lua_zones.empty())
+        return false;
+    const auto [name, begin] = lua_zones.back();
+    lua_zones.pop_back();
+    if(name)
+        Trace::record(name, begin);
+    return true;
+}
+
+void register_trace(nngn::lua::table_view t) {
+    t["BUFFER_SIZE"] = static_cast<lua_Integer>(Trace::BUFFER_SIZE);
+    t["active"] = Trace::active;
+    t["set_active"] = Trace::set_active;
+    t["frames"] = [] { return static_cast<lua_Integer>(Trace::frames()); };
+    t["set_frames"] = [](lua_Integer n) {
+        Trace::set_frames(static_cast<std::size_t>(n));
+    };
+    t["set_thread_name"] = Trace::set_thread_name;
+    t["clear"] = Trace::clear;
+    t["begin_zone"] = begin_zone;
+    t["end_zone"] = end_zone;
+    t["write_json"] = [](const char *path) { return Trace::write_json(path); };
+}
+
+}
+
+NNGN_LUA_DECLARE_USER_TYPE(Trace)
+NNGN_LUA_PROXY(Trace, register_trace)
@@ -10,12 +10,14 @@
 
 #include "stats.h"
 #include "timing.h"
+#include "trace.h"
 
 namespace nngn {
 
 #define NNGN_STATS_CONTEXT(c, p) \
     const auto NNGN_STATS_CONTEXT_VAR(__LINE__) = nngn::Profile::context<c>(p);
 #define NNGN_PROFILE_CONTEXT(p) \
+    NNGN_TRACE_ZONE(#p) \
     NNGN_STATS_CONTEXT(nngn::Profile, &nngn::Profile::stats.p)
 #define NNGN_STATS_CONTEXT_VAR(l) NNGN_STATS_CONTEXT_JOIN(prof_, l)
 #define NNGN_STATS_CONTEXT_JOIN(x, y) x##y
@@ -23,12 +25,12 @@ namespace nngn {
 struct ProfileStats : StatsBase<ProfileStats, 2> {
     std::array<uint64_t, 2>
         schedule, socket, collision_check, collision_resolve, collision_lua,
-        entities, animations, parents, renderers, renderers_debug, render,
-        vsync;
+        entities, animations, parents, interpolate, renderers,
+        renderers_debug, render, vsync;
     static constexpr std::array names = {
         "schedule", "socket", "collision_check", "collision_resolve",
-        "collision_lua", "entities", "animations", "parents", "renderers",
-        "renderers_debug", "render", "vsync",
+        "collision_lua", "entities", "animations", "parents", "interpolate",
+        "renderers", "renderers_debug", "render", "vsync",
     };
     const uint64_t *to_u64() const { return this->schedule.data(); }
     uint64_t *to_u64() { return this->schedule.data(); }
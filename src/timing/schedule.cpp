@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <utility>
 
 #include "utils/log.h"
 
@@ -9,32 +10,24 @@
 
 namespace {
 
-/** Applies \c f to all elements of \c v, \c f may modify \c v. */
-template<typename T, typename F>
-bool mut_iter(T *v, F &&f) {
-    for(std::size_t i = 0; i < v->size(); ++i)
-        if(!f((*v)[i]))
-            return false;
-    return true;
+template<typename T>
+void heap_push(std::vector<T> *v, T t) {
+    v->push_back(t);
+    std::ranges::push_heap(*v, std::greater<>{});
 }
 
-template<typename ...Ts>
-bool exec(std::ranges::forward_range auto *r, Ts ...ts) {
-    return mut_iter(r, [...ts = std::move(ts)](auto &x) {
-        return !x.active(ts...)
-            || x.call()
-            || (x.flags & nngn::Schedule::Flag::IGNORE_FAILURES);
-    });
+template<typename T>
+T heap_pop(std::vector<T> *v) {
+    std::ranges::pop_heap(*v, std::greater<>{});
+    const auto ret = v->back();
+    v->pop_back();
+    return ret;
 }
 
 }
 
 namespace nngn {
 
-bool Schedule::BaseEntry::call(void) {
-    return this->f(static_cast<void*>(this->data.data()));
-}
-
 bool Schedule::BaseEntry::destroy(void) {
     assert(this->f);
     if(this->dest && !this->dest(this->data.data()))
@@ -53,32 +46,139 @@ bool Schedule::TimeEntry::active(
 }
 
 template<typename T>
-std::size_t Schedule::add(std::vector<T> *v_, T t) {
-    const auto e = v_->end();
-    auto it = std::find_if_not(begin(*v_), e, std::mem_fn(&BaseEntry::active));
-    if(it == e)
-        it = v_->insert(it, t);
-    else
-        *it = t;
-    return static_cast<std::size_t>(std::distance(begin(*v_), it));
+std::size_t Schedule::add(
+    std::vector<T> *v_, std::vector<std::size_t> *free_, T t)
+{
+    // Indices past the end were released before the vector was truncated.
+    while(!free_->empty())
+        if(const auto i = heap_pop(free_); i < v_->size())
+            return (*v_)[i] = std::move(t), i;
+    v_->push_back(std::move(t));
+    return v_->size() - 1;
 }
 
 template<typename T>
-bool Schedule::cancel_common(std::vector<T> *v_, std::size_t i) {
-    assert(i < v_->size());
-    auto it = begin(*v_) + static_cast<std::ptrdiff_t>(i);
-    if(!it->destroy())
+bool Schedule::call(std::vector<T> *v_, std::size_t i) {
+    // The task can schedule others and reallocate the vector.
+    Entry e = (*v_)[i];
+    const auto prev = std::exchange(this->cur, {v_, i, &e.data});
+    const bool ret = e.f(static_cast<void*>(e.data.data()));
+    if(this->cur.v)
+        (*v_)[i].data = e.data;
+    this->cur = prev;
+    return ret;
+}
+
+template<typename T>
+bool Schedule::release(
+    std::vector<T> *v_, std::vector<std::size_t> *free_, std::size_t i)
+{
+    // Releasing an entry twice would add a duplicate to the free list.
+    if(i >= v_->size() || !(*v_)[i].BaseEntry::active())
+        return false;
+    const bool running = this->cur.v == v_ && this->cur.i == i;
+    if(running)
+        (*v_)[i].data = *this->cur.data;
+    if(!(*v_)[i].destroy())
         return false;
-    const auto e = end(*v_);
-    if(std::find_if(it, e, std::mem_fn(&BaseEntry::active)) == e)
-        v_->erase(it, e);
+    if(running)
+        *this->cur.data = {}, this->cur = {};
+    heap_push(free_, i);
     return true;
 }
 
+template<typename T>
+bool Schedule::cancel_common(
+    std::vector<T> *v_, std::vector<std::size_t> *free_, std::size_t i)
+{
+    if(!this->release(v_, free_, i))
+        return false;
+    while(!v_->empty() && !v_->back().BaseEntry::active())
+        v_->pop_back();
+    return true;
+}
+
+std::size_t Schedule::add_timer(TimeEntry e) {
+    e.gen = this->cur_gen;
+    const auto ret = this->add(&this->v, &this->free, std::move(e));
+    this->enqueue(ret);
+    return ret;
+}
+
+bool Schedule::valid(Ref r) const {
+    return r.i < this->v.size()
+        && this->v[r.i].serial == r.serial
+        && this->v[r.i].BaseEntry::active();
+}
+
+void Schedule::enqueue(std::size_t i) {
+    auto &x = this->v[i];
+    const Ref r = {i, x.serial = ++this->cur_serial};
+    if(x.time == Timing::time_point{})
+        heap_push(&this->frame_q, {x.frame, r});
+    else
+        heap_push(&this->time_q, {x.time, r});
+}
+
+void Schedule::enqueue_signal(std::size_t i, u64 s) {
+    auto &x = this->v[i];
+    x.time = {};
+    x.frame = 0;
+    this->waiting[s].push_back({i, x.serial = ++this->cur_serial});
+    ++this->n_waiting;
+}
+
+void Schedule::expire(u64 cur_frame, Timing::time_point now) {
+    auto &fq = this->frame_q;
+    auto &tq = this->time_q;
+    while(!fq.empty() && fq.front().key <= cur_frame) {
+        const auto r = heap_pop(&fq).ref;
+        if(!this->valid(r))
+            continue;
+        if(const auto t = this->v[r.i].time; now < t)
+            heap_push(&tq, {t, r});
+        else
+            this->due.push_back(r);
+    }
+    while(!tq.empty() && tq.front().key <= now) {
+        const auto r = heap_pop(&tq).ref;
+        if(!this->valid(r))
+            continue;
+        if(const auto f = this->v[r.i].frame; cur_frame < f)
+            heap_push(&fq, {f, r});
+        else
+            this->due.push_back(r);
+    }
+}
+
+void Schedule::compact(void) {
+    const auto f = [this](const auto &x) { return !this->valid(x.ref); };
+    std::erase_if(this->frame_q, f);
+    std::erase_if(this->time_q, f);
+    std::ranges::make_heap(this->frame_q, std::greater<>{});
+    std::ranges::make_heap(this->time_q, std::greater<>{});
+    const auto invalid = [this](Ref r) { return !this->valid(r); };
+    this->n_waiting = 0;
+    for(auto it = begin(this->waiting); it != end(this->waiting);)
+        if(std::erase_if(it->second, invalid), it->second.empty())
+            it = this->waiting.erase(it);
+        else
+            this->n_waiting += it->second.size(), ++it;
+}
+
+void Schedule::restore(void) {
+    for(const auto r : this->due) {
+        if(!this->valid(r))
+            continue;
+        if(const auto &x = this->v[r.i]; x.is_heartbeat())
+            this->heartbeats.push_back(r);
+        else
+            heap_push(&this->frame_q, {x.frame, r});
+    }
+}
+
 std::size_t Schedule::next(Entry e) {
-    TimeEntry te = {{std::move(e)}};
-    te.gen = this->cur_gen;
-    return this->add(&this->v, std::move(te));
+    return this->add_timer({{std::move(e)}});
 }
 
 std::size_t Schedule::in(std::chrono::milliseconds t, Entry e) {
@@ -88,27 +188,90 @@ std::size_t Schedule::in(std::chrono::milliseconds t, Entry e) {
 std::size_t Schedule::at(Timing::time_point t, Entry e) {
     TimeEntry te = {{std::move(e)}};
     te.time = t;
-    te.gen = this->cur_gen;
-    return this->add(&this->v, std::move(te));
+    return this->add_timer(std::move(te));
 }
 
 std::size_t Schedule::frame(u64 f, Entry e) {
     TimeEntry te = {{std::move(e)}};
     te.frame = f;
+    return this->add_timer(std::move(te));
+}
+
+std::size_t Schedule::wait(u64 s, Entry e) {
+    TimeEntry te = {{std::move(e)}};
     te.gen = this->cur_gen;
-    return this->add(&this->v, std::move(te));
+    const auto ret = this->add(&this->v, &this->free, std::move(te));
+    this->enqueue_signal(ret, s);
+    return ret;
 }
 
 std::size_t Schedule::atexit(Entry e) {
-    return this->add(&this->atexit_v, {std::move(e)});
+    return this->add(&this->atexit_v, &this->atexit_free, {std::move(e)});
+}
+
+std::size_t Schedule::signal(u64 s) {
+    const auto it = this->waiting.find(s);
+    if(it == this->waiting.end())
+        return 0;
+    std::size_t ret = 0;
+    for(const auto r : it->second)
+        if(this->valid(r))
+            heap_push(&this->frame_q, {0, r}), ++ret;
+    this->n_waiting -= it->second.size();
+    this->waiting.erase(it);
+    return ret;
+}
+
+auto Schedule::current(void) -> TimeEntry* {
+    NNGN_LOG_CONTEXT_CF(Schedule);
+    const auto i = this->cur.i;
+    if(this->cur.v == &this->v && this->v[i].BaseEntry::active())
+        return &this->v[i];
+    Log::l() << "no task is executing\n";
+    return nullptr;
+}
+
+bool Schedule::suspend_frame(u64 f) {
+    auto *const x = this->current();
+    if(!x)
+        return false;
+    x->time = {};
+    x->frame = f;
+    this->enqueue(this->cur.i);
+    return true;
+}
+
+bool Schedule::suspend_frames(u64 n) {
+    return this->suspend_frame(this->timing->frame + n);
+}
+
+bool Schedule::suspend_in(std::chrono::milliseconds t) {
+    return this->suspend_at(t + this->timing->now);
+}
+
+bool Schedule::suspend_at(Timing::time_point t) {
+    auto *const x = this->current();
+    if(!x)
+        return false;
+    x->time = t;
+    x->frame = 0;
+    this->enqueue(this->cur.i);
+    return true;
+}
+
+bool Schedule::suspend_signal(u64 s) {
+    if(!this->current())
+        return false;
+    this->enqueue_signal(this->cur.i, s);
+    return true;
 }
 
 bool Schedule::cancel(std::size_t i) {
-    return this->cancel_common(&this->v, i);
+    return this->cancel_common(&this->v, &this->free, i);
 }
 
 bool Schedule::cancel_atexit(std::size_t i) {
-    return this->cancel_common(&this->atexit_v, i);
+    return this->cancel_common(&this->atexit_v, &this->atexit_free, i);
 }
 
 bool Schedule::update(void) {
@@ -117,11 +280,29 @@ bool Schedule::update(void) {
     const auto now = this->timing->now;
     const auto cur_frame = this->timing->frame;
     const auto g = ++this->cur_gen;
-    if(!exec(&this->v, g, cur_frame, now))
-        return false;
-    for(auto &x : this->v)
-        if(x.active(g, cur_frame, now) && !x.is_heartbeat() && !x.destroy())
+    const auto n_refs =
+        this->frame_q.size() + this->time_q.size() + this->n_waiting;
+    if(n_refs > 2 * this->v.size() + 64)
+        this->compact();
+    this->due.clear();
+    std::swap(this->due, this->heartbeats);
+    this->expire(cur_frame, now);
+    std::ranges::sort(this->due, {}, &Ref::i);
+    for(const auto r : this->due) {
+        if(!this->valid(r) || !this->v[r.i].active(g, cur_frame, now))
+            continue;
+        const auto ignore = this->v[r.i].flags & Flag::IGNORE_FAILURES;
+        if(!this->call(&this->v, r.i) && !ignore)
+            return this->restore(), false;
+    }
+    for(const auto r : this->due) {
+        if(!this->valid(r))
+            continue;
+        if(this->v[r.i].is_heartbeat())
+            this->heartbeats.push_back(r);
+        else if(!this->release(&this->v, &this->free, r.i))
             return false;
+    }
     this->v.erase(
         std::find_if(
             rbegin(this->v), rend(this->v),
@@ -132,12 +313,19 @@ bool Schedule::update(void) {
 
 bool Schedule::exit(void) {
     NNGN_LOG_CONTEXT_CF(Schedule);
-    if(!exec(&this->atexit_v))
-        return false;
+    for(std::size_t i = 0; i < this->atexit_v.size(); ++i) {
+        const auto &x = this->atexit_v[i];
+        if(!x.active())
+            continue;
+        const auto ignore = x.flags & Flag::IGNORE_FAILURES;
+        if(!this->call(&this->atexit_v, i) && !ignore)
+            return false;
+    }
     const auto ret = std::all_of(
         begin(this->atexit_v), end(this->atexit_v),
         std::mem_fn(&BaseEntry::destroy));
     this->atexit_v.clear();
+    this->atexit_free.clear();
     return ret;
 }
 
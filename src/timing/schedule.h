@@ -1,7 +1,13 @@
 #ifndef NNGN_TIMING_SCHEDULE_H
 #define NNGN_TIMING_SCHEDULE_H
 
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "utils/def.h"
@@ -17,13 +23,27 @@ namespace nngn {
  * given time (\ref in, \ref at), or a combination of those (execution happens
  * at the first occurrence of either).  A separate category exists for tasks
  * that should be executed when the application terminates (\ref atexit).
+ *
+ * Tasks can also wait for a signal (\ref wait), in which case they are
+ * executed in the update following the next call to \ref signal with the same
+ * value.  While it is executing, a task can suspend itself (\ref suspend_frame,
+ * \ref suspend_at, \ref suspend_signal) instead of being destroyed after it
+ * returns, which is used to implement coroutines.
+ *
+ * Pending tasks are kept in priority queues ordered by frame and time point,
+ * so that only those which have expired are visited in each \ref update.
+ * Released slots are kept in a free list, making scheduling and cancelling
+ * independent of the number of pending tasks.
  */
 class Schedule {
 public:
     /**
      * Signature for task functions.
      * The single parameter is a pointer to the data associated with the task on
-     * construction.  \c true should be returned on success.
+     * construction.  \c true should be returned on success.  The data are
+     * copied out of the task list before the call, so the pointer remains
+     * valid if the task schedules others.  A task which cancels itself sees
+     * zeroed data after the call to \ref cancel.
      */
     using Fn = bool(*)(void*);
     enum Flag : u8 {
@@ -33,15 +53,24 @@ public:
         /** After it is triggered, execute again at every frame. */
         HEARTBEAT = 1u << 1,
     };
+    /**
+     * Opaque data associated with a task.
+     * Stored inline in each entry so that scheduling a task does not allocate.
+     * Larger objects should be allocated separately and referenced by pointer.
+     */
+    using Data = std::array<std::byte, 4 * sizeof(void*)>;
     struct Entry {
         /** The task's main function. */
         Fn f = {};
         /** Destructor for the associated data. */
         Fn dest = {};
         /** Opaque byte array associated with the task. */
-        std::vector<std::byte> data = {};
+        alignas(std::max_align_t) Data data = {};
         Flag flags = {};
     };
+    /** Copies the object representation of \p t into a \ref Data object. */
+    template<typename T>
+    static Data data(const T &t);
     void init(const Timing *t) { this->timing = t; }
     // Information
     std::size_t n(void) const { return this->v.size(); }
@@ -51,7 +80,17 @@ public:
     std::size_t frame(u64 f, Entry e);
     std::size_t in(std::chrono::milliseconds t, Entry e);
     std::size_t at(Timing::time_point t, Entry e);
+    std::size_t wait(u64 s, Entry e);
     std::size_t atexit(Entry e);
+    // Signals
+    /** Wakes all tasks waiting for \p s, returns the number of tasks. */
+    std::size_t signal(u64 s);
+    // Suspension, only valid for the task currently executing
+    bool suspend_frame(u64 f);
+    bool suspend_frames(u64 n);
+    bool suspend_in(std::chrono::milliseconds t);
+    bool suspend_at(Timing::time_point t);
+    bool suspend_signal(u64 s);
     // Cancelling
     bool cancel(std::size_t i);
     bool cancel_atexit(std::size_t i);
@@ -62,25 +101,99 @@ private:
     struct BaseEntry : Entry {
         bool active() const { return this->f; }
         bool is_heartbeat() const { return this->flags & Flag::HEARTBEAT; }
-        bool call(void);
         bool destroy(void);
     };
     struct TimeEntry : BaseEntry {
         Timing::time_point time = {};
         u64 frame = 0;
+        /** Identifies the current queue references, see \ref Ref. */
+        u64 serial = 0;
         u32 gen = {};
         bool active(u32 cur_gen, u64 cur_frame, Timing::time_point now) const;
     };
+    /**
+     * Reference to an entry from one of the queues.
+     * Cancelled or re-scheduled entries are not removed from the queues: each
+     * reference is instead checked against the entry's serial number when it
+     * is retrieved.
+     */
+    struct Ref {
+        std::size_t i = 0;
+        u64 serial = 0;
+    };
+    template<typename K>
+    struct Timer {
+        K key = {};
+        Ref ref = {};
+        bool operator>(const Timer &rhs) const { return this->key > rhs.key; }
+    };
+    static constexpr auto NO_TASK = std::numeric_limits<std::size_t>::max();
+    /** Entry being executed, see \ref call. */
+    struct Running {
+        const void *v = nullptr;
+        std::size_t i = NO_TASK;
+        Data *data = nullptr;
+    };
+    template<typename T>
+    std::size_t add(std::vector<T> *v, std::vector<std::size_t> *free_, T t);
+    /**
+     * Executes entry \p i of \p v on a copy of its data.
+     * Changes to the data are written back unless the entry is released
+     * during the call, in which case the copy is zeroed after it is destroyed.
+     */
+    template<typename T>
+    bool call(std::vector<T> *v, std::size_t i);
     template<typename T>
-    std::size_t add(std::vector<T> *v, T t);
+    bool release(
+        std::vector<T> *v, std::vector<std::size_t> *free_, std::size_t i);
     template<typename T>
-    bool cancel_common(std::vector<T> *v, std::size_t i);
+    bool cancel_common(
+        std::vector<T> *v, std::vector<std::size_t> *free_, std::size_t i);
+    std::size_t add_timer(TimeEntry e);
+    TimeEntry *current(void);
+    bool valid(Ref r) const;
+    void enqueue(std::size_t i);
+    void enqueue_signal(std::size_t i, u64 s);
+    void expire(u64 cur_frame, Timing::time_point now);
+    /** Removes references to inactive entries from the queues. */
+    void compact(void);
+    void restore(void);
     std::vector<TimeEntry> v = {};
     std::vector<BaseEntry> atexit_v = {};
+    /**
+     * Min-heaps of released indices in \ref v and \ref atexit_v.
+     * The lowest index is reused first, as if the vector were searched for the
+     * first inactive entry.
+     */
+    std::vector<std::size_t> free = {}, atexit_free = {};
+    /** Min-heap of entries waiting for a frame. */
+    std::vector<Timer<u64>> frame_q = {};
+    /** Min-heap of entries waiting for a time point. */
+    std::vector<Timer<Timing::time_point>> time_q = {};
+    /** Entries waiting for each signal. */
+    std::unordered_map<u64, std::vector<Ref>> waiting = {};
+    /** Total number of references in \ref waiting. */
+    std::size_t n_waiting = 0;
+    /** Heart beat entries which have already been triggered. */
+    std::vector<Ref> heartbeats = {};
+    /** Entries being executed in the current update. */
+    std::vector<Ref> due = {};
+    Running cur = {};
+    u64 cur_serial = 0;
     u32 cur_gen = 0;
     const Timing *timing = nullptr;
 };
 
+template<typename T>
+auto Schedule::data(const T &t) -> Data {
+    static_assert(sizeof(T) <= sizeof(Data));
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    static_assert(std::is_trivially_copyable_v<T>);
+    Data ret = {};
+    std::memcpy(ret.data(), &t, sizeof(T));
+    return ret;
+}
+
 }
 
 #endif
@@ -0,0 +1,38 @@
+#include <limits>
+
+#include "utils/log.h"
+
+#include "stats_stream.h"
+
+namespace nngn {
+
+bool StatsStream::write_header(
+    std::FILE *f, Type type, std::size_t n, u16 stride
+) {
+    NNGN_LOG_CONTEXT_CF(StatsStream);
+    if(std::numeric_limits<u32>::max() < n)
+        return Log::l() << "too many values: " << n << '\n', false;
+    const header h = {
+        .marker = MARKER,
+        .type = type,
+        .stride = stride,
+        .n = static_cast<u32>(n),
+    };
+    if(std::fwrite(&h, sizeof(h), 1, f) != 1)
+        return Log::perror("fwrite"), false;
+    return true;
+}
+
+bool StatsStream::write(
+    std::FILE *f, Type type, u16 stride, std::size_t n, const void *p
+) {
+    NNGN_LOG_CONTEXT_CF(StatsStream);
+    if(!StatsStream::write_header(f, type, n, stride))
+        return false;
+    const auto size = StatsStream::element_size(type);
+    if(n && std::fwrite(p, size, n, f) != n)
+        return Log::perror("fwrite"), false;
+    return true;
+}
+
+}
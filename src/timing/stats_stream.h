@@ -0,0 +1,93 @@
+#ifndef NNGN_TIMING_STATS_STREAM_H
+#define NNGN_TIMING_STATS_STREAM_H
+
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "utils/def.h"
+
+namespace nngn {
+
+/**
+ * Binary framing for statistics sent to external tools.
+ *
+ * Records can be freely mixed with the line-based text protocol understood by
+ * the tools: text commands always start with a printable character, while
+ * binary records start with \ref MARKER.  Each record is a \ref header
+ * followed by `n` values of the type indicated in the header, in native byte
+ * order (tools execute in the same machine).
+ *
+ * `stride` groups consecutive values (e.g. the events of each entry of a
+ * \ref StatsBase array), its interpretation is left to the receiver.
+ */
+struct StatsStream {
+    enum class Type : u8 { U64 = 1, F32 = 2 };
+    struct header {
+        u8 marker;
+        Type type;
+        u16 stride;
+        u32 n;
+    };
+    static_assert(sizeof(header) == 8);
+    static constexpr u8 MARKER = 0;
+    static constexpr std::size_t element_size(Type t);
+    /** Writes a record with the contents of \p s. */
+    static bool write(std::FILE *f, std::span<const u64> s, u16 stride = 1);
+    /** \copydoc write */
+    static bool write(std::FILE *f, std::span<const float> s, u16 stride = 1);
+    /**
+     * Writes only the header of a record.
+     * The caller must then write the \p n values.
+     */
+    static bool write_header(
+        std::FILE *f, Type type, std::size_t n, u16 stride = 1);
+    /**
+     * Decodes the record at the beginning of \p s.
+     * \return
+     *     Size of the record, or zero if \p s does not yet contain a complete
+     *     record.  `h->type` is zero if the header is invalid.
+     */
+    static std::size_t read(std::string_view s, header *h);
+private:
+    static bool write(
+        std::FILE *f, Type type, u16 stride, std::size_t n, const void *p);
+};
+
+inline constexpr std::size_t StatsStream::element_size(Type t) {
+    switch(t) {
+    case Type::U64: return sizeof(u64);
+    case Type::F32: return sizeof(float);
+    }
+    return 0;
+}
+
+inline bool StatsStream::write(
+    std::FILE *f, std::span<const u64> s, u16 stride
+) {
+    return StatsStream::write(f, Type::U64, stride, s.size(), s.data());
+}
+
+inline bool StatsStream::write(
+    std::FILE *f, std::span<const float> s, u16 stride
+) {
+    return StatsStream::write(f, Type::F32, stride, s.size(), s.data());
+}
+
+inline std::size_t StatsStream::read(std::string_view s, header *h) {
+    if(s.size() < sizeof(header))
+        return 0;
+    std::memcpy(h, s.data(), sizeof(header));
+    const auto size = StatsStream::element_size(h->type);
+    if(h->marker != MARKER || !size) {
+        h->type = {};
+        return sizeof(header);
+    }
+    const auto ret = sizeof(header) + size * h->n;
+    return ret <= s.size() ? ret : 0;
+}
+
+}
+
+#endif
@@ -0,0 +1,40 @@
+#include <algorithm>
+
+#include "timestep.h"
+
+namespace nngn {
+
+void FixedTimestep::set_step(duration d) {
+    this->m_step = d;
+    this->acc = {};
+}
+
+std::size_t FixedTimestep::update(duration dt) {
+    if(!this->enabled())
+        return 1;
+    this->acc = std::max(this->acc + dt, duration{});
+    auto n = static_cast<std::size_t>(this->acc / this->m_step);
+    if(const auto max = this->m_max_steps; n > max) {
+        this->m_dropped += n - max;
+        this->acc -= static_cast<duration::rep>(n - max) * this->m_step;
+        n = max;
+    }
+    this->acc -= static_cast<duration::rep>(n) * this->m_step;
+    return n;
+}
+
+float FixedTimestep::alpha(void) const {
+    if(!this->enabled())
+        return 1;
+    using D = std::chrono::duration<float>;
+    return D{this->acc} / D{this->m_step};
+}
+
+Timing FixedTimestep::tick(const Timing &t) const {
+    auto ret = t;
+    if(this->enabled())
+        ret.dt = this->m_step;
+    return ret;
+}
+
+}
@@ -0,0 +1,52 @@
+#ifndef NNGN_TIMING_TIMESTEP_H
+#define NNGN_TIMING_TIMESTEP_H
+
+#include <cstddef>
+
+#include "utils/def.h"
+
+#include "timing.h"
+
+namespace nngn {
+
+/**
+ * Accumulator which divides variable frame times into fixed simulation steps.
+ *
+ * Each frame, \ref update adds the frame time to the accumulator and returns
+ * the number of whole steps it contains, which should then be simulated.  The
+ * remainder is carried over to the next frame and \ref alpha can be used to
+ * interpolate between the last two simulated states.
+ *
+ * At most \ref max_steps are executed per frame so that a slow frame does not
+ * cause an ever-increasing amount of work in the following ones.  Time in
+ * excess of that is discarded and counted in \ref dropped.
+ *
+ * A step of zero (the default) disables fixed steps.
+ */
+class FixedTimestep {
+public:
+    using duration = Timing::duration;
+    static constexpr std::size_t DEFAULT_MAX_STEPS = 8;
+    bool enabled(void) const { return this->m_step.count(); }
+    duration step(void) const { return this->m_step; }
+    std::size_t max_steps(void) const { return this->m_max_steps; }
+    /** Number of steps discarded because of \ref max_steps. */
+    u64 dropped(void) const { return this->m_dropped; }
+    /** Sets the step length and resets the accumulator. */
+    void set_step(duration d);
+    void set_max_steps(std::size_t n) { this->m_max_steps = n; }
+    /** Adds \p dt to the accumulator, returns the number of steps to run. */
+    std::size_t update(duration dt);
+    /** Fraction of a step left in the accumulator, `[0, 1)`. */
+    float alpha(void) const;
+    /** \ref Timing object to be passed to each step. */
+    Timing tick(const Timing &t) const;
+private:
+    duration m_step = {}, acc = {};
+    std::size_t m_max_steps = DEFAULT_MAX_STEPS;
+    u64 m_dropped = 0;
+};
+
+}
+
+#endif
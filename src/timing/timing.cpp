@@ -52,7 +52,8 @@ float Timing::fdt_s(void) const { return fdt<s>(*this); }
 void Timing::update(void) {
     ++this->frame;
     const auto old = this->now;
-    this->now = Timing::clock::now();
+    this->now = this->fixed_dt.count()
+        ? old + this->fixed_dt : Timing::clock::now();
     this->dt = std::chrono::duration_cast<Timing::duration>(
         (this->now - old) / this->scale);
 }
@@ -25,6 +25,11 @@ struct Timing {
     u64 frame = 0;
     duration dt = duration(0);
     float scale = 1.0f;
+    /**
+     * If not zero, \ref update advances \ref now by this amount instead of
+     * sampling the clock, making the simulation independent of real time.
+     */
+    duration fixed_dt = duration(0);
     template<typename F> static duration time(F &&f);
     duration::rep now_ns(void) const;
     duration::rep now_us(void) const;
@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "utils/log.h"
+
+#include "trace.h"
+
+namespace {
+
+/**
+ * Single-producer ring buffer owned by one thread.
+ * Only the owning thread writes to \ref events and \ref head.  Readers load
+ * \ref head before and after copying events and discard those which may have
+ * been overwritten in the meantime.  Events are discarded by advancing \ref
+ * tail, so that clearing does not race with the owning thread.
+ */
+struct buffer {
+    std::array<nngn::Trace::event, nngn::Trace::BUFFER_SIZE> events = {};
+    std::atomic<nngn::u64> head = 0;
+    /** Index of the first event which has not been cleared. */
+    std::atomic<nngn::u64> tail = 0;
+    nngn::u64 tid = 0;
+    std::string name = {};
+};
+
+struct state {
+    std::mutex m = {};
+    std::vector<std::unique_ptr<buffer>> buffers = {};
+    std::unordered_set<std::string> strings = {};
+    std::vector<nngn::u64> frames =
+        std::vector<nngn::u64>(nngn::Trace::DEFAULT_FRAMES);
+    std::size_t frame_i = 0;
+};
+
+state &get_state(void) {
+    static state ret;
+    return ret;
+}
+
+thread_local buffer *thread_buffer = nullptr;
+
+buffer *get_buffer(void) {
+    if(thread_buffer)
+        return thread_buffer;
+    auto &s = get_state();
+    const std::lock_guard lock = std::lock_guard{s.m};
+    auto &ret = s.buffers.emplace_back(std::make_unique<buffer>());
+    ret->tid = s.buffers.size() - 1;
+    return thread_buffer = ret.get();
+}
+
+/** Copies the events recorded by \p b, oldest first. */
+void read(const buffer &b, std::vector<nngn::Trace::event> *v) {
+    constexpr auto n = nngn::Trace::BUFFER_SIZE;
+    const auto t = b.tail.load(std::memory_order_acquire);
+    const auto h0 = b.head.load(std::memory_order_acquire);
+    const auto b0 = std::max(t, h0 < n ? 0 : h0 - n);
+    const auto i0 = v->size();
+    for(auto i = b0; i != h0; ++i)
+        v->push_back(b.events[i % n]);
+    const auto h1 = b.head.load(std::memory_order_acquire);
+    if(const auto b1 = h1 < n ? 0 : h1 - n; b0 < b1) {
+        const auto first = static_cast<std::ptrdiff_t>(i0);
+        const auto n_lost = static_cast<std::ptrdiff_t>(std::min(b1, h0) - b0);
+        v->erase(v->begin() + first, v->begin() + first + n_lost);
+    }
+}
+
+void write_escaped(std::ostream *os, std::string_view s) {
+    for(const char c : s)
+        switch(c) {
+        case '"': case '\\': *os << '\\' << c; break;
+        case '\n': *os << "\\n"; break;
+        default:
+            if(static_cast<unsigned char>(c) >= 0x20)
+                *os << c;
+        }
+}
+
+void write_us(std::ostream *os, nngn::u64 ns) {
+    *os << ns / 1000 << '.' << std::setw(3) << std::setfill('0') << ns % 1000;
+}
+
+}
+
+namespace nngn {
+
+std::atomic_bool Trace::m_active = false;
+
+std::size_t Trace::frames(void) {
+    auto &s = get_state();
+    const std::lock_guard lock = std::lock_guard{s.m};
+    return s.frames.size();
+}
+
+void Trace::set_frames(std::size_t n) {
+    auto &s = get_state();
+    const std::lock_guard lock = std::lock_guard{s.m};
+    s.frames.assign(std::max<std::size_t>(n, 1), 0);
+    s.frame_i = 0;
+}
+
+void Trace::set_thread_name(std::string_view name) {
+    auto *const b = get_buffer();
+    const std::lock_guard lock = std::lock_guard{get_state().m};
+    b->name = name;
+}
+
+const char *Trace::intern(std::string_view s) {
+    auto &st = get_state();
+    const std::lock_guard lock = std::lock_guard{st.m};
+    return st.strings.emplace(s).first->c_str();
+}
+
+void Trace::frame(void) {
+    if(!Trace::active())
+        return;
+    auto &s = get_state();
+    const auto t = Trace::now();
+    const std::lock_guard lock = std::lock_guard{s.m};
+    s.frames[s.frame_i++ % s.frames.size()] = t;
+}
+
+void Trace::record(const char *name, u64 begin, u64 end) {
+    auto *const b = get_buffer();
+    const auto i = b->head.load(std::memory_order_relaxed);
+    b->events[i % BUFFER_SIZE] = {name, begin, end};
+    b->head.store(i + 1, std::memory_order_release);
+}
+
+void Trace::clear(void) {
+    auto &s = get_state();
+    const std::lock_guard lock = std::lock_guard{s.m};
+    for(auto &x : s.buffers)
+        x->tail.store(
+            x->head.load(std::memory_order_acquire),
+            std::memory_order_release);
+    std::ranges::fill(s.frames, 0);
+    s.frame_i = 0;
+}
+
+bool Trace::write_json(std::ostream *os) {
+    NNGN_LOG_CONTEXT_CF(Trace);
+    auto &s = get_state();
+    const std::lock_guard lock = std::lock_guard{s.m};
+    const auto n_frames = std::min(s.frame_i, s.frames.size());
+    const auto full = n_frames == s.frames.size();
+    const auto oldest = full ? s.frame_i % n_frames : 0;
+    const auto t0 = full ? s.frames[oldest] : 0;
+    std::vector<event> events = {};
+    const char *sep = "";
+    *os << R"({"displayTimeUnit":"ms","traceEvents":[)";
+    for(const auto &b : s.buffers) {
+        if(!b->name.empty()) {
+            *os << sep
+                << R"({"name":"thread_name","ph":"M","pid":0,"tid":)"
+                << b->tid << R"(,"args":{"name":")";
+            write_escaped(os, b->name);
+            *os << "\"}}";
+            sep = ",";
+        }
+        events.clear();
+        read(*b, &events);
+        for(const auto &e : events) {
+            if(e.begin < t0)
+                continue;
+            *os << sep << R"({"name":")";
+            write_escaped(os, e.name);
+            *os << R"(","ph":"X","pid":0,"tid":)" << b->tid << R"(,"ts":)";
+            write_us(os, e.begin);
+            *os << R"(,"dur":)";
+            write_us(os, e.end - e.begin);
+            *os << '}';
+            sep = ",";
+        }
+    }
+    for(std::size_t i = 0; i != n_frames; ++i) {
+        const auto t = s.frames[(oldest + i) % s.frames.size()];
+        *os << sep << R"({"name":"frame","ph":"i","s":"g","pid":0,"tid":0,)"
+            << R"("ts":)";
+        write_us(os, t);
+        *os << '}';
+        sep = ",";
+    }
+    *os << "]}\n";
+    if(!*os)
+        return Log::l() << "failed to write trace\n", false;
+    return true;
+}
+
+bool Trace::write_json(const char *path) {
+    NNGN_LOG_CONTEXT_CF(Trace);
+    std::ofstream f(path);
+    if(!f)
+        return Log::perror(path), false;
+    return Trace::write_json(&f);
+}
+
+}
@@ -0,0 +1,104 @@
+#ifndef NNGN_TIMING_TRACE_H
+#define NNGN_TIMING_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string_view>
+
+#include "utils/def.h"
+#include "utils/utils.h"
+
+#include "timing.h"
+
+#define NNGN_TRACE_ZONE(n) \
+    const auto NNGN_TRACE_ZONE_VAR(__LINE__) = nngn::Trace::zone{n};
+#define NNGN_TRACE_ZONE_VAR(l) NNGN_TRACE_ZONE_JOIN(trace_, l)
+#define NNGN_TRACE_ZONE_JOIN(x, y) x##y
+
+namespace nngn {
+
+/**
+ * Scoped-zone tracer.
+ *
+ * Zones are delimited by \ref zone objects (usually created by \ref
+ * NNGN_TRACE_ZONE) and can be arbitrarily nested.  Each thread records the
+ * zones it completes in its own fixed-size ring buffer, so that recording
+ * requires no synchronization.  Buffers are created the first time a thread
+ * records a zone and are never released.
+ *
+ * \ref frame marks the beginning of each frame.  The timestamps of the last
+ * \ref frames frames are kept and \ref write_json exports all zones contained
+ * in that window in the Chrome trace event format, which can be loaded in
+ * `chrome://tracing` or Perfetto.
+ *
+ * Recording is disabled by default.  The cost of a zone when tracing is
+ * inactive is a single relaxed atomic load.
+ */
+class Trace {
+public:
+    /** Completed zone, timestamps are in nanoseconds. */
+    struct event {
+        const char *name;
+        u64 begin, end;
+    };
+    /** Records an event for the enclosing scope if tracing is active. */
+    class zone {
+    public:
+        NNGN_NO_MOVE(zone)
+        explicit zone(const char *n) : name{n}
+            { if(Trace::active()) this->begin = Trace::now(); }
+        ~zone(void)
+            { if(this->begin) Trace::record(this->name, this->begin); }
+    private:
+        const char *name;
+        u64 begin = 0;
+    };
+    /** Number of events in each per-thread ring buffer. */
+    static constexpr std::size_t BUFFER_SIZE = 1u << 14;
+    /** Default number of frames in the export window. */
+    static constexpr std::size_t DEFAULT_FRAMES = 120;
+    static bool active(void)
+        { return Trace::m_active.load(std::memory_order_relaxed); }
+    static void set_active(bool a)
+        { Trace::m_active.store(a, std::memory_order_relaxed); }
+    static u64 now(void);
+    static std::size_t frames(void);
+    /** Resizes the frame window, discarding previous frame marks. */
+    static void set_frames(std::size_t n);
+    /** Name displayed for the calling thread. */
+    static void set_thread_name(std::string_view name);
+    /** Returns a pointer to a copy of \p s which lives until exit. */
+    static const char *intern(std::string_view s);
+    /** Marks the beginning of a frame. */
+    static void frame(void);
+    /** Adds an event which ends now to the calling thread's buffer. */
+    static void record(const char *name, u64 begin);
+    /** Adds an event to the calling thread's buffer. */
+    static void record(const char *name, u64 begin, u64 end);
+    /**
+     * Discards all recorded events and frame marks.
+     * Can be called while other threads are recording.
+     */
+    static void clear(void);
+    /** Writes the events in the frame window as a Chrome trace. */
+    static bool write_json(std::ostream *os);
+    static bool write_json(const char *path);
+private:
+    static std::atomic_bool m_active;
+};
+
+inline u64 Trace::now(void) {
+    using D = std::chrono::nanoseconds;
+    return static_cast<u64>(
+        std::chrono::duration_cast<D>(
+            Timing::clock::now().time_since_epoch()).count());
+}
+
+inline void Trace::record(const char *name, u64 begin) {
+    Trace::record(name, begin, Trace::now());
+}
+
+}
+
+#endif
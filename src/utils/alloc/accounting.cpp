@@ -0,0 +1,31 @@
+#include "accounting.h"
+
+namespace nngn {
+
+auto memory_accounting::get(memory_tag t) -> counters {
+    constexpr auto o = std::memory_order_relaxed;
+    const auto &d = memory_accounting::get_data(t);
+    return {
+        .bytes = d.bytes.load(o),
+        .peak = d.peak.load(o),
+        .n = d.n.load(o),
+        .frame_allocs = d.last_allocs.load(o),
+        .frame_bytes = d.last_bytes.load(o),
+    };
+}
+
+void memory_accounting::frame(void) {
+    constexpr auto o = std::memory_order_relaxed;
+    for(auto &x : memory_accounting::v) {
+        x.last_allocs.store(x.frame_allocs.exchange(0, o), o);
+        x.last_bytes.store(x.frame_bytes.exchange(0, o), o);
+    }
+}
+
+void memory_accounting::reset_peak(void) {
+    constexpr auto o = std::memory_order_relaxed;
+    for(auto &x : memory_accounting::v)
+        x.peak.store(x.bytes.load(o), o);
+}
+
+}
@@ -0,0 +1,116 @@
+#ifndef NNGN_UTILS_ALLOC_ACCOUNTING_H
+#define NNGN_UTILS_ALLOC_ACCOUNTING_H
+
+#include <array>
+#include <atomic>
+#include <string_view>
+#include <vector>
+
+#include "utils/def.h"
+#include "utils/utils.h"
+
+#include "tracking.h"
+
+namespace nngn {
+
+/** Subsystems for which memory is accounted, see \ref memory_accounting. */
+enum class memory_tag : u8 {
+    renderers, entities, textures, collision, terminal, vulkan, max,
+};
+
+/**
+ * Per-subsystem memory counters.
+ * Containers owned by each subsystem use \ref accounted_allocator, which
+ * reports every allocation to the counters of its \ref memory_tag.  Memory not
+ * allocated via standard allocators (e.g. device memory) can be reported
+ * directly with \ref allocate and \ref deallocate.
+ *
+ * Counters are updated atomically (but without ordering guarantees), so that
+ * containers can be used from any thread.  Allocations are also counted per
+ * frame: \ref frame closes the current frame, whose counts become available
+ * through \ref get until the next call.
+ */
+class memory_accounting {
+public:
+    struct counters {
+        /** Total size of active allocations. */
+        u64 bytes;
+        /** Maximum value of \ref bytes since the last \ref reset_peak. */
+        u64 peak;
+        /** Number of active allocations. */
+        u64 n;
+        /** Number of allocations in the last frame. */
+        u64 frame_allocs;
+        /** Total size of allocations in the last frame. */
+        u64 frame_bytes;
+    };
+    static constexpr auto n_tags = static_cast<std::size_t>(memory_tag::max);
+    /** Names for each tag, used in Lua and external tools. */
+    static constexpr std::array<std::string_view, n_tags> names = {
+        "renderers", "entities", "textures", "collision", "terminal", "vulkan",
+    };
+    static void allocate(memory_tag t, std::size_t n);
+    static void deallocate(memory_tag t, std::size_t n);
+    static counters get(memory_tag t);
+    /** Marks the end of a frame, resets per-frame counters. */
+    static void frame(void);
+    /** Sets the peak of every tag to its current size. */
+    static void reset_peak(void);
+private:
+    struct data {
+        std::atomic<u64> bytes, peak, n;
+        std::atomic<u64> frame_allocs, frame_bytes;
+        std::atomic<u64> last_allocs, last_bytes;
+    };
+    static data &get_data(memory_tag t)
+        { return memory_accounting::v[static_cast<std::size_t>(t)]; }
+    static inline std::array<data, n_tags> v = {};
+};
+
+/**
+ * \ref alloc_tracker which reports to \ref memory_accounting.
+ * Contains no state, so allocators which use it compare equal.
+ */
+template<typename T, memory_tag tag>
+struct memory_tracker {
+    using value_type = T;
+    using pointer = T*;
+    template<typename U>
+    struct rebind { using other = memory_tracker<U, tag>; };
+    memory_tracker(void) = default;
+    template<typename U>
+    explicit memory_tracker(const memory_tracker<U, tag>&) {}
+    void allocate(pointer, std::size_t n)
+        { memory_accounting::allocate(tag, n * sizeof(T)); }
+    void deallocate(pointer, std::size_t n)
+        { memory_accounting::deallocate(tag, n * sizeof(T)); }
+};
+
+template<typename T, memory_tag tag>
+using accounted_allocator = tracking_allocator<memory_tracker<T, tag>>;
+
+template<typename T, memory_tag tag>
+using accounted_vector = std::vector<T, accounted_allocator<T, tag>>;
+
+inline void memory_accounting::allocate(memory_tag t, std::size_t n) {
+    constexpr auto o = std::memory_order_relaxed;
+    auto &d = memory_accounting::get_data(t);
+    const auto b = d.bytes.fetch_add(n, o) + n;
+    for(auto p = d.peak.load(o); p < b;)
+        if(d.peak.compare_exchange_weak(p, b, o))
+            break;
+    d.n.fetch_add(1, o);
+    d.frame_allocs.fetch_add(1, o);
+    d.frame_bytes.fetch_add(n, o);
+}
+
+inline void memory_accounting::deallocate(memory_tag t, std::size_t n) {
+    constexpr auto o = std::memory_order_relaxed;
+    auto &d = memory_accounting::get_data(t);
+    d.bytes.fetch_sub(n, o);
+    d.n.fetch_sub(1, o);
+}
+
+}
+
+#endif
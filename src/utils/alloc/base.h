@@ -22,12 +22,16 @@
  *   object, similar to common `malloc(3)` implementations.
  * - \ref nngn::tracking_allocator keeps an account of the amount of memory it
  *   allocates and deallocates.
+ * - \ref nngn::pool_allocator serves small allocations from the size-class free
+ *   lists of a \ref nngn::size_class_pool.
  *
  * In addition, the following helpers are available:
  *
  * - \ref nngn::alloc_block is a simple type which can be used with some of the
  *   above or independently to allocate storage for a type and an associated
  *   header.
+ * - \ref nngn::memory_accounting keeps per-subsystem memory counters, updated
+ *   by containers which use \ref nngn::accounted_allocator.
  */
 #ifndef NNGN_UTILS_ALLOC_BASE_H
 #define NNGN_UTILS_ALLOC_BASE_H
@@ -85,6 +89,17 @@ static constexpr bool has_realloc =
         a.reallocate(p, n);
     };
 
+/**
+ * Checks whether an allocator supports memory relocation given the old size.
+ * Similar to \ref has_realloc, for allocators which cannot determine the size
+ * of an existing allocation themselves (e.g. \ref nngn::pool_allocator).
+ */
+template<typename A>
+static constexpr bool has_sized_realloc =
+    requires(A a, typename A::pointer p, std::size_t n) {
+        a.reallocate(p, n, n);
+    };
+
 /**
  * Checks whether an allocator supports typed memory allocations.
  * Allocators use this check to conditionally support this operation themselves
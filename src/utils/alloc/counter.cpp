@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <span>
+
+#include "os/platform.h"
+#include "utils/log.h"
+
+#include "counter.h"
+
+#ifdef HAVE_EXECINFO_H
+#include <execinfo.h>
+#endif
+
+using nngn::u64;
+
+namespace {
+
+struct site {
+    std::array<void*, nngn::alloc_counter::max_depth> stack;
+    std::size_t depth;
+    u64 n, bytes;
+};
+
+std::atomic_bool active = false, report = false;
+std::atomic<u64> total = 0;
+std::atomic<u64> frame_allocs = 0, frame_bytes = 0;
+std::atomic<u64> last_allocs = 0, last_bytes = 0;
+std::mutex sites_lock = {};
+std::array<site, nngn::alloc_counter::max_sites> sites = {};
+std::size_t n_sites = 0;
+/** Set while the counter itself allocates, such allocations are ignored. */
+thread_local bool internal = false;
+
+std::size_t get_stack(std::span<void*> s) {
+#ifdef HAVE_EXECINFO_H
+    return static_cast<std::size_t>(
+        ::backtrace(s.data(), static_cast<int>(s.size())));
+#else
+    return static_cast<void>(s), 0;
+#endif
+}
+
+void record_site(std::size_t n) {
+    std::array<void*, nngn::alloc_counter::max_depth> stack = {};
+    const auto depth = get_stack(stack);
+    const auto lock = std::lock_guard{sites_lock};
+    const auto b = begin(sites), e = b + static_cast<std::ptrdiff_t>(n_sites);
+    auto it = std::find_if(b, e, [&stack, depth](const auto &x) {
+        return x.depth == depth && x.stack == stack;
+    });
+    if(it == e) {
+        if(n_sites == sites.size())
+            return;
+        *it = {stack, depth, 0, 0};
+        ++n_sites;
+    }
+    ++it->n;
+    it->bytes += n;
+}
+
+void log_sites(void) {
+    NNGN_LOG_CONTEXT_CF(alloc_counter);
+    const auto lock = std::lock_guard{sites_lock};
+    auto &l = nngn::Log::l();
+    for(std::size_t i = 0; i != n_sites; ++i) {
+        const auto &x = sites[i];
+        l << x.n << " allocation(s), " << x.bytes << " byte(s):\n";
+#ifdef HAVE_EXECINFO_H
+        auto *const names =
+            backtrace_symbols(x.stack.data(), static_cast<int>(x.depth));
+        for(std::size_t j = 0; j != x.depth; ++j)
+            l << "  " << (names ? names[j] : "?") << '\n';
+        std::free(static_cast<void*>(names));
+#else
+        l << "  (call stacks not available)\n";
+#endif
+    }
+    n_sites = 0;
+}
+
+[[maybe_unused]] void *alloc(std::size_t n, std::size_t a, bool nothrow) {
+    nngn::alloc_counter::record(n);
+    n = std::max<std::size_t>(n, 1);
+    void *const ret = a <= alignof(std::max_align_t)
+        ? std::malloc(n)
+        : std::aligned_alloc(a, (n + a - 1) / a * a);
+    if(!ret && !nothrow)
+        std::abort();
+    return ret;
+}
+
+}
+
+namespace nngn {
+
+bool alloc_counter::active(void) { return ::active.load(); }
+bool alloc_counter::report(void) { return ::report.load(); }
+u64 alloc_counter::total(void) { return ::total.load(); }
+u64 alloc_counter::frame_allocs(void) { return last_allocs.load(); }
+u64 alloc_counter::frame_bytes(void) { return last_bytes.load(); }
+
+void alloc_counter::set_active(bool b) {
+    ::frame_allocs = ::frame_bytes = 0;
+    ::active = b;
+}
+
+void alloc_counter::set_report(bool b) {
+    // `backtrace` may allocate when it is first called (to load the unwinder),
+    // make sure that happens outside of the allocation functions.
+    if(b) {
+        internal = true;
+        std::array<void*, 1> tmp = {};
+        get_stack(tmp);
+        internal = false;
+    }
+    ::report = b;
+}
+
+void alloc_counter::record(std::size_t n) {
+    constexpr auto o = std::memory_order_relaxed;
+    if(internal || !::active.load(o))
+        return;
+    ::total.fetch_add(1, o);
+    ::frame_allocs.fetch_add(1, o);
+    ::frame_bytes.fetch_add(n, o);
+    if(!::report.load(o))
+        return;
+    internal = true;
+    record_site(n);
+    internal = false;
+}
+
+void alloc_counter::frame(void) {
+    constexpr auto o = std::memory_order_relaxed;
+    last_allocs.store(::frame_allocs.exchange(0, o), o);
+    last_bytes.store(::frame_bytes.exchange(0, o), o);
+    if(!::report.load(o))
+        return;
+    internal = true;
+    log_sites();
+    internal = false;
+}
+
+}
+
+#ifdef NNGN_ALLOC_COUNT
+
+void *operator new(std::size_t n) { return alloc(n, 0, false); }
+void *operator new[](std::size_t n) { return alloc(n, 0, false); }
+
+void *operator new(std::size_t n, const std::nothrow_t&) noexcept
+    { return alloc(n, 0, true); }
+void *operator new[](std::size_t n, const std::nothrow_t&) noexcept
+    { return alloc(n, 0, true); }
+
+void *operator new(std::size_t n, std::align_val_t a)
+    { return alloc(n, static_cast<std::size_t>(a), false); }
+void *operator new[](std::size_t n, std::align_val_t a)
+    { return alloc(n, static_cast<std::size_t>(a), false); }
+
+void *operator new(
+    std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept
+    { return alloc(n, static_cast<std::size_t>(a), true); }
+void *operator new[](
+    std::size_t n, std::align_val_t a, const std::nothrow_t&) noexcept
+    { return alloc(n, static_cast<std::size_t>(a), true); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+    { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept
+    { std::free(p); }
+void operator delete(void *p, const std::nothrow_t&) noexcept
+    { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t&) noexcept
+    { std::free(p); }
+void operator delete(
+    void *p, std::align_val_t, const std::nothrow_t&) noexcept
+    { std::free(p); }
+void operator delete[](
+    void *p, std::align_val_t, const std::nothrow_t&) noexcept
+    { std::free(p); }
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef NNGN_UTILS_ALLOC_COUNTER_H
+#define NNGN_UTILS_ALLOC_COUNTER_H
+
+#include <cstddef>
+
+#include "utils/def.h"
+
+namespace nngn {
+
+/**
+ * Debug counters for calls to the global allocation functions.
+ *
+ * When configured with `--enable-alloc-count`, the global `operator new` and
+ * `operator delete` (all variants) are replaced by versions which report to
+ * this class (see `Platform::alloc_count`).  Otherwise, the counters are
+ * always zero.  Allocations made directly with `malloc` (e.g. by C libraries)
+ * are not counted.
+ *
+ * Counting starts only after \ref set_active is called, so that the
+ * initialization of the program does not pollute the results.  Allocations
+ * are counted per frame: \ref frame closes the current frame, whose counts
+ * become available through \ref frame_allocs and \ref frame_bytes until the
+ * next call.  The main loop is expected to make no allocations in the steady
+ * state, so any non-zero value indicates a regression.
+ *
+ * To help locating them, \ref set_report can be used to additionally record
+ * the call stack of each allocation.  Unique call stacks are aggregated in a
+ * fixed-size table (new stacks are ignored once it is full) and logged with
+ * their counts by \ref frame.  Recording call stacks is expensive and should
+ * only be enabled for a few frames.
+ */
+class alloc_counter {
+public:
+    /** Maximum number of unique call stacks recorded in each frame. */
+    static constexpr std::size_t max_sites = 64;
+    /** Number of frames recorded for each call stack. */
+    static constexpr std::size_t max_depth = 12;
+    static bool active(void);
+    static bool report(void);
+    static void set_active(bool b);
+    static void set_report(bool b);
+    /** Number of allocations since \ref set_active was first called. */
+    static u64 total(void);
+    /** Number of allocations in the last frame. */
+    static u64 frame_allocs(void);
+    /** Total size of allocations in the last frame. */
+    static u64 frame_bytes(void);
+    /** Marks the end of a frame, logs call stacks if reporting is active. */
+    static void frame(void);
+    /** Called by the replacement allocation functions. */
+    static void record(std::size_t n);
+};
+
+}
+
+#endif
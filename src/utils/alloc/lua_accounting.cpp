@@ -0,0 +1,51 @@
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/table.h"
+
+#include "accounting.h"
+
+using nngn::memory_accounting, nngn::memory_tag;
+
+NNGN_LUA_DECLARE_USER_TYPE(memory_accounting, "Memory")
+
+namespace {
+
+memory_tag to_tag(lua_Integer t) {
+    const auto ret = nngn::narrow<std::size_t>(t);
+    assert(ret < memory_accounting::n_tags);
+    return static_cast<memory_tag>(ret);
+}
+
+std::string_view name(lua_Integer t) {
+    return memory_accounting::names[static_cast<std::size_t>(to_tag(t))];
+}
+
+auto info(lua_Integer t, nngn::lua::state_view lua) {
+    constexpr auto cast = [](auto x) { return static_cast<lua_Integer>(x); };
+    const auto c = memory_accounting::get(to_tag(t));
+    return nngn::lua::table_map(lua,
+        "bytes", cast(c.bytes),
+        "peak", cast(c.peak),
+        "n", cast(c.n),
+        "frame_allocs", cast(c.frame_allocs),
+        "frame_bytes", cast(c.frame_bytes)
+    ).release();
+}
+
+void register_memory(nngn::lua::table_view t) {
+    constexpr auto cast = [](auto x) { return static_cast<lua_Integer>(x); };
+    t["RENDERERS"] = cast(memory_tag::renderers);
+    t["ENTITIES"] = cast(memory_tag::entities);
+    t["TEXTURES"] = cast(memory_tag::textures);
+    t["COLLISION"] = cast(memory_tag::collision);
+    t["TERMINAL"] = cast(memory_tag::terminal);
+    t["VULKAN"] = cast(memory_tag::vulkan);
+    t["N_TAGS"] = cast(memory_accounting::n_tags);
+    t["name"] = name;
+    t["info"] = info;
+    t["reset_peak"] = memory_accounting::reset_peak;
+}
+
+}
+
+NNGN_LUA_PROXY(memory_accounting, register_memory)
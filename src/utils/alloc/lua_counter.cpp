@@ -0,0 +1,29 @@
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/table.h"
+
+#include "os/platform.h"
+
+#include "counter.h"
+
+using nngn::alloc_counter;
+
+NNGN_LUA_DECLARE_USER_TYPE(alloc_counter, "AllocCounter")
+
+namespace {
+
+void register_alloc_counter(nngn::lua::table_view t) {
+    static constexpr nngn::to<lua_Integer> cast = {};
+    t["ENABLED"] = nngn::Platform::alloc_count;
+    t["active"] = alloc_counter::active;
+    t["report"] = alloc_counter::report;
+    t["set_active"] = alloc_counter::set_active;
+    t["set_report"] = alloc_counter::set_report;
+    t["total"] = [] { return cast(alloc_counter::total()); };
+    t["frame_allocs"] = [] { return cast(alloc_counter::frame_allocs()); };
+    t["frame_bytes"] = [] { return cast(alloc_counter::frame_bytes()); };
+}
+
+}
+
+NNGN_LUA_PROXY(alloc_counter, register_alloc_counter)
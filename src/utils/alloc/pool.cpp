@@ -0,0 +1,56 @@
+#include "pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace nngn {
+
+size_class_pool::~size_class_pool(void) { this->clear(); }
+
+void size_class_pool::clear(void) {
+    for(auto *c = this->chunks; c;)
+        std::free(std::exchange(c, c->next));
+    this->chunks = nullptr;
+    this->free = {};
+    this->bump = {};
+    this->m_stats = {};
+}
+
+void *size_class_pool::refill(std::size_t i) noexcept {
+    const auto size = class_sizes[i];
+    auto &[b, e] = this->bump[i];
+    if(static_cast<std::size_t>(e - b) < size) {
+        auto *const c = static_cast<chunk_header*>(std::malloc(chunk_size));
+        if(!c) {
+            --this->m_stats.classes[i].n;
+            return nullptr;
+        }
+        this->chunks = new (c) chunk_header{this->chunks};
+        ++this->m_stats.chunks;
+        b = byte_cast<char*>(c) + header_size;
+        e = byte_cast<char*>(c) + chunk_size;
+    }
+    ++this->m_stats.classes[i].capacity;
+    return std::exchange(b, b + size);
+}
+
+void *size_class_pool::reallocate(void *p, std::size_t n0, std::size_t n1)
+    noexcept
+{
+    if(!p)
+        return this->allocate(n1);
+    const auto i0 = size_class_pool::class_index(n0);
+    const auto i1 = size_class_pool::class_index(n1);
+    if(i0 == i1 && i0 != no_class)
+        return p;
+    if(i0 == no_class && i1 == no_class)
+        return std::realloc(p, n1);
+    void *const ret = this->allocate(n1);
+    if(!ret)
+        return nullptr;
+    std::memcpy(ret, p, std::min(n0, n1));
+    this->deallocate(p, n0);
+    return ret;
+}
+
+}
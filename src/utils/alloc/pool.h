@@ -0,0 +1,179 @@
+#ifndef NNGN_UTILS_ALLOC_POOL_H
+#define NNGN_UTILS_ALLOC_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "utils/concepts.h"
+#include "utils/utils.h"
+
+#include "base.h"
+
+namespace nngn {
+
+/**
+ * Segregated free lists for small allocations.
+ * Requests of up to \ref max_size bytes are rounded up to one of the sizes in
+ * \ref class_sizes and served from fixed-size blocks carved out of large
+ * chunks, which are themselves allocated with `malloc(3)`.  Freed blocks are
+ * kept in a per-class free list and reused by later allocations of the same
+ * class, so that allocation and deallocation are both O(1) and never reach the
+ * system allocator in steady state.  Larger requests are forwarded to
+ * `malloc(3)`, `realloc(3)`, and `free(3)`.
+ *
+ * Size classes are tuned for the Lua VM: they are spaced more finely at the
+ * lower end, where strings, tables, closures, and up values are concentrated.
+ *
+ * Chunks are only released when the pool is destroyed.  Since the size of an
+ * allocation determines its class, the caller must provide it when a block is
+ * deallocated or reallocated (which Lua always does).
+ */
+class size_class_pool {
+public:
+    /** Size of each chunk requested from the system allocator. */
+    static constexpr std::size_t chunk_size = 64 * 1024;
+    /** Alignment of all blocks, equal to the smallest class. */
+    static constexpr std::size_t align = 16;
+    /** Block size of each class, in increasing order. */
+    static constexpr std::array<std::size_t, 16> class_sizes = {
+        16, 32, 48, 64, 80, 96, 112, 128,
+        160, 192, 224, 256, 320, 384, 448, 512,
+    };
+    static constexpr std::size_t n_classes = class_sizes.size();
+    /** Largest allocation served from the pool. */
+    static constexpr std::size_t max_size = class_sizes.back();
+    /** Sentinel returned by \ref class_index for large allocations. */
+    static constexpr std::size_t no_class = n_classes;
+    /** Statistics for a single size class. */
+    struct class_stats {
+        /** Blocks currently in use. */
+        std::size_t n;
+        /** Total blocks ever carved out of chunks. */
+        std::size_t capacity;
+    };
+    /** Aggregate statistics for the pool. */
+    struct stats {
+        std::array<class_stats, n_classes> classes;
+        /** Number of chunks requested from the system allocator. */
+        std::size_t chunks;
+        /** Number of live allocations forwarded to the system allocator. */
+        std::size_t large;
+    };
+    /** Index in \ref class_sizes of the class for \p n, or \ref no_class. */
+    static constexpr std::size_t class_index(std::size_t n);
+    size_class_pool(void) = default;
+    NNGN_NO_MOVE(size_class_pool)
+    ~size_class_pool(void);
+    const stats &get_stats(void) const { return this->m_stats; }
+    /** Allocates a block of at least \p n bytes. */
+    void *allocate(std::size_t n) noexcept;
+    /** Returns a block of \p n bytes previously allocated from the pool. */
+    void deallocate(void *p, std::size_t n) noexcept;
+    /**
+     * Resizes a block from \p n0 to \p n1 bytes.
+     * The same block is returned if both sizes map to the same class.
+     */
+    void *reallocate(void *p, std::size_t n0, std::size_t n1) noexcept;
+    /** Releases all chunks.  No blocks may be in use. */
+    void clear(void);
+private:
+    struct node { node *next; };
+    struct chunk_header { chunk_header *next; };
+    static constexpr std::size_t header_size =
+        (sizeof(chunk_header) + align - 1) / align * align;
+    static constexpr auto class_table = [] {
+        std::array<unsigned char, max_size / align + 1> ret = {};
+        for(std::size_t i = 0, c = 0; i != ret.size(); ++i) {
+            while(class_sizes[c] < i * align)
+                ++c;
+            ret[i] = static_cast<unsigned char>(c);
+        }
+        return ret;
+    }();
+    static_assert(class_sizes.front() == align);
+    static_assert(!(chunk_size % align));
+    void *refill(std::size_t i) noexcept;
+    std::array<node*, n_classes> free = {};
+    /** Unused region at the end of the current chunk of each class. */
+    std::array<std::pair<char*, char*>, n_classes> bump = {};
+    chunk_header *chunks = nullptr;
+    stats m_stats = {};
+};
+
+inline constexpr std::size_t size_class_pool::class_index(std::size_t n) {
+    if(n > max_size)
+        return no_class;
+    return class_table[(n + align - 1) / align];
+}
+
+inline void *size_class_pool::allocate(std::size_t n) noexcept {
+    const auto i = size_class_pool::class_index(n);
+    if(i == no_class) {
+        ++this->m_stats.large;
+        return std::malloc(n);
+    }
+    ++this->m_stats.classes[i].n;
+    if(auto *const ret = this->free[i]) {
+        this->free[i] = ret->next;
+        return ret;
+    }
+    return this->refill(i);
+}
+
+inline void size_class_pool::deallocate(void *p, std::size_t n) noexcept {
+    if(!p)
+        return;
+    const auto i = size_class_pool::class_index(n);
+    if(i == no_class) {
+        --this->m_stats.large;
+        return std::free(p);
+    }
+    --this->m_stats.classes[i].n;
+    this->free[i] = new (p) node{this->free[i]};
+}
+
+/**
+ * Allocator which serves allocations from a \ref nngn::size_class_pool.
+ * The pool is not owned and must outlive all allocators which refer to it.
+ * Can be nested in other allocators that provide an optional sized
+ * `reallocate` method (see \ref nngn::detail::has_sized_realloc).
+ */
+template<trivial T = char>
+struct pool_allocator : stateful_allocator<pool_allocator<T>> {
+    using value_type = T;
+    using pointer = std::add_pointer_t<value_type>;
+    pool_allocator(void) = default;
+    explicit pool_allocator(size_class_pool *p) : pool{p} {}
+    template<trivial U>
+    pool_allocator(const pool_allocator<U> &rhs) : pool{rhs.pool} {}
+    pointer allocate(std::size_t n) noexcept;
+    pointer reallocate(pointer p, std::size_t n0, std::size_t n1) noexcept;
+    void deallocate(pointer p, std::size_t n) noexcept;
+    size_class_pool *pool = nullptr;
+};
+
+template<trivial T>
+auto pool_allocator<T>::allocate(std::size_t n) noexcept -> pointer {
+    return static_cast<pointer>(this->pool->allocate(n * sizeof(T)));
+}
+
+template<trivial T>
+auto pool_allocator<T>::reallocate(pointer p, std::size_t n0, std::size_t n1)
+    noexcept -> pointer
+{
+    return static_cast<pointer>(
+        this->pool->reallocate(p, n0 * sizeof(T), n1 * sizeof(T)));
+}
+
+template<trivial T>
+void pool_allocator<T>::deallocate(pointer p, std::size_t n) noexcept {
+    this->pool->deallocate(p, n * sizeof(T));
+}
+
+}
+
+#endif
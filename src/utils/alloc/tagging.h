@@ -31,6 +31,7 @@ concept tagging_descriptor = requires(T t) {
  * in the upstream allocator `A`:
  *
  * - reallocations (see \ref nngn::reallocator)
+ * - sized reallocations (see \ref nngn::pool_allocator)
  * - typed allocations (see \ref nngn::tracking_allocator)
  *
  * \see nngn::tagging_descriptor
@@ -75,6 +76,8 @@ public:
         requires(detail::has_typed_alloc<allocator, I>);
     pointer reallocate(pointer p, std::size_t n) noexcept
         requires(detail::has_realloc<A>);
+    pointer reallocate(pointer p, std::size_t n0, std::size_t n) noexcept
+        requires(detail::has_sized_realloc<A>);
     void deallocate(pointer p, std::size_t n) noexcept;
     const allocator &get_allocator(void) const { return this->alloc; }
 private:
@@ -134,6 +137,16 @@ auto tagging_allocator<D, A>::reallocate(pointer p, std::size_t n)
     ).get();
 }
 
+template<tagging_descriptor D, typename A>
+auto tagging_allocator<D, A>::reallocate(
+    pointer p, std::size_t n0, std::size_t n
+) noexcept -> pointer requires(detail::has_sized_realloc<A>) {
+    return block_type::from_storage_ptr(
+        this->alloc.reallocate(
+            this->raw_from_ptr(p), this->alloc_size(n0), this->alloc_size(n))
+    ).get();
+}
+
 template<tagging_descriptor D, typename A>
 void tagging_allocator<D, A>::deallocate(pointer p, std::size_t n) noexcept {
     this->alloc.deallocate(this->raw_from_ptr(p), this->alloc_size(n));
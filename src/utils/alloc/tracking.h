@@ -2,6 +2,7 @@
 #define NNGN_UTILS_ALLOC_TRACKING_H
 
 #include <memory>
+#include <type_traits>
 
 #include "utils/utils.h"
 
@@ -64,6 +65,12 @@ concept alloc_tracker =
  * - \ref allocate(n, t): <tt>allocate(p, n, t)</tt>, as above but with the
  *   allocation type.
  * - \ref reallocate(p, n): <tt>reallocate(p, n)</tt>.
+ * - \ref reallocate(p, n0, n): <tt>reallocate(p, n)</tt>.
+ *
+ * If both \p T and \p A are empty types (e.g. when the tracker only updates
+ * global counters, see \ref nngn::memory_tracker), all allocators are
+ * considered equal, as with \ref nngn::stateless_allocator.  Otherwise, they
+ * are never equal, as with \ref nngn::stateful_allocator.
  *
  * \tparam T
  *     Type which contains tracking data and to which tracking operations are
@@ -72,7 +79,10 @@ concept alloc_tracker =
  */
 template<alloc_tracker T, typename A = std::allocator<typename T::value_type>>
 class tracking_allocator :
-    public stateful_allocator<tracking_allocator<T, A>>
+    public allocator_base<
+        tracking_allocator<T, A>,
+        allocator_opts{
+            .is_always_equal = std::is_empty_v<T> && std::is_empty_v<A>}>
 {
 public:
     using value_type = typename T::value_type;
@@ -96,6 +106,7 @@ public:
     tracking_allocator(void) = default;
     explicit tracking_allocator(T t) : m_tracker{std::move(t)} {}
     tracking_allocator(T t, const tracking_allocator &rhs);
+    tracking_allocator(T t, const allocator &a);
     tracking_allocator(const tracking_allocator &rhs);
     template<alloc_tracker T1, typename A1>
     tracking_allocator(const tracking_allocator<T1, A1> &rhs);
@@ -119,6 +130,14 @@ public:
             this->m_tracker.reallocate(p, n);
             return p;
         }
+    pointer reallocate(pointer p, std::size_t n0, std::size_t n) noexcept
+        requires detail::has_sized_realloc<allocator>
+        /*XXX clang*/ {
+            this->m_tracker.reallocate_pre(p, n);
+            p = this->alloc.reallocate(p, n0, n);
+            this->m_tracker.reallocate(p, n);
+            return p;
+        }
     template<typename I>
     pointer allocate(std::size_t n, I i) noexcept
         requires has_typed_alloc<I>;
@@ -131,6 +150,10 @@ template<alloc_tracker T, typename A>
 tracking_allocator<T, A>::tracking_allocator(T t, const tracking_allocator &rhs)
     : m_tracker{std::move(t)}, alloc{rhs.alloc} {}
 
+template<alloc_tracker T, typename A>
+tracking_allocator<T, A>::tracking_allocator(T t, const allocator &a)
+    : m_tracker{std::move(t)}, alloc{a} {}
+
 template<alloc_tracker T, typename A>
 tracking_allocator<T, A>::tracking_allocator(const tracking_allocator &rhs)
     : m_tracker{rhs.tracker()}, alloc{rhs.alloc} {}
@@ -3,6 +3,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include <vector>
 
 #include "utils/ranges.h"
@@ -17,12 +18,12 @@ namespace nngn {
  * vector is full results in undefined behavior, but the size can be changed
  * using \c set_capacity.
  */
-template<typename T>
-class static_vector : private std::vector<T> {
+template<typename T, typename A = std::allocator<T>>
+class static_vector : private std::vector<T, A> {
     union entry { entry *next_free; T t; std::uintptr_t align; };
     static_assert(sizeof(entry*) <= sizeof(T));
     static_assert(alignof(entry*) <= alignof(T));
-    using vector_type = std::vector<T>;
+    using vector_type = std::vector<T, A>;
     /** Pointer to the first entry in the free list. */
     entry *free_head = {};
 public:
@@ -83,33 +84,33 @@ public:
     void erase(iterator it);
 };
 
-template<typename T>
-std::size_t static_vector<T>::size(void) const {
+template<typename T, typename A>
+std::size_t static_vector<T, A>::size(void) const {
     return vector_type::size() - this->n_free();
 }
 
-template<typename T>
-bool static_vector<T>::full(void) const {
+template<typename T, typename A>
+bool static_vector<T, A>::full(void) const {
     return !this->free_head && vector_type::size() == this->capacity();
 }
 
-template<typename T>
-std::size_t static_vector<T>::n_free(void) const {
+template<typename T, typename A>
+std::size_t static_vector<T, A>::n_free(void) const {
     std::size_t ret = {};
     for(auto *p = this->free_head; p; p = p->next_free)
         ++ret;
     return ret;
 }
 
-template<typename T>
-void static_vector<T>::set_capacity(std::size_t c) {
+template<typename T, typename A>
+void static_vector<T, A>::set_capacity(std::size_t c) {
     nngn::set_capacity(static_cast<vector_type*>(this), c);
     this->free_head = {};
 }
 
-template<typename T>
+template<typename T, typename A>
 template<typename ...Ts>
-T &static_vector<T>::emplace(Ts &&...ts) {
+T &static_vector<T, A>::emplace(Ts &&...ts) {
     assert(!this->full());
     T *ret = {};
     if(entry **next = &this->free_head; *next)
@@ -119,15 +120,15 @@ T &static_vector<T>::emplace(Ts &&...ts) {
     return *ret = T(FWD(ts)...);
 }
 
-template<typename T>
-void static_vector<T>::erase(T *p) {
+template<typename T, typename A>
+void static_vector<T, A>::erase(T *p) {
     assert(&this->front() <= p);
     assert(p <= &this->back());
     return this->erase(this->begin() + (p - this->data()));
 }
 
-template<typename T>
-void static_vector<T>::erase(iterator it) {
+template<typename T, typename A>
+void static_vector<T, A>::erase(iterator it) {
     assert(this->begin() <= it);
     assert(it < this->end());
     if(&*it == &this->back())
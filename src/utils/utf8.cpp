@@ -0,0 +1,36 @@
+#include "utf8.h"
+
+using namespace std::string_view_literals;
+
+namespace {
+
+constexpr char32_t decode(std::string_view s) {
+    std::size_t n = 0;
+    return nngn::utf8::decode(s, &n);
+}
+
+constexpr std::size_t consumed(std::string_view s) {
+    std::size_t n = 0;
+    nngn::utf8::decode(s, &n);
+    return n;
+}
+
+}
+
+using nngn::utf8::REPLACEMENT;
+
+static_assert(decode("a") == U'a');
+static_assert(decode("é") == U'é');
+static_assert(decode("€") == U'€');
+static_assert(decode("\U0001f600") == U'\U0001f600');
+static_assert(consumed("\U0001f600") == 4);
+static_assert(decode("\xc0\xaf") == REPLACEMENT);
+static_assert(decode("\xe0\x80\xaf") == REPLACEMENT);
+static_assert(decode("\xed\xa0\x80") == REPLACEMENT);
+static_assert(decode("\xf4\x90\x80\x80") == REPLACEMENT);
+static_assert(decode("\xe2\x82") == REPLACEMENT);
+static_assert(consumed("\xe2\x82") == 1);
+static_assert(decode("\x80") == REPLACEMENT);
+static_assert(nngn::utf8::length("") == 0);
+static_assert(nngn::utf8::length("aé€\U0001f600") == 4);
+static_assert(nngn::utf8::length("\x80\x81"sv) == 2);
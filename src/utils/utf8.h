@@ -0,0 +1,81 @@
+#ifndef NNGN_UTILS_UTF8_H
+#define NNGN_UTILS_UTF8_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace nngn::utf8 {
+
+/** Returned by \ref decode for invalid sequences. */
+inline constexpr char32_t REPLACEMENT = 0xfffd;
+
+/** Whether \p c can only appear after the first byte of a sequence. */
+constexpr bool is_continuation(unsigned char c) { return (c & 0xc0) == 0x80; }
+
+/**
+ * Length of the sequence which starts with byte \p c.
+ * \c 0 if \p c cannot start a sequence (continuation bytes, overlong
+ * two-byte sequences, values past \c U+10FFFF).
+ */
+constexpr std::size_t seq_len(unsigned char c) {
+    return c < 0x80 ? 1
+        : c < 0xc2 ? 0
+        : c < 0xe0 ? 2
+        : c < 0xf0 ? 3
+        : c < 0xf5 ? 4
+        : 0;
+}
+
+/**
+ * Decodes the code point at the start of \p s, which must not be empty.
+ * Overlong encodings, surrogates, and truncated sequences are rejected.
+ * \param n
+ *     Set to the number of bytes consumed, always at least one, so that
+ *     decoding can resume after an invalid byte.
+ * \return Code point or \ref REPLACEMENT.
+ */
+constexpr char32_t decode(std::string_view s, std::size_t *n) {
+    const auto b = [s](std::size_t i) {
+        return static_cast<unsigned char>(s[i]);
+    };
+    *n = 1;
+    const auto len = seq_len(b(0));
+    if(!len)
+        return REPLACEMENT;
+    if(len == 1)
+        return b(0);
+    if(s.size() < len)
+        return REPLACEMENT;
+    // Valid range of the second byte, which excludes overlong encodings,
+    // surrogates, and values past U+10FFFF.
+    unsigned char lo = 0x80, hi = 0xbf;
+    switch(b(0)) {
+    case 0xe0: lo = 0xa0; break;
+    case 0xed: hi = 0x9f; break;
+    case 0xf0: lo = 0x90; break;
+    case 0xf4: hi = 0x8f; break;
+    }
+    if(b(1) < lo || hi < b(1))
+        return REPLACEMENT;
+    for(std::size_t i = 2; i != len; ++i)
+        if(!is_continuation(b(i)))
+            return REPLACEMENT;
+    constexpr unsigned char lead_mask[] = {0, 0, 0x1f, 0x0f, 0x07};
+    char32_t ret = b(0) & lead_mask[len];
+    for(std::size_t i = 1; i != len; ++i)
+        ret = ret << 6 | (b(i) & 0x3fu);
+    *n = len;
+    return ret;
+}
+
+/** Number of code points in \p s, counting each invalid byte as one. */
+constexpr std::size_t length(std::string_view s) {
+    std::size_t ret = 0;
+    for(std::size_t n = 0; !s.empty(); s.remove_prefix(n), ++ret)
+        decode(s, &n);
+    return ret;
+}
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+#include "audio/dsp.h"
+
+#include "dsp_test.h"
+
+namespace dsp = nngn::dsp;
+
+namespace {
+
+constexpr std::size_t RATE = 48000;
+constexpr double STEP = 440.0 / RATE;
+constexpr auto w = 2 * std::numbers::pi;
+
+/** Largest absolute difference between \p v and \p f(i). */
+double max_error(std::span<const float> v, auto &&f) {
+    double ret = 0;
+    for(std::size_t i = 0; i != v.size(); ++i)
+        ret = std::max(ret, std::abs(static_cast<double>(v[i]) - f(i)));
+    return ret;
+}
+
+/** Largest absolute difference between \p v and \p r. */
+double max_diff(std::span<const float> v, std::span<const float> r) {
+    return max_error(v, [r](auto i) { return static_cast<double>(r[i]); });
+}
+
+double frac(double x) { return x - std::floor(x); }
+
+}
+
+void DSPTest::sin(void) {
+    double e = 0;
+    for(float p = -4; p < 4; p += 1e-5f)
+        e = std::max(e, std::abs(
+            static_cast<double>(dsp::fast_sin(p))
+                - std::sin(w * static_cast<double>(p))));
+    QVERIFY(e < 1e-6);
+}
+
+void DSPTest::exp2_log2(void) {
+    double e = 0;
+    for(float x = -20; x < 20; x += 1e-4f) {
+        const auto r = std::exp2(static_cast<double>(x));
+        e = std::max(
+            e, std::abs(static_cast<double>(dsp::fast_exp2(x)) - r) / r);
+    }
+    QVERIFY(e < 1e-6);
+    e = 0;
+    for(float x = 1e-6f; x < 10; x *= 1.0001f)
+        e = std::max(e, std::abs(
+            static_cast<double>(dsp::fast_log2(x))
+                - std::log2(static_cast<double>(x))));
+    QVERIFY(e < 2e-6);
+}
+
+void DSPTest::sine(void) {
+    std::vector<float> v(10 * RATE), r(v.size());
+    const auto p = dsp::sine(v, 0.25, STEP);
+    QVERIFY(std::abs(p - frac(0.25 + 10 * RATE * STEP)) < 1e-9);
+    dsp::ref::sine(r, 0.25, STEP);
+    const auto f = [](auto i) {
+        return std::sin(w * (0.25 + static_cast<double>(i) * STEP));
+    };
+    const auto e = max_error(v, f);
+    QVERIFY(e < 1e-5);
+    QVERIFY(e < max_error(r, f));
+}
+
+void DSPTest::sine_phase(void) {
+    std::vector<float> v(1000), c(v.size());
+    dsp::sine(v, 0, STEP);
+    const auto s = std::span{c};
+    auto p = dsp::sine(s.subspan(0, 100), 0, STEP);
+    p = dsp::sine(s.subspan(100, 333), p, STEP);
+    dsp::sine(s.subspan(433), p, STEP);
+    QVERIFY(max_diff(v, c) < 1e-5);
+}
+
+void DSPTest::sine_fm(void) {
+    constexpr double lfo = 5.0 / RATE;
+    constexpr float beta = 4.4f;
+    std::vector<float> v(10 * RATE);
+    dsp::sine_fm(v, STEP, beta, 0.1, lfo);
+    QVERIFY(max_error(v, [](auto i) {
+        const auto t = static_cast<double>(i);
+        return std::sin(
+            w * t * STEP
+                + static_cast<double>(beta) * std::sin(w * (0.1 + t * lfo)));
+    }) < 1e-5);
+}
+
+void DSPTest::square_saw(void) {
+    constexpr double eps = 1e-4;
+    std::vector<float> sq(RATE), saw(sq.size());
+    dsp::square(sq, 0.1, STEP);
+    dsp::saw(saw, 0.1, STEP);
+    for(std::size_t i = 0; i != sq.size(); ++i) {
+        const auto p = frac(0.1 + static_cast<double>(i) * STEP);
+        if(p < eps || 1 - p < eps)
+            continue;
+        QVERIFY(std::abs(static_cast<double>(saw[i]) - (2 * p - 1)) < 1e-3);
+        if(std::abs(p - 0.5) > eps)
+            QCOMPARE(sq[i], p < 0.5 ? 1.0f : -1.0f);
+    }
+}
+
+void DSPTest::effects(void) {
+    std::vector<float> in(RATE);
+    dsp::sine(in, 0, STEP);
+    dsp::gain(in, 1.5f);
+    auto v = in, r = in;
+    const auto cmp = [&v, &r] { return max_diff(v, r) < 1e-4; };
+    dsp::over(v, 4, 0.5f);
+    dsp::ref::over(r, 4, 0.5f);
+    QVERIFY(cmp());
+    v = r = in;
+    dsp::fade(v, v.size(), 1, 0.25f);
+    dsp::ref::fade(r, r.size(), 1, 0.25f);
+    QVERIFY(cmp());
+    for(const auto e : {0.0f, 0.5f, 2.0f, 8.0f}) {
+        v = r = in;
+        dsp::exp_fade(v, 2 * v.size(), 0, 1, e);
+        dsp::ref::exp_fade(r, 2 * r.size(), 0, 1, e);
+        QVERIFY(cmp());
+        v = r = in;
+        dsp::exp_fade(v, v.size(), 1, 0, e);
+        dsp::ref::exp_fade(r, r.size(), 1, 0, e);
+        QVERIFY(cmp());
+    }
+    v = r = in;
+    dsp::trem(v, 0.5f, 5.0 / RATE, 0.75f);
+    dsp::ref::trem(r, 0.5f, 5.0 / RATE, 0.75f);
+    QVERIFY(cmp());
+}
+
+void DSPTest::normalize(void) {
+    constexpr auto inf = std::numeric_limits<float>::infinity();
+    constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+    constexpr std::array<float, 9> src = {
+        -inf, -2, -1, -0.5f, 0, 0.5f, 1, 2, inf};
+    constexpr std::array<nngn::i16, 9> exp = {
+        -32767, -32767, -32767, -16383, 0, 16383, 32767, 32767, 32767};
+    std::array<nngn::i16, 9> dst = {};
+    dsp::normalize(dst, src);
+    QCOMPARE(dst, exp);
+    const std::array<float, 1> n = {nan};
+    dsp::normalize(std::span{dst}.subspan(0, 1), n);
+    QCOMPARE(dst[0], -32767);
+}
+
+QTEST_MAIN(DSPTest)
@@ -0,0 +1,19 @@
+#ifndef NNGN_TEST_AUDIO_DSP_H
+#define NNGN_TEST_AUDIO_DSP_H
+
+#include <QTest>
+
+class DSPTest : public QObject {
+    Q_OBJECT
+private slots:
+    void sin(void);
+    void exp2_log2(void);
+    void sine(void);
+    void sine_phase(void);
+    void sine_fm(void);
+    void square_saw(void);
+    void effects(void);
+    void normalize(void);
+};
+
+#endif
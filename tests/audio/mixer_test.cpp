@@ -0,0 +1,242 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "audio/mixer.h"
+#include "audio/wav.h"
+
+#include "mixer_test.h"
+
+using namespace std::chrono_literals;
+using nngn::Mixer;
+
+namespace {
+
+constexpr std::size_t RATE = 44100;
+constexpr auto CENTER = std::numbers::sqrt2_v<float> / 2;
+
+bool fuzzy_eq(float x, float y) { return std::abs(x - y) < 1e-5f; }
+
+/** Generates an increasing sequence of samples, stops after `n`. */
+struct counter {
+    std::size_t i = 0, n = SIZE_MAX;
+    static std::size_t gen(void *p, std::span<float> s) {
+        auto &c = *static_cast<counter*>(p);
+        std::size_t ret = 0;
+        for(auto &x : s) {
+            if(c.i == c.n)
+                break;
+            x = static_cast<float>(c.i++);
+            ++ret;
+        }
+        return ret;
+    }
+};
+
+/** Records the first sample of each period, accepts `n` at a time. */
+class test_sink final : public Mixer::Sink {
+public:
+    test_sink(std::size_t *p, std::vector<float> *out) : n{p}, v{out} {}
+    NNGN_NO_MOVE(test_sink)
+    ~test_sink(void) final = default;
+    std::size_t available(void) final { return *this->n; }
+    bool write(std::span<const float> s) final {
+        return this->v->push_back(s[0]), true;
+    }
+private:
+    std::size_t *n;
+    std::vector<float> *v;
+};
+
+}
+
+void MixerTest::buffer(void) {
+    Mixer m = {};
+    QVERIFY(m.init(RATE, 4, 2));
+    const std::array<float, 6> b = {1, 1, 1, 1, 1, 1};
+    const auto v = m.add_voice(b);
+    QVERIFY(static_cast<bool>(v));
+    QVERIFY(!m.playing(v));
+    std::array<float, 4 * Mixer::CHANNELS> out = {};
+    m.mix(out);
+    for(auto x : out)
+        QCOMPARE(x, 0.0f);
+    QVERIFY(m.play(v));
+    m.mix(out);
+    for(auto x : out)
+        QVERIFY(fuzzy_eq(x, CENTER));
+    QVERIFY(m.playing(v));
+    m.mix(out);
+    for(std::size_t i = 0; i != 4; ++i)
+        QVERIFY(fuzzy_eq(out[i], CENTER));
+    for(std::size_t i = 4; i != out.size(); ++i)
+        QCOMPARE(out[i], 0.0f);
+    QVERIFY(!m.playing(v));
+}
+
+void MixerTest::loop(void) {
+    Mixer m = {};
+    QVERIFY(m.init(RATE, 4, 2));
+    const std::array<float, 3> b = {1, 2, 3};
+    const auto v = m.add_voice(b);
+    QVERIFY(m.set_voice_loop(v, true));
+    QVERIFY(m.set_voice_gain(v, 2));
+    QVERIFY(m.play(v));
+    std::array<float, 4 * Mixer::CHANNELS> out = {};
+    for(const auto e : {std::array{1, 2, 3, 1}, std::array{2, 3, 1, 2}}) {
+        m.mix(out);
+        for(std::size_t i = 0; i != e.size(); ++i) {
+            const auto x = 2 * CENTER * static_cast<float>(e[i]);
+            QVERIFY(fuzzy_eq(out[2 * i], x));
+            QVERIFY(fuzzy_eq(out[2 * i + 1], x));
+        }
+    }
+    QVERIFY(m.playing(v));
+}
+
+void MixerTest::pan(void) {
+    Mixer m = {};
+    QVERIFY(m.init(RATE, 1, 1));
+    const std::array<float, 1> b = {1};
+    const auto v = m.add_voice(b);
+    const auto check = [&m, v](nngn::vec3 p, float l, float r) {
+        std::array<float, Mixer::CHANNELS> out = {};
+        m.set_voice_pos(v, p);
+        m.play(v);
+        m.mix(out);
+        return fuzzy_eq(out[0], l) && fuzzy_eq(out[1], r);
+    };
+    QVERIFY(check({0, 0, 0}, CENTER, CENTER));
+    QVERIFY(check({0.5f, 0, 0}, 0, 1));
+    QVERIFY(check({-2, 0, 0}, 0.5f, 0));
+    QVERIFY(check({0, 4, 0}, CENTER / 4, CENTER / 4));
+    m.set_listener({0, 4, 0});
+    QVERIFY(check({0, 4, 0}, CENTER, CENTER));
+    m.set_gain(0.5f);
+    QVERIFY(check({0, 4, 0}, CENTER / 2, CENTER / 2));
+}
+
+void MixerTest::stream(void) {
+    Mixer m = {};
+    QVERIFY(m.init(RATE, 4, 2));
+    counter c = {.n = 6};
+    const auto v = m.add_voice(counter::gen, &c);
+    QVERIFY(m.play(v));
+    std::array<float, 4 * Mixer::CHANNELS> out = {};
+    m.mix(out);
+    for(std::size_t i = 0; i != 4; ++i)
+        QVERIFY(fuzzy_eq(out[2 * i], CENTER * static_cast<float>(i)));
+    m.mix(out);
+    QVERIFY(fuzzy_eq(out[0], CENTER * 4));
+    QVERIFY(fuzzy_eq(out[2], CENTER * 5));
+    QCOMPARE(out[4], 0.0f);
+    QVERIFY(!m.playing(v));
+}
+
+void MixerTest::voices(void) {
+    Mixer m = {};
+    QVERIFY(m.init(RATE, 1, 1));
+    const std::array<float, 1> b = {1};
+    QCOMPARE(m.n_voices(), 0);
+    const auto v0 = m.add_voice(b);
+    const auto v1 = m.add_voice(b);
+    const auto v2 = m.add_voice(b);
+    QCOMPARE(m.n_voices(), 3);
+    QVERIFY(m.remove_voice(v1));
+    QVERIFY(!m.remove_voice(v1));
+    QVERIFY(!m.play(v1));
+    QCOMPARE(m.n_voices(), 2);
+    const auto v3 = m.add_voice(b);
+    QVERIFY(v3 != v1);
+    QCOMPARE(m.n_voices(), 3);
+    QVERIFY(!m.play(v1));
+    QVERIFY(m.play(v3));
+    QVERIFY(!m.remove_voice(v1));
+    QVERIFY(m.remove_voice(v2));
+    QVERIFY(m.remove_voice(v3));
+    QVERIFY(m.remove_voice(v0));
+    QCOMPARE(m.n_voices(), 0);
+    QVERIFY(!m.play(v0));
+}
+
+void MixerTest::ring(void) {
+    std::size_t n = 0;
+    std::vector<float> periods = {};
+    Mixer m = {};
+    QVERIFY(m.init(RATE, 4, 3));
+    QVERIFY(m.set_sink(std::make_unique<test_sink>(&n, &periods)));
+    counter c = {};
+    m.set_listener({1, 0, 0});
+    m.play(m.add_voice(counter::gen, &c));
+    QVERIFY(m.update());
+    QVERIFY(periods.empty());
+    QCOMPARE(c.i, 12);
+    n = 2;
+    QVERIFY(m.update());
+    QCOMPARE(m.n_written(), 2);
+    QCOMPARE(c.i, 20);
+    n = 8;
+    QVERIFY(m.update());
+    QCOMPARE(m.n_written(), 5);
+    QCOMPARE(c.i, 32);
+    QCOMPARE(periods.size(), 5);
+    for(std::size_t i = 0; i != periods.size(); ++i)
+        QCOMPARE(periods[i], 4 * static_cast<float>(i));
+}
+
+void MixerTest::wav(void) {
+    constexpr std::size_t period = 8, n = 3;
+    auto *const f = std::tmpfile();
+    QVERIFY(f);
+    Mixer m = {};
+    QVERIFY(m.init(RATE, period, 1));
+    auto sink = std::make_unique<nngn::WAVSink>(f);
+    auto *const p = sink.get();
+    QVERIFY(m.set_sink(std::move(sink)));
+    const std::array<float, 1> b = {2};
+    const auto v = m.add_voice(b);
+    QVERIFY(m.set_voice_loop(v, true));
+    QVERIFY(m.set_voice_pos(v, {-1, 0, 0}));
+    QVERIFY(m.play(v));
+    for(std::size_t i = 0; i != n; ++i)
+        QVERIFY(m.update());
+    QVERIFY(p->finish());
+    constexpr auto size = n * period * Mixer::CHANNELS * sizeof(nngn::i16);
+    std::vector<std::byte> data(nngn::WAV::HEADER_SIZE + size);
+    std::rewind(f);
+    QCOMPARE(std::fread(data.data(), 1, data.size() + 1, f), data.size());
+    std::fclose(f);
+    const auto wav = nngn::WAV{data};
+    QCOMPARE(wav.channels(), Mixer::CHANNELS);
+    QCOMPARE(wav.rate(), RATE);
+    QCOMPARE(wav.bits_per_sample(), 16);
+    const auto s = nngn::byte_cast<const nngn::i16>(wav.data());
+    QCOMPARE(s.size(), n * period * Mixer::CHANNELS);
+    for(std::size_t i = 0; i != s.size(); i += 2) {
+        QCOMPARE(s[i], INT16_MAX);
+        QCOMPARE(s[i + 1], 0);
+    }
+}
+
+void MixerTest::thread(void) {
+    Mixer m = {};
+    QVERIFY(m.init(RATE, 64, 2));
+    QVERIFY(m.set_sink(std::make_unique<nngn::NullSink>(true)));
+    const std::array<float, 1> b = {1};
+    const auto v = m.add_voice(b);
+    QVERIFY(m.set_voice_loop(v, true));
+    QVERIFY(m.play(v));
+    QVERIFY(m.start_thread());
+    QVERIFY(m.running());
+    for(int i = 0; i != 1000 && m.n_written() < 4; ++i)
+        std::this_thread::sleep_for(1ms);
+    QVERIFY(m.set_voice_gain(v, 0.5f));
+    m.stop_thread();
+    QVERIFY(!m.running());
+    QVERIFY(4 <= m.n_written());
+}
+
+QTEST_MAIN(MixerTest)
@@ -0,0 +1,19 @@
+#ifndef NNGN_TEST_AUDIO_MIXER_H
+#define NNGN_TEST_AUDIO_MIXER_H
+
+#include <QTest>
+
+class MixerTest : public QObject {
+    Q_OBJECT
+private slots:
+    void buffer(void);
+    void loop(void);
+    void pan(void);
+    void stream(void);
+    void voices(void);
+    void ring(void);
+    void wav(void);
+    void thread(void);
+};
+
+#endif
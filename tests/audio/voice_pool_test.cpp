@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+#include <optional>
+
+#include "audio/voice_pool.h"
+
+#include "voice_pool_test.h"
+
+using nngn::VoicePool;
+
+void VoicePoolTest::acquire(void) {
+    VoicePool p = {};
+    p.set_capacity(3);
+    QCOMPARE(p.capacity(), 3);
+    QCOMPARE(p.size(), 0);
+    std::array<VoicePool::handle, 3> v = {};
+    for(auto &x : v)
+        QVERIFY(static_cast<bool>(x = p.acquire(0)));
+    QCOMPARE(p.size(), 3);
+    QVERIFY(p.full());
+    std::array<std::size_t, 3> i = {};
+    for(std::size_t j = 0; j != v.size(); ++j) {
+        const auto o = p.index(v[j]);
+        QVERIFY(o);
+        i[j] = *o;
+    }
+    std::ranges::sort(i);
+    QVERIFY(std::ranges::adjacent_find(i) == i.end());
+    QVERIFY(i.back() < 3);
+    QVERIFY(!p.index({}));
+}
+
+void VoicePoolTest::release(void) {
+    VoicePool p{3};
+    const auto h0 = p.acquire(0), h1 = p.acquire(0);
+    const auto i0 = *p.index(h0);
+    QVERIFY(p.release(h0));
+    QCOMPARE(p.size(), 1);
+    QVERIFY(!p.index(h0));
+    QVERIFY(!p.release(h0));
+    QVERIFY(p.index(h1));
+    const auto h2 = p.acquire(0);
+    QCOMPARE(*p.index(h2), i0);
+    QVERIFY(h2 != h0);
+    QVERIFY(!p.index(h0));
+    QVERIFY(!p.set_priority(h0, 1));
+    QVERIFY(p.set_priority(h2, 1));
+    QCOMPARE(*p.priority(h2), 1);
+}
+
+void VoicePoolTest::generation(void) {
+    VoicePool p{1};
+    auto h = p.acquire(0);
+    const auto h0 = h;
+    for(std::size_t i = 0; i != 1000; ++i) {
+        QVERIFY(p.release(h));
+        h = p.acquire(0);
+        QVERIFY(static_cast<bool>(h));
+        QVERIFY(!p.index(h0));
+    }
+    QCOMPARE(*p.index(h), 0);
+}
+
+void VoicePoolTest::steal(void) {
+    VoicePool p{3};
+    const auto h0 = p.acquire(0), h1 = p.acquire(0), h2 = p.acquire(0);
+    std::optional<std::size_t> stolen = {};
+    const auto h3 = p.acquire(0, [](auto) { return true; }, &stolen);
+    QVERIFY(static_cast<bool>(h3));
+    QVERIFY(stolen);
+    QCOMPARE(*stolen, *p.index(h3));
+    QVERIFY(!p.index(h0));
+    QVERIFY(p.index(h1));
+    QVERIFY(p.index(h2));
+    QCOMPARE(p.size(), 3);
+    stolen.reset();
+    QVERIFY(static_cast<bool>(p.acquire(0)));
+    QVERIFY(!p.index(h1));
+    QVERIFY(p.index(h2));
+}
+
+void VoicePoolTest::steal_priority(void) {
+    VoicePool p{3};
+    const auto h0 = p.acquire(2), h1 = p.acquire(1), h2 = p.acquire(2);
+    QVERIFY(!static_cast<bool>(p.acquire(0)));
+    QVERIFY(p.index(h0));
+    QVERIFY(p.index(h1));
+    QVERIFY(p.index(h2));
+    const auto h3 = p.acquire(1);
+    QVERIFY(static_cast<bool>(h3));
+    QVERIFY(!p.index(h1));
+    const auto h4 = p.acquire(3);
+    QVERIFY(static_cast<bool>(h4));
+    QVERIFY(!p.index(h3));
+    QVERIFY(p.index(h0));
+    QVERIFY(p.index(h2));
+    QVERIFY(p.set_priority(h2, 0));
+    QVERIFY(static_cast<bool>(p.acquire(1)));
+    QVERIFY(!p.index(h2));
+    QVERIFY(p.index(h0));
+}
+
+void VoicePoolTest::steal_stopped(void) {
+    VoicePool p{3};
+    const auto h0 = p.acquire(0), h1 = p.acquire(5), h2 = p.acquire(0);
+    const auto stopped = *p.index(h1);
+    const auto playing = [stopped](std::size_t i) { return i != stopped; };
+    std::optional<std::size_t> stolen = {};
+    const auto h3 = p.acquire(-1, playing, &stolen);
+    QVERIFY(static_cast<bool>(h3));
+    QCOMPARE(*stolen, stopped);
+    QVERIFY(!p.index(h1));
+    QVERIFY(p.index(h0));
+    QVERIFY(p.index(h2));
+    QVERIFY(!static_cast<bool>(p.acquire(-2)));
+}
+
+QTEST_MAIN(VoicePoolTest)
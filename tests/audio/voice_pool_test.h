@@ -0,0 +1,17 @@
+#ifndef NNGN_TEST_AUDIO_VOICE_POOL_H
+#define NNGN_TEST_AUDIO_VOICE_POOL_H
+
+#include <QTest>
+
+class VoicePoolTest : public QObject {
+    Q_OBJECT
+private slots:
+    void acquire(void);
+    void release(void);
+    void generation(void);
+    void steal(void);
+    void steal_priority(void);
+    void steal_stopped(void);
+};
+
+#endif
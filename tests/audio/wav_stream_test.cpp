@@ -0,0 +1,202 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "audio/mixer.h"
+#include "audio/wav.h"
+#include "audio/wav_stream.h"
+
+#include "wav_stream_test.h"
+
+using nngn::i16, nngn::WAV, nngn::WAVStream;
+
+namespace {
+
+constexpr std::size_t RATE = 44100;
+constexpr float SCALE = 1.0f / INT16_MAX;
+
+using file_ptr = std::unique_ptr<FILE, decltype(&std::fclose)>;
+
+/** Writes a WAV file whose `i`th sample is `i % 1000`. */
+file_ptr write_wav(std::size_t n) {
+    auto ret = file_ptr{std::tmpfile(), &std::fclose};
+    if(!ret)
+        return ret;
+    std::array<std::byte, WAV::HEADER_SIZE> h = {};
+    const auto wav = WAV{std::span{h}};
+    wav.set_size(static_cast<nngn::u32>(n * sizeof(i16)));
+    wav.set_channels(1);
+    wav.set_rate(RATE);
+    wav.fill();
+    std::fwrite(h.data(), 1, h.size(), ret.get());
+    std::array<i16, 1000> b = {};
+    std::iota(begin(b), end(b), i16{});
+    for(std::size_t i = 0; i < n; i += b.size()) {
+        const auto c = std::min(b.size(), n - i);
+        std::fwrite(b.data(), sizeof(i16), c, ret.get());
+    }
+    return ret;
+}
+
+float sample(std::size_t i) { return static_cast<float>(i % 1000) * SCALE; }
+
+/** Current resident set size, or zero if it cannot be determined. */
+std::size_t rss(void) {
+    std::ifstream f{"/proc/self/statm"};
+    std::size_t size = 0, ret = 0;
+    if(!(f >> size >> ret))
+        return 0;
+    return ret * nngn::MappedFile::page_size();
+}
+
+template<typename F>
+auto measure(F &&f) {
+    const auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::steady_clock::now() - t0;
+}
+
+}
+
+void WAVStreamTest::read(void) {
+    constexpr std::size_t n = 2500;
+    const auto f = write_wav(n);
+    QVERIFY(f);
+    WAVStream s = {};
+    QVERIFY(s.open(f.get()));
+    QCOMPARE(s.rate(), RATE);
+    QCOMPARE(s.n_samples(), n);
+    std::vector<float> v(1000);
+    for(std::size_t i = 0; i != 3; ++i) {
+        const auto r = s.read(v);
+        QCOMPARE(r, std::min<std::size_t>(v.size(), n - 1000 * i));
+        QCOMPARE(s.pos(), 1000 * i + r);
+        for(std::size_t j = 0; j != r; ++j)
+            QCOMPARE(v[j], sample(j));
+    }
+    QCOMPARE(s.read(v), 0);
+}
+
+void WAVStreamTest::seek(void) {
+    const auto f = write_wav(2000);
+    QVERIFY(f);
+    WAVStream s{1};
+    QVERIFY(s.open(f.get()));
+    std::array<float, 4> v = {};
+    QVERIFY(s.seek(1998));
+    QCOMPARE(s.read(v), 2);
+    QCOMPARE(v[0], sample(998));
+    QCOMPARE(v[1], sample(999));
+    QVERIFY(s.seek(500));
+    QCOMPARE(s.read(v), v.size());
+    QCOMPARE(v[0], sample(500));
+    QCOMPARE(v[3], sample(503));
+    QVERIFY(s.seek(2000));
+    QCOMPARE(s.read(v), 0);
+    QVERIFY(!s.seek(2001));
+    QCOMPARE(s.pos(), 2000);
+}
+
+void WAVStreamTest::invalid(void) {
+    const auto f = file_ptr{std::tmpfile(), &std::fclose};
+    QVERIFY(f);
+    WAVStream s = {};
+    QVERIFY(!s.open(f.get()));
+    std::array<std::byte, 16> b = {};
+    std::fwrite(b.data(), 1, b.size(), f.get());
+    QVERIFY(!s.open(f.get()));
+    std::array<std::byte, WAV::HEADER_SIZE> h = {};
+    std::fwrite(h.data(), 1, h.size(), f.get());
+    QVERIFY(!s.open(f.get()));
+}
+
+void WAVStreamTest::truncated(void) {
+    constexpr std::size_t n = 100;
+    const auto f = write_wav(n);
+    QVERIFY(f);
+    // Smaller than the file, but larger than the data after the header.
+    const auto size = static_cast<nngn::u32>(n * sizeof(i16) + 40);
+    QVERIFY(!std::fseek(f.get(), 40, SEEK_SET));
+    QCOMPARE(std::fwrite(&size, sizeof(size), 1, f.get()), 1);
+    QVERIFY(!std::fflush(f.get()));
+    WAVStream s = {};
+    QVERIFY(!s.open(f.get()));
+}
+
+void WAVStreamTest::mixer(void) {
+    constexpr std::size_t period = 4;
+    const auto f = write_wav(6);
+    QVERIFY(f);
+    auto s = std::make_unique<WAVStream>();
+    QVERIFY(s->open(f.get()));
+    nngn::Mixer m = {};
+    QVERIFY(m.init(RATE, period, 1));
+    m.set_listener({-1, 0, 0});
+    const auto v = m.add_voice(std::move(s));
+    QVERIFY(m.set_voice_loop(v, true));
+    QVERIFY(m.play(v));
+    std::array<float, period * nngn::Mixer::CHANNELS> out = {};
+    const auto check = [&out](std::array<std::size_t, period> e) {
+        for(std::size_t i = 0; i != period; ++i)
+            if(std::abs(out[2 * i + 1] - sample(e[i])) > 1e-6f)
+                return false;
+        return true;
+    };
+    m.mix(out);
+    QVERIFY(check({0, 1, 2, 3}));
+    m.mix(out);
+    QVERIFY(check({4, 5, 0, 1}));
+    QVERIFY(m.set_voice_loop(v, false));
+    m.mix(out);
+    QVERIFY(check({2, 3, 4, 5}));
+    m.mix(out);
+    QVERIFY(!m.playing(v));
+    QVERIFY(m.play(v));
+    m.mix(out);
+    QVERIFY(check({0, 1, 2, 3}));
+    QVERIFY(m.stop(v));
+    QVERIFY(m.play(v));
+    m.mix(out);
+    QVERIFY(check({0, 1, 2, 3}));
+}
+
+void WAVStreamTest::memory(void) {
+    if(!nngn::MappedFile::mapped() || !rss())
+        QSKIP("memory mapping or resident set size not available");
+    // ~6min, 32MiB.
+    constexpr std::size_t n = 16 * 1024 * 1024;
+    constexpr std::size_t size = WAV::HEADER_SIZE + n * sizeof(i16);
+    constexpr std::size_t read_ahead = 256 * 1024;
+    const auto f = write_wav(n);
+    QVERIFY(f);
+    // Reference: read the entire file.
+    std::vector<std::byte> v = {};
+    const auto t_read = measure([&f, &v] {
+        v.resize(size);
+        std::rewind(f.get());
+        QCOMPARE(std::fread(v.data(), 1, v.size(), f.get()), v.size());
+    });
+    v = {};
+    WAVStream s{read_ahead};
+    const auto t_open = measure([&f, &s] { QVERIFY(s.open(f.get())); });
+    QVERIFY(t_open < t_read);
+    // Stream the entire file and record the peak resident set size.
+    std::array<float, 1024> b = {};
+    const auto base = rss();
+    std::size_t peak = base;
+    for(std::size_t i = 0; s.read(b) == b.size(); ++i)
+        if(!(i % 64))
+            peak = std::max(peak, rss());
+    QCOMPARE(s.pos(), n);
+    // Only a few windows should be resident at any time.  The limit is
+    // relaxed to accommodate the shadow memory of address sanitizers, which
+    // grows with the size of the mapping.
+    QVERIFY(peak < base + size / 4);
+    QVERIFY(rss() < base + size / 4);
+}
+
+QTEST_MAIN(WAVStreamTest)
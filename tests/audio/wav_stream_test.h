@@ -0,0 +1,17 @@
+#ifndef NNGN_TEST_AUDIO_WAV_STREAM_H
+#define NNGN_TEST_AUDIO_WAV_STREAM_H
+
+#include <QTest>
+
+class WAVStreamTest : public QObject {
+    Q_OBJECT
+private slots:
+    void read(void);
+    void seek(void);
+    void invalid(void);
+    void truncated(void);
+    void mixer(void);
+    void memory(void);
+};
+
+#endif
@@ -0,0 +1,86 @@
+#include "dsp.h"
+
+#include <vector>
+
+#include "audio/dsp.h"
+
+namespace dsp = nngn::dsp;
+
+namespace {
+
+constexpr std::size_t N = NNGN_BENCH_DSP_N;
+constexpr double STEP = 440.0 / 48000;
+
+void impl_data(void) {
+    QTest::addColumn<bool>("ref");
+    QTest::newRow("scalar") << true;
+    QTest::newRow("vector") << false;
+}
+
+std::vector<float> input(void) {
+    std::vector<float> ret(N);
+    dsp::sine(ret, 0, STEP);
+    return ret;
+}
+
+}
+
+void DSPBench::sine_data(void) { impl_data(); }
+void DSPBench::sine_fm_data(void) { impl_data(); }
+void DSPBench::saw_data(void) { impl_data(); }
+void DSPBench::trem_data(void) { impl_data(); }
+void DSPBench::over_data(void) { impl_data(); }
+void DSPBench::exp_fade_data(void) { impl_data(); }
+void DSPBench::normalize_data(void) { impl_data(); }
+
+void DSPBench::sine(void) {
+    QFETCH(const bool, ref);
+    std::vector<float> v(N);
+    const auto f = ref ? dsp::ref::sine : dsp::sine;
+    QBENCHMARK { f(v, 0, STEP); }
+}
+
+void DSPBench::sine_fm(void) {
+    QFETCH(const bool, ref);
+    std::vector<float> v(N);
+    const auto f = ref ? dsp::ref::sine_fm : dsp::sine_fm;
+    QBENCHMARK { f(v, STEP, 4.4f, 0, 5.0 / 48000); }
+}
+
+void DSPBench::saw(void) {
+    QFETCH(const bool, ref);
+    std::vector<float> v(N);
+    const auto f = ref ? dsp::ref::saw : dsp::saw;
+    QBENCHMARK { f(v, 0, STEP); }
+}
+
+void DSPBench::trem(void) {
+    QFETCH(const bool, ref);
+    auto v = input();
+    const auto f = ref ? dsp::ref::trem : dsp::trem;
+    QBENCHMARK { f(v, 1, 5.0 / 48000, 0.5f); }
+}
+
+void DSPBench::over(void) {
+    QFETCH(const bool, ref);
+    auto v = input();
+    const auto f = ref ? dsp::ref::over : dsp::over;
+    QBENCHMARK { f(v, 4, 0.5f); }
+}
+
+void DSPBench::exp_fade(void) {
+    QFETCH(const bool, ref);
+    auto v = input();
+    const auto f = ref ? dsp::ref::exp_fade : dsp::exp_fade;
+    QBENCHMARK { f(v, N, 1, 0.5f, 2); }
+}
+
+void DSPBench::normalize(void) {
+    QFETCH(const bool, ref);
+    const auto v = input();
+    std::vector<nngn::i16> o(N);
+    const auto f = ref ? dsp::ref::normalize : dsp::normalize;
+    QBENCHMARK { f(o, v); }
+}
+
+QTEST_MAIN(DSPBench)
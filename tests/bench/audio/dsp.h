@@ -0,0 +1,29 @@
+#ifndef NNGN_TEST_BENCH_AUDIO_DSP_H
+#define NNGN_TEST_BENCH_AUDIO_DSP_H
+
+#ifndef NNGN_BENCH_DSP_N
+#define NNGN_BENCH_DSP_N (1u << 20)
+#endif
+
+#include <QTest>
+
+class DSPBench : public QObject {
+    Q_OBJECT
+private slots:
+    void sine_data(void);
+    void sine(void);
+    void sine_fm_data(void);
+    void sine_fm(void);
+    void saw_data(void);
+    void saw(void);
+    void trem_data(void);
+    void trem(void);
+    void over_data(void);
+    void over(void);
+    void exp_fade_data(void);
+    void exp_fade(void);
+    void normalize_data(void);
+    void normalize(void);
+};
+
+#endif
@@ -0,0 +1,15 @@
+#include "native_jobs.h"
+
+CollisionNativeJobsBench::CollisionNativeJobsBench() :
+    jobs{std::make_unique<nngn::Jobs>()}
+{
+    this->jobs->set_threads(nngn::Jobs::default_threads());
+}
+
+nngn::Colliders CollisionNativeJobsBench::make_colliders() const {
+    nngn::Colliders ret = {};
+    ret.set_backend(nngn::Colliders::native_backend(this->jobs.get()));
+    return ret;
+}
+
+QTEST_MAIN(CollisionNativeJobsBench)
@@ -0,0 +1,18 @@
+#ifndef NNGN_TEST_BENCH_COLLISION_NATIVE_JOBS_H
+#define NNGN_TEST_BENCH_COLLISION_NATIVE_JOBS_H
+
+#include <memory>
+
+#include "jobs/jobs.h"
+
+#include "collision.h"
+
+class CollisionNativeJobsBench : public CollisionBench {
+    Q_OBJECT
+    std::unique_ptr<nngn::Jobs> jobs = {};
+    nngn::Colliders make_colliders() const override;
+public:
+    CollisionNativeJobsBench();
+};
+
+#endif
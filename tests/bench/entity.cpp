@@ -3,9 +3,11 @@
 #include <algorithm>
 #include <functional>
 #include <random>
+#include <string>
 
 #include "../../src/entity.h"
 
+#include "jobs/jobs.h"
 #include "timing/timing.h"
 
 constexpr std::size_t N = 1u << 20;
@@ -50,6 +52,12 @@ bool check_alive(const Entities &es) {
     return std::all_of(es.cbegin() + 1, es.cend(), std::mem_fn(&Entity::alive));
 }
 
+void threads_data() {
+    QTest::addColumn<std::size_t>("threads");
+    for(const std::size_t n : {1u, 2u, 4u, 8u})
+        QTest::newRow(std::to_string(n).c_str()) << n;
+}
+
 }
 
 EntityBench::EntityBench() {
@@ -93,6 +101,14 @@ void EntityBench::benchmark(Entities &&es) {
     QBENCHMARK { es.update(t); }
 }
 
+void EntityBench::benchmark_jobs(Entities &&es) {
+    QFETCH(const std::size_t, threads);
+    nngn::Jobs jobs = {};
+    QVERIFY(jobs.set_threads(threads - 1));
+    es.set_jobs(&jobs);
+    this->benchmark_full(std::move(es));
+}
+
 void EntityBench::update_pos()
     { this->benchmark_full(this->gen_entities()); }
 void EntityBench::update_pos_components()
@@ -110,4 +126,11 @@ void EntityBench::update_pos_components_with_holes() {
     this->benchmark(std::move(es));
 }
 
+void EntityBench::update_pos_jobs_data() { threads_data(); }
+void EntityBench::update_pos_components_jobs_data() { threads_data(); }
+void EntityBench::update_pos_jobs()
+    { this->benchmark_jobs(this->gen_entities()); }
+void EntityBench::update_pos_components_jobs()
+    { this->benchmark_jobs(this->gen_entities_with_components()); }
+
 QTEST_MAIN(EntityBench)
@@ -25,6 +25,7 @@ class EntityBench : public QObject {
     Entities gen_entities_with_components();
     void benchmark_full(Entities &&es);
     void benchmark(Entities &&es);
+    void benchmark_jobs(Entities &&es);
 public:
     EntityBench();
 private slots:
@@ -32,6 +33,10 @@ private slots:
     void update_pos_components();
     void update_pos_with_holes();
     void update_pos_components_with_holes();
+    void update_pos_jobs_data();
+    void update_pos_jobs();
+    void update_pos_components_jobs_data();
+    void update_pos_components_jobs();
 };
 
 #endif
@@ -0,0 +1,90 @@
+#include "texture.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "graphics/texture.h"
+
+namespace {
+
+constexpr auto N = static_cast<nngn::u32>(NNGN_BENCH_TEXTURE_N);
+
+std::vector<std::string> names(std::size_t n, std::string_view prefix) {
+    std::vector<std::string> ret = {};
+    ret.reserve(n);
+    for(std::size_t i = 0; i != n; ++i)
+        ret.push_back(std::string{prefix} + std::to_string(i));
+    return ret;
+}
+
+void load_all(
+    nngn::Textures *t, const std::vector<std::string> &v,
+    std::vector<nngn::u32> *ids)
+{
+    ids->clear();
+    for(const auto &x : v)
+        ids->push_back(t->load_data(x.c_str(), nullptr));
+}
+
+void remove_all(nngn::Textures *t, const std::vector<nngn::u32> &ids) {
+    for(const auto x : ids)
+        t->remove(x);
+}
+
+}
+
+void TextureBench::load_remove(void) {
+    nngn::Textures t;
+    t.set_max(N + 1);
+    const auto v = names(N, "texture");
+    std::vector<nngn::u32> ids = {};
+    ids.reserve(N);
+    QBENCHMARK {
+        load_all(&t, v, &ids);
+        remove_all(&t, ids);
+    }
+    QCOMPARE(t.n(), 1);
+}
+
+void TextureBench::load_existing(void) {
+    nngn::Textures t;
+    t.set_max(N + 1);
+    const auto v = names(N, "texture");
+    std::vector<nngn::u32> ids = {};
+    ids.reserve(N);
+    load_all(&t, v, &ids);
+    QBENCHMARK {
+        for(const auto &x : v)
+            QVERIFY(t.load(x.c_str()));
+        remove_all(&t, ids);
+    }
+    QCOMPARE(t.n(), N + 1);
+}
+
+void TextureBench::replace(void) {
+    nngn::Textures t;
+    t.set_max(N + 1);
+    const std::vector<std::string> v[2] = {names(N, "a"), names(N, "b")};
+    std::vector<nngn::u32> ids = {};
+    ids.reserve(N);
+    std::size_t i = 0;
+    load_all(&t, v[i], &ids);
+    QBENCHMARK {
+        remove_all(&t, ids);
+        load_all(&t, v[i ^= 1], &ids);
+    }
+    QCOMPARE(t.n(), N + 1);
+}
+
+void TextureBench::n(void) {
+    nngn::Textures t;
+    t.set_max(N + 1);
+    const auto v = names(N, "texture");
+    std::vector<nngn::u32> ids = {};
+    ids.reserve(N);
+    load_all(&t, v, &ids);
+    QBENCHMARK { QCOMPARE(t.n(), N + 1); }
+}
+
+QTEST_MAIN(TextureBench)
@@ -0,0 +1,19 @@
+#ifndef NNGN_TEST_BENCH_GRAPHICS_TEXTURE_H
+#define NNGN_TEST_BENCH_GRAPHICS_TEXTURE_H
+
+#ifndef NNGN_BENCH_TEXTURE_N
+#define NNGN_BENCH_TEXTURE_N 10'000
+#endif
+
+#include <QTest>
+
+class TextureBench : public QObject {
+    Q_OBJECT
+private slots:
+    void load_remove(void);
+    void load_existing(void);
+    void replace(void);
+    void n(void);
+};
+
+#endif
@@ -0,0 +1,49 @@
+-- Compares per-entity position accessors with the bulk `Entities` API.
+-- Usage: ./nngn @tests/bench/lua/entities.lua
+dofile "src/lua/path.lua"
+
+local N <const> = 10000
+local R <const> = 32
+local SIZE <const> = 3 * N
+
+local function bench(name, f)
+    f()
+    local t <const> = Timing.time_ns(function()
+        for _ = 1, R do f() end
+    end)
+    print(string.format("%-16s %10.3f ms/iter", name, t / R / 1e6))
+end
+
+local entities <const> = nngn:entities()
+entities:set_max(N)
+local es <const> = {}
+for i = 1, N do
+    local e <const> = entities:add()
+    e:set_pos(i, 2 * i, 0)
+    es[i] = e
+end
+
+local v <const> = Compute.create_vector(Compute.SIZEOF_FLOAT * SIZE)
+
+bench("per-entity", function()
+    for i = 1, N do
+        local e <const> = es[i]
+        local x <const>, y <const>, z <const> = e:pos()
+        e:set_pos(x + 1, y, z)
+    end
+end)
+
+bench("bulk", function()
+    assert(entities:read(Entities.POS, v, 0, N))
+    assert(entities:write(Entities.POS, v, 0, N))
+end)
+
+bench("bulk+table", function()
+    assert(entities:read(Entities.POS, v, 0, N))
+    local t <const> = Compute.read_vector(v, 0, SIZE, Compute.FLOATV)
+    for i = 1, SIZE, 3 do t[i] = t[i] + 1 end
+    assert(Compute.write_vector(v, 0, {Compute.FLOATV, t}))
+    assert(entities:write(Entities.POS, v, 0, N))
+end)
+
+nngn:exit()
@@ -1,13 +1,43 @@
 #include "lua.h"
 
+#include <string>
+
 #include <lua.hpp>
 
+#include "lua/alloc.h"
+#include "lua/function.h"
+#include "lua/register.h"
+#include "lua/state.h"
+#include "lua/table.h"
 #include "utils/utils.h"
 
 namespace {
 
+struct object {
+    int i = 0;
+    int get(void) const { return this->i; }
+    void set(int j) { this->i = j; }
+    int add2(int j, int k) const { return this->i + j + k; }
+    void add3(int j, int k, int l) { this->i += j + k + l; }
+};
+
+}
+
+NNGN_LUA_DECLARE_USER_TYPE(object)
+
+namespace {
+
 constexpr int N = NNGN_BENCH_LUA_N;
 
+// Allocation-heavy script: short-lived strings, tables, and closures, with a
+// small working set that survives a few iterations.
+constexpr auto gc_script = R"(
+local t <const> = {}
+for i = 1, ... do
+    local s <const> = "s" .. i
+    t[i % 1024 + 1] = {s, {x = i, y = -i}, function() return s end}
+end)";
+
 void repeat(auto &&f) { for(int i = 0; i != N; ++i) f(); }
 void bench(auto &&f) { QBENCHMARK { repeat(FWD(f)); } }
 
@@ -26,6 +56,40 @@ void registry_access(auto *L) {
     luaL_unref(L, LUA_REGISTRYINDEX, r);
 }
 
+void gc(lua_State *L) {
+    QVERIFY(L);
+    luaL_openlibs(L);
+    QCOMPARE(luaL_loadstring(L, gc_script), LUA_OK);
+    QBENCHMARK {
+        lua_pushvalue(L, -1);
+        lua_pushinteger(L, NNGN_BENCH_LUA_GC_N);
+        if(lua_pcall(L, 1, 0, 0) != LUA_OK)
+            QFAIL(lua_tostring(L, -1));
+    }
+    lua_close(L);
+}
+
+// `f` is either a member function pointer or a `nngn::lua::method` tag.
+template<auto f>
+void method(const char *args) {
+    nngn::lua::state lua = {};
+    QVERIFY(lua.init());
+    object o = {};
+    lua.new_user_type<object>()["f"] = f;
+    lua.globals()["o"] = &o;
+    const auto script =
+        std::string{"local o <const> = o\nfor _ = 1, ... do o:f("}
+        + args + ") end";
+    QCOMPARE(luaL_loadstring(lua, script.c_str()), LUA_OK);
+    QBENCHMARK {
+        lua_pushvalue(lua, -1);
+        lua_pushinteger(lua, NNGN_BENCH_LUA_METHOD_N);
+        if(lua_pcall(lua, 1, 0, 0) != LUA_OK)
+            QFAIL(lua_tostring(lua, -1));
+    }
+    lua_pop(lua, 1);
+}
+
 }
 
 void LuaBench::initTestCase(void) { this->L = luaL_newstate(); }
@@ -97,4 +161,37 @@ void LuaBench::push_global(void) {
     lua_setglobal(L, "x");
 }
 
+void LuaBench::gc_malloc(void) { ::gc(luaL_newstate()); }
+
+void LuaBench::gc_alloc(void) {
+    nngn::lua::alloc_info info = {};
+    ::gc(lua_newstate(nngn::lua::alloc_info::lua_alloc, &info));
+}
+
+void LuaBench::gc_pool(void) {
+    nngn::lua::alloc_info info = {};
+    ::gc(lua_newstate(nngn::lua::alloc_info::lua_alloc_pool, &info));
+}
+
+void LuaBench::method0(void) { ::method<&object::get>(""); }
+void LuaBench::method1(void) { ::method<&object::set>("1"); }
+void LuaBench::method2(void) { ::method<&object::add2>("1, 2"); }
+void LuaBench::method3(void) { ::method<&object::add3>("1, 2, 3"); }
+
+void LuaBench::method0_compiled(void) {
+    ::method<nngn::lua::method<&object::get>>("");
+}
+
+void LuaBench::method1_compiled(void) {
+    ::method<nngn::lua::method<&object::set>>("1");
+}
+
+void LuaBench::method2_compiled(void) {
+    ::method<nngn::lua::method<&object::add2>>("1, 2");
+}
+
+void LuaBench::method3_compiled(void) {
+    ::method<nngn::lua::method<&object::add3>>("1, 2, 3");
+}
+
 QTEST_MAIN(LuaBench)
@@ -7,6 +7,14 @@
 #define NNGN_BENCH_LUA_N (1'000'000 - 5 - 1)
 #endif
 
+#ifndef NNGN_BENCH_LUA_GC_N
+#define NNGN_BENCH_LUA_GC_N 100'000
+#endif
+
+#ifndef NNGN_BENCH_LUA_METHOD_N
+#define NNGN_BENCH_LUA_METHOD_N 1'000'000
+#endif
+
 #include <QTest>
 
 struct lua_State;
@@ -25,6 +33,17 @@ private slots:
     void push_stack(void);
     void push_registry(void);
     void push_global(void);
+    void gc_malloc(void);
+    void gc_alloc(void);
+    void gc_pool(void);
+    void method0(void);
+    void method0_compiled(void);
+    void method1(void);
+    void method1_compiled(void);
+    void method2(void);
+    void method2_compiled(void);
+    void method3(void);
+    void method3_compiled(void);
 };
 
 #endif
@@ -0,0 +1,89 @@
+#include "schedule.h"
+
+#include <chrono>
+
+#include "timing/schedule.h"
+#include "timing/timing.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr std::size_t N = NNGN_BENCH_SCHEDULE_N;
+
+bool nop(void*) { return true; }
+
+}
+
+void ScheduleBench::update_empty(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    QBENCHMARK { QVERIFY(s.update()); }
+}
+
+void ScheduleBench::update_pending(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    for(std::size_t i = 0; i != N / 2; ++i) {
+        s.in(1h, {nop});
+        s.frame(~nngn::u64{}, {nop});
+    }
+    QBENCHMARK { QVERIFY(s.update()); }
+    QCOMPARE(s.n(), N);
+}
+
+void ScheduleBench::update_expired(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    QBENCHMARK {
+        for(std::size_t i = 0; i != N; ++i)
+            s.frame(t.frame + 1, {nop});
+        ++t.frame;
+        QVERIFY(s.update());
+    }
+    QCOMPARE(s.n(), 0);
+}
+
+void ScheduleBench::update_heartbeat(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    for(std::size_t i = 0; i != N; ++i)
+        s.next({nop, nullptr, {}, nngn::Schedule::Flag::HEARTBEAT});
+    QBENCHMARK { QVERIFY(s.update()); }
+    QCOMPARE(s.n(), N);
+}
+
+void ScheduleBench::add_cancel(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    for(std::size_t i = 0; i != N; ++i)
+        s.in(1h, {nop});
+    QBENCHMARK {
+        for(std::size_t i = 0; i != N; i += 2)
+            QVERIFY(s.cancel(i));
+        for(std::size_t i = 0; i != N; i += 2)
+            s.in(1h, {nop});
+    }
+    QCOMPARE(s.n(), N);
+}
+
+void ScheduleBench::signal(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    QBENCHMARK {
+        for(std::size_t i = 0; i != N; ++i)
+            s.wait(i % 16, {nop});
+        for(nngn::u64 i = 0; i != 16; ++i)
+            s.signal(i);
+        QVERIFY(s.update());
+    }
+    QCOMPARE(s.n(), 0);
+}
+
+QTEST_MAIN(ScheduleBench)
@@ -0,0 +1,21 @@
+#ifndef NNGN_TEST_BENCH_TIMING_SCHEDULE_H
+#define NNGN_TEST_BENCH_TIMING_SCHEDULE_H
+
+#ifndef NNGN_BENCH_SCHEDULE_N
+#define NNGN_BENCH_SCHEDULE_N 10'000
+#endif
+
+#include <QTest>
+
+class ScheduleBench : public QObject {
+    Q_OBJECT
+private slots:
+    void update_empty(void);
+    void update_pending(void);
+    void update_expired(void);
+    void update_heartbeat(void);
+    void add_cancel(void);
+    void signal(void);
+};
+
+#endif
@@ -1,7 +1,77 @@
 #include "native_test.h"
 
+#include <random>
+
+#include "jobs/jobs.h"
+#include "timing/timing.h"
+
+#include "tests/tests.h"
+
+namespace {
+
+void gen(nngn::Colliders *c, std::size_t n) {
+    constexpr nngn::vec2 bl = {-.5f, -.5f}, tr = {.5f, .5f};
+    auto gen = std::mt19937{};
+    auto pos_dist = std::uniform_real_distribution<float>{0, 16};
+    auto rot_dist = std::uniform_real_distribution<float>{-1, 1};
+    const auto pos = [&gen, &pos_dist]
+        { return nngn::vec2{pos_dist(gen), pos_dist(gen)}; };
+    for(std::size_t i = 0; i != n; ++i) {
+        const auto p0 = pos(), p1 = pos();
+        c->add(nngn::AABBCollider{p0 + bl, p0 + tr});
+        c->add(nngn::BBCollider{
+            p1 + bl, p1 + tr, rot_dist(gen), rot_dist(gen)});
+        c->add(nngn::SphereCollider{{pos(), 0}, .5f});
+    }
+}
+
+}
+
 NativeTest::NativeTest() {
     this->colliders.set_backend(nngn::Colliders::native_backend());
 }
 
+void NativeTest::jobs_data() {
+    QTest::addColumn<std::size_t>("max");
+    QTest::newRow("all") << (std::size_t{1} << 20);
+    QTest::newRow("overflow") << std::size_t{1000};
+}
+
+void NativeTest::jobs() {
+    constexpr std::size_t n = 512;
+    QFETCH(const std::size_t, max);
+    const auto flags = [](const auto &v) {
+        std::vector<nngn::Collider::Flag> ret = {};
+        for(const auto &x : v)
+            ret.push_back(x.flags);
+        return ret;
+    };
+    auto &c = this->colliders;
+    c.clear();
+    QVERIFY(c.set_max_colliders(n));
+    QVERIFY(c.set_max_collisions(max));
+    gen(&c, n);
+    QVERIFY(c.check_collisions(nngn::Timing{}));
+    const auto v0 = c.collisions();
+    const auto aabb = flags(c.aabb()), bb = flags(c.bb());
+    const auto sphere = flags(c.sphere());
+    QVERIFY(!v0.empty());
+    nngn::Jobs jobs = {};
+    QVERIFY(jobs.set_threads(3));
+    QVERIFY(c.set_backend(nngn::Colliders::native_backend(&jobs)));
+    QVERIFY(c.check_collisions(nngn::Timing{}));
+    const auto &v1 = c.collisions();
+    QCOMPARE(v1.size(), v0.size());
+    for(std::size_t i = 0; i != v0.size(); ++i) {
+        QCOMPARE(v1[i].force, v0[i].force);
+        QVERIFY(v1[i].flags0 == v0[i].flags0);
+        QVERIFY(v1[i].flags1 == v0[i].flags1);
+    }
+    QVERIFY(flags(c.aabb()) == aabb);
+    QVERIFY(flags(c.bb()) == bb);
+    QVERIFY(flags(c.sphere()) == sphere);
+    QVERIFY(c.set_backend(nngn::Colliders::native_backend()));
+    c.clear();
+}
+
 QTEST_MAIN(NativeTest)
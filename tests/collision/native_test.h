@@ -8,6 +8,9 @@ class NativeTest : public CollisionTest {
 public:
     NativeTest();
     ~NativeTest() { this->colliders.set_backend(nullptr); }
+private slots:
+    void jobs_data();
+    void jobs();
 };
 
 #endif
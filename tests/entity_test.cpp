@@ -5,6 +5,9 @@
 #include "entity.h"
 
 #include "collision/colliders.h"
+#include "jobs/jobs.h"
+#include "render/light.h"
+#include "render/renderers.h"
 #include "timing/timing.h"
 
 #include "tests/tests.h"
@@ -110,4 +113,163 @@ void EntityTest::parent() {
     QCOMPARE(c.pos, parent_pos + child_pos);
 }
 
+void EntityTest::bulk_read() {
+    using C = Entities::Component;
+    Entities es = {};
+    es.set_max(4);
+    nngn::SpriteRenderer r = {};
+    r.z_off = 8;
+    for(float i = 0; i != 4; ++i)
+        es.add()->set_pos({i, 2 * i, 3 * i});
+    es.begin()[1].set_renderer(&r);
+    es.remove(&es.begin()[2]);
+    std::vector<float> v(8, -1.0f);
+    QVERIFY(es.read(C::POS, 1, 2, 4, v));
+    QCOMPARE(v, (std::vector<float>{1, 2, 3, -1, 0, 0, 0, -1}));
+    QVERIFY(es.read(C::RENDERER_Z_OFF, 0, 3, 1, v));
+    QCOMPARE(v, (std::vector<float>{0, 8, 0, -1, 0, 0, 0, -1}));
+}
+
+void EntityTest::bulk_write() {
+    using C = Entities::Component;
+    Entities es = {};
+    es.set_max(3);
+    nngn::Collider c = {};
+    nngn::Light l = {};
+    for(int i = 0; i != 3; ++i)
+        es.add();
+    auto *const e0 = &es.begin()[0], *const e1 = &es.begin()[1];
+    e0->set_collider(&c);
+    e1->set_light(&l);
+    l.updated = false;
+    const std::vector<float> v = {1, 2, 3, 4, 5, 6, 7, 8};
+    QVERIFY(es.write(C::POS, 0, 2, 4, v));
+    QCOMPARE(e0->p, (nngn::vec3{1, 2, 3}));
+    QCOMPARE(e1->p, (nngn::vec3{5, 6, 7}));
+    QCOMPARE(c.pos, e0->p);
+    QVERIFY(e0->pos_updated());
+    QVERIFY(es.write(C::VEL, 0, 1, 3, v));
+    QCOMPARE(e0->v, (nngn::vec3{1, 2, 3}));
+    QCOMPARE(c.vel, e0->v);
+    QVERIFY(es.write(C::LIGHT_COLOR, 0, 2, 4, v));
+    QCOMPARE(l.color, (nngn::vec4{5, 6, 7, 8}));
+    QVERIFY(l.updated);
+    QVERIFY(es.write(C::MAX_VEL, 1, 2, 1, v));
+    QCOMPARE(e1->max_v, 1.0f);
+    QCOMPARE(es.begin()[2].max_v, 2.0f);
+}
+
+void EntityTest::bulk_idx() {
+    using C = Entities::Component;
+    Entities es = {};
+    es.set_max(4);
+    for(int i = 0; i != 4; ++i)
+        es.add();
+    const std::vector<u32> idx = {3, 1};
+    const std::vector<float> src = {1, 2, 3, 4, 5, 6};
+    QVERIFY(es.write(C::ACC, idx, 3, src));
+    QCOMPARE(es.begin()[3].a, (nngn::vec3{1, 2, 3}));
+    QCOMPARE(es.begin()[1].a, (nngn::vec3{4, 5, 6}));
+    QCOMPARE(es.begin()[0].a, (nngn::vec3{}));
+    std::vector<float> dst(6);
+    QVERIFY(es.read(C::ACC, std::vector<u32>{1, 3}, 3, dst));
+    QCOMPARE(dst, (std::vector<float>{4, 5, 6, 1, 2, 3}));
+}
+
+void EntityTest::bulk_invalid() {
+    using C = Entities::Component;
+    Entities es = {};
+    es.set_max(2);
+    es.add();
+    es.add();
+    std::vector<float> v(6);
+    QVERIFY(!es.read(C::POS, 0, 2, 2, v));
+    QVERIFY(!es.read(C::POS, 0, 3, 3, v));
+    QVERIFY(!es.read(C::POS, 1, 2, 3, v));
+    QVERIFY(!es.read(C::LIGHT_COLOR, 0, 2, 4, v));
+    QVERIFY(!es.write(C::POS, std::vector<u32>{0, 2}, 3, v));
+    QVERIFY(es.write(C::POS, 0, 0, 3, {}));
+}
+
+void EntityTest::interpolate() {
+    Entities es = {};
+    es.set_max(3);
+    nngn::SpriteRenderer r0 = {}, r1 = {}, r2 = {};
+    auto &e0 = *es.add(), &e1 = *es.add();
+    e0.set_renderer(&r0);
+    e1.set_renderer(&r1);
+    e1.set_pos({1, 0, 0});
+    es.save_positions();
+    e0.move({2, 4, 0});
+    es.interpolate(0.25f);
+    QCOMPARE(r0.pos, (nngn::vec3{0.5f, 1, 0}));
+    QCOMPARE(r1.pos, (nngn::vec3{1, 0, 0}));
+    auto &e2 = *es.add();
+    e2.set_renderer(&r2);
+    e2.set_pos({3, 0, 0});
+    e2.set_parent(&e0);
+    es.interpolate(0.5f);
+    QCOMPARE(r0.pos, (nngn::vec3{1, 2, 0}));
+    QCOMPARE(r2.pos, (nngn::vec3{4, 2, 0}));
+    es.save_positions();
+    QCOMPARE(r0.pos, (nngn::vec3{2, 4, 0}));
+    QCOMPARE(r2.pos, (nngn::vec3{5, 4, 0}));
+    es.interpolate(0.5f);
+    QCOMPARE(r0.pos, (nngn::vec3{2, 4, 0}));
+    QCOMPARE(r2.pos, (nngn::vec3{5, 4, 0}));
+    e0.set_pos({-2, 0, 0});
+    es.update_children();
+    QCOMPARE(r0.pos, (nngn::vec3{-2, 0, 0}));
+    QCOMPARE(r2.pos, (nngn::vec3{1, 0, 0}));
+    es.interpolate(0.5f);
+    QCOMPARE(r0.pos, (nngn::vec3{-2, 0, 0}));
+    QCOMPARE(r2.pos, (nngn::vec3{1, 0, 0}));
+    es.save_positions();
+    e0.move({0, 0, 0});
+    es.interpolate(0.5f);
+    QCOMPARE(r0.pos, (nngn::vec3{-1, 0, 0}));
+    QCOMPARE(r2.pos, (nngn::vec3{2, 0, 0}));
+    es.stop_interpolation();
+    QCOMPARE(r0.pos, (nngn::vec3{0, 0, 0}));
+    QCOMPARE(r2.pos, (nngn::vec3{3, 0, 0}));
+}
+
+void EntityTest::update_jobs() {
+    constexpr std::size_t n = 3 * Entities::UPDATE_GRAIN + 1;
+    nngn::Timing t = {};
+    t.dt = std::chrono::milliseconds{16};
+    nngn::Jobs jobs = {};
+    QVERIFY(jobs.set_threads(3));
+    std::array<Entities, 2> es = {};
+    std::array<std::vector<nngn::SpriteRenderer>, 2> rs = {};
+    for(std::size_t k = 0; k != 2; ++k) {
+        auto &e = es[k];
+        e.set_max(n);
+        rs[k].resize(n);
+        for(std::size_t i = 0; i != n; ++i) {
+            const auto f = static_cast<float>(i);
+            auto *const x = e.add();
+            x->set_renderer(&rs[k][i]);
+            x->set_pos({f, 2 * f, 0});
+            x->set_vel({1, f, 0});
+            x->a = {f, 0, 1};
+            x->max_v = static_cast<float>(i % 3);
+            if(i % 5 == 1)
+                x->set_parent(&e.begin()[static_cast<std::ptrdiff_t>(i - 1)]);
+        }
+    }
+    es[1].set_jobs(&jobs);
+    for(auto &x : es) {
+        x.update(t);
+        x.update_children();
+    }
+    for(std::size_t i = 0; i != n; ++i) {
+        const auto &e0 = es[0].begin()[static_cast<std::ptrdiff_t>(i)];
+        const auto &e1 = es[1].begin()[static_cast<std::ptrdiff_t>(i)];
+        QCOMPARE(e1.p, e0.p);
+        QCOMPARE(e1.v, e0.v);
+        QCOMPARE(rs[1][i].pos, rs[0][i].pos);
+    }
+}
+
 QTEST_MAIN(EntityTest)
@@ -11,6 +11,12 @@ private slots:
     void add_remove();
     void parent_data();
     void parent();
+    void bulk_read();
+    void bulk_write();
+    void bulk_idx();
+    void bulk_invalid();
+    void interpolate();
+    void update_jobs();
 };
 
 #endif
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "font/atlas.h"
+
+#include "atlas_test.h"
+
+using nngn::GlyphAtlas, nngn::u32, nngn::uvec2;
+
+Q_DECLARE_METATYPE(nngn::uvec2)
+
+void AtlasTest::insert() {
+    GlyphAtlas a{16};
+    QCOMPARE(a.extent(), 16u);
+    QCOMPARE(a.size(), 0);
+    QCOMPARE(a.occupancy(), 0.0f);
+    const auto s0 = a.insert(U'a', {3, 3}, nullptr);
+    const auto s1 = a.insert(U'b', {3, 2}, nullptr);
+    QVERIFY(s0);
+    QVERIFY(s1);
+    QVERIFY(s0 != s1);
+    QCOMPARE(a.size(), 2);
+    QCOMPARE(a.pos(s0), uvec2(0, 0));
+    QCOMPARE(a.pos(s1), uvec2(4, 0));
+    QCOMPARE(a.occupancy(), 15.0f / 256.0f);
+}
+
+void AtlasTest::shelves() {
+    GlyphAtlas a{16};
+    const auto s0 = a.insert(U'a', {7, 3}, nullptr);
+    const auto s1 = a.insert(U'b', {7, 7}, nullptr);
+    const auto s2 = a.insert(U'c', {3, 2}, nullptr);
+    const auto s3 = a.insert(U'd', {7, 3}, nullptr);
+    QCOMPARE(a.pos(s0), uvec2(0, 0));
+    QCOMPARE(a.pos(s1), uvec2(0, 4));
+    QCOMPARE(a.pos(s2), uvec2(8, 0));
+    QCOMPARE(a.pos(s3), uvec2(8, 4));
+}
+
+void AtlasTest::remove() {
+    GlyphAtlas a{16};
+    const auto s0 = a.insert(U'a', {3, 3}, nullptr);
+    const auto s1 = a.insert(U'b', {3, 3}, nullptr);
+    a.insert(U'c', {3, 3}, nullptr);
+    a.remove(s0);
+    a.remove(s1);
+    QCOMPARE(a.size(), 1);
+    const auto s3 = a.insert(U'd', {7, 3}, nullptr);
+    QCOMPARE(a.pos(s3), uvec2(0, 0));
+    const auto s4 = a.insert(U'e', {3, 3}, nullptr);
+    QCOMPARE(a.pos(s4), uvec2(12, 0));
+    QCOMPARE(a.n_evicted(), 0);
+}
+
+void AtlasTest::evict() {
+    GlyphAtlas a{8};
+    std::array<u32, 4> v = {};
+    for(u32 i = 0; i != v.size(); ++i) {
+        v[i] = a.insert(U'a' + i, {3, 3}, nullptr);
+        QVERIFY(v[i]);
+        a.next_frame();
+    }
+    a.touch(v[0]);
+    a.next_frame();
+    std::vector<char32_t> evicted = {};
+    const auto s = a.insert(U'e', {3, 3}, &evicted);
+    QVERIFY(s);
+    QCOMPARE(evicted.size(), 1);
+    QCOMPARE(evicted[0], U'b');
+    QCOMPARE(a.pos(s), uvec2(4, 0));
+    QCOMPARE(a.n_evicted(), 1);
+    QCOMPARE(a.size(), 4);
+}
+
+void AtlasTest::evict_frame() {
+    GlyphAtlas a{8};
+    for(u32 i = 0; i != 4; ++i)
+        QVERIFY(a.insert(U'a' + i, {3, 3}, nullptr));
+    std::vector<char32_t> evicted = {};
+    QVERIFY(!a.insert(U'e', {3, 3}, &evicted));
+    QVERIFY(evicted.empty());
+    a.next_frame();
+    QVERIFY(a.insert(U'e', {3, 3}, &evicted));
+    QCOMPARE(evicted.size(), 1);
+}
+
+void AtlasTest::too_large() {
+    GlyphAtlas a{8};
+    QVERIFY(a.fits({7, 7}));
+    QVERIFY(!a.fits({8, 1}));
+    QVERIFY(!a.insert(U'a', {8, 1}, nullptr));
+    QVERIFY(a.insert(U'a', {7, 7}, nullptr));
+}
+
+void AtlasTest::dirty() {
+    GlyphAtlas a{16};
+    QVERIFY(a.dirty().empty());
+    a.insert(U'a', {3, 3}, nullptr);
+    a.insert(U'b', {2, 1}, nullptr);
+    QCOMPARE(a.dirty().size(), 1);
+    QCOMPARE(a.dirty()[0].pos, uvec2(0, 0));
+    QCOMPARE(a.dirty()[0].size, uvec2(7, 4));
+    a.insert(U'c', {3, 6}, nullptr);
+    QCOMPARE(a.dirty().size(), 2);
+    QCOMPARE(a.dirty()[1].pos, uvec2(0, 4));
+    QCOMPARE(a.dirty()[1].size, uvec2(4, 8));
+    a.clear_dirty();
+    QVERIFY(a.dirty().empty());
+}
+
+void AtlasTest::write() {
+    GlyphAtlas a{8};
+    const auto s = a.insert(U'a', {2, 2}, nullptr);
+    QVERIFY(a.insert(U'b', {1, 1}, nullptr));
+    constexpr std::array<std::byte, 6> src = {
+        std::byte{1}, std::byte{2}, std::byte{9},
+        std::byte{3}, std::byte{4}, std::byte{9},
+    };
+    a.write(s, src.data(), 3);
+    const auto d = a.data();
+    QCOMPARE(d.size(), 64);
+    QCOMPARE(d[0], std::byte{1});
+    QCOMPARE(d[1], std::byte{2});
+    QCOMPARE(d[2], std::byte{});
+    QCOMPARE(d[8], std::byte{3});
+    QCOMPARE(d[9], std::byte{4});
+    QCOMPARE(d[16], std::byte{});
+    QVERIFY(std::all_of(d.begin() + 10, d.begin() + 16,
+        [](auto x) { return x == std::byte{}; }));
+}
+
+QTEST_MAIN(AtlasTest)
@@ -0,0 +1,19 @@
+#ifndef NNGN_TEST_ATLAS_H
+#define NNGN_TEST_ATLAS_H
+
+#include <QTest>
+
+class AtlasTest : public QObject {
+    Q_OBJECT
+private slots:
+    void insert();
+    void shelves();
+    void remove();
+    void evict();
+    void evict_frame();
+    void too_large();
+    void dirty();
+    void write();
+};
+
+#endif
@@ -31,12 +31,23 @@ void FontTest::from_file() {
     nngn::Fonts fs;
     QVERIFY(fs.init());
     QVERIFY(fs.load(64, path.data()));
-    const auto *f = fs.fonts() + 1;
-    QCOMPARE(f->chars.size(), 128);
-    const auto &c = f->chars['f'];
+    auto *f = fs.fonts() + 1;
+    QVERIFY(f->chars.empty());
+    const auto &c = f->glyph('f');
+    QCOMPARE(f->chars.size(), 1);
+    QCOMPARE(f->n_rasterized, 1);
     QCOMPARE(c.size, nngn::uvec2(23, 49));
     QCOMPARE(c.bearing, nngn::ivec2(1, 0));
     QCOMPARE(c.advance, 23.0f);
+    QVERIFY(c.slot);
+    QCOMPARE(f->atlas.size(), 1);
+    f->glyph('f');
+    QCOMPARE(f->n_rasterized, 1);
+    const auto &e = f->glyph(U'\u00e9');
+    QVERIFY(e.slot);
+    QVERIFY(e.advance);
+    QCOMPARE(f->n_rasterized, 2);
+    QCOMPARE(f->atlas.size(), 2);
 }
 
 void FontTest::from_file_err() {
@@ -49,4 +60,23 @@ void FontTest::from_file_err() {
         "Fonts::load: FT_New_Face(/dev/null): unknown file format\n");
 }
 
+void FontTest::atlas_full() {
+    const auto path = find_font();
+    QVERIFY(path[0]);
+    nngn::Fonts fs;
+    QVERIFY(fs.init());
+    QVERIFY(fs.load(1024, path.data()));
+    auto *f = fs.fonts() + 1;
+    char32_t c = 'A';
+    while(c <= 'Z' && f->glyph(c).slot)
+        ++c;
+    QVERIFY(c <= 'Z');
+    const auto n = f->n_rasterized;
+    QVERIFY(!f->glyph(c).slot);
+    QCOMPARE(f->n_rasterized, n);
+    QVERIFY(fs.update());
+    QVERIFY(f->glyph(c).slot);
+    QCOMPARE(f->n_rasterized, n + 1);
+}
+
 QTEST_MAIN(FontTest)
@@ -8,6 +8,7 @@ class FontTest : public QObject {
 private slots:
     void from_file();
     void from_file_err();
+    void atlas_full();
 };
 
 #endif
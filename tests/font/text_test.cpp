@@ -11,6 +11,7 @@ static nngn::Font gen_font() {
     font.chars['t'].advance = 2.0f;
     font.chars['e'].advance = 3.0f;
     font.chars['s'].advance = 5.0f;
+    font.chars[U'\u00e9'].advance = 7.0f;
     return font;
 }
 
@@ -80,4 +81,38 @@ void TextTest::size() {
     QCOMPARE(text.size, size);
 }
 
+void TextTest::utf8() {
+    nngn::Font font = gen_font();
+    const std::string_view str = "t\u00e9\x80s\nt\u00e9";
+    QCOMPARE(nngn::Text::max_width(font, str, 1), 2.0f);
+    QCOMPARE(nngn::Text::max_width(font, str, 3), 9.0f);
+    QCOMPARE(nngn::Text::max_width(font, str, 5), 14.0f);
+    QCOMPARE(nngn::Text::max_width(font, str, str.size()), 14.0f);
+    QCOMPARE(nngn::Text(font, str).nlines, 2u);
+}
+
+void TextTest::layout() {
+    nngn::Font font = gen_font();
+    const std::string_view str = "te\x81st\ns\u00e9";
+    nngn::Text text(font, str, 0);
+    QCOMPARE(text.glyphs.size(), 6);
+    QCOMPARE(text.lines.size(), 2);
+    QCOMPARE(text.lines[1].begin, 6u);
+    QCOMPARE(text.lines[1].max_width, 12.0f);
+    const auto &g = text.glyphs;
+    QCOMPARE(g[2].c, U's');
+    QCOMPARE(g[2].x, 5.0f);
+    QCOMPARE(g[2].cmd, 0x81);
+    QCOMPARE(g[2].end, 4u);
+    QCOMPARE(g[4].line, 1u);
+    QCOMPARE(g[5].col, 1u);
+    QCOMPARE(g[5].c, U'\u00e9');
+    QCOMPARE(g[5].end, str.size());
+    for(std::size_t i = 0; i <= str.size(); ++i) {
+        text.update_cur(font, i);
+        QCOMPARE(text.size.x, nngn::Text::max_width(font, str, i));
+        QCOMPARE(text.nlines, nngn::Text::count_lines(str, i));
+    }
+}
+
 QTEST_MAIN(TextTest)
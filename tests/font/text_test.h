@@ -13,6 +13,8 @@ private slots:
     void size_zero();
     void size_data();
     void size();
+    void utf8();
+    void layout();
 };
 
 #endif
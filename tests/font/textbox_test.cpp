@@ -20,11 +20,12 @@ void TextboxTest::update() {
     nngn::Fonts fonts;
     nngn::Font font;
     font.size = 32;
-    fonts.add(font);
+    const auto i = fonts.add(std::move(font));
+    auto &f = fonts.fonts()[i];
     nngn::Textbox b;
     b.init(&fonts);
     b.speed = 100ms;
-    b.str = nngn::Text(font, "0123456789", 0);
+    b.str = nngn::Text(f, "0123456789", 0);
     t.dt = 100ms;
     b.update(t);
     QCOMPARE(b.timer.count(), dt(0ms));
@@ -44,4 +45,57 @@ void TextboxTest::update() {
     QCOMPARE(b.str.cur, 10ul);
 }
 
+void TextboxTest::update_utf8() {
+    nngn::Timing t;
+    nngn::Fonts fonts;
+    nngn::Font font;
+    font.size = 32;
+    fonts.add(std::move(font));
+    nngn::Textbox b;
+    b.init(&fonts);
+    b.speed = 100ms;
+    b.set_text("a\u00e9\x81\u20acb");
+    QCOMPARE(b.text_length(), 0);
+    t.dt = 100ms;
+    b.update(t);
+    QCOMPARE(b.str.cur, 1ul);
+    b.update(t);
+    QCOMPARE(b.str.cur, 3ul);
+    b.update(t);
+    QCOMPARE(b.str.cur, 7ul);
+    b.update(t);
+    QCOMPARE(b.str.cur, 8ul);
+    QCOMPARE(b.text_length(), 4);
+}
+
+void TextboxTest::appended() {
+    nngn::Timing t;
+    nngn::Fonts fonts;
+    nngn::Font font;
+    font.size = 32;
+    fonts.add(std::move(font));
+    nngn::Textbox b;
+    b.init(&fonts);
+    b.speed = 100ms;
+    b.set_text("ab\ncd");
+    QVERIFY(b.updated());
+    QVERIFY(!b.appended());
+    b.clear_updated();
+    t.dt = 100ms;
+    for(std::size_t i = 1; i != 3; ++i) {
+        QVERIFY(b.update(t));
+        QCOMPARE(b.str.cur, i);
+        QVERIFY(b.appended());
+        b.clear_updated();
+    }
+    QVERIFY(b.update(t));
+    QCOMPARE(b.str.cur, 4ul);
+    QVERIFY(b.updated());
+    QVERIFY(!b.appended());
+    b.clear_updated();
+    t.dt = 50ms;
+    QVERIFY(!b.update(t));
+    QVERIFY(!b.updated());
+}
+
 QTEST_MAIN(TextboxTest)
@@ -8,6 +8,8 @@ class TextboxTest : public QObject {
 private slots:
     void constructor();
     void update();
+    void update_utf8();
+    void appended();
 };
 
 #endif
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "graphics/pseudo.h"
+#include "graphics/texture.h"
+#include "graphics/texture_atlas.h"
+#include "utils/log.h"
+
+#include "texture_atlas_test.h"
+
+using nngn::u32, nngn::uvec2;
+
+namespace {
+
+constexpr auto EXTENT = nngn::Graphics::TEXTURE_EXTENT;
+
+struct Graphics : public nngn::Pseudograph {
+    std::vector<u32> uploads = {};
+    std::vector<std::vector<std::byte>> data = {};
+    bool load_textures(u32 i, u32 n, const std::byte *p) override {
+        const auto s = std::size_t{n} * nngn::Graphics::TEXTURE_SIZE;
+        if(this->data.size() <= i)
+            this->data.resize(i + 1);
+        this->uploads.push_back(i);
+        this->data[i].assign(p, p + s);
+        return true;
+    }
+};
+
+std::vector<std::byte> image(uvec2 size, unsigned char v) {
+    return std::vector(
+        std::size_t{4} * size.x * size.y, static_cast<std::byte>(v));
+}
+
+std::byte pixel(std::span<const std::byte> v, uvec2 p) {
+    return v[4 * (std::size_t{p.y} * EXTENT + p.x)];
+}
+
+}
+
+void TextureAtlasTest::load() {
+    nngn::Textures t;
+    t.set_max(4);
+    nngn::TextureAtlas a;
+    a.set_textures(&t);
+    const auto i0 = a.load_data("0", {32, 16}, image({32, 16}, 1).data());
+    const auto i1 = a.load_data("1", {8, 8}, image({8, 8}, 2).data());
+    QCOMPARE(i0, 1u);
+    QCOMPARE(i1, 2u);
+    QCOMPARE(a.n(), 2);
+    QCOMPARE(a.n_layers(), 1);
+    QCOMPARE(t.n(), 2);
+    QCOMPARE(a.tex(i0), 1u);
+    QCOMPARE(a.tex(i1), 1u);
+    QCOMPARE(a.rect(i0).pos, (uvec2{0, 0}));
+    QCOMPARE(a.rect(i0).size, (uvec2{32, 16}));
+    QCOMPARE(a.rect(i1).pos, (uvec2{32 + nngn::TextureAtlas::PADDING, 0}));
+    const auto uv = a.uv(i0);
+    const auto e = static_cast<float>(EXTENT);
+    QCOMPARE(uv[0], (nngn::vec2{0, 1}));
+    QCOMPARE(uv[1], (nngn::vec2{32 / e, 1 - 16 / e}));
+}
+
+void TextureAtlasTest::cache() {
+    nngn::Textures t;
+    t.set_max(4);
+    nngn::TextureAtlas a;
+    a.set_textures(&t);
+    const auto v = image({8, 8}, 1);
+    const auto i = a.load_data("0", {8, 8}, v.data());
+    QVERIFY(i);
+    const auto s = nngn::Log::capture([&a, &v, i]
+        { QCOMPARE(a.load_data("0", {8, 8}, v.data()), i); });
+    QCOMPARE(
+        s.c_str(),
+        "TextureAtlas::load_data: 0: already loaded, ignoring data\n");
+    QCOMPARE(a.n(), 1);
+    a.remove(i);
+    QCOMPARE(a.n(), 1);
+    a.remove(i);
+    QCOMPARE(a.n(), 0);
+}
+
+void TextureAtlasTest::remove() {
+    nngn::Textures t;
+    t.set_max(4);
+    nngn::TextureAtlas a;
+    a.set_textures(&t);
+    const auto v = image({8, 8}, 1);
+    const auto i0 = a.load_data("0", {8, 8}, v.data());
+    const auto i1 = a.load_data("1", {8, 8}, v.data());
+    a.remove(i0);
+    QCOMPARE(a.n(), 1);
+    QCOMPARE(a.n_layers(), 1);
+    QCOMPARE(t.n(), 2);
+    const auto i2 = a.load_data("2", {8, 8}, v.data());
+    QCOMPARE(i2, i0);
+    QCOMPARE(a.rect(i2).pos, (uvec2{0, 0}));
+    const auto i3 = a.load_data("0", {8, 8}, v.data());
+    QVERIFY(i3 != i0);
+    a.remove(i3);
+    nngn::Log::capture([&a, i2, &v]
+        { QCOMPARE(a.load_data("2", {8, 8}, v.data()), i2); });
+    a.remove(i2);
+    a.remove(i1);
+    a.remove(i2);
+    QCOMPARE(a.n(), 0);
+    QCOMPARE(a.n_layers(), 0);
+    QCOMPARE(t.n(), 1);
+}
+
+void TextureAtlasTest::invalid() {
+    nngn::Textures t;
+    t.set_max(4);
+    nngn::TextureAtlas a;
+    a.set_textures(&t);
+    const auto v = image({1, 1}, 1);
+    const auto s = nngn::Log::capture([&a, &v] {
+        QCOMPARE(a.load_data("0", {0, 1}, v.data()), 0u);
+        QCOMPARE(a.load_data("1", {EXTENT + 1, 1}, v.data()), 0u);
+    });
+    const auto cmp =
+        "TextureAtlas::load_data: 0: invalid size: 0x1\n"
+        "TextureAtlas::load_data: 1: invalid size: "
+        + std::to_string(EXTENT + 1) + "x1\n";
+    QCOMPARE(s.c_str(), cmp.c_str());
+    QCOMPARE(a.n(), 0);
+    QCOMPARE(t.n(), 1);
+}
+
+void TextureAtlasTest::max() {
+    nngn::Textures t;
+    t.set_max(3);
+    nngn::TextureAtlas a;
+    a.set_textures(&t);
+    const auto v = image({EXTENT, EXTENT}, 1);
+    QVERIFY(a.load_data("0", {EXTENT, EXTENT}, v.data()));
+    QVERIFY(a.load_data("1", {EXTENT, EXTENT}, v.data()));
+    QCOMPARE(a.n_layers(), 2);
+    const auto s = nngn::Log::capture([&a, &v]
+        { QCOMPARE(a.load_data("2", {EXTENT, EXTENT}, v.data()), 0u); });
+    QCOMPARE(
+        s.c_str(),
+        "TextureAtlas::load_data: 2: Textures::load_data: atlas/2: "
+        "cannot load more textures (max = 3)\n");
+    QCOMPARE(a.n(), 2);
+    QCOMPARE(a.n_layers(), 2);
+}
+
+void TextureAtlasTest::update() {
+    Graphics g;
+    nngn::Textures t;
+    t.set_max(4);
+    t.set_graphics(&g);
+    nngn::TextureAtlas a;
+    a.set_textures(&t);
+    const auto i0 = a.load_data("0", {4, 4}, image({4, 4}, 1).data());
+    const auto i1 = a.load_data("1", {4, 4}, image({4, 4}, 2).data());
+    QVERIFY(g.uploads.empty());
+    QVERIFY(a.update());
+    QCOMPARE(g.uploads, (std::vector<u32>{1}));
+    QVERIFY(a.update());
+    QCOMPARE(g.uploads.size(), 1);
+    const auto &d = g.data[1];
+    const auto p0 = a.rect(i0).pos, p1 = a.rect(i1).pos;
+    QCOMPARE(pixel(d, p0), std::byte{1});
+    QCOMPARE(pixel(d, p0 + 3u), std::byte{1});
+    QCOMPARE(pixel(d, p0 + 4u), std::byte{});
+    QCOMPARE(pixel(d, p1), std::byte{2});
+    QCOMPARE(pixel(d, p1 + 3u), std::byte{2});
+}
+
+void TextureAtlasTest::repack() {
+    constexpr u32 n = 64, side = 100;
+    Graphics g;
+    nngn::Textures t;
+    t.set_max(n);
+    t.set_graphics(&g);
+    nngn::TextureAtlas a;
+    a.set_textures(&t);
+    std::vector<u32> v = {};
+    for(u32 i = 0; i != n; ++i) {
+        const auto name = std::to_string(i);
+        // Alternate heights so that each shelf is only partially used.
+        const uvec2 size = {side, i % 2 ? side / 2 : side};
+        const auto img = image(size, static_cast<unsigned char>(i));
+        v.push_back(a.load_data(name.c_str(), size, img.data()));
+        QVERIFY(v.back());
+    }
+    const auto n_layers = a.n_layers();
+    for(u32 i = 0; i != n; i += 2)
+        a.remove(v[i]);
+    QCOMPARE(a.n_layers(), n_layers);
+    const auto occupancy = a.occupancy();
+    const auto gen = a.generation();
+    QVERIFY(a.repack());
+    QCOMPARE(a.generation(), gen + 1);
+    QVERIFY(a.n_layers() < n_layers);
+    QVERIFY(occupancy < a.occupancy());
+    QCOMPARE(t.n(), a.n_layers() + 1);
+    QVERIFY(a.update());
+    for(u32 i = 1; i < n; i += 2) {
+        const auto r = a.rect(v[i]);
+        const auto &d = g.data[a.tex(v[i])];
+        const auto c = static_cast<std::byte>(i);
+        QCOMPARE(pixel(d, r.pos), c);
+        QCOMPARE(pixel(d, r.pos + r.size - 1u), c);
+    }
+}
+
+QTEST_MAIN(TextureAtlasTest)
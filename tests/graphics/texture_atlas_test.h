@@ -0,0 +1,18 @@
+#ifndef NNGN_TEST_TEXTURE_ATLAS_H
+#define NNGN_TEST_TEXTURE_ATLAS_H
+
+#include <QTest>
+
+class TextureAtlasTest : public QObject {
+    Q_OBJECT
+private slots:
+    void load();
+    void cache();
+    void remove();
+    void invalid();
+    void max();
+    void update();
+    void repack();
+};
+
+#endif
@@ -1,4 +1,9 @@
+#include <chrono>
+#include <fstream>
 #include <iomanip>
+#include <thread>
+
+#include <QTemporaryDir>
 
 #include "graphics/pseudo.h"
 #include "graphics/texture.h"
@@ -8,7 +13,7 @@
 
 struct TextureTestGraphics : public nngn::Pseudograph {
     bool called = false;
-    std::uint32_t i = 0, n = 0;
+    std::uint32_t i = 0, n = 0, n_calls = 0;
     const std::byte *p = nullptr;
     std::vector<std::byte> d = {};
     bool load_textures(std::uint32_t, std::uint32_t, const std::byte*) override;
@@ -18,6 +23,7 @@ bool TextureTestGraphics::load_textures(
     std::uint32_t i_, std::uint32_t n_, const std::byte *p_
 ) {
     this->called = true;
+    ++this->n_calls;
     this->i = i_;
     this->n = n_;
     this->p = p_;
@@ -210,4 +216,282 @@ void TextureTest::remove() {
     QCOMPARE(id2, id0);
 }
 
+void TextureTest::reuse() {
+    TextureTestGraphics g;
+    nngn::Textures t;
+    t.set_max(4);
+    t.set_graphics(&g);
+    const auto a = t.load_data("a", this->data);
+    const auto b = t.load_data("b", this->data);
+    QCOMPARE(a, 1);
+    QCOMPARE(b, 2);
+    t.remove(a);
+    QCOMPARE(t.n(), 2);
+    g.called = false;
+    QCOMPARE(t.load_data("a", this->data), a);
+    QVERIFY(!g.called);
+    QCOMPARE(t.n(), 3);
+    t.remove(b);
+    QCOMPARE(t.n(), 2);
+    QCOMPARE(t.load_data("c", this->data), b);
+    QVERIFY(g.called);
+    QCOMPARE(g.i, b);
+    QCOMPARE(t.load_data("b", this->data), 3);
+    QCOMPARE(t.n(), 4);
+    const auto gen = t.generation();
+    t.remove(a);
+    QCOMPARE(t.generation(), gen + 1);
+    t.set_max(8);
+    QCOMPARE(t.n(), 3);
+    QCOMPARE(t.load_data("d", this->data), a);
+    QCOMPARE(t.load_data("e", this->data), 4);
+}
+
+void TextureTest::collision() {
+    struct Colliding : nngn::Textures {
+        Colliding(void) {
+            this->set_hash([](std::span<const char>) { return nngn::Hash{}; });
+        }
+    };
+    TextureTestGraphics g;
+    Colliding t;
+    t.set_max(3);
+    t.set_graphics(&g);
+    const auto a = t.load_data("a", this->data);
+    QCOMPARE(a, 1);
+    g.called = false;
+    const auto b = t.load_data("b", this->data);
+    QCOMPARE(b, 2);
+    QVERIFY(g.called);
+    QCOMPARE(t.load("a"), a);
+    QCOMPARE(t.load("b"), b);
+    QCOMPARE(t.n(), 3);
+}
+
+void TextureTest::load_async_data() {
+    QTest::addColumn<std::size_t>("threads");
+    QTest::newRow("sync") << std::size_t{0};
+    QTest::newRow("threads") << std::size_t{2};
+}
+
+void TextureTest::load_async() {
+    QFETCH(std::size_t, threads);
+    TextureTestGraphics g;
+    nngn::Textures t;
+    t.set_max(2);
+    t.set_graphics(&g);
+    QVERIFY(t.set_decode_threads(threads));
+    std::vector<std::uint32_t> ids = {};
+    const auto f = [&ids](auto i) { ids.push_back(i); return true; };
+    QCOMPARE(t.load_async(this->data_file.c_str(), f), 0u);
+    QCOMPARE(t.n(), 2);
+    QCOMPARE(t.n_pending(), 1);
+    QVERIFY(!g.called);
+    while(t.n_pending())
+        QVERIFY(t.update());
+    QCOMPARE(ids, (std::vector<std::uint32_t>{1}));
+    QVERIFY(g.called);
+    QCOMPARE(g.i, 1);
+    QCOMPARE(g.n, 1);
+    const auto off = img_diff(g.d, this->data);
+    if(off != nngn::Graphics::TEXTURE_SIZE)
+        QCOMPARE(fmt_img(g.d, off), fmt_img(this->data, off));
+}
+
+void TextureTest::load_async_cache() {
+    TextureTestGraphics g;
+    nngn::Textures t;
+    t.set_max(2);
+    t.set_graphics(&g);
+    std::vector<std::uint32_t> ids = {};
+    const auto f = [&ids](auto i) { ids.push_back(i); return true; };
+    QCOMPARE(t.load_async(this->data_file.c_str(), f), 0u);
+    QCOMPARE(t.load_async(this->data_file.c_str(), f), 0u);
+    QCOMPARE(t.n_pending(), 1);
+    const auto s = nngn::Log::capture(
+        [&t] { QVERIFY(!t.set_cache_dir("cache")); });
+    QVERIFY(s.find("loads are pending") != s.npos);
+    QVERIFY(t.update());
+    QCOMPARE(ids, (std::vector<std::uint32_t>{1, 1}));
+    QCOMPARE(g.n_calls, 1);
+    ids.clear();
+    QCOMPARE(t.load_async(this->data_file.c_str(), f), 1u);
+    QVERIFY(ids.empty());
+    QVERIFY(t.update());
+    QCOMPARE(ids, (std::vector<std::uint32_t>{1}));
+    QCOMPARE(g.n_calls, 1);
+    for(std::size_t i = 0; i != 3; ++i)
+        t.remove(1);
+    QCOMPARE(t.n(), 1);
+}
+
+void TextureTest::load_async_err() {
+    TextureTestGraphics g;
+    nngn::Textures t;
+    t.set_max(2);
+    t.set_graphics(&g);
+    std::vector<std::uint32_t> ids = {};
+    const auto f = [&ids](auto i) { ids.push_back(i); return true; };
+    QCOMPARE(t.load_async("/dev/null", f), 0u);
+    QCOMPARE(t.n(), 2);
+    auto s = nngn::Log::capture([&t] { QVERIFY(t.update()); });
+    constexpr auto cmp =
+        "Textures::update: Textures::read: /dev/null: Read Error\n";
+    QCOMPARE(s.c_str(), cmp);
+    QCOMPARE(ids, (std::vector<std::uint32_t>{0}));
+    QCOMPARE(t.n(), 1);
+    QVERIFY(!g.called);
+}
+
+void TextureTest::load_async_remove() {
+    TextureTestGraphics g;
+    nngn::Textures t;
+    t.set_max(3);
+    t.set_graphics(&g);
+    std::vector<std::uint32_t> ids = {};
+    const auto f = [&ids](auto i) { ids.push_back(i); return true; };
+    QCOMPARE(t.load_async(this->data_file.c_str(), f), 0u);
+    t.remove(1);
+    QCOMPARE(t.n(), 2);
+    QCOMPARE(t.load_data("other", this->data_alpha), 2);
+    QCOMPARE(g.i, 2);
+    QVERIFY(t.update());
+    QCOMPARE(ids, (std::vector<std::uint32_t>{1}));
+    QCOMPARE(g.i, 1);
+    QCOMPARE(t.n(), 2);
+    QCOMPARE(t.load_data("third", this->data), 1);
+    QCOMPARE(t.n(), 3);
+}
+
+void TextureTest::load_async_budget() {
+    constexpr std::size_t n = 8;
+    TextureTestGraphics g;
+    nngn::Textures t;
+    t.set_max(n + 1);
+    t.set_graphics(&g);
+    t.set_upload_budget(3);
+    QVERIFY(t.set_decode_threads(2));
+    std::vector<std::uint32_t> ids = {};
+    const auto f = [&ids](auto i) { ids.push_back(i); return true; };
+    QCOMPARE(t.load_async(this->data_file.c_str(), f), 0u);
+    QCOMPARE(t.load_async(this->data_alpha_file.c_str(), f), 0u);
+    for(std::size_t i = 2; i != n; ++i)
+        QCOMPARE(t.load_async(std::to_string(i).c_str(), f), 0u);
+    QCOMPARE(t.n_pending(), n);
+    std::size_t prev = n;
+    while(t.n_pending()) {
+        QVERIFY(t.update());
+        QVERIFY(prev - t.n_pending() <= 3);
+        prev = t.n_pending();
+    }
+    QCOMPARE(g.n_calls, 2);
+    QCOMPARE(ids.size(), n);
+    std::ranges::sort(ids);
+    QCOMPARE(ids, (std::vector<std::uint32_t>{0, 0, 0, 0, 0, 0, 1, 2}));
+    QCOMPARE(t.n(), 3);
+}
+
+void TextureTest::reload_all() {
+    TextureTestGraphics g;
+    nngn::Textures t;
+    t.set_max(3);
+    t.set_graphics(&g);
+    QVERIFY(t.load(this->data_file.c_str()));
+    QVERIFY(t.load(this->data_alpha_file.c_str()));
+    QVERIFY(t.set_decode_threads(2));
+    g.n_calls = 0;
+    QVERIFY(t.reload_all());
+    QCOMPARE(g.n_calls, 2);
+    QVERIFY(!t.n_pending());
+}
+
+void TextureTest::cache() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const std::filesystem::path d = dir.path().toStdString();
+    const auto src = d / "src.png";
+    std::error_code ec = {};
+    QVERIFY(std::filesystem::copy_file(this->data_file, src, ec));
+    for(int i = 0; i != 2; ++i) {
+        TextureTestGraphics g;
+        nngn::Textures t;
+        t.set_max(2);
+        t.set_graphics(&g);
+        QVERIFY(t.set_cache_dir(d / "cache"));
+        QVERIFY(t.load(src.c_str()));
+        QCOMPARE(t.cache().hits(), static_cast<std::uint64_t>(i));
+        QCOMPARE(t.cache().misses(), static_cast<std::uint64_t>(!i));
+        const auto entry = t.cache().path(src.c_str());
+        QVERIFY(std::filesystem::exists(entry));
+        const auto ref = d / "ref";
+        std::ofstream{ref};
+        QCOMPARE(
+            std::filesystem::status(entry).permissions(),
+            std::filesystem::status(ref).permissions());
+        const auto off = img_diff(g.d, this->data);
+        if(off != nngn::Graphics::TEXTURE_SIZE)
+            QCOMPARE(fmt_img(g.d, off), fmt_img(this->data, off));
+    }
+}
+
+void TextureTest::cache_stale() {
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const std::filesystem::path d = dir.path().toStdString();
+    const auto src = d / "src.png";
+    std::error_code ec = {};
+    QVERIFY(std::filesystem::copy_file(this->data_file, src, ec));
+    TextureTestGraphics g;
+    nngn::Textures t;
+    t.set_max(2);
+    t.set_graphics(&g);
+    QVERIFY(t.set_cache_dir(d / "cache"));
+    const auto i = t.load(src.c_str());
+    QVERIFY(i);
+    QCOMPARE(t.cache().misses(), 1);
+    const auto mtime = std::filesystem::last_write_time(src, ec);
+    QVERIFY(!ec);
+    std::filesystem::last_write_time(src, mtime + std::chrono::hours{1}, ec);
+    QVERIFY(!ec);
+    QVERIFY(t.reload(i));
+    QCOMPARE(t.cache().hits(), 0);
+    QCOMPARE(t.cache().misses(), 2);
+    QVERIFY(t.reload(i));
+    QCOMPARE(t.cache().hits(), 1);
+    QCOMPARE(t.cache().misses(), 2);
+    const auto off = img_diff(g.d, this->data);
+    if(off != nngn::Graphics::TEXTURE_SIZE)
+        QCOMPARE(fmt_img(g.d, off), fmt_img(this->data, off));
+}
+
+void TextureTest::cache_concurrent() {
+    constexpr std::size_t n = 16;
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const std::filesystem::path d = dir.path().toStdString();
+    const auto src = d / "src.png";
+    std::error_code ec = {};
+    QVERIFY(std::filesystem::copy_file(this->data_file, src, ec));
+    const auto mtime = nngn::TextureCache::mtime(src.c_str());
+    QVERIFY(mtime);
+    std::array<nngn::TextureCache, 2> c = {};
+    for(auto &x : c)
+        QVERIFY(x.set_dir(d / "cache"));
+    std::array<std::size_t, 2> ok = {};
+    const auto f = [&src, t = *mtime, &c, &ok](std::size_t i) {
+        for(std::size_t j = 0; j != n; ++j)
+            ok[i] += c[i].write(src.c_str(), t, TextureTest::data);
+    };
+    std::thread t0 = std::thread{f, 0}, t1 = std::thread{f, 1};
+    t0.join();
+    t1.join();
+    QCOMPARE(ok, (std::array<std::size_t, 2>{n, n}));
+    nngn::MappedFile m = {};
+    QVERIFY(c[0].read(src.c_str(), *mtime + 1, &m).empty());
+    const auto s = c[0].read(src.c_str(), *mtime, &m);
+    QCOMPARE(s.size(), nngn::Graphics::TEXTURE_SIZE);
+    QCOMPARE(std::distance(
+        std::filesystem::directory_iterator{d / "cache"}, {}), 1);
+}
+
 QTEST_MAIN(TextureTest)
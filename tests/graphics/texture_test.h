@@ -23,6 +23,18 @@ private slots:
     void load_max();
     void load_cache();
     void remove();
+    void reuse();
+    void collision();
+    void load_async_data();
+    void load_async();
+    void load_async_cache();
+    void load_async_err();
+    void load_async_remove();
+    void load_async_budget();
+    void reload_all();
+    void cache();
+    void cache_stale();
+    void cache_concurrent();
 };
 
 #endif
@@ -0,0 +1,170 @@
+#include <sstream>
+
+#include "input/recorder.h"
+#include "utils/log.h"
+#include "utils/utils.h"
+
+#include "recorder_test.h"
+
+using namespace std::chrono_literals;
+using nngn::Recorder;
+using Type = Recorder::Type;
+
+namespace {
+
+auto replay_stream(const std::string &s) {
+    return std::make_unique<std::stringstream>(s);
+}
+
+}
+
+void RecorderTest::none(void) {
+    Recorder r;
+    nngn::Timing t;
+    r.init(&t);
+    const auto now = t.now;
+    QCOMPARE(r.mode(), Recorder::Mode::NONE);
+    QVERIFY(r.frame());
+    QCOMPARE(t.now, now);
+    QVERIFY(r.key(0, 1, 0));
+    QVERIFY(r.button(0, 1, 0));
+    QVERIFY(r.move({}));
+    QVERIFY(r.socket("x"));
+}
+
+void RecorderTest::record_replay(void) {
+    auto out = std::make_unique<std::stringstream>();
+    auto *const s = out.get();
+    Recorder r;
+    nngn::Timing t;
+    r.init(&t);
+    t.now = nngn::Timing::time_point{1s};
+    t.dt = 16ms;
+    QVERIFY(r.record(std::move(out)));
+    QCOMPARE(r.mode(), Recorder::Mode::RECORD);
+    QVERIFY(r.key('A', nngn::Input::KEY_PRESS, nngn::Input::MOD_SHIFT));
+    QVERIFY(r.move({1.5, 2.5}));
+    QVERIFY(r.socket("print(42)"));
+    t.now += 17ms;
+    t.dt = 17ms;
+    QVERIFY(r.frame());
+    t.now += 18ms;
+    t.dt = 18ms;
+    QVERIFY(r.frame());
+    QVERIFY(r.button(1, 0, 2));
+    const auto data = s->str();
+    r.stop();
+    QCOMPARE(r.mode(), Recorder::Mode::NONE);
+    QVERIFY(r.replay(replay_stream(data)));
+    QCOMPARE(r.mode(), Recorder::Mode::REPLAY);
+    QVERIFY(!r.key('B', nngn::Input::KEY_PRESS, 0));
+    QVERIFY(!r.socket("live"));
+    t = {};
+    QVERIFY(r.frame());
+    QCOMPARE(t.now, nngn::Timing::time_point{1s});
+    QCOMPARE(t.dt, nngn::Timing::duration{16ms});
+    auto e = r.events();
+    QCOMPARE(e.size(), 3u);
+    QCOMPARE(e[0].type, Type::KEY);
+    QCOMPARE(e[0].i0, 'A');
+    QCOMPARE(e[0].i1, nngn::Input::KEY_PRESS);
+    QCOMPARE(e[0].i2, nngn::Input::MOD_SHIFT);
+    QCOMPARE(e[1].type, Type::MOVE);
+    QCOMPARE(e[1].pos, (nngn::dvec2{1.5, 2.5}));
+    QCOMPARE(e[2].type, Type::SOCKET);
+    QCOMPARE(e[2].data, "print(42)");
+    QVERIFY(r.frame());
+    QCOMPARE(t.now, nngn::Timing::time_point{1s + 17ms});
+    QCOMPARE(t.dt, nngn::Timing::duration{17ms});
+    QVERIFY(r.events().empty());
+    QVERIFY(r.frame());
+    QCOMPARE(t.dt, nngn::Timing::duration{18ms});
+    e = r.events();
+    QCOMPARE(e.size(), 1u);
+    QCOMPARE(e[0].type, Type::BUTTON);
+    QCOMPARE(e[0].i0, 1);
+    QCOMPARE(e[0].i2, 2);
+}
+
+void RecorderTest::keys(void) {
+    auto out = std::make_unique<std::stringstream>();
+    auto *const s = out.get();
+    Recorder r;
+    nngn::Timing t;
+    r.init(&t);
+    QVERIFY(r.record(std::move(out)));
+    QVERIFY(r.key('A', nngn::Input::KEY_PRESS, 0));
+    QVERIFY(r.key('B', nngn::Input::KEY_PRESS, 0));
+    QVERIFY(r.frame());
+    QVERIFY(r.key('A', nngn::Input::KEY_RELEASE, 0));
+    const auto data = s->str();
+    QVERIFY(r.replay(replay_stream(data)));
+    std::array<nngn::i32, 3> keys = {};
+    const auto get = [&r, &keys] {
+        keys = {'A', 'B', 'C'};
+        r.get_keys(keys);
+        return keys;
+    };
+    QCOMPARE(get(), (std::array<nngn::i32, 3>{0, 0, 0}));
+    QVERIFY(r.frame());
+    QCOMPARE(get(), (std::array<nngn::i32, 3>{1, 1, 0}));
+    QVERIFY(r.frame());
+    QCOMPARE(get(), (std::array<nngn::i32, 3>{0, 1, 0}));
+}
+
+void RecorderTest::end(void) {
+    auto out = std::make_unique<std::stringstream>();
+    auto *const s = out.get();
+    Recorder r;
+    nngn::Timing t;
+    r.init(&t);
+    QVERIFY(r.record(std::move(out)));
+    const auto data = s->str();
+    QVERIFY(r.replay(replay_stream(data)));
+    QVERIFY(r.frame());
+    QCOMPARE(r.mode(), Recorder::Mode::REPLAY);
+    bool ok = false;
+    const auto log = nngn::Log::capture([&r, &ok] { ok = r.frame(); });
+    QVERIFY(ok);
+    QCOMPARE(r.mode(), Recorder::Mode::NONE);
+    QVERIFY(log.find("replay finished") != log.npos);
+}
+
+void RecorderTest::invalid(void) {
+    Recorder r;
+    nngn::Timing t;
+    r.init(&t);
+    bool ok = true;
+    auto log = nngn::Log::capture([&r, &ok] {
+        ok = r.replay(std::make_unique<std::stringstream>("nngnrex"));
+    });
+    QVERIFY(!ok);
+    QCOMPARE(r.mode(), Recorder::Mode::NONE);
+    QVERIFY(log.find("invalid header") != log.npos);
+    auto s = std::make_unique<std::stringstream>();
+    s->write(Recorder::MAGIC.data(), 7);
+    s->put(static_cast<char>(Recorder::VERSION));
+    s->put(static_cast<char>(Type::FRAME));
+    s->put(0);
+    QVERIFY(r.replay(std::move(s)));
+    log = nngn::Log::capture([&r, &ok] { ok = r.frame(); });
+    QVERIFY(!ok);
+    QCOMPARE(r.mode(), Recorder::Mode::NONE);
+    QVERIFY(log.find("truncated frame record") != log.npos);
+    s = std::make_unique<std::stringstream>();
+    s->write(Recorder::MAGIC.data(), 7);
+    s->put(static_cast<char>(Recorder::VERSION));
+    s->put(static_cast<char>(Type::FRAME));
+    const std::string f(2 * sizeof(std::int64_t), 0);
+    s->write(f.data(), static_cast<std::streamsize>(f.size()));
+    s->put(static_cast<char>(Type::SOCKET));
+    const nngn::u32 n = Recorder::MAX_COMMAND + 1;
+    s->write(nngn::byte_cast<const char*>(&n), sizeof(n));
+    QVERIFY(r.replay(std::move(s)));
+    log = nngn::Log::capture([&r, &ok] { ok = r.frame(); });
+    QVERIFY(!ok);
+    QCOMPARE(r.mode(), Recorder::Mode::NONE);
+    QVERIFY(log.find("command too large") != log.npos);
+}
+
+QTEST_MAIN(RecorderTest)
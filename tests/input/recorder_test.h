@@ -0,0 +1,16 @@
+#ifndef NNGN_TEST_INPUT_RECORDER_H
+#define NNGN_TEST_INPUT_RECORDER_H
+
+#include <QTest>
+
+class RecorderTest : public QObject {
+    Q_OBJECT
+private slots:
+    void none(void);
+    void record_replay(void);
+    void keys(void);
+    void end(void);
+    void invalid(void);
+};
+
+#endif
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "jobs/deque.h"
+#include "jobs/jobs.h"
+
+#include "jobs_test.h"
+
+using nngn::Jobs;
+
+void JobsTest::deque(void) {
+    nngn::work_stealing_deque<int, 4> q = {};
+    int x = 0;
+    QVERIFY(!q.pop(&x));
+    QVERIFY(!q.steal(&x));
+    for(int i = 0; i != 4; ++i)
+        QVERIFY(q.push(i));
+    QVERIFY(!q.push(4));
+    QCOMPARE(q.size(), 4u);
+    QVERIFY(q.pop(&x));
+    QCOMPARE(x, 3);
+    QVERIFY(q.steal(&x));
+    QCOMPARE(x, 0);
+    QVERIFY(q.push(5));
+    QVERIFY(q.push(6));
+    QVERIFY(!q.push(7));
+    QVERIFY(q.pop(&x));
+    QCOMPARE(x, 6);
+    QVERIFY(q.pop(&x));
+    QCOMPARE(x, 5);
+    QVERIFY(q.pop(&x));
+    QCOMPARE(x, 2);
+    QVERIFY(q.pop(&x));
+    QCOMPARE(x, 1);
+    QVERIFY(!q.pop(&x));
+    QCOMPARE(q.size(), 0u);
+}
+
+void JobsTest::deque_steal(void) {
+    constexpr int n = 1 << 16, n_thieves = 3;
+    nngn::work_stealing_deque<int, 256> q = {};
+    std::vector<int> seen(n);
+    std::atomic_bool done = false;
+    std::vector<std::thread> thieves = {};
+    for(int t = 0; t != n_thieves; ++t)
+        thieves.emplace_back([&q, &seen, &done] {
+            for(int x = 0; !done.load() || q.size();)
+                if(q.steal(&x))
+                    ++seen[static_cast<std::size_t>(x)];
+        });
+    for(int i = 0, x = 0; i != n;) {
+        if(q.push(i))
+            ++i;
+        else if(q.pop(&x))
+            ++seen[static_cast<std::size_t>(x)];
+    }
+    for(int x = 0; q.pop(&x);)
+        ++seen[static_cast<std::size_t>(x)];
+    done = true;
+    for(auto &x : thieves)
+        x.join();
+    QVERIFY(std::ranges::all_of(seen, [](int x) { return x == 1; }));
+}
+
+void JobsTest::threads(void) {
+    Jobs j = {};
+    QCOMPARE(j.threads(), 0u);
+    QVERIFY(j.set_threads(4));
+    QCOMPARE(j.threads(), 4u);
+    QVERIFY(j.set_threads(2));
+    QCOMPARE(j.threads(), 2u);
+    QVERIFY(j.set_threads(0));
+    QCOMPARE(j.threads(), 0u);
+}
+
+void JobsTest::parallel_for_serial(void) {
+    Jobs j = {};
+    std::vector<std::pair<std::size_t, std::size_t>> v = {};
+    j.parallel_for("test", 100, 10, [&v](auto b, auto e) { v.emplace_back(b, e); });
+    QCOMPARE(v.size(), 1u);
+    QCOMPARE(v[0].first, 0u);
+    QCOMPARE(v[0].second, 100u);
+    v.clear();
+    j.parallel_for("test", 0, 10, [&v](auto b, auto e) { v.emplace_back(b, e); });
+    QVERIFY(v.empty());
+}
+
+void JobsTest::parallel_for(void) {
+    constexpr std::size_t n = 100000;
+    Jobs j = {};
+    QVERIFY(j.set_threads(3));
+    std::vector<int> v(n);
+    std::atomic<std::size_t> calls = 0;
+    j.parallel_for("test", n, 1000, [&v, &calls](auto b, auto e) {
+        QVERIFY(e - b <= 1000);
+        for(auto i = b; i != e; ++i)
+            ++v[i];
+        ++calls;
+    });
+    QCOMPARE(calls.load(), 100u);
+    QVERIFY(std::ranges::all_of(v, [](int x) { return x == 1; }));
+}
+
+void JobsTest::parallel_for_nested(void) {
+    constexpr std::size_t n = 64;
+    Jobs j = {};
+    QVERIFY(j.set_threads(3));
+    std::vector<std::atomic<int>> v(n * n);
+    j.parallel_for("outer", n, 1, [&j, &v](auto b0, auto e0) {
+        for(auto i = b0; i != e0; ++i)
+            j.parallel_for("inner", n, 4, [&v, i](auto b1, auto e1) {
+                for(auto k = b1; k != e1; ++k)
+                    ++v[i * n + k];
+            });
+    });
+    QVERIFY(std::ranges::all_of(v, [](const auto &x) { return x == 1; }));
+}
+
+void JobsTest::graph(void) {
+    for(const std::size_t threads : {0u, 1u, 3u}) {
+        Jobs j = {};
+        QVERIFY(j.set_threads(threads));
+        std::atomic<int> a = 0, b = 0, c = 0, d = 0;
+        bool ok = true;
+        {
+            Jobs::Graph g = Jobs::Graph{&j};
+            auto *const ja = g.add("a", [&a] { a = 1; });
+            auto *const jb = g.add("b", [&] { ok &= a == 1; b = 1; }, {ja});
+            auto *const jc = g.add("c", [&] { ok &= a == 1; c = 1; }, {ja});
+            g.add("d", [&] { ok &= b == 1 && c == 1; d = 1; }, {jb, jc});
+            g.wait();
+            QVERIFY(g.done());
+        }
+        QVERIFY(ok);
+        QCOMPARE(d.load(), 1);
+    }
+}
+
+void JobsTest::graph_main(void) {
+    Jobs j = {};
+    QVERIFY(j.set_threads(2));
+    const auto main = std::this_thread::get_id();
+    std::thread::id id = {};
+    std::atomic<int> n = 0;
+    Jobs::Graph g = Jobs::Graph{&j};
+    auto *const j0 = g.add("worker", [&n] { ++n; });
+    g.add_main("main", [&id, &n] { id = std::this_thread::get_id(); ++n; }, {j0});
+    g.wait();
+    QCOMPARE(n.load(), 2);
+    QVERIFY(id == main);
+    std::thread::id id1 = {};
+    g.add_main("main", [&id1] { id1 = std::this_thread::get_id(); });
+    j.run_main();
+    QVERIFY(g.done());
+    QVERIFY(id1 == main);
+}
+
+void JobsTest::foreign_thread(void) {
+    constexpr std::size_t n = 10000;
+    for(const std::size_t threads : {0u, 2u}) {
+        Jobs j = {};
+        QVERIFY(j.set_threads(threads));
+        std::vector<int> v(n);
+        std::thread{[&j, &v] {
+            j.parallel_for("test", n, 100, [&v](auto b, auto e) {
+                for(auto i = b; i != e; ++i)
+                    v[i] = static_cast<int>(i);
+            });
+        }}.join();
+        std::vector<int> expected(n);
+        std::iota(begin(expected), end(expected), 0);
+        QVERIFY(v == expected);
+    }
+}
+
+QTEST_MAIN(JobsTest)
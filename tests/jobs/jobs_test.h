@@ -0,0 +1,20 @@
+#ifndef NNGN_TEST_JOBS_JOBS_H
+#define NNGN_TEST_JOBS_JOBS_H
+
+#include <QTest>
+
+class JobsTest : public QObject {
+    Q_OBJECT
+private slots:
+    void deque(void);
+    void deque_steal(void);
+    void threads(void);
+    void parallel_for_serial(void);
+    void parallel_for(void);
+    void parallel_for_nested(void);
+    void graph(void);
+    void graph_main(void);
+    void foreign_thread(void);
+};
+
+#endif
@@ -1,5 +1,7 @@
 #include "register_test.h"
 
+#include "os/platform.h"
+#include "utils/log.h"
 #include "utils/regexp.h"
 
 #include "lua/function.h"
@@ -17,10 +19,15 @@ struct user_type {
     int i;
     member m;
     int f(void) const { return this->i; }
+    void set(int j) { this->i = j; }
+    int add(int j, int k, int l) const { return this->i + j + k + l; }
 };
 
 using T = user_type;
 
+int ref(T &t, int j) { return t.i * j; }
+int ptr(const T *t) { return -t->i; }
+
 }
 
 NNGN_LUA_DECLARE_USER_TYPE(member)
@@ -83,4 +90,45 @@ void RegisterTest::member_fn(void) {
     QCOMPARE(ret, u.i);
 }
 
+void RegisterTest::method(void) {
+    this->mt["f"] = nngn::lua::method<&user_type::f>;
+    this->mt["set"] = nngn::lua::method<&user_type::set>;
+    T u = {.i = 42};
+    this->g["u"] = &u;
+    QVERIFY(this->lua.dostring("i = u:f(); u:set(43)"));
+    const int ret = this->g["i"];
+    QCOMPARE(ret, 42);
+    QCOMPARE(u.i, 43);
+}
+
+void RegisterTest::method_args(void) {
+    this->mt["add"] = nngn::lua::method<&user_type::add>;
+    this->mt["ref"] = nngn::lua::method<ref>;
+    this->mt["ptr"] = nngn::lua::method<ptr>;
+    T u = {.i = 1};
+    this->g["u"] = &u;
+    QVERIFY(this->lua.dostring(
+        "add = u:add(2, 3, 4); ref = u:ref(5); ptr = u:ptr()"));
+    const int add = this->g["add"], ref = this->g["ref"], ptr = this->g["ptr"];
+    QCOMPARE(add, 10);
+    QCOMPARE(ref, 5);
+    QCOMPARE(ptr, -1);
+}
+
+void RegisterTest::method_invalid(void) {
+    if constexpr(!nngn::Platform::debug)
+        QSKIP("type verification is only performed in debug builds");
+    this->lua.new_user_type<member>();
+    this->mt["f"] = nngn::lua::method<&user_type::f>;
+    T u = {};
+    member m = {};
+    this->g["u"] = &u;
+    this->g["m"] = &m;
+    const auto log = nngn::Log::capture([this] {
+        QVERIFY(!this->lua.dostring("u.f(m)"));
+        QVERIFY(!this->lua.dostring("u.f(nil)"));
+    });
+    QVERIFY(log.find("expected a user data value") != std::string::npos);
+}
+
 QTEST_MAIN(RegisterTest)
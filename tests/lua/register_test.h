@@ -19,6 +19,9 @@ private slots:
     void accessor(void);
     void value_accessor(void);
     void member_fn(void);
+    void method(void);
+    void method_args(void);
+    void method_invalid(void);
 };
 
 #endif
@@ -18,3 +18,4 @@ run tests/lua/font.lua
 run tests/lua/textbox.lua
 run tests/lua/light.lua
 run tests/lua/state.lua
+run tests/lua/schedule.lua
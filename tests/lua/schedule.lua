@@ -0,0 +1,47 @@
+dofile "src/lua/path.lua"
+local common = require "tests/lua/common"
+
+local s <const> = nngn:schedule()
+local log <const> = {}
+local self_log <const> = {}
+
+local function task()
+    table.insert(log, "a")
+    Schedule.wait_frames(2)
+    table.insert(log, "b")
+    Schedule.wait_signal(42)
+    table.insert(log, "c")
+end
+
+local function cancelled()
+    Schedule.wait_frames(1)
+    table.insert(log, "cancelled")
+end
+
+local self_i
+local function self_cancelled()
+    s:cancel(self_i)
+    table.insert(self_log, "a")
+    coroutine.yield()
+    table.insert(self_log, "b")
+end
+
+local function test()
+    Schedule.wait_frames(1)
+    common.assert_eq(log, {"a"}, common.deep_cmp)
+    Schedule.wait_frames(2)
+    common.assert_eq(log, {"a", "b"}, common.deep_cmp)
+    common.assert_eq(s:signal(42), 1)
+    common.assert_eq(s:signal(42), 0)
+    coroutine.yield()
+    common.assert_eq(log, {"a", "b", "c"}, common.deep_cmp)
+    common.assert_eq(self_log, {"a"}, common.deep_cmp)
+    Schedule.wait_ms(0)
+    nngn:exit()
+end
+
+common.setup_hook(1)
+s:spawn(0, task)
+s:cancel(s:spawn(0, cancelled))
+self_i = s:spawn(0, self_cancelled)
+s:spawn(0, test)
@@ -26,8 +26,21 @@ local function test_indent()
     common.assert_eq(deserialize(serial.serialize(t, 2)), t, common.deep_cmp)
 end
 
+local function test_json()
+    common.assert_eq(serial.json{}, "[]")
+    common.assert_eq(serial.json(42), "42")
+    common.assert_eq(serial.json(0.5), "0.5")
+    common.assert_eq(serial.json(0 / 0), "null")
+    common.assert_eq(serial.json("a\"b\n"), '"a\\u0022b\\u000a"')
+    common.assert_eq(serial.json({1, true, "x"}, 0), '[\n1,\ntrue,\n"x"\n]')
+    common.assert_eq(
+        serial.json({b = {c = 1}, a = false}, 1),
+        '{\n "a": false,\n "b": {\n  "c": 1\n }\n}')
+end
+
 return {
     test_empty,
     test_table,
     test_indent,
+    test_json,
 }
@@ -0,0 +1,66 @@
+#include <atomic>
+#include <thread>
+
+#include "os/worker.h"
+
+#include "worker_test.h"
+
+void WorkerTest::start_stop(void) {
+    nngn::Worker w = {};
+    QVERIFY(!w.running());
+    QVERIFY(w.wait());
+    QVERIFY(w.start("test"));
+    QVERIFY(w.running());
+    QVERIFY(w.start("test"));
+    QVERIFY(w.wait());
+    w.stop();
+    QVERIFY(!w.running());
+    w.stop();
+    QVERIFY(w.start("test"));
+    QVERIFY(w.running());
+}
+
+void WorkerTest::submit(void) {
+    nngn::Worker w = {};
+    QVERIFY(w.start("test"));
+    const auto main_id = std::this_thread::get_id();
+    std::thread::id id = {};
+    int n = 0;
+    for(int i = 0; i != 16; ++i) {
+        w.submit([&id, &n] { id = std::this_thread::get_id(); ++n; return true; });
+        QVERIFY(w.wait());
+    }
+    QCOMPARE(n, 16);
+    QVERIFY(id != main_id);
+    w.submit([&n] { ++n; return true; });
+    w.stop();
+    QCOMPARE(n, 17);
+}
+
+void WorkerTest::result(void) {
+    nngn::Worker w = {};
+    QVERIFY(w.start("test"));
+    w.submit([] { return false; });
+    QVERIFY(!w.wait());
+    QVERIFY(w.wait());
+    w.submit([] { return true; });
+    QVERIFY(w.wait());
+}
+
+void WorkerTest::concurrent(void) {
+    nngn::Worker w = {};
+    QVERIFY(w.start("test"));
+    std::atomic_bool go = false, done = false;
+    w.submit([&go, &done] {
+        while(!go.load())
+            std::this_thread::yield();
+        done = true;
+        return true;
+    });
+    QVERIFY(!done.load());
+    go = true;
+    QVERIFY(w.wait());
+    QVERIFY(done.load());
+}
+
+QTEST_MAIN(WorkerTest)
@@ -0,0 +1,15 @@
+#ifndef NNGN_TEST_OS_WORKER_H
+#define NNGN_TEST_OS_WORKER_H
+
+#include <QTest>
+
+class WorkerTest : public QObject {
+    Q_OBJECT
+private slots:
+    void start_stop(void);
+    void submit(void);
+    void result(void);
+    void concurrent(void);
+};
+
+#endif
@@ -1,3 +1,6 @@
+#include <array>
+#include <string_view>
+
 #include "timing/fps.h"
 
 #include "fps_test.h"
@@ -50,4 +53,104 @@ void FpsTest::avg() {
     QCOMPARE(fps.avg, 100.0f);
 }
 
+void FpsTest::histogram() {
+    using H = nngn::Histogram;
+    for(nngn::u64 i = 0; i != H::SUB_COUNT; ++i) {
+        QCOMPARE(H::bucket(i), i);
+        QCOMPARE(H::bucket_max(i), i);
+    }
+    for(std::size_t i = 1; i != H::N_BUCKETS; ++i)
+        QCOMPARE(H::bucket(H::bucket_max(i - 1) + 1), i);
+    for(nngn::u64 v = 1; v < (nngn::u64{1} << H::MAX_BITS); v = v * 3 + 1) {
+        const auto max = H::bucket_max(H::bucket(v));
+        QVERIFY(v <= max);
+        QVERIFY(static_cast<double>(max - v) / static_cast<double>(v)
+            <= 1.0 / H::HALF_COUNT);
+    }
+    QCOMPARE(H::bucket(~nngn::u64{}), H::N_BUCKETS - 1);
+}
+
+void FpsTest::percentiles() {
+    nngn::Histogram h;
+    QCOMPARE(h.percentile(0.5), 0u);
+    for(nngn::u64 i = 1; i <= 1000; ++i)
+        h.record(i * 1000);
+    QCOMPARE(h.count(), 1000u);
+    QCOMPARE(h.min(), 1000u);
+    QCOMPARE(h.max(), 1000000u);
+    QCOMPARE(h.sum(), 500500000u);
+    QCOMPARE(h.percentile(1), 1000000u);
+    const auto check = [&h](double q, double expected) {
+        const auto v = static_cast<double>(h.percentile(q));
+        return expected <= v && v <= expected * (1 + 1.0 / 32);
+    };
+    QVERIFY(check(0, 1000));
+    QVERIFY(check(0.5, 500000));
+    QVERIFY(check(0.9, 900000));
+    QVERIFY(check(0.99, 990000));
+    QVERIFY(check(0.999, 999000));
+    h.reset();
+    QCOMPARE(h.count(), 0u);
+    QCOMPARE(h.min(), 0u);
+    QCOMPARE(h.max(), 0u);
+}
+
+void FpsTest::window() {
+    using namespace std::chrono_literals;
+    auto t = nngn::Timing::clock::now();
+    nngn::FPS fps(1);
+    fps.init(t);
+    for(unsigned int i = 0; i < 99; ++i)
+        fps.frame(t += 10ms);
+    fps.frame(t += 100ms);
+    QCOMPARE(fps.hist.count(), 100u);
+    QVERIFY(fps.hist.percentile(0.99) < 11000000u);
+    QCOMPARE(fps.hist.max(), 100000000u);
+    fps.hist_window = 100;
+    fps.frame(t += 20ms);
+    QCOMPARE(fps.hist.count(), 1u);
+    QCOMPARE(fps.hist.max(), 20000000u);
+    fps.reset_hist();
+    QCOMPARE(fps.hist.count(), 0u);
+}
+
+void FpsTest::profile() {
+    using namespace std::chrono_literals;
+    constexpr auto ns = [](auto d) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<nngn::Timing::duration>(d).count());
+    };
+    nngn::FPS fps;
+    nngn::ProfileStats s = {};
+    s.schedule = {ns(1ms), ns(2ms)};
+    s.vsync = {ns(1ms), ns(17ms)};
+    fps.profile(s);
+    fps.profile(s);
+    s.schedule = {ns(20ms), ns(23ms)};
+    fps.profile(s);
+    const auto &h = fps.prof_hist;
+    QCOMPARE(h[0].count(), 2u);
+    QCOMPARE(h[0].min(), 1000000u);
+    QCOMPARE(h[0].max(), 3000000u);
+    QCOMPARE(h[1].count(), 0u);
+    QCOMPARE(h.back().count(), 1u);
+    QCOMPARE(h.back().max(), 16000000u);
+}
+
+void FpsTest::to_string() {
+    using namespace std::chrono_literals;
+    auto t = nngn::Timing::clock::now();
+    nngn::FPS fps(2);
+    fps.init(t);
+    fps.frame(t += 10ms);
+    fps.frame(t += 20ms);
+    QCOMPARE(fps.last_dt(), nngn::Timing::clock::duration{20ms});
+    std::array<char, 64> s = {};
+    QVERIFY(
+        std::string_view{fps.to_string(s)}
+        == " cur: 0 avg: 66.7 min: 10.0 max: 20.0");
+    std::array<char, 8> small = {};
+    QVERIFY(std::string_view{fps.to_string(small)} == " cur: 0");
+}
+
 QTEST_MAIN(FpsTest)
@@ -9,6 +9,11 @@ private slots:
     void constructor();
     void sec();
     void avg();
+    void histogram();
+    void percentiles();
+    void window();
+    void profile();
+    void to_string();
 };
 
 #endif
@@ -1,9 +1,9 @@
 #include <chrono>
+#include <cstdint>
 #include <cstring>
 
 #include "timing/schedule.h"
 #include "timing/timing.h"
-#include "utils/scoped.h"
 
 #include "schedule_test.h"
 
@@ -11,11 +11,8 @@ using namespace std::chrono_literals;
 
 const auto CB = [](void *p) { return **static_cast<bool**>(p) = true; };
 
-static std::vector<std::byte> gen_data(bool *p) {
-    constexpr auto n = sizeof(p);
-    std::vector<std::byte> ret(n);
-    new (ret.data()) bool*{p};
-    return ret;
+static nngn::Schedule::Data gen_data(bool *p) {
+    return nngn::Schedule::data(p);
 }
 
 void ScheduleTest::next(void) {
@@ -167,14 +164,34 @@ void ScheduleTest::cancel(void) {
     QVERIFY(called2);
 }
 
+void ScheduleTest::cancel_twice(void) {
+    constexpr auto nop = [](void*) { return true; };
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    QCOMPARE(s.in(1s, {nop}), 0);
+    QCOMPARE(s.in(1s, {nop}), 1);
+    QCOMPARE(s.in(1s, {nop}), 2);
+    QVERIFY(s.cancel(1));
+    QVERIFY(!s.cancel(1));
+    QVERIFY(!s.cancel(3));
+    const auto i = s.next({nop});
+    QCOMPARE(i, 1);
+    QVERIFY(s.update());
+    QVERIFY(!s.cancel(i));
+    QCOMPARE(s.n(), 3);
+    QCOMPARE(s.in(1s, {nop}), 1);
+    QCOMPARE(s.in(1s, {nop}), 3);
+    QCOMPARE(s.n(), 4);
+}
+
 void ScheduleTest::recursive(void) {
     nngn::Timing t;
     nngn::Schedule s;
     s.init(&t);
     bool called = false;
     struct data { nngn::Schedule *s; bool *p; };
-    std::vector<std::byte> v(sizeof(data));
-    new (v.data()) data{&s, &called};
+    const auto v = nngn::Schedule::data(data{&s, &called});
     s.next({
         [](void *p) {
             auto inner_d = static_cast<data*>(p);
@@ -196,16 +213,42 @@ void ScheduleTest::recursive_remove(void) {
     nngn::Schedule s;
     s.init(&t);
     size_t i = 0;
+    static bool zeroed = false;
     struct data { nngn::Schedule *s; size_t *i; };
-    std::vector<std::byte> v(sizeof(data));
-    new (v.data()) data{&s, &i};
+    const auto v = nngn::Schedule::data(data{&s, &i});
     i = s.next({
         [](auto *p) {
             auto inner_d = static_cast<data*>(p);
             inner_d->s->cancel(*inner_d->i);
+            zeroed = !inner_d->s;
             return true;
         }, nullptr, v, {}});
     QVERIFY(s.update());
+    QVERIFY(zeroed);
+}
+
+void ScheduleTest::recursive_realloc(void) {
+    constexpr std::size_t n = 64;
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    struct data { nngn::Schedule *s; std::size_t *i; std::size_t n; };
+    std::size_t i = 0;
+    s.next({
+        [](void *p) {
+            auto *const d = static_cast<data*>(p);
+            for(std::size_t j = 0; j != n; ++j)
+                d->s->next({[](void*) { return true; }});
+            *d->i = ++d->n;
+            return true;
+        }, nullptr, nngn::Schedule::data(data{&s, &i, 0}),
+        nngn::Schedule::Flag::HEARTBEAT});
+    QVERIFY(s.update());
+    QCOMPARE(i, 1);
+    QCOMPARE(s.n(), n + 1);
+    QVERIFY(s.update());
+    QCOMPARE(i, 2);
+    QCOMPARE(s.n(), 2 * n + 1);
 }
 
 void ScheduleTest::destructor(void) {
@@ -239,25 +282,25 @@ void ScheduleTest::map(void) {
         nngn::Schedule *s;
         nngn::Schedule::Fn next;
         size_t *next_i;
-        std::vector<std::byte> d;
+        const nngn::Schedule::Data *d;
     };
     struct d1 {
         nngn::Schedule *s;
         nngn::Schedule::Fn next;
-        std::vector<std::byte> d;
+        const nngn::Schedule::Data *d;
         size_t *i;
     };
     struct d2 { nngn::Schedule *s; size_t *f1; size_t *i; };
     const auto f0 = [](auto *p) {
         auto d = static_cast<d0*>(p);
         *d->next_i = d->s->next({
-            d->next, nullptr, d->d, nngn::Schedule::Flag::HEARTBEAT});
+            d->next, nullptr, *d->d, nngn::Schedule::Flag::HEARTBEAT});
         return true;
     };
     const auto f1 = [](auto *p) {
         auto d = static_cast<d1*>(p);
         if((*d->i)++ == 1)
-            d->s->next({d->next, nullptr, d->d, {}});
+            d->s->next({d->next, nullptr, *d->d, {}});
         return true;
     };
     const auto f2 = [](auto *p) {
@@ -267,16 +310,9 @@ void ScheduleTest::map(void) {
         return true;
     };
     size_t i = 0, f1_idx = 0;
-    auto v0 = std::vector<std::byte>(sizeof(d0));
-    auto v1 = std::vector<std::byte>(sizeof(d1));
-    std::vector<std::byte> v2(sizeof(d2));
-    new (v2.data()) d2{&s, &f1_idx, &i};
-    auto destroy_v1 = nngn::make_scoped_obj(
-        new (v1.data()) d1{&s, f2, v2, &i},
-        [](auto *x) { static_cast<d1*>(static_cast<void*>(x))->d1::~d1(); });
-    auto destroy_v0 = nngn::make_scoped_obj(
-        new (v0.data()) d0{&s, f1, &f1_idx, v1},
-        [](auto *x) { static_cast<d0*>(static_cast<void*>(x))->d0::~d0(); });
+    const auto v2 = nngn::Schedule::data(d2{&s, &f1_idx, &i});
+    const auto v1 = nngn::Schedule::data(d1{&s, f2, &v2, &i});
+    const auto v0 = nngn::Schedule::data(d0{&s, f1, &f1_idx, &v1});
     s.init(&t);
     s.next({f0, nullptr, v0, {}});
     QVERIFY(s.update());
@@ -289,4 +325,168 @@ void ScheduleTest::map(void) {
     QCOMPARE(i, 0);
 }
 
+void ScheduleTest::signal(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    bool called0 = false, called1 = false;
+    s.wait(1, {CB, nullptr, gen_data(&called0), {}});
+    s.wait(2, {CB, nullptr, gen_data(&called1), {}});
+    QVERIFY(s.update());
+    QVERIFY(!called0);
+    QVERIFY(!called1);
+    QCOMPARE(s.signal(1), 1);
+    QCOMPARE(s.signal(3), 0);
+    QVERIFY(!called0);
+    QVERIFY(s.update());
+    QVERIFY(called0);
+    QVERIFY(!called1);
+    called0 = false;
+    QCOMPARE(s.signal(1), 0);
+    QVERIFY(s.update());
+    QVERIFY(!called0);
+    QVERIFY(!called1);
+}
+
+void ScheduleTest::suspend(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    int n = 0;
+    struct data { nngn::Schedule *s; const nngn::Timing *t; int *n; };
+    const auto v = nngn::Schedule::data(data{&s, &t, &n});
+    s.next({
+        [](void *p) {
+            const auto *const d = static_cast<const data*>(p);
+            switch((*d->n)++) {
+            case 0: return d->s->suspend_frame(d->t->frame + 2);
+            case 1: return d->s->suspend_at(d->t->now + 1s);
+            default: return true;
+            }
+        }, nullptr, v, {}});
+    QVERIFY(s.update());
+    QCOMPARE(n, 1);
+    t.frame = 1;
+    QVERIFY(s.update());
+    QCOMPARE(n, 1);
+    t.frame = 2;
+    QVERIFY(s.update());
+    QCOMPARE(n, 2);
+    QCOMPARE(s.n(), 1);
+    t.frame = 3;
+    t.now += 500ms;
+    QVERIFY(s.update());
+    QCOMPARE(n, 2);
+    t.now += 500ms;
+    QVERIFY(s.update());
+    QCOMPARE(n, 3);
+    QCOMPARE(s.n(), 0);
+    QVERIFY(s.update());
+    QCOMPARE(n, 3);
+    QVERIFY(!s.suspend_frame(0));
+}
+
+void ScheduleTest::suspend_signal(void) {
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    int n = 0;
+    struct data { nngn::Schedule *s; int *n; };
+    const auto v = nngn::Schedule::data(data{&s, &n});
+    const auto i = s.next({
+        [](void *p) {
+            const auto *const d = static_cast<const data*>(p);
+            return (*d->n)++ || d->s->suspend_signal(42);
+        }, nullptr, v, {}});
+    QVERIFY(s.update());
+    QCOMPARE(n, 1);
+    QVERIFY(s.update());
+    QCOMPARE(n, 1);
+    QCOMPARE(s.signal(42), 1);
+    QVERIFY(s.update());
+    QCOMPARE(n, 2);
+    QVERIFY(s.update());
+    QCOMPARE(n, 2);
+    const auto j = s.next({
+        [](void *p) {
+            return static_cast<const data*>(p)->s->suspend_signal(42);
+        }, nullptr, v, {}});
+    QCOMPARE(j, i);
+    QVERIFY(s.update());
+    QVERIFY(s.cancel(j));
+    QCOMPARE(s.signal(42), 0);
+    QCOMPARE(s.n(), 0);
+}
+
+void ScheduleTest::pending(void) {
+    constexpr std::size_t n = 10000;
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    std::size_t called = 0;
+    const auto f = [](void *p) {
+        return ++**static_cast<std::size_t**>(p), true;
+    };
+    const auto v = nngn::Schedule::data(&called);
+    for(std::size_t i = 0; i != n; ++i)
+        s.frame(i + 1, {f, nullptr, v, {}});
+    for(std::size_t i = 0; i != n; ++i)
+        s.in(
+            std::chrono::seconds{static_cast<std::int64_t>(i + 1)},
+            {f, nullptr, v, {}});
+    for(std::size_t i = 1; i <= n; ++i) {
+        t.frame = i;
+        t.now += 1s;
+        QVERIFY(s.update());
+        QCOMPARE(called, 2 * i);
+    }
+    QCOMPARE(s.n(), 0);
+}
+
+void ScheduleTest::indices(void) {
+    constexpr auto nop = [](void*) { return true; };
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    QCOMPARE(s.in(1s, {nop}), 0);
+    QCOMPARE(s.in(1s, {nop}), 1);
+    QCOMPARE(s.in(1s, {nop}), 2);
+    QCOMPARE(s.in(1s, {nop}), 3);
+    QVERIFY(s.cancel(2));
+    QVERIFY(s.cancel(1));
+    QCOMPARE(s.n(), 4);
+    QCOMPARE(s.in(1s, {nop}), 1);
+    QVERIFY(s.cancel(3));
+    QCOMPARE(s.n(), 2);
+    QCOMPARE(s.in(1s, {nop}), 2);
+    QCOMPARE(s.in(1s, {nop}), 3);
+    QCOMPARE(s.in(1s, {nop}), 4);
+    QCOMPARE(s.atexit({nop}), 0);
+    QCOMPARE(s.atexit({nop}), 1);
+    QVERIFY(s.cancel_atexit(0));
+    QCOMPARE(s.atexit({nop}), 0);
+}
+
+void ScheduleTest::compact(void) {
+    constexpr std::size_t n = 1024;
+    nngn::Timing t;
+    nngn::Schedule s;
+    s.init(&t);
+    bool called = false;
+    s.in(1s, {CB, nullptr, gen_data(&called), {}});
+    for(std::size_t i = 0; i != n; ++i) {
+        const auto nop = [](void*) { return true; };
+        QVERIFY(s.cancel(s.in(1s, {nop})));
+        QVERIFY(s.cancel(s.frame(1, {nop})));
+        QVERIFY(s.cancel(s.wait(0, {nop})));
+        QVERIFY(s.update());
+    }
+    QCOMPARE(s.n(), 1);
+    QVERIFY(!called);
+    t.now += 1s;
+    QVERIFY(s.update());
+    QVERIFY(called);
+    QCOMPARE(s.n(), 0);
+}
+
 QTEST_MAIN(ScheduleTest)
@@ -14,10 +14,18 @@ private slots:
     void ignore_failures(void);
     void heartbeat(void);
     void cancel(void);
+    void cancel_twice(void);
     void recursive(void);
     void recursive_remove(void);
+    void recursive_realloc(void);
     void destructor(void);
     void map(void);
+    void signal(void);
+    void suspend(void);
+    void suspend_signal(void);
+    void pending(void);
+    void indices(void);
+    void compact(void);
 };
 
 #endif
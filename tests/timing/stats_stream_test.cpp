@@ -0,0 +1,90 @@
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "timing/stats_stream.h"
+
+#include "stats_stream_test.h"
+
+using nngn::StatsStream;
+using nngn::u64;
+
+namespace {
+
+std::string contents(std::FILE *f) {
+    std::string ret(static_cast<std::size_t>(std::ftell(f)), 0);
+    std::rewind(f);
+    if(std::fread(ret.data(), 1, ret.size(), f) != ret.size())
+        return {};
+    return ret;
+}
+
+}
+
+void StatsStreamTest::write(void) {
+    const auto f = std::unique_ptr<std::FILE, decltype(&std::fclose)>{
+        std::tmpfile(), &std::fclose};
+    QVERIFY(f);
+    constexpr std::array<u64, 4> u = {1, 2, 3, 4};
+    constexpr std::array<float, 3> x = {0.5f, 1, 2};
+    QVERIFY(StatsStream::write(f.get(), u, 2));
+    QVERIFY(StatsStream::write(f.get(), x));
+    QVERIFY(StatsStream::write(f.get(), std::span<const float>{}));
+    const auto s = contents(f.get());
+    QCOMPARE(s.size(), 3 * sizeof(StatsStream::header) + 4 * 8 + 3 * 4);
+    QCOMPARE(s[0], static_cast<char>(StatsStream::MARKER));
+    std::string_view v = s;
+    StatsStream::header h = {};
+    auto n = StatsStream::read(v, &h);
+    QCOMPARE(n, sizeof(h) + sizeof(u));
+    QVERIFY(h.type == StatsStream::Type::U64);
+    QCOMPARE(h.stride, nngn::u16{2});
+    QCOMPARE(h.n, 4u);
+    std::array<u64, 4> ru = {};
+    std::memcpy(ru.data(), v.data() + sizeof(h), sizeof(ru));
+    QVERIFY(ru == u);
+    v.remove_prefix(n);
+    n = StatsStream::read(v, &h);
+    QCOMPARE(n, sizeof(h) + sizeof(x));
+    QVERIFY(h.type == StatsStream::Type::F32);
+    QCOMPARE(h.stride, nngn::u16{1});
+    std::array<float, 3> rx = {};
+    std::memcpy(rx.data(), v.data() + sizeof(h), sizeof(rx));
+    QVERIFY(rx == x);
+    v.remove_prefix(n);
+    n = StatsStream::read(v, &h);
+    QCOMPARE(n, sizeof(h));
+    QCOMPARE(h.n, 0u);
+    QCOMPARE(v.size(), n);
+}
+
+void StatsStreamTest::read_incomplete(void) {
+    const auto f = std::unique_ptr<std::FILE, decltype(&std::fclose)>{
+        std::tmpfile(), &std::fclose};
+    QVERIFY(f);
+    constexpr std::array<u64, 2> u = {1, 2};
+    QVERIFY(StatsStream::write(f.get(), u));
+    const auto s = contents(f.get());
+    StatsStream::header h = {};
+    for(std::size_t i = 0; i != s.size(); ++i) {
+        const auto prefix = std::string_view{s}.substr(0, i);
+        QCOMPARE(StatsStream::read(prefix, &h), std::size_t{});
+    }
+    QCOMPARE(StatsStream::read(s, &h), s.size());
+}
+
+void StatsStreamTest::read_invalid(void) {
+    constexpr auto size = sizeof(StatsStream::header);
+    StatsStream::header h = {};
+    std::string s = "d l 1\n\n\n";
+    QCOMPARE(StatsStream::read(s, &h), size);
+    QVERIFY(h.type == StatsStream::Type{});
+    s.assign(size, 0);
+    s[1] = 42;
+    QCOMPARE(StatsStream::read(s, &h), size);
+    QVERIFY(h.type == StatsStream::Type{});
+}
+
+QTEST_MAIN(StatsStreamTest)
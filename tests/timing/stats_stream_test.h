@@ -0,0 +1,14 @@
+#ifndef NNGN_TEST_TIMING_STATS_STREAM_H
+#define NNGN_TEST_TIMING_STATS_STREAM_H
+
+#include <QTest>
+
+class StatsStreamTest : public QObject {
+    Q_OBJECT
+private slots:
+    void write(void);
+    void read_incomplete(void);
+    void read_invalid(void);
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "timing/timestep.h"
+
+#include "timestep_test.h"
+
+using namespace std::chrono_literals;
+
+void TimestepTest::disabled(void) {
+    nngn::FixedTimestep t = {};
+    QVERIFY(!t.enabled());
+    QCOMPARE(t.update(0ms), 1u);
+    QCOMPARE(t.update(100ms), 1u);
+    QCOMPARE(t.alpha(), 1.0f);
+}
+
+void TimestepTest::update(void) {
+    nngn::FixedTimestep t = {};
+    t.set_step(10ms);
+    QVERIFY(t.enabled());
+    QCOMPARE(t.update(5ms), 0u);
+    QCOMPARE(t.update(5ms), 1u);
+    QCOMPARE(t.update(25ms), 2u);
+    QCOMPARE(t.update(5ms), 1u);
+    QCOMPARE(t.update(0ms), 0u);
+    QCOMPARE(t.update(-5ms), 0u);
+    QCOMPARE(t.update(10ms), 1u);
+    QCOMPARE(t.dropped(), 0u);
+}
+
+void TimestepTest::alpha(void) {
+    nngn::FixedTimestep t = {};
+    t.set_step(8ms);
+    QCOMPARE(t.alpha(), 0.0f);
+    t.update(2ms);
+    QCOMPARE(t.alpha(), 0.25f);
+    t.update(12ms);
+    QCOMPARE(t.alpha(), 0.75f);
+    t.update(2ms);
+    QCOMPARE(t.alpha(), 0.0f);
+}
+
+void TimestepTest::max_steps(void) {
+    nngn::FixedTimestep t = {};
+    t.set_step(10ms);
+    t.set_max_steps(2);
+    QCOMPARE(t.update(55ms), 2u);
+    QCOMPARE(t.dropped(), 3u);
+    QCOMPARE(t.alpha(), 0.5f);
+    QCOMPARE(t.update(5ms), 1u);
+    QCOMPARE(t.dropped(), 3u);
+}
+
+void TimestepTest::set_step(void) {
+    nngn::FixedTimestep t = {};
+    t.set_step(10ms);
+    t.update(5ms);
+    t.set_step(20ms);
+    QCOMPARE(t.step(), nngn::FixedTimestep::duration{20ms});
+    QCOMPARE(t.alpha(), 0.0f);
+    QCOMPARE(t.update(15ms), 0u);
+    t.set_step({});
+    QVERIFY(!t.enabled());
+    QCOMPARE(t.update(15ms), 1u);
+}
+
+void TimestepTest::tick(void) {
+    nngn::Timing timing = {};
+    timing.dt = 16ms;
+    nngn::FixedTimestep t = {};
+    QCOMPARE(t.tick(timing).dt, timing.dt);
+    t.set_step(10ms);
+    const auto tick = t.tick(timing);
+    QCOMPARE(tick.dt, nngn::Timing::duration{10ms});
+    QCOMPARE(tick.now, timing.now);
+}
+
+QTEST_MAIN(TimestepTest)
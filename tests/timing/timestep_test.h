@@ -0,0 +1,17 @@
+#ifndef NNGN_TEST_TIMING_TIMESTEP_H
+#define NNGN_TEST_TIMING_TIMESTEP_H
+
+#include <QTest>
+
+class TimestepTest : public QObject {
+    Q_OBJECT
+private slots:
+    void disabled(void);
+    void update(void);
+    void alpha(void);
+    void max_steps(void);
+    void set_step(void);
+    void tick(void);
+};
+
+#endif
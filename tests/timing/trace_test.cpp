@@ -0,0 +1,125 @@
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "timing/trace.h"
+
+#include "trace_test.h"
+
+using nngn::Trace;
+
+namespace {
+
+std::string to_json(void) {
+    std::stringstream s;
+    if(!Trace::write_json(&s))
+        return {};
+    return s.str();
+}
+
+std::size_t count(std::string_view s, std::string_view x) {
+    std::size_t ret = 0;
+    for(auto i = s.find(x); i != s.npos; i = s.find(x, i + x.size()))
+        ++ret;
+    return ret;
+}
+
+}
+
+void TraceTest::init(void) {
+    Trace::clear();
+    Trace::set_active(true);
+}
+
+void TraceTest::cleanup(void) {
+    Trace::set_active(false);
+    Trace::set_frames(Trace::DEFAULT_FRAMES);
+    Trace::clear();
+}
+
+void TraceTest::inactive(void) {
+    Trace::set_active(false);
+    {
+        NNGN_TRACE_ZONE("zone");
+    }
+    QCOMPARE(count(to_json(), R"("ph":"X")"), 0);
+}
+
+void TraceTest::nested(void) {
+    {
+        NNGN_TRACE_ZONE("outer");
+        {
+            NNGN_TRACE_ZONE("inner");
+        }
+    }
+    const auto json = to_json();
+    QCOMPARE(count(json, R"("ph":"X")"), 2);
+    const auto inner = json.find(R"("name":"inner")");
+    const auto outer = json.find(R"("name":"outer")");
+    QVERIFY(inner != json.npos);
+    QVERIFY(outer != json.npos);
+    QVERIFY(inner < outer);
+}
+
+void TraceTest::threads(void) {
+    Trace::set_thread_name("main");
+    {
+        NNGN_TRACE_ZONE("main_zone");
+    }
+    std::thread{[] {
+        Trace::set_thread_name("worker \"1\"");
+        NNGN_TRACE_ZONE("worker_zone");
+    }}.join();
+    const auto json = to_json();
+    QCOMPARE(count(json, R"("ph":"M")"), 2);
+    QVERIFY(json.find(R"("args":{"name":"main"})") != json.npos);
+    QVERIFY(json.find(R"("args":{"name":"worker \"1\""})") != json.npos);
+    const auto tid = [&json](std::string_view name) {
+        const auto i = json.find("\"tid\":", json.find(name));
+        return json.substr(i, json.find(',', i) - i);
+    };
+    QVERIFY(tid("main_zone") != tid("worker_zone"));
+}
+
+void TraceTest::clear_threads(void) {
+    std::atomic_int step = 0;
+    std::thread t{[&step] {
+        Trace::record("old", 1, 2);
+        step = 1;
+        step.notify_one();
+        step.wait(1);
+        Trace::record("new", 3, 4);
+    }};
+    step.wait(0);
+    Trace::clear();
+    step = 2;
+    step.notify_one();
+    t.join();
+    const auto json = to_json();
+    QCOMPARE(count(json, R"("name":"old")"), 0);
+    QCOMPARE(count(json, R"("name":"new")"), 1);
+}
+
+void TraceTest::frames(void) {
+    Trace::set_frames(2);
+    QCOMPARE(Trace::frames(), 2);
+    Trace::frame();
+    Trace::record("old", 1, 2);
+    Trace::frame();
+    Trace::frame();
+    Trace::record("new", Trace::now());
+    const auto json = to_json();
+    QCOMPARE(count(json, R"("name":"frame")"), 2);
+    QCOMPARE(count(json, R"("name":"old")"), 0);
+    QCOMPARE(count(json, R"("name":"new")"), 1);
+}
+
+void TraceTest::overflow(void) {
+    constexpr auto n = Trace::BUFFER_SIZE;
+    for(std::size_t i = 0; i != n + n / 2; ++i)
+        Trace::record("zone", i + 1, i + 2);
+    QCOMPARE(count(to_json(), R"("ph":"X")"), n);
+}
+
+QTEST_MAIN(TraceTest)
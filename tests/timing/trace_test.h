@@ -0,0 +1,19 @@
+#ifndef NNGN_TEST_TIMING_TRACE_H
+#define NNGN_TEST_TIMING_TRACE_H
+
+#include <QTest>
+
+class TraceTest : public QObject {
+    Q_OBJECT
+private slots:
+    void init(void);
+    void cleanup(void);
+    void inactive(void);
+    void nested(void);
+    void threads(void);
+    void clear_threads(void);
+    void frames(void);
+    void overflow(void);
+};
+
+#endif
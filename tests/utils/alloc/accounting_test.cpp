@@ -0,0 +1,86 @@
+#include "accounting_test.h"
+
+#include "utils/alloc/accounting.h"
+
+using nngn::memory_accounting, nngn::memory_tag;
+
+namespace {
+
+constexpr auto tag = memory_tag::entities;
+
+template<typename T>
+using tagged_vector = nngn::accounted_vector<T, tag>;
+
+}
+
+void AccountingTest::vector(void) {
+    const auto c0 = memory_accounting::get(tag);
+    {
+        auto v = tagged_vector<int>{};
+        v.reserve(16);
+        auto c = memory_accounting::get(tag);
+        QCOMPARE(c.bytes, c0.bytes + 16 * sizeof(int));
+        QCOMPARE(c.n, c0.n + 1);
+        v.reserve(32);
+        c = memory_accounting::get(tag);
+        QCOMPARE(c.bytes, c0.bytes + 32 * sizeof(int));
+        QCOMPARE(c.n, c0.n + 1);
+        const auto other = memory_tag::textures;
+        const auto other0 = memory_accounting::get(other);
+        auto v1 = tagged_vector<char>(8);
+        c = memory_accounting::get(tag);
+        QCOMPARE(c.bytes, c0.bytes + 32 * sizeof(int) + 8);
+        QCOMPARE(c.n, c0.n + 2);
+        QCOMPARE(memory_accounting::get(other).bytes, other0.bytes);
+    }
+    const auto c = memory_accounting::get(tag);
+    QCOMPARE(c.bytes, c0.bytes);
+    QCOMPARE(c.n, c0.n);
+}
+
+void AccountingTest::peak(void) {
+    memory_accounting::reset_peak();
+    const auto c0 = memory_accounting::get(tag);
+    QCOMPARE(c0.peak, c0.bytes);
+    {
+        auto v = tagged_vector<char>(1024);
+        v = tagged_vector<char>(16);
+    }
+    auto c = memory_accounting::get(tag);
+    QCOMPARE(c.bytes, c0.bytes);
+    QCOMPARE(c.peak, c0.bytes + 1024 + 16);
+    memory_accounting::reset_peak();
+    c = memory_accounting::get(tag);
+    QCOMPARE(c.peak, c0.bytes);
+}
+
+void AccountingTest::frame(void) {
+    memory_accounting::frame();
+    {
+        auto v = tagged_vector<char>(8);
+        v = tagged_vector<char>(16);
+        memory_accounting::frame();
+    }
+    auto c = memory_accounting::get(tag);
+    QCOMPARE(c.frame_allocs, 2);
+    QCOMPARE(c.frame_bytes, 24);
+    memory_accounting::frame();
+    c = memory_accounting::get(tag);
+    QCOMPARE(c.frame_allocs, 0);
+    QCOMPARE(c.frame_bytes, 0);
+}
+
+void AccountingTest::equal(void) {
+    using A = nngn::accounted_allocator<int, tag>;
+    QVERIFY(A{} == A{});
+    const auto c0 = memory_accounting::get(tag);
+    auto v0 = tagged_vector<int>(4), v1 = tagged_vector<int>{};
+    const auto *const p = v0.data();
+    v1 = std::move(v0);
+    QCOMPARE(v1.data(), p);
+    std::swap(v0, v1);
+    QCOMPARE(v0.data(), p);
+    QCOMPARE(memory_accounting::get(tag).n, c0.n + 1);
+}
+
+QTEST_MAIN(AccountingTest)
@@ -0,0 +1,15 @@
+#ifndef NNGN_TESTS_UTILS_ALLOC_ACCOUNTING_H
+#define NNGN_TESTS_UTILS_ALLOC_ACCOUNTING_H
+
+#include <QTest>
+
+class AccountingTest : public QObject {
+    Q_OBJECT
+private slots:
+    void vector(void);
+    void peak(void);
+    void frame(void);
+    void equal(void);
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include <new>
+#include <sstream>
+
+#include "os/platform.h"
+#include "utils/alloc/counter.h"
+#include "utils/log.h"
+
+#include "counter_test.h"
+
+using nngn::alloc_counter;
+
+void CounterTest::count(void) {
+    if constexpr(!nngn::Platform::alloc_count)
+        QSKIP("configured without --enable-alloc-count");
+    alloc_counter::set_active(true);
+    const auto total = alloc_counter::total();
+    alloc_counter::frame();
+    auto *const p0 = ::operator new(16);
+    auto *const p1 = ::operator new(8, std::align_val_t{64});
+    ::operator delete(p1, std::align_val_t{64});
+    ::operator delete(p0);
+    alloc_counter::frame();
+    alloc_counter::set_active(false);
+    QCOMPARE(alloc_counter::frame_allocs(), 2u);
+    QCOMPARE(alloc_counter::frame_bytes(), 24u);
+    QCOMPARE(alloc_counter::total(), total + 2);
+    ::operator delete(::operator new(16));
+    alloc_counter::frame();
+    QCOMPARE(alloc_counter::frame_allocs(), 0u);
+    QCOMPARE(alloc_counter::total(), total + 2);
+}
+
+void CounterTest::report(void) {
+    if constexpr(!nngn::Platform::alloc_count)
+        QSKIP("configured without --enable-alloc-count");
+    std::stringstream log;
+    {
+        const nngn::Log::replace r(&log);
+        alloc_counter::set_report(true);
+        alloc_counter::set_active(true);
+        alloc_counter::frame();
+        for(int i = 0; i != 3; ++i)
+            ::operator delete(::operator new(16));
+        alloc_counter::frame();
+        alloc_counter::set_active(false);
+        alloc_counter::set_report(false);
+    }
+    QCOMPARE(alloc_counter::frame_allocs(), 3u);
+    const auto s = log.str();
+    QVERIFY(s.find("3 allocation(s), 48 byte(s)") != std::string::npos);
+}
+
+QTEST_MAIN(CounterTest)
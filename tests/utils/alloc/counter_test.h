@@ -0,0 +1,13 @@
+#ifndef NNGN_TESTS_UTILS_ALLOC_COUNTER_H
+#define NNGN_TESTS_UTILS_ALLOC_COUNTER_H
+
+#include <QTest>
+
+class CounterTest : public QObject {
+    Q_OBJECT
+private slots:
+    void count(void);
+    void report(void);
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "pool_test.h"
+
+#include "utils/alloc/block.h"
+#include "utils/alloc/pool.h"
+#include "utils/alloc/tagging.h"
+#include "utils/alloc/tracking.h"
+#include "utils/literals.h"
+
+using namespace nngn::literals;
+
+namespace {
+
+using pool = nngn::size_class_pool;
+
+struct info { std::size_t n, bytes; };
+
+template<typename T>
+struct tracker {
+    using value_type = T;
+    using pointer = std::add_pointer_t<T>;
+    using block_type = nngn::alloc_block<std::size_t, value_type>;
+    template<typename U> struct rebind { using other = tracker<U>; };
+    void allocate(pointer p, std::size_t n);
+    void reallocate_pre(pointer p, std::size_t n);
+    void reallocate(pointer p, std::size_t n);
+    void deallocate(pointer p, std::size_t n);
+    info *i = nullptr;
+};
+
+template<typename T>
+void tracker<T>::allocate(pointer p, std::size_t n) {
+    *block_type::from_ptr(p).header() = n;
+    ++this->i->n;
+    this->i->bytes += n;
+}
+
+template<typename T>
+void tracker<T>::reallocate_pre(pointer p, std::size_t) {
+    this->deallocate(p, *block_type::from_ptr(p).header());
+}
+
+template<typename T>
+void tracker<T>::reallocate(pointer p, std::size_t n) {
+    this->allocate(p, n);
+}
+
+template<typename T>
+void tracker<T>::deallocate(pointer, std::size_t n) {
+    --this->i->n;
+    this->i->bytes -= n;
+}
+
+}
+
+void PoolTest::class_index(void) {
+    QCOMPARE(pool::class_index(0), 0);
+    QCOMPARE(pool::class_index(1), 0);
+    QCOMPARE(pool::class_index(16), 0);
+    QCOMPARE(pool::class_index(17), 1);
+    QCOMPARE(pool::class_index(129), 8);
+    QCOMPARE(pool::class_index(160), 8);
+    QCOMPARE(pool::class_index(512), pool::n_classes - 1);
+    QCOMPARE(pool::class_index(513), pool::no_class);
+    for(std::size_t i = 1; i <= pool::max_size; ++i) {
+        const auto c = pool::class_index(i);
+        QVERIFY(i <= pool::class_sizes[c]);
+        QVERIFY(!c || pool::class_sizes[c - 1] < i);
+    }
+}
+
+void PoolTest::alloc(void) {
+    pool p = {};
+    auto *const p0 = static_cast<char*>(p.allocate(24));
+    auto *const p1 = static_cast<char*>(p.allocate(24));
+    auto *const p2 = static_cast<char*>(p.allocate(200));
+    QVERIFY(p0);
+    QVERIFY(p1);
+    QVERIFY(p2);
+    QVERIFY(p0 != p1);
+    QCOMPARE(p1 - p0, 32);
+    QVERIFY(!(reinterpret_cast<std::uintptr_t>(p0) % pool::align));
+    QVERIFY(!(reinterpret_cast<std::uintptr_t>(p2) % pool::align));
+    std::memset(p0, 0, 24);
+    std::memset(p1, 0, 24);
+    std::memset(p2, 0, 200);
+    const auto &s = p.get_stats();
+    QCOMPARE(s.chunks, 2);
+    QCOMPARE(s.classes[1].n, 2);
+    QCOMPARE(s.classes[1].capacity, 2);
+    QCOMPARE(s.classes[pool::class_index(200)].n, 1);
+    p.deallocate(p0, 24);
+    p.deallocate(p1, 24);
+    p.deallocate(p2, 200);
+    QCOMPARE(s.classes[1].n, 0);
+    QCOMPARE(s.classes[1].capacity, 2);
+}
+
+void PoolTest::reuse(void) {
+    pool p = {};
+    constexpr auto n = 2 * pool::chunk_size / 64;
+    std::vector<void*> v(n);
+    for(auto &x : v)
+        QVERIFY(x = p.allocate(64));
+    const auto chunks = p.get_stats().chunks;
+    QCOMPARE(chunks, 3);
+    for(auto *x : v)
+        p.deallocate(x, 64);
+    for(auto &x : v)
+        QVERIFY(x = p.allocate(50));
+    QCOMPARE(p.get_stats().chunks, chunks);
+    QCOMPARE(p.get_stats().classes[3].capacity, n);
+    for(auto *x : v)
+        p.deallocate(x, 50);
+}
+
+void PoolTest::large(void) {
+    pool p = {};
+    constexpr auto n = 4_z * pool::max_size;
+    auto *const p0 = p.allocate(n);
+    QVERIFY(p0);
+    std::memset(p0, 0, n);
+    QCOMPARE(p.get_stats().large, 1);
+    QCOMPARE(p.get_stats().chunks, 0);
+    p.deallocate(p0, n);
+    QCOMPARE(p.get_stats().large, 0);
+}
+
+void PoolTest::realloc(void) {
+    pool p = {};
+    auto *const p0 = static_cast<char*>(p.allocate(20));
+    std::memcpy(p0, "0123456789", 10);
+    QCOMPARE(static_cast<char*>(p.reallocate(p0, 20, 30)), p0);
+    auto *const p1 = static_cast<char*>(p.reallocate(p0, 30, 100));
+    QVERIFY(p1 != p0);
+    QVERIFY(!std::memcmp(p1, "0123456789", 10));
+    auto *const p2 = static_cast<char*>(p.reallocate(p1, 100, 4096));
+    QVERIFY(!std::memcmp(p2, "0123456789", 10));
+    QCOMPARE(p.get_stats().large, 1);
+    auto *const p3 = static_cast<char*>(p.reallocate(p2, 4096, 8));
+    QVERIFY(!std::memcmp(p3, "01234567", 8));
+    QCOMPARE(p.get_stats().large, 0);
+    const auto &s = p.get_stats().classes;
+    QVERIFY(std::all_of(
+        begin(s) + 1, end(s), [](const auto &x) { return !x.n; }));
+    QCOMPARE(s[0].n, 1);
+    p.deallocate(p3, 8);
+}
+
+void PoolTest::tracking(void) {
+    using T = char;
+    using A0 = nngn::pool_allocator<T>;
+    using A1 = nngn::tagging_allocator<tracker<T>, A0>;
+    using A2 = nngn::tracking_allocator<tracker<T>, A1>;
+    pool p = {};
+    info i = {};
+    auto a = A2{tracker<T>{&i}, A1{A0{&p}}};
+    auto *p0 = a.allocate(24);
+    QCOMPARE(i.n, 1);
+    QCOMPARE(i.bytes, 24);
+    QCOMPARE(p.get_stats().classes[pool::class_index(32)].n, 1);
+    p0 = a.reallocate(p0, 24, 1024);
+    QCOMPARE(i.n, 1);
+    QCOMPARE(i.bytes, 1024);
+    QCOMPARE(p.get_stats().classes[pool::class_index(32)].n, 0);
+    QCOMPARE(p.get_stats().large, 1);
+    a.deallocate(p0, 1024);
+    QCOMPARE(i.n, 0);
+    QCOMPARE(i.bytes, 0);
+    QCOMPARE(p.get_stats().large, 0);
+}
+
+QTEST_MAIN(PoolTest)
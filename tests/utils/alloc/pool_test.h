@@ -0,0 +1,17 @@
+#ifndef NNGN_TESTS_UTILS_ALLOC_POOL_H
+#define NNGN_TESTS_UTILS_ALLOC_POOL_H
+
+#include <QTest>
+
+class PoolTest : public QObject {
+    Q_OBJECT
+private slots:
+    void class_index(void);
+    void alloc(void);
+    void reuse(void);
+    void large(void);
+    void realloc(void);
+    void tracking(void);
+};
+
+#endif
@@ -80,3 +80,11 @@ bool PlotWorker::cmd_data(std::stringstream *ss) {
     emit this->new_data(static_cast<Graph::Type>(type), value);
     return true;
 }
+
+bool PlotWorker::cmd_record(
+    const nngn::StatsStream::header &h, std::string_view s
+) {
+    NNGN_LOG_CONTEXT_CF(PlotWorker);
+    return Worker::read_record(h, s, [this](qreal x)
+        { emit this->new_data(Graph::Type::LINE, x); });
+}
@@ -11,6 +11,8 @@ class PlotWorker final : public Worker {
         QUIT = 'q', SIZE = 's', GRAPH = 'g', FRAME = 'f', DATA = 'd',
     };
     bool cmd(std::string_view s) final;
+    bool cmd_record(
+        const nngn::StatsStream::header &h, std::string_view s) final;
     bool cmd_size(std::stringstream *ss);
     bool cmd_graph(std::stringstream *ss);
     bool cmd_frame(std::stringstream *ss);
@@ -20,17 +20,8 @@ std::ptrdiff_t LineReader::read(int fd) {
             }
             break;
         }
-        this->ss.write(b.data(), n);
+        this->data.append(b.data(), static_cast<std::size_t>(n));
         ret += n;
     }
     return ret;
 }
-
-bool LineReader::next_line(std::string *s) {
-    const bool ret = !!std::getline(this->ss, *s);
-    if(this->ss.eof()) {
-        this->ss.clear();
-        this->ss.str({});
-    }
-    return ret;
-}
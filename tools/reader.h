@@ -2,24 +2,55 @@
 #define NNGN_SCRIPTS_READER_H
 
 #include <cstddef>
-#include <sstream>
 #include <string>
-#include <vector>
+#include <string_view>
+#include <utility>
 
+#include "timing/stats_stream.h"
+
+/**
+ * Splits the input into commands.
+ * Commands are either text lines or binary records (see
+ * `nngn::StatsStream`).  Incomplete commands are kept until the rest of the
+ * data is read.
+ */
 class LineReader {
     std::string buf = std::string(4096, 0);
-    std::stringstream ss = {};
-    bool next_line(std::string *s);
+    std::string data = {};
+    std::size_t pos = 0;
 public:
     std::ptrdiff_t read(int fd);
-    template<typename T> bool for_each(T f);
+    /**
+     * Calls `f(line)` or `g(header, payload)` for each complete command.
+     * Stops and returns `false` if any call returns `false`.
+     */
+    template<typename F, typename G> bool for_each(F f, G g);
 };
 
-bool LineReader::for_each(auto f) {
-    std::string l;
-    while(this->next_line(&l))
-        if(!f(std::string_view{l}))
+template<typename F, typename G>
+bool LineReader::for_each(F f, G g) {
+    using nngn::StatsStream;
+    for(StatsStream::header h = {};;) {
+        const auto s = std::string_view{this->data}.substr(this->pos);
+        if(s.empty())
+            break;
+        if(s[0] == static_cast<char>(StatsStream::MARKER)) {
+            const auto n = StatsStream::read(s, &h);
+            if(!n)
+                break;
+            this->pos += n;
+            if(!g(h, s.substr(sizeof(h), n - sizeof(h))))
+                return false;
+            continue;
+        }
+        const auto i = s.find('\n');
+        if(i == std::string_view::npos)
+            break;
+        this->pos += i + 1;
+        if(!f(s.substr(0, i)))
             return false;
+    }
+    this->data.erase(0, std::exchange(this->pos, 0));
     return true;
 }
 
@@ -38,3 +38,32 @@ bool PlotWorker::cmd_data(std::stringstream *ss) {
     emit this->new_data(v);
     return true;
 }
+
+bool PlotWorker::cmd_record(
+    const nngn::StatsStream::header &h, std::string_view s
+) {
+    NNGN_LOG_CONTEXT_CF(PlotWorker);
+    // Each graph takes four values, shorter entries are expanded in the same
+    // way as the text commands sent by the engine.
+    QVector<qreal> v;
+    switch(h.stride) {
+    case 1:
+        if(!Worker::read_record(h, s, [&v](qreal x) { v << 0 << 0 << 0 << x; }))
+            return false;
+        break;
+    case 2:
+        if(!Worker::read_record(h, s, [&v](qreal x) { v << x << x; }))
+            return false;
+        break;
+    case 4:
+        if(!Worker::read_record(h, s, [&v](qreal x) { v << x; }))
+            return false;
+        break;
+    default:
+        nngn::Log::l() << "invalid stride: " << h.stride << '\n';
+        this->err();
+        return false;
+    }
+    emit this->new_data(v);
+    return true;
+}
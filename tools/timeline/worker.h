@@ -7,6 +7,8 @@ class PlotWorker final : public Worker {
     Q_OBJECT
     enum class Command : uint8_t { QUIT = 'q', GRAPH = 'g', DATA = 'd' };
     bool cmd(std::string_view s) final;
+    bool cmd_record(
+        const nngn::StatsStream::header &h, std::string_view s) final;
     void cmd_graph(std::stringstream *ss);
     bool cmd_data(std::stringstream *ss);
 signals:
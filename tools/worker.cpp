@@ -13,6 +13,15 @@ bool Worker::destroy(void) {
 void Worker::err(void) { this->error = true; emit this->finished(); }
 void Worker::finish(void) { if(!this->poller.finish()) this->error = true; }
 
+bool Worker::cmd_record(
+    const nngn::StatsStream::header&, std::string_view
+) {
+    NNGN_LOG_CONTEXT_CF(Worker);
+    nngn::Log::l() << "binary records are not supported\n";
+    this->err();
+    return false;
+}
+
 void Worker::run(void) {
     LineReader reader = {};
     for(;;) {
@@ -26,7 +35,11 @@ void Worker::run(void) {
         case -1: return this->err();
         case 0: return emit this->finished();
         default:
-            if(!reader.for_each([this](auto l) { return this->cmd(l); }))
+            if(!reader.for_each(
+                [this](auto l) { return this->cmd(l); },
+                [this](const auto &h, auto s)
+                    { return this->cmd_record(h, s); }
+            ))
                 return;
         }
     }
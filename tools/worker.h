@@ -1,10 +1,12 @@
 #ifndef NNGN_TOOLS_WORKER_H
 #define NNGN_TOOLS_WORKER_H
 
+#include <cstring>
 #include <iomanip>
 
 #include <QThread>
 
+#include "timing/stats_stream.h"
 #include "utils/log.h"
 
 #include "poller.h"
@@ -14,6 +16,10 @@ class Worker : public QThread {
 protected:
     template<typename ...Ts>
     auto read_values(std::stringstream *s, Ts *...ts);
+    /** Calls `f(x)` for each value in a binary record. */
+    template<typename F>
+    static bool read_record(
+        const nngn::StatsStream::header &h, std::string_view s, F f);
     void err(void);
 public:
     bool init(int fd);
@@ -26,6 +32,8 @@ signals:
     void finished(void);
 private:
     virtual bool cmd(std::string_view s) = 0;
+    virtual bool cmd_record(
+        const nngn::StatsStream::header &h, std::string_view s);
     bool error = false;
     int fd = -1;
     Poller poller = {};
@@ -42,4 +50,26 @@ auto Worker::read_values(std::stringstream *s, Ts *...ts) {
     return false;
 }
 
+template<typename F>
+bool Worker::read_record(
+    const nngn::StatsStream::header &h, std::string_view s, F f)
+{
+    using T = nngn::StatsStream::Type;
+    const auto read = [s, f]<typename V>(V) {
+        for(std::size_t i = 0; i < s.size(); i += sizeof(V)) {
+            V v = {};
+            std::memcpy(&v, s.data() + i, sizeof(V));
+            f(static_cast<qreal>(v));
+        }
+        return true;
+    };
+    switch(h.type) {
+    case T::U64: return read(nngn::u64{});
+    case T::F32: return read(float{});
+    }
+    nngn::Log::l()
+        << "invalid record type: " << static_cast<int>(h.type) << '\n';
+    return false;
+}
+
 #endif